@@ -5,11 +5,15 @@ set(mlas_common_srcs
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/platform.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/threading.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/sgemm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/gemm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/qgemm.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/convolve.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/nchwc.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/pooling.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/activate.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/logistic.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/tanh.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/compute.cpp
 )
 
 if (MSVC)
@@ -65,6 +69,14 @@ if (MSVC)
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/cvtfp16a.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/LogisticKernelFma3.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/TanhKernelFma3.asm
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/qgemm_kernel_avx2.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/qgemm_kernel_avx512vnni.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/convolve_kernel_fma3.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/convolve_kernel_avx512f.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/nchwc_kernel_fma3.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/nchwc_kernel_avx512f.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/compute_kernel_fma3.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/compute_kernel_avx512f.cpp
     )
 
   endif()
@@ -120,19 +132,32 @@ else()
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SgemmKernelFma3.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/LogisticKernelFma3.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/TanhKernelFma3.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/qgemm_kernel_avx2.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/convolve_kernel_fma3.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/nchwc_kernel_fma3.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/compute_kernel_fma3.cpp
     )
     set_source_files_properties(${mlas_platform_srcs_avx2} PROPERTIES COMPILE_FLAGS "-mavx2 -mfma")
 
     set(mlas_platform_srcs_avx512f
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SgemmKernelAvx512F.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/convolve_kernel_avx512f.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/nchwc_kernel_avx512f.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/compute_kernel_avx512f.cpp
     )
     set_source_files_properties(${mlas_platform_srcs_avx512f} PROPERTIES COMPILE_FLAGS "-mavx512f")
 
+    set(mlas_platform_srcs_avx512vnni
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/qgemm_kernel_avx512vnni.cpp
+    )
+    set_source_files_properties(${mlas_platform_srcs_avx512vnni} PROPERTIES COMPILE_FLAGS "-mavx512f -mavx512vnni")
+
     set(mlas_platform_srcs
       ${mlas_platform_srcs_sse2}
       ${mlas_platform_srcs_avx}
       ${mlas_platform_srcs_avx2}
       ${mlas_platform_srcs_avx512f}
+      ${mlas_platform_srcs_avx512vnni}
     )
 
   endif()
@@ -140,5 +165,5 @@ else()
 endif()
 
 add_library(onnxruntime_mlas STATIC ${mlas_common_srcs} ${mlas_platform_srcs})
-target_include_directories(onnxruntime_mlas PRIVATE ${ONNXRUNTIME_ROOT}/core/mlas/inc ${ONNXRUNTIME_ROOT}/core/mlas/lib)
+target_include_directories(onnxruntime_mlas PRIVATE ${ONNXRUNTIME_ROOT}/core/mlas/inc ${ONNXRUNTIME_ROOT}/core/mlas/lib ${ONNXRUNTIME_ROOT})
 set_target_properties(onnxruntime_mlas PROPERTIES FOLDER "ONNXRuntime")
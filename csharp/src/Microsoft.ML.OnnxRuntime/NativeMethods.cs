@@ -65,6 +65,26 @@ namespace Microsoft.ML.OnnxRuntime
                                                 IntPtr[] outputValues /* An array of output value pointers. Array must be allocated by the caller */
                                                 );
 
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtCreatePreparedRun(
+                                                IntPtr /*(OrtSession*)*/ session,
+                                                string[] inputNames,
+                                                ulong inputCount,  /* TODO: size_t, make it portable for x86 arm */
+                                                string[] outputNames,
+                                                ulong outputCount,  /* TODO: size_t, make it portable for x86 and arm */
+                                                out IntPtr /*(OrtPreparedRun*)*/ preparedRun);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtRunPrepared(
+                                                IntPtr /*(OrtPreparedRun*)*/ preparedRun,
+                                                IntPtr /*(OrtSessionRunOptions*)*/ runOptions,  // can be null to use the default options
+                                                IntPtr[] /* (OrtValue*[])*/ inputValues,
+                                                [In, Out] IntPtr[] outputValues /* An array of output value pointers. Array must be allocated by the caller */
+                                                );
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern void OrtReleasePreparedRun(IntPtr /*(OrtPreparedRun*)*/ preparedRun);
+
 
         [DllImport(nativeLib, CharSet = charSet)]
         public static extern IntPtr /*(OrtStatus*)*/ OrtSessionGetInputCount(
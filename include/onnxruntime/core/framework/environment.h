@@ -9,6 +9,8 @@
 #include "core/common/status.h"
 
 namespace onnxruntime {
+class SharedInitializerStore;
+
 /**
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -30,6 +32,12 @@ class Environment {
   */
   static bool IsInitialized() { return is_initialized_; }
 
+  /**
+     Returns the store of the initializers that are shared by the sessions created with
+     SessionOptions::share_initializers enabled.
+  */
+  static SharedInitializerStore& GetSharedInitializerStore();
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Environment);
 
@@ -56,6 +56,12 @@ class IExecutionProvider {
   */
   virtual AllocatorPtr GetAllocator(int id, OrtMemType mem_type) const;
 
+  /**
+     Return the memory held by the arenas of <*this> execution provider that isn't in use
+     to the device. Returns the number of bytes released.
+  */
+  size_t ShrinkArenas();
+
   /**
      Get execution provider's capability for the specified <graph>.
      Return a bunch of IndexedSubGraphs <*this> execution provider can run if
@@ -20,6 +20,9 @@
 #include "onnx/defs/schema.h"
 
 namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
 class IExecutionFrame;
 class OpKernelContext;
 class OpKernelWrapper;
@@ -63,6 +66,7 @@ class OpKernelContext {
 
   explicit OpKernelContext(IExecutionFrame* frame,
                            const OpKernel* kernel,
+                           concurrency::ThreadPool* threadpool,
                            const logging::Logger& logger);
 
   virtual ~OpKernelContext() = default;
@@ -145,6 +149,12 @@ class OpKernelContext {
   */
   Fence_t OutputFence(int index) const;
 
+  /**
+  Returns the intra-op threadpool shared by the kernels of the session.
+  It is nullptr if the kernel should run on the calling thread only.
+  */
+  concurrency::ThreadPool* GetOperatorThreadPool() const { return threadpool_; }
+
  protected:
   onnxruntime::NodeIndex GetNodeIndex() const;
 
@@ -164,6 +174,7 @@ class OpKernelContext {
 
   IExecutionFrame* execution_frame_{nullptr};
   const OpKernel* kernel_{nullptr};
+  concurrency::ThreadPool* threadpool_{nullptr};
   const logging::Logger* logger_{nullptr};
 
   // The argument starting index in ExecutionFrame.
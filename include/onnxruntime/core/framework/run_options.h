@@ -18,6 +18,10 @@ struct OrtRunOptions {
   /// set to 'true' to terminate any currently executing Run() calls that are using this
   /// OrtRunOptions instance. the individual calls will exit gracefully and return an error status.
   bool terminate = false;
+
+  /// set to 'true' to return the memory of the session's arenas that isn't in use to the system when the Run()
+  /// call completes, so a long-running process doesn't keep the peak memory of a large request.
+  bool shrink_arenas = false;
   OrtRunOptions() = default;
   ~OrtRunOptions() = default;
 
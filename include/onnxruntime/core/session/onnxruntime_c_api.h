@@ -152,6 +152,7 @@ ORT_RUNTIME_CLASS(TensorTypeAndShapeInfo);
 ORT_RUNTIME_CLASS(SessionOptions);
 ORT_RUNTIME_CLASS(Callback);
 ORT_RUNTIME_CLASS(CustomOpDomain);
+ORT_RUNTIME_CLASS(PreparedRun);
 
 // When passing in an allocator to any ORT function, be sure that the allocator object
 // is not destroyed until the last allocated object using it is freed.
@@ -194,6 +195,27 @@ ORT_API_STATUS(OrtRun, _Inout_ OrtSession* sess,
                _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
                _In_ const char* const* output_names, size_t output_names_len, _Out_ OrtValue** output);
 
+/**
+ * Prepare for repeated calls to OrtRunPrepared with the same input and output names. The names are validated
+ * and resolved once here, instead of on every OrtRun call.
+ * A prepared run must not be used by multiple threads at the same time. Create one per thread instead.
+ * \param out Should be freed by OrtReleasePreparedRun after use, and before the session is released.
+ */
+ORT_API_STATUS(OrtCreatePreparedRun, _Inout_ OrtSession* sess,
+               _In_ const char* const* input_names, size_t input_len,
+               _In_ const char* const* output_names, size_t output_names_len, _Out_ OrtPreparedRun** out);
+
+/**
+ * Run with the input and output names of the prepared run.
+ * \param input Must contain input_len values, in the order of the input_names the prepared run was created with.
+ * \param output Must contain output_names_len entries, in the order of the output_names. As for OrtRun, a non-null
+ *        entry is a pre-allocated output that the result is written to, and a null entry is set to a newly
+ *        created OrtValue that should be freed by OrtReleaseValue. Pre-allocate all the outputs to avoid creating
+ *        new OrtValue instances on every call.
+ */
+ORT_API_STATUS(OrtRunPrepared, _Inout_ OrtPreparedRun* prepared_run, _In_opt_ OrtRunOptions* run_options,
+               _In_ const OrtValue* const* input, _Inout_ OrtValue** output);
+
 /**
  * \return A pointer of the newly created object. The pointer should be freed by OrtReleaseSessionOptions after use
  */
@@ -219,6 +241,38 @@ ORT_API(void, OrtDisableMemPattern, _In_ OrtSessionOptions* options);
 ORT_API(void, OrtEnableCpuMemArena, _In_ OrtSessionOptions* options);
 ORT_API(void, OrtDisableCpuMemArena, _In_ OrtSessionOptions* options);
 
+// Use per-thread caches of small buffers in front of the CPU memory arena, so that threads allocating
+// concurrently don't contend on the arena lock. Each thread may keep a few MB of freed buffers for reuse.
+ORT_API(void, OrtEnableCpuMemArenaThreadCache, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableCpuMemArenaThreadCache, _In_ OrtSessionOptions* options);
+
+// Set the size of the first region the CPU memory arena allocates, the factor each new region grows by (1 to keep
+// the initial size), and the bytes of free regions the arena keeps before returning them to the system.
+// Returns -1 if initial_chunk_size_bytes is 0 or growth_factor is less than 1.
+ORT_API(int, OrtSetCpuMemArenaSettings, _In_ OrtSessionOptions* options, size_t initial_chunk_size_bytes,
+        int growth_factor, size_t max_retained_bytes);
+
+// Return the memory of the session's arenas that isn't in use to the system once no OrtRun* call has been active
+// for timeout_ms milliseconds. 0 (the default) keeps the memory until the session is released.
+ORT_API(void, OrtSetArenaShrinkIdleTimeout, _In_ OrtSessionOptions* options, unsigned int timeout_ms);
+
+// Use the external data of initializers on CPU directly by mapping the data files into copy-on-write memory,
+// instead of copying the data. Writes to the data are not written to the files. The mappings are released when the
+// session is released.
+ORT_API(void, OrtEnableMmapForExternalInitializers, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableMmapForExternalInitializers, _In_ OrtSessionOptions* options);
+
+// Share the initializers on CPU with the other sessions in the process that load the same weights from the same
+// model, so only one copy of each weight is kept in memory. A shared weight is released with the last session using it.
+ORT_API(void, OrtEnableSharedInitializers, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableSharedInitializers, _In_ OrtSessionOptions* options);
+
+// Save the model to optimized_model_filepath once the graph transforms and partitioning have been applied.
+// If the file already contains the optimized model for the same model and execution providers, it's loaded instead
+// of applying the transforms and partitioning again. The file is not used if custom op domains are added.
+ORT_API(void, OrtSetOptimizedModelFilePath, _In_ OrtSessionOptions* options,
+        _In_ const ORTCHAR_T* optimized_model_filepath);
+
 // < logger id to use for session output
 ORT_API(void, OrtSetSessionLogId, _In_ OrtSessionOptions* options, const char* logid);
 
@@ -228,6 +282,10 @@ ORT_API(void, OrtSetSessionLogVerbosityLevel, _In_ OrtSessionOptions* options, u
 // How many threads in the session thread pool.
 ORT_API(int, OrtSetSessionThreadPoolSize, _In_ OrtSessionOptions* options, int session_thread_pool_size);
 
+// How many threads in the intra-op thread pool shared by all the kernels of the session.
+// 0 lets onnxruntime choose. 1 runs the kernels on the calling thread only.
+ORT_API(int, OrtSetIntraOpNumThreads, _In_ OrtSessionOptions* options, int intra_op_num_threads);
+
 /**
   * To use additional providers, you must build ORT with the extra providers enabled. Then call one of these
   * functions to enable them in the session:
@@ -277,6 +335,10 @@ ORT_API(const char*, OrtRunOptionsGetRunTag, _In_ OrtRunOptions*);
 // will exit as soon as possible if the flag is true.
 ORT_API(void, OrtRunOptionsSetTerminate, _In_ OrtRunOptions*, _In_ int flag);
 
+// If the flag is true, return the memory of the session's arenas that isn't in use to the system when the OrtRun*
+// call using this instance of OrtRunOptions completes.
+ORT_API(void, OrtRunOptionsSetShrinkArenas, _In_ OrtRunOptions*, _In_ int flag);
+
 /**
  * Create a tensor from an allocator. OrtReleaseValue will also release the buffer inside the output value
  * \param out Should be freed by calling OrtReleaseValue
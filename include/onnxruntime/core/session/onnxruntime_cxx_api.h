@@ -73,6 +73,13 @@ struct default_delete<OrtSessionOptions> {
     OrtReleaseSessionOptions(ptr);
   }
 };
+
+template <>
+struct default_delete<OrtPreparedRun> {
+  void operator()(OrtPreparedRun* ptr) {
+    OrtReleasePreparedRun(ptr);
+  }
+};
 }  // namespace std
 
 namespace onnxruntime {
@@ -94,10 +101,20 @@ class SessionOptionsWrapper {
   ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableMemPattern)
   ORT_REDIRECT_SIMPLE_FUNCTION_CALL(EnableCpuMemArena)
   ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableCpuMemArena)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(EnableCpuMemArenaThreadCache)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableCpuMemArenaThreadCache)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(EnableMmapForExternalInitializers)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableMmapForExternalInitializers)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(EnableSharedInitializers)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableSharedInitializers)
   void EnableProfiling(_In_ const ORTCHAR_T* profile_file_prefix) {
     OrtEnableProfiling(value.get(), profile_file_prefix);
   }
 
+  void SetOptimizedModelFilePath(_In_ const ORTCHAR_T* optimized_model_filepath) {
+    OrtSetOptimizedModelFilePath(value.get(), optimized_model_filepath);
+  }
+
   void SetSessionLogId(const char* logid) {
     OrtSetSessionLogId(value.get(), logid);
   }
@@ -107,6 +124,15 @@ class SessionOptionsWrapper {
   void SetSessionThreadPoolSize(int session_thread_pool_size) {
     OrtSetSessionThreadPoolSize(value.get(), session_thread_pool_size);
   }
+  void SetIntraOpNumThreads(int intra_op_num_threads) {
+    OrtSetIntraOpNumThreads(value.get(), intra_op_num_threads);
+  }
+  void SetCpuMemArenaSettings(size_t initial_chunk_size_bytes, int growth_factor, size_t max_retained_bytes) {
+    OrtSetCpuMemArenaSettings(value.get(), initial_chunk_size_bytes, growth_factor, max_retained_bytes);
+  }
+  void SetArenaShrinkIdleTimeout(unsigned int timeout_ms) {
+    OrtSetArenaShrinkIdleTimeout(value.get(), timeout_ms);
+  }
 
   SessionOptionsWrapper clone() const {
     OrtSessionOptions* p = OrtCloneSessionOptions(value.get());
@@ -0,0 +1,258 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "fused_elementwise.h"
+#include "core/common/threadpool.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    FusedElementwise,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise<float>);
+
+namespace {
+
+// Number of output elements evaluated by each pass through the expression.
+// The inputs that are broadcast and the result of every step use a buffer of
+// this size, so the working set of the expression stays in the L1 cache.
+constexpr size_t kBlockSize = 256;
+
+// Number of output elements computed by each task on the thread pool.
+constexpr size_t kTaskSize = 64 * kBlockSize;
+
+struct ElementwiseOpInfo {
+  const char* name;
+  ElementwiseOp op;
+  bool binary;
+};
+
+const ElementwiseOpInfo kElementwiseOps[] = {
+    {"Add", ElementwiseOp::Add, true},
+    {"Sub", ElementwiseOp::Sub, true},
+    {"Mul", ElementwiseOp::Mul, true},
+    {"Div", ElementwiseOp::Div, true},
+    {"Pow", ElementwiseOp::Pow, true},
+    {"Max", ElementwiseOp::Max, true},
+    {"Min", ElementwiseOp::Min, true},
+    {"Abs", ElementwiseOp::Abs, false},
+    {"Neg", ElementwiseOp::Neg, false},
+    {"Exp", ElementwiseOp::Exp, false},
+    {"Log", ElementwiseOp::Log, false},
+    {"Sqrt", ElementwiseOp::Sqrt, false},
+    {"Reciprocal", ElementwiseOp::Reciprocal, false},
+    {"Floor", ElementwiseOp::Floor, false},
+    {"Ceil", ElementwiseOp::Ceil, false},
+    {"Relu", ElementwiseOp::Relu, false},
+    {"Sigmoid", ElementwiseOp::Sigmoid, false},
+    {"Tanh", ElementwiseOp::Tanh, false},
+};
+
+void ComputeStep(ElementwiseOp op, const float* a, const float* b, float* y, size_t count) {
+  ConstEigenVectorArrayMap<float> A(a, count);
+  EigenVectorArrayMap<float> Y(y, count);
+
+  switch (op) {
+    case ElementwiseOp::Add:
+      Y = A + ConstEigenVectorArrayMap<float>(b, count);
+      break;
+    case ElementwiseOp::Sub:
+      Y = A - ConstEigenVectorArrayMap<float>(b, count);
+      break;
+    case ElementwiseOp::Mul:
+      Y = A * ConstEigenVectorArrayMap<float>(b, count);
+      break;
+    case ElementwiseOp::Div:
+      Y = A / ConstEigenVectorArrayMap<float>(b, count);
+      break;
+    case ElementwiseOp::Pow:
+      Y = A.pow(ConstEigenVectorArrayMap<float>(b, count));
+      break;
+    case ElementwiseOp::Max:
+      Y = A.max(ConstEigenVectorArrayMap<float>(b, count));
+      break;
+    case ElementwiseOp::Min:
+      Y = A.min(ConstEigenVectorArrayMap<float>(b, count));
+      break;
+    case ElementwiseOp::Abs:
+      Y = A.abs();
+      break;
+    case ElementwiseOp::Neg:
+      Y = -A;
+      break;
+    case ElementwiseOp::Exp:
+      Y = A.exp();
+      break;
+    case ElementwiseOp::Log:
+      Y = A.log();
+      break;
+    case ElementwiseOp::Sqrt:
+      Y = A.sqrt();
+      break;
+    case ElementwiseOp::Reciprocal:
+      Y = A.inverse();
+      break;
+    case ElementwiseOp::Floor:
+      Y = A.floor();
+      break;
+    case ElementwiseOp::Ceil:
+      Y = A.ceil();
+      break;
+    case ElementwiseOp::Relu:
+      Y = A.cwiseMax(0.0f);
+      break;
+    case ElementwiseOp::Sigmoid:
+      MlasComputeLogistic(a, y, count);
+      break;
+    case ElementwiseOp::Tanh:
+      MlasComputeTanh(a, y, count);
+      break;
+  }
+}
+
+}  // namespace
+
+template <typename T>
+FusedElementwise<T>::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  input_count_ = info.node().InputDefs().size();
+
+  std::vector<std::string> ops;
+  std::vector<int64_t> operands;
+  ORT_ENFORCE(info.GetAttrs<std::string>("ops", ops).IsOK());
+  ORT_ENFORCE(info.GetAttrs<int64_t>("operands", operands).IsOK());
+  ORT_ENFORCE(!ops.empty() && operands.size() == 2 * ops.size(), "FusedElementwise requires two operands for each op");
+
+  for (size_t i = 0; i < ops.size(); i++) {
+    const auto* op_info = std::find_if(std::begin(kElementwiseOps), std::end(kElementwiseOps),
+                                       [&ops, i](const ElementwiseOpInfo& entry) { return ops[i] == entry.name; });
+    ORT_ENFORCE(op_info != std::end(kElementwiseOps), "FusedElementwise does not support op ", ops[i]);
+
+    // Each operand must be an input or the result of an earlier step.
+    const int64_t operand_limit = static_cast<int64_t>(input_count_ + i);
+    const int64_t operand0 = operands[2 * i];
+    const int64_t operand1 = operands[2 * i + 1];
+    ORT_ENFORCE(operand0 >= 0 && operand0 < operand_limit, "Invalid operand for step ", i);
+    if (op_info->binary) {
+      ORT_ENFORCE(operand1 >= 0 && operand1 < operand_limit, "Invalid operand for step ", i);
+    } else {
+      ORT_ENFORCE(operand1 == -1, "Unary step ", i, " has a second operand");
+    }
+
+    steps_.push_back({op_info->op, operand0, operand1});
+  }
+}
+
+template <>
+Status FusedElementwise<float>::Compute(OpKernelContext* context) const {
+  std::vector<const float*> input_data(input_count_);
+  std::vector<size_t> input_sizes(input_count_);
+
+  // Broadcast the input shapes to find the output shape.
+  std::vector<int64_t> output_dims;
+  for (size_t i = 0; i < input_count_; i++) {
+    const Tensor* X = context->Input<Tensor>(static_cast<int>(i));
+    const auto& dims = X->Shape().GetDims();
+
+    if (dims.size() > output_dims.size()) {
+      output_dims.insert(output_dims.begin(), dims.size() - output_dims.size(), 1);
+    }
+
+    const size_t leading = output_dims.size() - dims.size();
+    for (size_t d = 0; d < dims.size(); d++) {
+      int64_t& output_dim = output_dims[leading + d];
+      if (output_dim == 1) {
+        output_dim = dims[d];
+      } else if (dims[d] != 1 && dims[d] != output_dim) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise: input ", i,
+                               " is not broadcastable to the other inputs. Shape: ", X->Shape());
+      }
+    }
+
+    input_data[i] = X->Data<float>();
+    input_sizes[i] = static_cast<size_t>(X->Shape().Size());
+  }
+
+  // Each input must repeat along the leading dimensions of the output, so
+  // that the element of an input at an output offset is the input element at
+  // the offset modulo the input size.
+  for (size_t i = 0; i < input_count_; i++) {
+    const auto& dims = context->Input<Tensor>(static_cast<int>(i))->Shape().GetDims();
+    auto first = std::find_if(dims.begin(), dims.end(), [](int64_t dim) { return dim != 1; });
+    if (!std::equal(first, dims.end(), output_dims.end() - (dims.end() - first))) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise: input ", i,
+                             " is broadcast along a trailing dimension of the output");
+    }
+  }
+
+  Tensor* Y = context->Output(0, TensorShape(output_dims));
+  float* output = Y->MutableData<float>();
+  const size_t output_size = static_cast<size_t>(Y->Shape().Size());
+
+  if (output_size == 0) {
+    return Status::OK();
+  }
+
+  const size_t task_count = (output_size + kTaskSize - 1) / kTaskSize;
+
+  concurrency::ThreadPool::TryParallelFor(context->GetOperatorThreadPool(), static_cast<int32_t>(task_count), [&](int32_t task) {
+    const size_t task_begin = static_cast<size_t>(task) * kTaskSize;
+    const size_t task_end = std::min(task_begin + kTaskSize, output_size);
+
+    // Operands are numbered as the inputs followed by the step results, and
+    // each operand has a block sized buffer.
+    const size_t operand_count = input_count_ + steps_.size();
+    std::vector<const float*> operands(operand_count);
+    std::vector<float> buffer(operand_count * kBlockSize);
+
+    for (size_t offset = task_begin; offset < task_end; offset += kBlockSize) {
+      const size_t count = std::min(kBlockSize, task_end - offset);
+
+      for (size_t i = 0; i < input_count_; i++) {
+        const size_t input_size = input_sizes[i];
+
+        if (input_size == output_size) {
+          operands[i] = input_data[i] + offset;
+          continue;
+        }
+
+        // Expand the broadcast input for this block.
+        float* expanded = buffer.data() + i * kBlockSize;
+        if (input_size == 1) {
+          std::fill_n(expanded, count, input_data[i][0]);
+        } else {
+          size_t index = offset % input_size;
+          for (size_t n = 0; n < count;) {
+            const size_t chunk = std::min(input_size - index, count - n);
+            std::copy_n(input_data[i] + index, chunk, expanded + n);
+            n += chunk;
+            index = 0;
+          }
+        }
+        operands[i] = expanded;
+      }
+
+      for (size_t s = 0; s < steps_.size(); s++) {
+        const Step& step = steps_[s];
+
+        // The last step writes directly to the output.
+        float* result = (s + 1 == steps_.size()) ? output + offset : buffer.data() + (input_count_ + s) * kBlockSize;
+
+        ComputeStep(step.op, operands[step.operand0], (step.operand1 >= 0) ? operands[step.operand1] : nullptr,
+                    result, count);
+
+        operands[input_count_ + s] = result;
+      }
+    }
+  });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
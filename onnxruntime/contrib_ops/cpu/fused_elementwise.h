@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// The FusedElementwise operator is inserted by the ElementwiseFusion
+// transformer. The expression is evaluated one block of the output at a time,
+// so that the intermediate results of the expression stay in the L1 cache
+// instead of being written to full size tensors.
+
+enum class ElementwiseOp {
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Pow,
+  Max,
+  Min,
+  Abs,
+  Neg,
+  Exp,
+  Log,
+  Sqrt,
+  Reciprocal,
+  Floor,
+  Ceil,
+  Relu,
+  Sigmoid,
+  Tanh,
+};
+
+template <typename T>
+class FusedElementwise : public OpKernel {
+ public:
+  FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  struct Step {
+    ElementwiseOp op;
+    int64_t operand0;
+    int64_t operand1;
+  };
+
+  std::vector<Step> steps_;
+  size_t input_count_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
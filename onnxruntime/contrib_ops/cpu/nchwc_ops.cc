@@ -0,0 +1,195 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "nchwc_ops.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    ReorderInput,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    ReorderInput<float>);
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    ReorderOutput,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    ReorderOutput<float>);
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    NchwcConv,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .MayInplace(3, 0),
+    NchwcConv<float>);
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    NchwcMaxPool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcMaxPool<float>);
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    NchwcAveragePool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcAveragePool<float>);
+
+template <>
+Status ReorderInput<float>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const TensorShape& X_shape = X->Shape();
+  ORT_ENFORCE(X_shape.NumDimensions() == 4);
+
+  const int64_t block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  const int64_t nchwc_channels = (X_shape[1] + block_size - 1) & ~(block_size - 1);
+
+  Tensor* Y = context->Output(0, {X_shape[0], nchwc_channels, X_shape[2], X_shape[3]});
+
+  MlasReorderInput(X_shape.GetDims().data(), X->template Data<float>(), Y->template MutableData<float>());
+
+  return Status::OK();
+}
+
+template <>
+Status ReorderOutput<float>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const TensorShape& X_shape = X->Shape();
+  ORT_ENFORCE(X_shape.NumDimensions() == 4);
+  ORT_ENFORCE(channels_ <= X_shape[1]);
+
+  std::vector<int64_t> Y_shape(X_shape.GetDims());
+  Y_shape[1] = channels_;
+  Tensor* Y = context->Output(0, Y_shape);
+
+  MlasReorderOutput(Y_shape.data(), X->template Data<float>(), Y->template MutableData<float>());
+
+  return Status::OK();
+}
+
+template <>
+Status NchwcConv<float>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = context->Input<Tensor>(1);
+  const Tensor* B = context->Input<Tensor>(2);
+  const Tensor* Sum = context->Input<Tensor>(3);
+
+  ORT_RETURN_IF_ERROR(ValidateInputShape(X, W));
+
+  const TensorShape& X_shape = X->Shape();
+  const TensorShape& W_shape = W->Shape();
+  ORT_ENFORCE(X_shape.NumDimensions() == 4);
+
+  const size_t block_size = MlasNchwcGetBlockSize();
+  ORT_ENFORCE((static_cast<size_t>(X_shape[1]) % block_size) == 0);
+  ORT_ENFORCE((static_cast<size_t>(W_shape[0]) % block_size) == 0);
+
+  std::vector<int64_t> kernel_shape;
+  ORT_RETURN_IF_ERROR(ComputeKernelShape(W_shape, kernel_shape));
+  if (kernel_shape.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unsupported convolution size.");
+  }
+
+  std::vector<int64_t> pads(pads_);
+  if (pads.empty()) {
+    pads.resize(kernel_shape.size() * 2, 0);
+  }
+  std::vector<int64_t> dilations(dilations_);
+  if (dilations.empty()) {
+    dilations.resize(kernel_shape.size(), 1);
+  }
+  std::vector<int64_t> strides(strides_);
+  if (strides.empty()) {
+    strides.resize(kernel_shape.size(), 1);
+  }
+
+  std::vector<int64_t> Y_dims({X_shape[0], W_shape[0]});
+  TensorShape input_shape = X_shape.Slice(2);
+  ORT_RETURN_IF_ERROR(InferOutputShape(input_shape, kernel_shape, strides, dilations, &pads, &Y_dims));
+  Tensor* Y = context->Output(0, Y_dims);
+  float* y_data = Y->template MutableData<float>();
+
+  // Accumulate into the optional Sum tensor, which may have been allocated
+  // in place of the output buffer.
+  bool zero_mode = true;
+  if (Sum != nullptr) {
+    ORT_ENFORCE(Sum->Shape() == Y->Shape(), "output and sum shape must match");
+    const float* sum_data = Sum->template Data<float>();
+    if (sum_data != y_data) {
+      std::copy_n(sum_data, Y->Shape().Size(), y_data);
+    }
+    zero_mode = false;
+  }
+
+  MLAS_ACTIVATION Activation;
+  if (activation_.empty()) {
+    Activation.ActivationKind = MlasIdentityActivation;
+  } else if (activation_ == "Relu") {
+    Activation.ActivationKind = MlasReluActivation;
+  } else if (activation_ == "LeakyRelu") {
+    Activation.ActivationKind = MlasLeakyReluActivation;
+    Activation.alpha = alpha_;
+  } else if (activation_ == "Tanh") {
+    Activation.ActivationKind = MlasTanhActivation;
+  } else if (activation_ == "Sigmoid") {
+    Activation.ActivationKind = MlasLogisticActivation;
+  } else {
+    ORT_NOT_IMPLEMENTED("Not implemented fused activation: ", activation_);
+  }
+
+  MlasNchwcConv(X_shape.GetDims().data(),
+                kernel_shape.data(),
+                dilations.data(),
+                pads.data(),
+                strides.data(),
+                Y_dims.data(),
+                static_cast<size_t>(group_),
+                X->template Data<float>(),
+                W->template Data<float>(),
+                B != nullptr ? B->template Data<float>() : nullptr,
+                y_data,
+                &Activation,
+                zero_mode,
+                context->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
+template <>
+Status NchwcPool<float>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const TensorShape& X_shape = X->Shape();
+  ORT_ENFORCE(X_shape.NumDimensions() == 4);
+  ORT_ENFORCE((static_cast<size_t>(X_shape[1]) % MlasNchwcGetBlockSize()) == 0);
+
+  std::vector<int64_t> pads = pads_;
+  std::vector<int64_t> output_dims = PoolBase::SetOutputSize(X_shape, X_shape[1], &pads);
+  Tensor* Y = context->Output(0, output_dims);
+
+  MlasNchwcPool(kind_,
+                X_shape.GetDims().data(),
+                kernel_shape_.data(),
+                pads.data(),
+                strides_.data(),
+                output_dims.data(),
+                X->template Data<float>(),
+                Y->template MutableData<float>(),
+                context->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
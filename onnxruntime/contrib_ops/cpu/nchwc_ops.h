@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/nn/conv_base.h"
+#include "core/providers/cpu/nn/pool_base.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// The NCHWc operators are inserted by the NchwcTransformer. A tensor in the
+// NCHWc layout has the logical shape [N, C, H, W], where C is padded to a
+// multiple of MlasNchwcGetBlockSize(), and the channels of each block are
+// stored contiguously for each spatial element.
+
+template <typename T>
+class ReorderInput : public OpKernel {
+ public:
+  ReorderInput(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+template <typename T>
+class ReorderOutput : public OpKernel {
+ public:
+  ReorderOutput(const OpKernelInfo& info) : OpKernel(info) {
+    ORT_ENFORCE(info.GetAttr<int64_t>("channels", &channels_).IsOK());
+    ORT_ENFORCE(channels_ > 0, "invalid channel count");
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t channels_;
+};
+
+template <typename T>
+class NchwcConv : public OpKernel, public ConvBase {
+ public:
+  NchwcConv(const OpKernelInfo& info) : OpKernel(info), ConvBase(info) {
+    activation_ = info.GetAttrOrDefault<std::string>("activation", "");
+    alpha_ = info.GetAttrOrDefault("alpha", 0.01f);
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+template <typename T>
+class NchwcPool : public OpKernel, public PoolBase {
+ public:
+  NchwcPool(const OpKernelInfo& info, MLAS_POOLING_KIND kind) : OpKernel(info), PoolBase(info), kind_(kind) {}
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  MLAS_POOLING_KIND kind_;
+};
+
+template <typename T>
+class NchwcMaxPool : public NchwcPool<T> {
+ public:
+  NchwcMaxPool(const OpKernelInfo& info) : NchwcPool<T>(info, MlasMaximumPooling) {}
+};
+
+template <typename T>
+class NchwcAveragePool : public NchwcPool<T> {
+ public:
+  NchwcAveragePool(const OpKernelInfo& info)
+      : NchwcPool<T>(info, info.GetAttrOrDefault<int64_t>("count_include_pad", 0) != 0
+                               ? MlasAveragePoolingIncludePad
+                               : MlasAveragePoolingExcludePad) {}
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
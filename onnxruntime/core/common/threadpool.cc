@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/threadpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+
+#include <unsupported/Eigen/CXX11/ThreadPool>
+
+namespace onnxruntime {
+namespace concurrency {
+
+class ThreadPool::Impl : public Eigen::ThreadPool {
+ public:
+  explicit Impl(int num_threads) : Eigen::ThreadPool(num_threads) {}
+};
+
+ThreadPool::ThreadPool(const std::string& name, int num_threads)
+    : name_(name) {
+  ORT_ENFORCE(num_threads > 0, "ThreadPool '", name, "' requires at least one thread. Got ", num_threads);
+  impl_ = std::make_unique<Impl>(num_threads);
+}
+
+ThreadPool::~ThreadPool() = default;
+
+void ThreadPool::Schedule(std::function<void()> fn) {
+  impl_->Schedule(std::move(fn));
+}
+
+void ThreadPool::ParallelFor(int32_t total, std::function<void(int32_t)> fn) {
+  if (total <= 0) {
+    return;
+  }
+
+  // run inline if there's a single unit of work, or if we're already on one of our worker threads.
+  // in the latter case the other workers may all be blocked in the same way so scheduling more work
+  // and waiting on it could deadlock.
+  if (total == 1 || CurrentThreadId() != -1) {
+    for (int32_t i = 0; i < total; ++i) {
+      fn(i);
+    }
+    return;
+  }
+
+  // the calling thread takes part in the work, so schedule at most total - 1 helpers.
+  const int num_helpers = std::min(NumThreads(), static_cast<int>(total) - 1);
+
+  std::atomic<int32_t> next{0};
+  std::exception_ptr first_exception;
+  std::mutex exception_lock;
+
+  auto run_work = [&]() {
+    for (int32_t i = next++; i < total; i = next++) {
+      try {
+        fn(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(exception_lock);
+        if (!first_exception) {
+          first_exception = std::current_exception();
+        }
+      }
+    }
+  };
+
+  Eigen::Barrier barrier(static_cast<unsigned int>(num_helpers));
+
+  for (int h = 0; h < num_helpers; ++h) {
+    impl_->Schedule([&run_work, &barrier]() {
+      run_work();
+      barrier.Notify();
+    });
+  }
+
+  run_work();
+  barrier.Wait();
+
+  if (first_exception) {
+    std::rethrow_exception(first_exception);
+  }
+}
+
+int ThreadPool::NumThreads() const {
+  return impl_->NumThreads();
+}
+
+int ThreadPool::CurrentThreadId() const {
+  return impl_->CurrentThreadId();
+}
+
+}  // namespace concurrency
+}  // namespace onnxruntime
@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace concurrency {
+
+/**
+ * Generic class for intra-op parallelism.
+ *
+ * A single instance is created per InferenceSession and shared by every kernel of that session
+ * (and its subgraphs) through OpKernelContext::GetOperatorThreadPool(), so the number of threads
+ * doing operator level work is bounded by SessionOptions::intra_op_num_threads regardless of how
+ * many kernels in the model want to run in parallel.
+ *
+ * The calling thread always participates in the work, so a pool of N threads provides a
+ * parallelism of N + 1 to a ParallelFor call.
+ */
+class ThreadPool {
+ public:
+  /**
+  Create a thread pool.
+  @param name Name used to identify the pool in logging.
+  @param num_threads Number of worker threads. Must be > 0.
+  */
+  ThreadPool(const std::string& name, int num_threads);
+
+  ~ThreadPool();
+
+  /**
+  Enqueue a unit of work to run on one of the worker threads.
+  */
+  void Schedule(std::function<void()> fn);
+
+  /**
+  Execute fn(i) for each i in [0, total) and wait for all of them to complete.
+  The work is shared between the worker threads and the calling thread. If fn throws,
+  the first exception is re-thrown on the calling thread once all the work has completed.
+  If called from one of this pool's worker threads the work is executed inline to avoid
+  blocking a worker on work that may be queued behind it.
+  */
+  void ParallelFor(int32_t total, std::function<void(int32_t)> fn);
+
+  /**
+  Same as ParallelFor but runs the work serially on the calling thread if tp is nullptr.
+  */
+  static void TryParallelFor(ThreadPool* tp, int32_t total, std::function<void(int32_t)> fn) {
+    if (tp == nullptr) {
+      for (int32_t i = 0; i < total; ++i) {
+        fn(i);
+      }
+      return;
+    }
+
+    tp->ParallelFor(total, std::move(fn));
+  }
+
+  /**
+  Return the number of worker threads in the pool.
+  */
+  int NumThreads() const;
+
+  /**
+  Return the index of the current worker thread in [0, NumThreads()), or -1 if the
+  caller is not one of this pool's threads.
+  */
+  int CurrentThreadId() const;
+
+  const std::string& Name() const noexcept { return name_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadPool);
+
+  class Impl;
+
+  const std::string name_;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace concurrency
+}  // namespace onnxruntime
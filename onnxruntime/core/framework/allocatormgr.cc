@@ -12,11 +12,12 @@ namespace onnxruntime {
 
 using namespace ::onnxruntime::common;
 
-AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id) {
+AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id,
+                             const ArenaSettings& arena_settings) {
   auto device_allocator = std::unique_ptr<IDeviceAllocator>(info.factory(device_id));
   if (device_allocator->AllowsArena())
     return std::shared_ptr<IArenaAllocator>(
-        std::make_unique<BFCArena>(std::move(device_allocator), info.max_mem));
+        std::make_unique<BFCArena>(std::move(device_allocator), info.max_mem, arena_settings));
 
   return device_allocator;
 }
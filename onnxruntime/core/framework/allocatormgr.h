@@ -16,7 +16,10 @@ struct DeviceAllocatorRegistrationInfo {
   size_t max_mem;
 };
 
-AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id = 0);
+// Create the allocator for a device. If the device allocator allows it, an arena with arena_settings is put in
+// front of it. see BFCArena.
+AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id = 0,
+                             const ArenaSettings& arena_settings = ArenaSettings());
 
 class DeviceAllocatorRegistry {
  public:
@@ -3,12 +3,27 @@
 
 #pragma once
 
+#include <limits>
 #include <string>
 
 #include "core/common/common.h"
 #include "core/framework/allocator.h"
 
 namespace onnxruntime {
+// Settings for the arena in front of a device allocator.
+struct ArenaSettings {
+  // Size of the first region the arena allocates from the device.
+  size_t initial_chunk_size_bytes = 1 << 20;
+  // Each new region is this many times the size of the previous one, or the size of the request if that's larger.
+  // A factor of 1 keeps the regions at the initial size.
+  int growth_factor = 2;
+  // The bytes the arena may hold in free regions. A region that becomes free is returned to the device when the
+  // arena holds more than this.
+  size_t max_retained_bytes = std::numeric_limits<size_t>::max();
+  // Put a cache of small chunks for each thread in front of the arena.
+  bool enable_thread_cache = false;
+};
+
 // The interface for arena which manage memory allocations
 // Arena will hold a pool of pre-allocate memories and manage their lifecycle.
 // Need an underline IResourceAllocator to allocate memories.
@@ -26,6 +41,9 @@ class IArenaAllocator : public IAllocator {
   void Free(void* p) override = 0;
   virtual size_t Used() const = 0;
   virtual size_t Max() const = 0;
+  // Return the memory held by the arena that isn't in use to the device.
+  // Returns the number of bytes released. Shrink call need to be thread safe.
+  virtual size_t Shrink() { return 0; }
   const OrtAllocatorInfo& Info() const override = 0;
   // allocate host pinned memory?
 };
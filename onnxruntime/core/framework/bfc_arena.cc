@@ -3,14 +3,24 @@
 
 #include "core/framework/bfc_arena.h"
 
+#include <algorithm>
+
 namespace onnxruntime {
 BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
-                   size_t total_memory)
-    : device_allocator_(std::move(resource_allocator)),
+                   size_t total_memory,
+                   const ArenaSettings& settings)
+    : initial_chunk_size_bytes_(settings.initial_chunk_size_bytes),
+      growth_factor_(settings.growth_factor),
+      max_retained_bytes_(settings.max_retained_bytes),
+      device_allocator_(std::move(resource_allocator)),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1),
-      info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().id, device_allocator_->Info().mem_type) {
-  curr_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, size_t{1048576}));
+      info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().id, device_allocator_->Info().mem_type),
+      enable_thread_cache_(settings.enable_thread_cache),
+      handle_(std::make_shared<ArenaHandle>(this)) {
+  ORT_ENFORCE(initial_chunk_size_bytes_ > 0, "The initial chunk size of the arena must be positive.");
+  ORT_ENFORCE(growth_factor_ >= 1, "The growth factor of the arena must be at least 1. Got ", growth_factor_);
+  curr_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, initial_chunk_size_bytes_));
 
   // Allocate the requested amount of memory.
   memory_limit_ = total_memory;
@@ -35,6 +45,12 @@ BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
 }
 
 BFCArena::~BFCArena() {
+  // wait for any thread that is returning its cache as it exits, and stop the others from doing so
+  {
+    std::lock_guard<OrtMutex> lock(handle_->mutex);
+    handle_->arena = nullptr;
+  }
+
   for (const auto& region : region_manager_.regions()) {
     device_allocator_->Free(region.ptr());
   }
@@ -65,16 +81,23 @@ bool BFCArena::Extend(size_t rounded_bytes) {
   }
 
   // If curr_region_allocation_bytes_ is not enough to satisfy the
-  // allocation, keep multiplying by a power of two until that is
-  // sufficient.
+  // allocation, keep multiplying by the growth factor until that is
+  // sufficient. If the arena doesn't grow, size this region for the request
+  // and keep the next ones at the initial size.
   bool increased_allocation = false;
-  while (rounded_bytes > curr_region_allocation_bytes_) {
-    curr_region_allocation_bytes_ *= 2;
-    increased_allocation = true;
+  size_t region_bytes = curr_region_allocation_bytes_;
+  if (growth_factor_ > 1) {
+    while (rounded_bytes > curr_region_allocation_bytes_) {
+      curr_region_allocation_bytes_ *= growth_factor_;
+      increased_allocation = true;
+    }
+    region_bytes = curr_region_allocation_bytes_;
+  } else {
+    region_bytes = std::max(region_bytes, rounded_bytes);
   }
 
   // Try allocating.
-  size_t bytes = std::min(curr_region_allocation_bytes_, available_bytes);
+  size_t bytes = std::min(region_bytes, available_bytes);
   void* mem_addr = device_allocator_->Alloc(bytes);
   if (mem_addr == nullptr && !started_backpedal_) {
     // Only backpedal once.
@@ -96,7 +119,7 @@ bool BFCArena::Extend(size_t rounded_bytes) {
 
   if (!increased_allocation) {
     // Increase the region size of the next required allocation.
-    curr_region_allocation_bytes_ *= 2;
+    curr_region_allocation_bytes_ *= growth_factor_;
   }
 
   LOGS_DEFAULT(INFO) << "Extending allocation by " << bytes
@@ -160,7 +183,204 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
-  return AllocateRawInternal(size, false);
+  ThreadCache* cache = nullptr;
+  if (enable_thread_cache_ && size > 0) {
+    cache = GetThreadCache();
+    MaybeReleaseThreadCache(*cache);
+    size_t rounded_bytes = RoundedBytes(size);
+    if (rounded_bytes <= kMaxThreadCacheChunkSize) {
+      void* ptr = TakeFromThreadCache(*cache, rounded_bytes);
+      if (ptr != nullptr) {
+        cache->hits.store(cache->hits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return ptr;
+      }
+
+      cache->misses.store(cache->misses.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+  }
+
+  return AllocateRawInternal(size, false, cache);
+}
+
+BFCArena::ThreadCacheEntry::~ThreadCacheEntry() {
+  auto handle = arena_handle.lock();
+  if (handle == nullptr) {
+    return;
+  }
+
+  std::lock_guard<OrtMutex> handle_lock(handle->mutex);
+  if (handle->arena != nullptr) {
+    handle->arena->RemoveThreadCache(*cache);
+  }
+}
+
+BFCArena::ThreadCache* BFCArena::GetThreadCache() {
+  // the caches of this thread by arena. the cache belongs to the arena at that address while the handle hasn't
+  // expired.
+  thread_local std::unordered_map<const BFCArena*, ThreadCacheEntry> caches;
+
+  auto entry = caches.find(this);
+  if (entry != caches.end() && !entry->second.arena_handle.expired()) {
+    return entry->second.cache.get();
+  }
+
+  // drop the caches of the arenas that were destroyed
+  for (auto it = caches.begin(); it != caches.end();) {
+    if (it->second.arena_handle.expired()) {
+      it = caches.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  auto cache = std::make_shared<ThreadCache>();
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    thread_caches_.push_back(cache);
+  }
+
+  auto& new_entry = caches[this];
+  new_entry.arena_handle = handle_;
+  new_entry.cache = cache;
+  return cache.get();
+}
+
+void BFCArena::RemoveThreadCache(ThreadCache& cache) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  ReleaseThreadCache(cache);
+
+  // keep the counts of the allocations served by the cache
+  const int64_t hits = cache.hits.load(std::memory_order_relaxed);
+  stats_.num_allocs += hits;
+  stats_.num_thread_cache_hits += hits;
+  stats_.num_thread_cache_misses += cache.misses.load(std::memory_order_relaxed);
+
+  thread_caches_.erase(std::remove_if(thread_caches_.begin(), thread_caches_.end(),
+                                      [&cache](const std::shared_ptr<ThreadCache>& c) { return c.get() == &cache; }),
+                       thread_caches_.end());
+}
+
+void* BFCArena::TakeFromThreadCache(ThreadCache& cache, size_t rounded_bytes) {
+  if (rounded_bytes > kMaxThreadCacheChunkSize) {
+    return nullptr;
+  }
+
+  auto& free_chunks = cache.free_chunks[rounded_bytes / kMinAllocationSize - 1];
+  if (free_chunks.empty()) {
+    return nullptr;
+  }
+
+  void* ptr = free_chunks.back();
+  free_chunks.pop_back();
+  cache.cached_bytes.store(cache.cached_bytes.load(std::memory_order_relaxed) - rounded_bytes,
+                           std::memory_order_relaxed);
+  return ptr;
+}
+
+void BFCArena::FlushPendingFrees(ThreadCache& cache) {
+  int64_t cached_bytes = cache.cached_bytes.load(std::memory_order_relaxed);
+
+  for (void* p : cache.pending_frees) {
+    if (reserved_chunks_.find(p) == reserved_chunks_.end()) {
+      BFCArena::ChunkHandle h = region_manager_.get_handle(p);
+      ORT_ENFORCE(h != kInvalidChunkHandle);
+      const size_t size = ChunkFromHandle(h)->size;
+
+      if (size <= kMaxThreadCacheChunkSize && cached_bytes + size <= kMaxThreadCacheBytes) {
+        cache.free_chunks[size / kMinAllocationSize - 1].push_back(p);
+        cached_bytes += size;
+        continue;
+      }
+    }
+
+    FreeInternal(p);
+  }
+
+  cache.pending_frees.clear();
+  cache.cached_bytes.store(cached_bytes, std::memory_order_relaxed);
+}
+
+void BFCArena::ReleaseThreadCache(ThreadCache& cache) {
+  for (void* p : cache.pending_frees) {
+    FreeInternal(p);
+  }
+
+  for (auto& free_chunks : cache.free_chunks) {
+    for (void* p : free_chunks) {
+      FreeInternal(p);
+    }
+
+    free_chunks.clear();
+  }
+
+  cache.pending_frees.clear();
+  cache.cached_bytes.store(0, std::memory_order_relaxed);
+  cache.release_requested.store(false, std::memory_order_relaxed);
+}
+
+void BFCArena::MaybeReleaseThreadCache(ThreadCache& cache) {
+  if (cache.release_requested.load(std::memory_order_relaxed)) {
+    std::lock_guard<OrtMutex> lock(lock_);
+    ReleaseThreadCache(cache);
+  }
+}
+
+size_t BFCArena::Shrink() {
+  ThreadCache* own_cache = enable_thread_cache_ ? GetThreadCache() : nullptr;
+
+  std::lock_guard<OrtMutex> lock(lock_);
+
+  // the chunks cached by the threads keep their regions in use. the cache of this thread can be released now,
+  // the other threads release theirs the next time they allocate or free.
+  for (const auto& cache : thread_caches_) {
+    if (cache.get() == own_cache) {
+      ReleaseThreadCache(*cache);
+    } else {
+      cache->release_requested.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  return ReleaseFreeRegions(0);
+}
+
+size_t BFCArena::ReleaseFreeRegions(size_t max_retained_bytes) {
+  size_t released_bytes = 0;
+
+  // release the most recent regions first, as they are usually the largest
+  const auto& regions = region_manager_.regions();
+  for (size_t i = regions.size(); i > 0; --i) {
+    if (static_cast<size_t>(stats_.total_allocated_bytes - stats_.bytes_in_use) <= max_retained_bytes) {
+      break;
+    }
+
+    // a region is free if it's a single chunk that isn't in use
+    void* ptr = regions[i - 1].ptr();
+    const size_t size = regions[i - 1].memory_size();
+    ChunkHandle h = region_manager_.get_handle(ptr);
+    const Chunk* c = ChunkFromHandle(h);
+    if (c->in_use() || c->next != kInvalidChunkHandle) {
+      continue;
+    }
+
+    RemoveFreeChunkFromBin(h);
+    DeleteChunk(h);
+    region_manager_.RemoveAllocationRegion(ptr);
+    device_allocator_->Free(ptr);
+
+    stats_.total_allocated_bytes -= size;
+    released_bytes += size;
+
+    LOGS_DEFAULT(INFO) << "Released region of " << size << " bytes at " << ptr << ". Total allocated bytes: "
+                       << stats_.total_allocated_bytes;
+  }
+
+  // start growing from the initial size again once all the regions were released
+  if (regions.empty()) {
+    curr_region_allocation_bytes_ = RoundedBytes(std::min(memory_limit_, initial_chunk_size_bytes_));
+    started_backpedal_ = false;
+  }
+
+  return released_bytes;
 }
 
 void* BFCArena::Reserve(size_t size) {
@@ -196,7 +416,8 @@ size_t BFCArena::AllocatedSize(const void* ptr) {
 }
 
 void* BFCArena::AllocateRawInternal(size_t num_bytes,
-                                    bool dump_log_on_failure) {
+                                    bool dump_log_on_failure,
+                                    ThreadCache* cache) {
   if (num_bytes == 0) {
     LOGS_DEFAULT(WARNING) << "tried to allocate 0 bytes";
     return nullptr;
@@ -210,6 +431,16 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   BinNum bin_num = BinNumForSize(rounded_bytes);
 
   std::lock_guard<OrtMutex> lock(lock_);
+
+  // return the pending frees of the thread while holding the lock, which may provide a chunk of the right size
+  if (cache != nullptr && !cache->pending_frees.empty()) {
+    FlushPendingFrees(*cache);
+    void* ptr = TakeFromThreadCache(*cache, rounded_bytes);
+    if (ptr != nullptr) {
+      return ptr;
+    }
+  }
+
   void* ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
   if (ptr != nullptr) {
     return ptr;
@@ -238,6 +469,14 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<OrtMutex> lock(lock_);
   *stats = stats_;
+
+  for (const auto& cache : thread_caches_) {
+    int64_t hits = cache->hits.load(std::memory_order_relaxed);
+    stats->num_allocs += hits;
+    stats->num_thread_cache_hits += hits;
+    stats->num_thread_cache_misses += cache->misses.load(std::memory_order_relaxed);
+    stats->bytes_in_thread_caches += cache->cached_bytes.load(std::memory_order_relaxed);
+  }
 }
 
 void* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
@@ -328,7 +567,23 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+  if (enable_thread_cache_) {
+    ThreadCache* cache = GetThreadCache();
+    MaybeReleaseThreadCache(*cache);
+    cache->pending_frees.push_back(p);
+    if (cache->pending_frees.size() >= kThreadCacheFreeBatchSize) {
+      std::lock_guard<OrtMutex> lock(lock_);
+      FlushPendingFrees(*cache);
+    }
+
+    return;
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
+  FreeInternal(p);
+}
+
+void BFCArena::FreeInternal(void* p) {
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
     device_allocator_->Free(it->first);
@@ -347,6 +602,10 @@ void BFCArena::DeallocateRawInternal(void* ptr) {
 
   // Consider coalescing it.
   FreeAndMaybeCoalesce(h);
+
+  if (static_cast<size_t>(stats_.total_allocated_bytes - stats_.bytes_in_use) > max_retained_bytes_) {
+    ReleaseFreeRegions(max_retained_bytes_);
+  }
 }
 
 // Merges h1 and h2 when Chunk(h1)->next is h2 and Chunk(h2)->prev is c1.
@@ -16,9 +16,11 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <unordered_map>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -49,6 +51,9 @@ struct AllocatorStats {
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
   int64_t bytes_limit;
+  int64_t num_thread_cache_hits;    // Number of allocations served by a thread cache without taking the arena lock.
+  int64_t num_thread_cache_misses;  // Number of allocations of a cached size that had to take the arena lock.
+  int64_t bytes_in_thread_caches;   // Number of bytes held by thread caches. These are included in bytes_in_use.
 
   AllocatorStats() { Clear(); }
 
@@ -59,6 +64,9 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->num_thread_cache_hits = 0;
+    this->num_thread_cache_misses = 0;
+    this->bytes_in_thread_caches = 0;
   }
 
   std::string DebugString() const {
@@ -68,7 +76,10 @@ struct AllocatorStats {
        << "TotalAllocated: " << this->total_allocated_bytes << "\n"
        << "MaxInUse:       " << this->max_bytes_in_use << "\n"
        << "NumAllocs:      " << this->num_allocs << "\n"
-       << "MaxAllocSize:   " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:   " << this->max_alloc_size << "\n"
+       << "CacheHits:      " << this->num_thread_cache_hits << "\n"
+       << "CacheMisses:    " << this->num_thread_cache_misses << "\n"
+       << "BytesInCaches:  " << this->bytes_in_thread_caches << "\n";
     return ss.str();
   }
 };
@@ -81,9 +92,21 @@ struct AllocatorStats {
 // coalescing.  One assumption we make is that the process using this
 // allocator owns pretty much all of the memory, and that nearly
 // all requests to allocate memory go through this interface.
+//
+// The arena grows by allocating regions from the device, starting with a
+// region of settings.initial_chunk_size_bytes and multiplying the size by
+// settings.growth_factor for each new region. A region is returned to the
+// device when all of it is free, either by Shrink or, if the arena holds more
+// than settings.max_retained_bytes in free regions, when it becomes free.
+//
+// If settings.enable_thread_cache is true, each thread that uses the arena gets a
+// cache of small free chunks in front of the shared bins, so that most
+// small allocations and frees don't take the arena lock. Frees are queued
+// by the thread and returned to its cache or to the bins in batches.
 class BFCArena : public IArenaAllocator {
  public:
-  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory);
+  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory,
+           const ArenaSettings& settings = ArenaSettings());
 
   ~BFCArena() override;
 
@@ -97,6 +120,11 @@ class BFCArena : public IArenaAllocator {
 
   void* Reserve(size_t size) override;
 
+  // Returns the regions that are free to the device.
+  // The chunks cached by other threads are returned to the arena the next time those threads use it, so the
+  // regions they are in are released by a later call.
+  size_t Shrink() override;
+
   size_t Used() const override {
     return stats_.bytes_in_use;
   }
@@ -116,14 +144,25 @@ class BFCArena : public IArenaAllocator {
 
   void GetStats(AllocatorStats* stats);
 
+  // With the thread cache enabled, the requested size of a chunk that was reused from a thread cache is the size
+  // of the request the chunk was first allocated for.
   size_t RequestedSize(const void* ptr);
 
   size_t AllocatedSize(const void* ptr);
 
  private:
-  void* AllocateRawInternal(size_t num_bytes, bool dump_log_on_failure);
+  struct ThreadCache;
+
+  void* AllocateRawInternal(size_t num_bytes, bool dump_log_on_failure, ThreadCache* cache);
   void DeallocateRawInternal(void* ptr);
 
+  // Frees p, which is either a reserved buffer or an allocated chunk. Requires lock_ to be held.
+  void FreeInternal(void* p);
+
+  // Returns free regions to the device until the arena holds at most max_retained_bytes in free chunks, or no
+  // region is free. Returns the number of bytes released. Requires lock_ to be held.
+  size_t ReleaseFreeRegions(size_t max_retained_bytes);
+
   // A ChunkHandle is an index into the chunks_ vector in BFCAllocator
   // kInvalidChunkHandle means an invalid chunk
   using ChunkHandle = size_t;
@@ -306,6 +345,13 @@ class BFCArena : public IArenaAllocator {
       regions_.insert(entry, AllocationRegion(ptr, memory_size));
     }
 
+    void RemoveAllocationRegion(void* ptr) {
+      auto entry =
+          std::upper_bound(regions_.begin(), regions_.end(), ptr, &Comparator);
+      ORT_ENFORCE(entry != regions_.end() && entry->ptr() == ptr);
+      regions_.erase(entry);
+    }
+
     ChunkHandle get_handle(const void* p) const {
       return RegionFor(p)->get_handle(p);
     }
@@ -344,6 +390,69 @@ class BFCArena : public IArenaAllocator {
     std::vector<AllocationRegion> regions_;
   };
 
+  // Chunks of up to kMaxThreadCacheChunkSize bytes are kept in thread caches, with a limit of
+  // kMaxThreadCacheBytes per thread. Frees are returned to the cache or the bins every
+  // kThreadCacheFreeBatchSize frees, or when the thread misses the cache.
+  static const size_t kMaxThreadCacheChunkSize = 64 << 10;
+  static const size_t kNumThreadCacheClasses = kMaxThreadCacheChunkSize / kMinAllocationSize;
+  static const size_t kMaxThreadCacheBytes = 4 << 20;
+  static const size_t kThreadCacheFreeBatchSize = 16;
+
+  // The cache of a thread. Only the owning thread uses it, while holding lock_ to move chunks between the cache
+  // and the bins. The counters are only written by the owning thread, and are read by GetStats.
+  // When the thread exits, its chunks are returned to the bins and the cache is removed from the arena.
+  // release_requested is set by Shrink to have the owning thread return all its chunks to the bins.
+  struct ThreadCache {
+    // free_chunks[i] are chunks of (i + 1) * kMinAllocationSize bytes that are in use from the bins point of view
+    std::array<std::vector<void*>, kNumThreadCacheClasses> free_chunks;
+    // pointers freed by the thread that haven't been returned to the cache or the bins yet
+    std::vector<void*> pending_frees;
+    std::atomic<int64_t> cached_bytes{0};
+    std::atomic<int64_t> hits{0};
+    std::atomic<int64_t> misses{0};
+    std::atomic<bool> release_requested{false};
+  };
+
+  // Shared by the arena and the threads that have a cache for it. arena is set to nullptr under mutex when the
+  // arena is destroyed, so a thread that exits only returns its cache to an arena that still exists.
+  struct ArenaHandle {
+    explicit ArenaHandle(BFCArena* a) : arena(a) {}
+    OrtMutex mutex;
+    BFCArena* arena;
+  };
+
+  // The cache of a thread for an arena, held in thread local storage. Returns the cache to the arena when the
+  // thread exits.
+  struct ThreadCacheEntry {
+    ThreadCacheEntry() = default;
+    ~ThreadCacheEntry();
+
+    std::weak_ptr<ArenaHandle> arena_handle;
+    std::shared_ptr<ThreadCache> cache;
+
+   private:
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadCacheEntry);
+  };
+
+  // Returns the cache of the calling thread, creating it on first use.
+  ThreadCache* GetThreadCache();
+
+  // Returns all the chunks held by the cache of a thread that exits to the bins and removes the cache.
+  void RemoveThreadCache(ThreadCache& cache);
+
+  // Returns a free chunk of rounded_bytes from cache, or nullptr.
+  void* TakeFromThreadCache(ThreadCache& cache, size_t rounded_bytes);
+
+  // Moves the pending frees of cache to the cache, or to the bins if they aren't cacheable or the cache is full.
+  // Requires lock_ to be held.
+  void FlushPendingFrees(ThreadCache& cache);
+
+  // Returns all the chunks held by cache to the bins. Requires lock_ to be held.
+  void ReleaseThreadCache(ThreadCache& cache);
+
+  // Releases cache if Shrink requested it.
+  void MaybeReleaseThreadCache(ThreadCache& cache);
+
   // Returns 'bytes' rounded up to the next highest kMinAllocationSize.
   size_t RoundedBytes(size_t bytes);
 
@@ -402,6 +511,9 @@ class BFCArena : public IArenaAllocator {
 
   // Structures immutable after construction
   size_t memory_limit_ = 0;
+  const size_t initial_chunk_size_bytes_;
+  const int growth_factor_;
+  const size_t max_retained_bytes_;
 
   int Log2FloorNonZeroSlow(uint64_t n) {
     int r = 0;
@@ -480,6 +592,13 @@ class BFCArena : public IArenaAllocator {
 
   std::unordered_map<void*, size_t> reserved_chunks_;
 
+  const bool enable_thread_cache_;
+  // The threads refer to the arena through a weak_ptr to the handle, so a thread detects that an arena was destroyed
+  // and another one created at the same address.
+  std::shared_ptr<ArenaHandle> handle_;
+  // The caches of the live threads that used the arena.
+  std::vector<std::shared_ptr<ThreadCache>> thread_caches_;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
 #ifdef __GNUC__
@@ -3,6 +3,7 @@
 
 #include "core/framework/environment.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/graph/constants.h"
 #include "core/graph/contrib_ops/contrib_defs.h"
 #include "core/graph/op.h"
@@ -105,6 +106,11 @@ Internal copy node
   return status;
 }
 
+SharedInitializerStore& Environment::GetSharedInitializerStore() {
+  static SharedInitializerStore store;
+  return store;
+}
+
 Environment::~Environment() {
   ::google::protobuf::ShutdownProtobufLibrary();
 }
@@ -3,6 +3,7 @@
 
 #include "core/framework/execution_frame.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "core/framework/mem_pattern_planner.h"
@@ -23,11 +24,15 @@ IExecutionFrame::IExecutionFrame(const std::vector<int>& feed_mlvalue_idxs,
                                  const std::vector<MLValue>& fetches,
                                  const MLValueNameIdxMap& mlvalue_idx_map,
                                  const NodeIndexInfo& node_index_info)
-    : node_index_info_{node_index_info}, fetch_mlvalue_idxs_{fetch_mlvalue_idxs} {
+    : node_index_info_{node_index_info},
+      feed_mlvalue_idxs_{feed_mlvalue_idxs},
+      fetch_mlvalue_idxs_{fetch_mlvalue_idxs} {
   ORT_ENFORCE(feeds.size() == feed_mlvalue_idxs.size());
   ORT_ENFORCE(fetches.empty() || fetches.size() == fetch_mlvalue_idxs.size());
 
-  Init(feed_mlvalue_idxs, feeds, initializers, fetch_mlvalue_idxs, fetches, mlvalue_idx_map);
+  all_values_.resize(mlvalue_idx_map.MaxIdx() + 1);
+
+  Init(feeds, initializers, fetches);
 }
 
 IExecutionFrame::~IExecutionFrame() = default;
@@ -96,26 +101,31 @@ int IExecutionFrame::GetNodeIdxToMLValueIdx(int index) const {
   return mlvalue_idx;
 }
 
-void IExecutionFrame::Init(const std::vector<int>& feed_mlvalue_idxs,
-                           const std::vector<MLValue>& feeds,
-                           const std::unordered_map<int, MLValue>& initializers,
-                           const std::vector<int>& fetch_mlvalue_idxs,
-                           const std::vector<MLValue>& fetches,
-                           const MLValueNameIdxMap& mlvalue_idx_map) {
-  // 1. resize the all_value_ vector
-  all_values_.resize(mlvalue_idx_map.MaxIdx() + 1);
+void IExecutionFrame::ResetValues(const std::vector<MLValue>& feeds,
+                                  const std::unordered_map<int, MLValue>& initializers,
+                                  const std::vector<MLValue>& fetches) {
+  ORT_ENFORCE(feeds.size() == feed_mlvalue_idxs_.size());
+  ORT_ENFORCE(fetches.empty() || fetches.size() == fetch_mlvalue_idxs_.size());
 
-  // 2. Handle non-empty output vector
+  std::fill(all_values_.begin(), all_values_.end(), MLValue());
+
+  Init(feeds, initializers, fetches);
+}
+
+void IExecutionFrame::Init(const std::vector<MLValue>& feeds,
+                           const std::unordered_map<int, MLValue>& initializers,
+                           const std::vector<MLValue>& fetches) {
+  // 1. Handle non-empty output vector
   if (!fetches.empty()) {
-    auto num_fetches = fetch_mlvalue_idxs.size();
+    auto num_fetches = fetch_mlvalue_idxs_.size();
 
     for (size_t idx = 0; idx < num_fetches; ++idx) {
-      int mlvalue_idx = fetch_mlvalue_idxs[idx];
+      int mlvalue_idx = fetch_mlvalue_idxs_[idx];
       all_values_[mlvalue_idx] = fetches[idx];
     }
   }
 
-  // 3. handle the weights.
+  // 2. handle the weights.
   // We do this after the fetches to handle an edge case (possibly dubious) where a Constant is an output.
   // The Constant gets lifted to an initializer so there's no Node producing the value as an output during Graph
   // execution (i.e. Graph execution won't write the value to all_values_).
@@ -127,9 +137,9 @@ void IExecutionFrame::Init(const std::vector<int>& feed_mlvalue_idxs,
     all_values_[mlvalue_index] = entry.second;
   }
 
-  // 4. handle feed in values. these can override initializer values so must be last
-  for (size_t idx = 0, end = feed_mlvalue_idxs.size(); idx < end; ++idx) {
-    int mlvalue_idx = feed_mlvalue_idxs[idx];
+  // 3. handle feed in values. these can override initializer values so must be last
+  for (size_t idx = 0, end = feed_mlvalue_idxs_.size(); idx < end; ++idx) {
+    int mlvalue_idx = feed_mlvalue_idxs_[idx];
     // we are sharing the underline tensor/object for MLValue
     all_values_[mlvalue_idx] = feeds[idx];
   }
@@ -171,8 +181,47 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs,
       session_state_{session_state},
       mem_patterns_{nullptr},
       planner_{nullptr} {
+  InitCustomAllocators(fetch_allocators);
+  InitMemoryPatterns(feeds);
+}
+
+ExecutionFrame::~ExecutionFrame() = default;
+
+Status ExecutionFrame::Reset(const std::vector<MLValue>& feeds,
+                             const std::vector<MLValue>& fetches,
+                             const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  // the values from the previous execution are released first, so any tensors that were placed in the memory
+  // pattern buffers are gone before the buffers are reused or freed. graph outputs are never placed in those
+  // buffers, so the fetches returned by the previous execution remain valid.
+  ResetValues(feeds, session_state_.GetInitializedTensors(), fetches);
+
+  custom_allocators_.clear();
+  InitCustomAllocators(fetch_allocators);
+
+  bool same_shapes = mem_patterns_ != nullptr && feeds.size() == mem_patterns_input_shapes_.size();
+  for (size_t i = 0; same_shapes && i < feeds.size(); ++i) {
+    same_shapes = feeds[i].IsTensor() && feeds[i].Get<Tensor>().Shape() == mem_patterns_input_shapes_[i];
+  }
+
+  // select the memory pattern again if the shapes changed, or if the previous execution traced the allocations
+  // as there may now be a pattern for these shapes.
+  if (!same_shapes) {
+    mem_patterns_ = nullptr;
+    mem_patterns_input_shapes_.clear();
+    planner_ = nullptr;
+    buffers_.clear();
+
+    InitMemoryPatterns(feeds);
+  }
+
+  return Status::OK();
+}
+
+void ExecutionFrame::InitCustomAllocators(
+    const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
   // map the custom allocators to mlvalue_idx entries
   if (!fetch_allocators.empty()) {
+    const auto& fetch_mlvalue_idxs = GetFetchMLValueIdxs();
     for (size_t idx = 0, end = fetch_mlvalue_idxs.size(); idx < end; ++idx) {
       int mlvalue_idx = fetch_mlvalue_idxs[idx];
 
@@ -182,11 +231,13 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs,
       }
     }
   }
+}
 
+void ExecutionFrame::InitMemoryPatterns(const std::vector<MLValue>& feeds) {
   // If the session enable memory pattern optimization
   // and we have execution plan generated, try to setup
   // memory pattern optimization.
-  if (session_state.GetExecutionPlan()) {
+  if (session_state_.GetExecutionPlan()) {
     std::vector<TensorShape> input_shapes;
     bool all_tensors = true;
     for (const auto& feed : feeds) {
@@ -200,10 +251,15 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs,
 
     // if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(input_shapes);
-      // if no existing patterns, generate one in this executionframe
+      mem_patterns_ = session_state_.GetMemoryPatternGroup(input_shapes);
+      // if no existing patterns, try to generate one from the inferred shapes
+      if (!mem_patterns_) {
+        mem_patterns_ = session_state_.GenerateMemoryPatternGroup(input_shapes, GetFeedMLValueIdxs(), feeds);
+      }
+
+      // if that's not possible, generate one by tracing the allocations in this executionframe
       if (!mem_patterns_) {
-        planner_ = std::make_unique<MLValuePatternPlanner>(*session_state.GetExecutionPlan());
+        planner_ = std::make_unique<MLValuePatternPlanner>(*session_state_.GetExecutionPlan());
       } else {
         // pre-allocate the big chunk requested in memory pattern.
         // all the internal kernel's input/output tensors will be allocated on these buffer.
@@ -215,13 +271,13 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs,
                              : nullptr;
           buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(buffer, alloc);
         }
+
+        mem_patterns_input_shapes_ = std::move(input_shapes);
       }
     }
   }
 }
 
-ExecutionFrame::~ExecutionFrame() = default;
-
 Status ExecutionFrame::AllocateMLValueTensorSelfOwnBuffer(MLValue& mlvalue,
                                                           int mlvalue_index,
                                                           MLDataType element_type,
@@ -271,17 +327,18 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(MLValue& mlvalue
       // if block not found, fall back to default behavior
       if (block) {
         auto it = buffers_.find(location);
-        // if the block is not correct, log message then fall back to default behavior
-        if (it != buffers_.end() && block->size_ == size) {
+        // if the block is not correct, log message then fall back to default behavior.
+        // the pattern may have been generated from larger inputs in the same shape bucket so a smaller size is fine.
+        if (it != buffers_.end() && size <= block->size_) {
           void* buffer = it->second.get();
           auto status = AllocateTensorWithPreAllocateBufferHelper(
               mlvalue, static_cast<void*>(static_cast<char*>(buffer) + block->offset_),
               element_type, location, shape);
           return status;
         }
-        if (block->size_ != size) {
+        if (size > block->size_) {
           LOGS_DEFAULT(WARNING) << "For mlvalue with index: " << mlvalue_index << ", block in memory pattern size is: "
-                                << block->size_ << " but the actually size is: " << size
+                                << block->size_ << " but the actual size is larger: " << size
                                 << ", fall back to default allocation behavior";
         } else if (it == buffers_.end()) {
           LOGS_DEFAULT(WARNING) << "For mlvalue with index: " << mlvalue_index
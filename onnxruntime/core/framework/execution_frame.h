@@ -62,6 +62,20 @@ class IExecutionFrame {
   Status ReleaseMLValue(int mlvalue_idx);
 
  protected:
+  // Release all the values in the frame and set the feeds, initializers and fetches again so that the frame can
+  // execute the graph another time. The feeds and fetches must be for the same indexes as the original ones.
+  void ResetValues(const std::vector<MLValue>& feeds,
+                   const std::unordered_map<int, MLValue>& initializers,
+                   const std::vector<MLValue>& fetches);
+
+  const std::vector<int>& GetFeedMLValueIdxs() const {
+    return feed_mlvalue_idxs_;
+  }
+
+  const std::vector<int>& GetFetchMLValueIdxs() const {
+    return fetch_mlvalue_idxs_;
+  }
+
   // get the mlvalue_idx from NodeIndexInfo
   int GetNodeIdxToMLValueIdx(int index) const;
 
@@ -77,12 +91,9 @@ class IExecutionFrame {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IExecutionFrame);
 
-  void Init(const std::vector<int>& feed_mlvalue_idxs,
-            const std::vector<MLValue>& feeds,
+  void Init(const std::vector<MLValue>& feeds,
             const std::unordered_map<int, MLValue>& initializers,
-            const std::vector<int>& fetch_mlvalue_idxs,
-            const std::vector<MLValue>& fetches,
-            const MLValueNameIdxMap& mlvalue_idx_map);
+            const std::vector<MLValue>& fetches);
 
   const MLValue& GetMLValue(int mlvalue_index) const {
     ORT_ENFORCE(mlvalue_index >= 0 && static_cast<size_t>(mlvalue_index) < all_values_.size());
@@ -98,6 +109,7 @@ class IExecutionFrame {
   // Input and Output values are passed in by executors
   std::vector<MLValue> all_values_;
 
+  const std::vector<int> feed_mlvalue_idxs_;
   const std::vector<int> fetch_mlvalue_idxs_;
 };
 
@@ -113,6 +125,13 @@ class ExecutionFrame final : public IExecutionFrame {
 
   ~ExecutionFrame();
 
+  // Prepare the frame to execute the graph again with new feeds and fetches, such as for the next iteration of a
+  // Loop or Scan subgraph. The buffers for the memory pattern are kept if the shapes of the feeds are unchanged,
+  // so the intermediate values of the graph are placed in the same memory as the previous execution.
+  Status Reset(const std::vector<MLValue>& feeds,
+               const std::vector<MLValue>& fetches,
+               const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
   // TODO: These two AllocateMLValue... methods are in the API purely for unit test usage.
   // Fix the unit tests so they set an execution plan that results in these methods being called by
   // GetOrCreateNodeOutputMLValue instead
@@ -139,6 +158,9 @@ class ExecutionFrame final : public IExecutionFrame {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ExecutionFrame);
 
+  void InitCustomAllocators(const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+  void InitMemoryPatterns(const std::vector<MLValue>& feeds);
+
   AllocatorPtr GetAllocatorImpl(const OrtAllocatorInfo& info) const override;
   Status ReleaseMLValueImpl(int mlvalue_idx) override;
   Status CreateNodeOutputMLValueImpl(MLValue& mlvalue, int mlvalue_idx, const TensorShape* shape) override;
@@ -173,7 +195,10 @@ class ExecutionFrame final : public IExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
+
+  // Shapes of the feeds that mem_patterns_ was selected for.
+  std::vector<TensorShape> mem_patterns_input_shapes_;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
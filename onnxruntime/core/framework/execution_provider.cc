@@ -3,6 +3,7 @@
 #include "core/framework/execution_provider.h"
 
 #include "core/graph/graph_viewer.h"
+#include "core/framework/arena.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/op_kernel.h"
@@ -25,6 +26,18 @@ AllocatorPtr IExecutionProvider::GetAllocator(int id, OrtMemType mem_type) const
   return nullptr;
 }
 
+size_t IExecutionProvider::ShrinkArenas() {
+  size_t released_bytes = 0;
+  for (auto& allocator : allocators_) {
+    auto* arena = dynamic_cast<IArenaAllocator*>(allocator.second.get());
+    if (arena != nullptr) {
+      released_bytes += arena->Shrink();
+    }
+  }
+
+  return released_bytes;
+}
+
 std::vector<std::unique_ptr<ComputeCapability>>
 IExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph,
                                   const std::vector<const KernelRegistry*>& kernel_registries) const {
@@ -3,6 +3,8 @@
 
 #include "core/framework/feeds_fetches_manager.h"
 
+#include <algorithm>
+
 #include "core/framework/execution_providers.h"
 #include "core/framework/mlvalue_name_idx_map.h"
 
@@ -66,4 +68,67 @@ void FeedsFetchesManager::SetDeviceCopyChecks(DeviceCopyChecks checks) {
           ? DeviceCopyCheck::NoCopy
           : DeviceCopyCheck::Copy;
 }
+
+void FeedsFetchesManager::SetFeedsFetchesLocations(const std::vector<MLValue>& feeds,
+                                                   const std::vector<MLValue>& fetches) {
+  const auto num_outputs = feeds_fetches_info_.output_names.size();
+
+  feeds_fetches_locations_.clear();
+  feeds_fetches_locations_.reserve(feeds.size() + num_outputs);
+
+  const MLValueLocation not_allocated_tensor{false, OrtAllocatorInfo(CPU, OrtDeviceAllocator)};
+
+  auto add_location = [this, &not_allocated_tensor](const MLValue& mlvalue) {
+    if (mlvalue.IsAllocated() && mlvalue.IsTensor()) {
+      feeds_fetches_locations_.push_back({true, mlvalue.Get<Tensor>().Location()});
+    } else {
+      feeds_fetches_locations_.push_back(not_allocated_tensor);
+    }
+  };
+
+  std::for_each(feeds.cbegin(), feeds.cend(), add_location);
+
+  // an empty fetches vector is equivalent to one where none of the fetches are pre-allocated
+  if (fetches.empty()) {
+    feeds_fetches_locations_.insert(feeds_fetches_locations_.end(), num_outputs, not_allocated_tensor);
+  } else {
+    std::for_each(fetches.cbegin(), fetches.cend(), add_location);
+  }
+}
+
+bool FeedsFetchesManager::MatchesFeedsFetchesLocations(const std::vector<MLValue>& feeds,
+                                                       const std::vector<MLValue>& fetches) const {
+  const auto num_outputs = fetches.empty() ? feeds_fetches_info_.output_names.size() : fetches.size();
+  if (feeds.size() + num_outputs != feeds_fetches_locations_.size()) {
+    return false;
+  }
+
+  auto matches = [](const MLValueLocation& expected, const MLValue& mlvalue) {
+    if (!mlvalue.IsAllocated() || !mlvalue.IsTensor()) {
+      return !expected.is_allocated_tensor;
+    }
+
+    return expected.is_allocated_tensor && expected.location == mlvalue.Get<Tensor>().Location();
+  };
+
+  size_t idx = 0;
+  for (const auto& feed : feeds) {
+    if (!matches(feeds_fetches_locations_[idx++], feed)) {
+      return false;
+    }
+  }
+
+  if (fetches.empty()) {
+    return std::none_of(feeds_fetches_locations_.cbegin() + idx, feeds_fetches_locations_.cend(),
+                        [](const MLValueLocation& l) { return l.is_allocated_tensor; });
+  }
+
+  for (const auto& fetch : fetches) {
+    if (!matches(feeds_fetches_locations_[idx++], fetch)) {
+      return false;
+    }
+  }
+
+  return true;
+}
 }  // namespace onnxruntime
@@ -74,6 +74,13 @@ class FeedsFetchesManager {
   DeviceCopyChecks GetDeviceCopyChecks() const { return device_copy_checks_; }
   void SetDeviceCopyChecks(DeviceCopyChecks checks);
 
+  // Save the locations of the feeds and any pre-allocated fetches that the device copy info was created for.
+  void SetFeedsFetchesLocations(const std::vector<MLValue>& feeds, const std::vector<MLValue>& fetches);
+
+  // Check whether the feeds and pre-allocated fetches are on the same devices as the ones the device copy info
+  // was created for. If they are not, the cached copy info can't be used.
+  bool MatchesFeedsFetchesLocations(const std::vector<MLValue>& feeds, const std::vector<MLValue>& fetches) const;
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(FeedsFetchesManager);
 
@@ -84,5 +91,13 @@ class FeedsFetchesManager {
   std::vector<MLValueCopyInfo> feeds_device_copiers_;
   std::vector<bool> can_use_fetch_during_execution_flags_;
   std::vector<MLValueCopyInfo> fetches_device_copiers_;
+
+  struct MLValueLocation {
+    bool is_allocated_tensor;
+    OrtAllocatorInfo location;
+  };
+
+  // location of each feed followed by each fetch
+  std::vector<MLValueLocation> feeds_fetches_locations_;
 };
 }  // namespace onnxruntime
@@ -18,7 +18,11 @@ limitations under the License.
 #pragma once
 #include "core/framework/mem_pattern.h"
 #include "core/framework/allocation_planner.h"
-#include <list>
+#include <iterator>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
 
 namespace onnxruntime {
 // MemPatternPlanner is used to trace allocation/free steps
@@ -34,39 +38,62 @@ class MemPatternPlanner {
       return;
     }
 
-    size_t current = 0;
-    size_t waste_bytes = std::numeric_limits<size_t>::max();
+    // use the smallest gap between the allocated blocks that is large enough. ties go to the lowest offset.
+    // if there is no such gap, allocate after the last block.
     size_t best_offset = 0;
-    if (!blocks_.empty()) {
-      auto last_block = allocs_[*blocks_.rbegin()];
-      best_offset = last_block.block_.offset_ + last_block.block_.size_;
-    }
-
-    std::list<int>::iterator best_fit_it = blocks_.end();
-    for (auto it = blocks_.begin(); it != blocks_.end(); it++) {
-      if (allocs_[*it].block_.offset_ >= current) {
-        auto gap = allocs_[*it].block_.offset_ - current;
-        if (gap >= size && (gap - size) < waste_bytes) {
-          best_fit_it = it;
-          waste_bytes = gap - size;
-          best_offset = current;
-        }
+    auto best_fit_it = gaps_.lower_bound({size, 0});
+    if (best_fit_it != gaps_.end()) {
+      auto gap_size = best_fit_it->first;
+      best_offset = best_fit_it->second;
+      gaps_.erase(best_fit_it);
+      if (gap_size > size) {
+        gaps_.insert({gap_size - size, best_offset + size});
       }
-      current = allocs_[*it].block_.offset_ + allocs_[*it].block_.size_;
+    } else if (!blocks_.empty()) {
+      const auto& last_block = allocs_[blocks_.rbegin()->second].block_;
+      best_offset = last_block.offset_ + last_block.size_;
     }
 
     allocs_.emplace_back(ml_value_idx, MemoryBlock(best_offset, size));
     buffer_size = std::max(buffer_size, best_offset + size);
-    blocks_.insert(best_fit_it, (static_cast<int>(allocs_.size()) - 1));
+    blocks_[best_offset] = static_cast<int>(allocs_.size()) - 1;
+    block_offsets_[ml_value_idx] = best_offset;
   }
 
   void TraceFree(int ml_value_index) {
-    for (auto it = blocks_.begin(); it != blocks_.end(); it++) {
-      if (allocs_[*it].index_ == ml_value_index) {
-        blocks_.erase(it);
-        break;
+    auto offset_it = block_offsets_.find(ml_value_index);
+    if (offset_it == block_offsets_.end()) {
+      return;
+    }
+
+    auto it = blocks_.find(offset_it->second);
+    block_offsets_.erase(offset_it);
+
+    const auto& block = allocs_[it->second].block_;
+    size_t gap_start = 0;
+    if (it != blocks_.begin()) {
+      const auto& prev_block = allocs_[std::prev(it)->second].block_;
+      gap_start = prev_block.offset_ + prev_block.size_;
+    }
+
+    // merge the gaps on either side of the block. if it's the last block the space becomes part of the free
+    // space after the last block instead.
+    if (block.offset_ > gap_start) {
+      gaps_.erase({block.offset_ - gap_start, gap_start});
+    }
+
+    auto next_it = std::next(it);
+    if (next_it != blocks_.end()) {
+      auto gap_end = allocs_[next_it->second].block_.offset_;
+      auto block_end = block.offset_ + block.size_;
+      if (gap_end > block_end) {
+        gaps_.erase({gap_end - block_end, block_end});
       }
+
+      gaps_.insert({gap_end - gap_start, gap_start});
     }
+
+    blocks_.erase(it);
   }
 
   MemoryPattern GenerateMemPattern() const {
@@ -89,8 +116,12 @@ class MemPatternPlanner {
   };
 
   std::vector<MLValueAllocationBlock> allocs_;
-  // blocks_ the list of currently allocated memory blocks, sorted in order of their offset
-  std::list<int> blocks_;
+  // blocks_ the currently allocated memory blocks, keyed by their offset. value is the index in allocs_
+  std::map<size_t, int> blocks_;
+  // the offset of the currently allocated memory block for each MLValue index
+  std::unordered_map<int, size_t> block_offsets_;
+  // the free space between the currently allocated memory blocks, as {size, offset}
+  std::set<std::pair<size_t, size_t>> gaps_;
   size_t buffer_size{0};
 };
 
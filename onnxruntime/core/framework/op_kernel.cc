@@ -11,9 +11,11 @@ namespace onnxruntime {
 
 OpKernelContext::OpKernelContext(IExecutionFrame* frame,
                                  const OpKernel* kernel,
+                                 concurrency::ThreadPool* threadpool,
                                  const logging::Logger& logger)
     : execution_frame_(frame),
       kernel_(kernel),
+      threadpool_(threadpool),
       logger_(&logger) {
   ORT_ENFORCE(frame != nullptr, "Execution frame was null");
   ORT_ENFORCE(kernel != nullptr, "OpKernel was null");
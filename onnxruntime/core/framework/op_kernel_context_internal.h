@@ -21,7 +21,7 @@ class OpKernelContextInternal : public OpKernelContext {
                                    const logging::Logger& logger,
                                    const std::vector<NodeArg*>& implicit_inputs,
                                    const bool& terminate_flag)
-      : OpKernelContext(&frame, &kernel, logger),
+      : OpKernelContext(&frame, &kernel, session_state.GetIntraOpThreadPool(), logger),
         session_state_{session_state},
         implicit_inputs_{implicit_inputs},
         terminate_flag_{terminate_flag} {
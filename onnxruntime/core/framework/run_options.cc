@@ -33,3 +33,7 @@ ORT_API(const char*, OrtRunOptionsGetRunTag, _In_ OrtRunOptions* options) {
 ORT_API(void, OrtRunOptionsSetTerminate, _In_ OrtRunOptions* options, bool value) {
   options->terminate = value;
 }
+
+ORT_API(void, OrtRunOptionsSetShrinkArenas, _In_ OrtRunOptions* options, int flag) {
+  options->shrink_arenas = flag != 0;
+}
@@ -28,6 +28,34 @@ Status SequentialExecutor::Execute(const SessionState& session_state,
                                    std::vector<MLValue>& fetches,
                                    const std::unordered_map<size_t, CustomAllocator> fetch_allocators,
                                    const logging::Logger& logger) {
+  ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state};
+
+  return ExecuteWithFrame(session_state, frame, feeds, fetches, logger);
+}
+
+Status SequentialExecutor::Execute(const SessionState& session_state,
+                                   const std::vector<int>& feed_mlvalue_idxs,
+                                   const std::vector<MLValue>& feeds,
+                                   const std::vector<int>& fetch_mlvalue_idxs,
+                                   std::vector<MLValue>& fetches,
+                                   const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                                   std::unique_ptr<ExecutionFrame>& frame,
+                                   const logging::Logger& logger) {
+  if (frame) {
+    ORT_RETURN_IF_ERROR(frame->Reset(feeds, fetches, fetch_allocators));
+  } else {
+    frame = std::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
+                                             fetch_allocators, session_state);
+  }
+
+  return ExecuteWithFrame(session_state, *frame, feeds, fetches, logger);
+}
+
+Status SequentialExecutor::ExecuteWithFrame(const SessionState& session_state,
+                                            ExecutionFrame& frame,
+                                            const std::vector<MLValue>& feeds,
+                                            std::vector<MLValue>& fetches,
+                                            const logging::Logger& logger) {
   bool f_profiler_enabled = session_state.Profiler().FEnabled();
   TimePoint tp;
   TimePoint sync_time_begin;
@@ -37,8 +65,6 @@ Status SequentialExecutor::Execute(const SessionState& session_state,
     tp = session_state.Profiler().StartTime();
   }
 
-  ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state};
-
   LOGS(logger, INFO) << "Begin execution";
   const SequentialExecutionPlan& seq_exec_plan = *session_state.GetExecutionPlan();
   const auto& exec_plan_vec = seq_exec_plan.execution_plan;
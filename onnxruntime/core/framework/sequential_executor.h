@@ -14,6 +14,8 @@
 #include "core/graph/graph_viewer.h"
 
 namespace onnxruntime {
+class ExecutionFrame;
+
 class SequentialExecutor : public IExecutor {
  public:
   SequentialExecutor(const bool& terminate_flag = false) : terminate_flag_{terminate_flag} {}
@@ -26,7 +28,25 @@ class SequentialExecutor : public IExecutor {
                          const std::unordered_map<size_t, CustomAllocator> fetch_allocators,
                          const logging::Logger& logger) override;
 
+  // Execute using the ExecutionFrame in 'frame', creating it if it is null. A frame created by a previous call
+  // is reset with the new feeds and fetches, so it must be for the same SessionState, feeds and fetches. This
+  // allows a subgraph executed many times, such as by a Loop or Scan node, to reuse the frame and its buffers.
+  common::Status Execute(const SessionState& session_state,
+                         const std::vector<int>& feed_mlvalue_idxs,
+                         const std::vector<MLValue>& feeds,
+                         const std::vector<int>& fetch_mlvalue_idxs,
+                         std::vector<MLValue>& fetches,
+                         const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                         std::unique_ptr<ExecutionFrame>& frame,
+                         const logging::Logger& logger);
+
  private:
+  common::Status ExecuteWithFrame(const SessionState& session_state,
+                                  ExecutionFrame& frame,
+                                  const std::vector<MLValue>& feeds,
+                                  std::vector<MLValue>& fetches,
+                                  const logging::Logger& logger);
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SequentialExecutor);
   const bool& terminate_flag_;
 };
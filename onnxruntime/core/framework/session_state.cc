@@ -66,34 +66,210 @@ void SessionState::SetProfiler(profiling::Profiler& profiler) { profiler_ = &pro
 
 ::onnxruntime::profiling::Profiler& SessionState::Profiler() const { return *profiler_; }
 
-static int64_t CalculateMemoryPatternsKey(const std::vector<TensorShape>& shapes) {
-  int64_t key = 0;
+// round a dimension up to a power of two so that inputs with similar shapes share a bucket
+static int64_t BucketDimension(int64_t dim) {
+  if (dim <= 1) {
+    return dim;
+  }
+
+  int64_t bucket = 1;
+  while (bucket < dim) {
+    bucket <<= 1;
+  }
+
+  return bucket;
+}
+
+static std::vector<int64_t> CalculateMemoryPatternsKey(const std::vector<TensorShape>& shapes) {
+  std::vector<int64_t> key;
   for (auto& shape : shapes) {
-    for (auto dim : shape.GetDims()) key ^= dim;
+    // include the rank so shapes with different ranks can't produce the same key
+    const auto& dims = shape.GetDims();
+    key.push_back(static_cast<int64_t>(dims.size()));
+    for (auto dim : dims) {
+      key.push_back(BucketDimension(dim));
+    }
   }
   return key;
 }
 
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(const std::vector<TensorShape>& input_shapes) const {
+// check that no dimension of the input shapes is larger than in the shapes a pattern was generated from.
+// both have the same bucketed shapes, so they have the same number of inputs with the same ranks.
+static bool FitsInPatternShapes(const std::vector<TensorShape>& shapes,
+                                const std::vector<TensorShape>& pattern_shapes) {
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    const auto& dims = shapes[i].GetDims();
+    const auto& pattern_dims = pattern_shapes[i].GetDims();
+    for (size_t j = 0; j < dims.size(); ++j) {
+      if (dims[j] > pattern_dims[j]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
+    const std::vector<TensorShape>& input_shapes) const {
+  auto key = CalculateMemoryPatternsKey(input_shapes);
+
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) return nullptr;
+  auto it = mem_patterns_index_.find(key);
+
+  // a pattern generated from inputs that are smaller in any dimension may have blocks that are too small, so treat
+  // it as a miss. the pattern generated by this execution will replace it.
+  if (it == mem_patterns_index_.end() || !FitsInPatternShapes(input_shapes, it->second->input_shapes)) {
+    ++mem_pattern_cache_stats_.misses;
+    return nullptr;
+  }
+
+  ++mem_pattern_cache_stats_.hits;
 
-  return it->second.get();
+  // move to the front of the LRU list
+  mem_patterns_.splice(mem_patterns_.begin(), mem_patterns_, it->second);
+
+  return it->second->mem_patterns;
 }
 
 Status SessionState::UpdateMemoryPatternGroupCache(const std::vector<TensorShape>& input_shape,
                                                    std::unique_ptr<MemoryPatternGroup> mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shape);
+  CacheMemoryPatternGroup(input_shape, std::move(mem_patterns));
+  return Status::OK();
+}
+
+std::shared_ptr<const MemoryPatternGroup> SessionState::CacheMemoryPatternGroup(
+    const std::vector<TensorShape>& input_shape, std::shared_ptr<const MemoryPatternGroup> mem_patterns) const {
+  auto key = CalculateMemoryPatternsKey(input_shape);
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
-    mem_patterns_[key] = std::move(mem_patterns);
+  auto it = mem_patterns_index_.find(key);
+  if (it != mem_patterns_index_.end()) {
+    // keep the cached pattern if it was generated from inputs that are at least as large in every dimension,
+    // otherwise it can't be used for these inputs so replace it
+    if (!FitsInPatternShapes(input_shape, it->second->input_shapes)) {
+      it->second->input_shapes = input_shape;
+      it->second->mem_patterns = std::move(mem_patterns);
+    }
+
+    mem_patterns_.splice(mem_patterns_.begin(), mem_patterns_, it->second);
+    return it->second->mem_patterns;
   }
 
-  return Status::OK();
+  // evict the least recently used entries if needed. executors using an evicted pattern keep it alive until
+  // they complete as they hold a shared_ptr to it.
+  while (!mem_patterns_.empty() && mem_patterns_.size() >= max_mem_pattern_groups_) {
+    mem_patterns_index_.erase(mem_patterns_.back().key);
+    mem_patterns_.pop_back();
+    ++mem_pattern_cache_stats_.evictions;
+  }
+
+  if (max_mem_pattern_groups_ > 0) {
+    mem_patterns_.push_front(MemoryPatternCacheEntry{key, input_shape, mem_patterns});
+    mem_patterns_index_[std::move(key)] = mem_patterns_.begin();
+  }
+
+  return mem_patterns;
+}
+
+void SessionState::SetSymbolicMemPatternPlanner(std::unique_ptr<SymbolicMemPatternPlanner> planner) {
+  symbolic_mem_pattern_planner_ = std::move(planner);
+}
+
+std::shared_ptr<const MemoryPatternGroup> SessionState::GenerateMemoryPatternGroup(
+    const std::vector<TensorShape>& input_shapes,
+    const std::vector<int>& feed_mlvalue_idxs,
+    const std::vector<MLValue>& feeds) const {
+  if (!symbolic_mem_pattern_planner_) {
+    return nullptr;
+  }
+
+  auto mem_patterns = std::make_unique<MemoryPatternGroup>();
+  auto status = symbolic_mem_pattern_planner_->GeneratePatterns(feed_mlvalue_idxs, feeds, mem_patterns.get());
+  if (!status.IsOK()) {
+    LOGS(Logger(), VERBOSE) << "Memory pattern was not generated from the inferred shapes: " << status.ErrorMessage();
+    return nullptr;
+  }
+
+  return CacheMemoryPatternGroup(input_shapes, std::move(mem_patterns));
+}
+
+void SessionState::SetMaxMemoryPatternGroups(size_t max_mem_pattern_groups) {
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  max_mem_pattern_groups_ = max_mem_pattern_groups;
+
+  while (mem_patterns_.size() > max_mem_pattern_groups_) {
+    mem_patterns_index_.erase(mem_patterns_.back().key);
+    mem_patterns_.pop_back();
+    ++mem_pattern_cache_stats_.evictions;
+  }
+}
+
+SessionState::MemoryPatternCacheStats SessionState::GetMemoryPatternCacheStats() const {
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  return mem_pattern_cache_stats_;
+}
+
+static bool MatchesNames(const FeedsFetchesManager& feeds_fetches_manager,
+                         const std::vector<std::string>& feed_names,
+                         const std::vector<std::string>& output_names) {
+  const auto& info = feeds_fetches_manager.GetFeedsFetchesInfo();
+  return info.feed_names == feed_names && info.output_names == output_names;
+}
+
+const FeedsFetchesManager* SessionState::GetCachedFeedsFetchesManager(
+    const std::vector<std::string>& feed_names,
+    const std::vector<std::string>& output_names) const {
+  for (const auto* entry = cached_feeds_fetches_managers_.load(std::memory_order_acquire);
+       entry != nullptr;
+       entry = entry->next) {
+    if (MatchesNames(*entry->feeds_fetches_manager, feed_names, output_names)) {
+      return entry->feeds_fetches_manager.get();
+    }
+  }
+
+  return nullptr;
+}
+
+void SessionState::CacheFeedsFetchesManager(std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager) const {
+  // bound the cache size so a caller that requests many different combinations of outputs can't grow it
+  // indefinitely. the limit may be exceeded slightly if multiple threads add entries concurrently.
+  if (num_cached_feeds_fetches_managers_.load(std::memory_order_relaxed) >= kMaxCachedFeedsFetchesManagers) {
+    return;
+  }
+
+  const auto& info = feeds_fetches_manager->GetFeedsFetchesInfo();
+  auto entry = std::make_unique<CachedFeedsFetchesManager>();
+  entry->feeds_fetches_manager = std::move(feeds_fetches_manager);
+  entry->next = cached_feeds_fetches_managers_.load(std::memory_order_acquire);
+
+  const CachedFeedsFetchesManager* searched_to = nullptr;
+  do {
+    // check the entries added since the last search for a matching one. if another thread won the race to
+    // add an entry for these names, keep that one.
+    for (const auto* cur = entry->next; cur != searched_to; cur = cur->next) {
+      if (MatchesNames(*cur->feeds_fetches_manager, info.feed_names, info.output_names)) {
+        return;
+      }
+    }
+
+    searched_to = entry->next;
+  } while (!cached_feeds_fetches_managers_.compare_exchange_weak(entry->next, entry.get(),
+                                                                 std::memory_order_release,
+                                                                 std::memory_order_acquire));
+
+  entry.release();
+  ++num_cached_feeds_fetches_managers_;
+}
+
+void SessionState::ClearCachedFeedsFetchesManagers() {
+  auto* entry = cached_feeds_fetches_managers_.exchange(nullptr);
+  while (entry != nullptr) {
+    auto* next = entry->next;
+    delete entry;
+    entry = next;
+  }
+
+  num_cached_feeds_fetches_managers_ = 0;
 }
 
 
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <list>
 #include <memory>
 #include <map>
 #include <unordered_map>
@@ -22,6 +24,7 @@
 #include "core/framework/callback.h"
 #include "core/framework/mlvalue_name_idx_map.h"
 #include "core/framework/node_index_info.h"
+#include "core/framework/symbolic_mem_pattern_planner.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/fuse_nodes_funcs.h"
 
@@ -37,6 +40,9 @@ class OpKernel;
 class NodeIndexInfo;
 struct SequentialExecutionPlan;
 struct MemoryPatternGroup;
+namespace concurrency {
+class ThreadPool;
+}
 
 #ifndef USE_EIGEN_THREADPOOL
 class TaskThreadPool;
@@ -57,6 +63,8 @@ class SessionState {
     for (auto& kvp : deleter_for_initialized_tensors_) {
       kvp.second.f(kvp.second.param);
     }
+
+    ClearCachedFeedsFetchesManagers();
   }
 
   // Graph viewer.
@@ -117,17 +125,71 @@ class SessionState {
   profiling::Profiler& Profiler() const;
 
   /**
-  Get cached memory pattern based on input shapes
+  Get cached memory pattern based on input shapes.
+  The input shapes are grouped into buckets by rounding each dimension up to a power of two so that inputs with
+  similar shapes can share a memory pattern. A cached pattern is only returned if no dimension of input_shapes is
+  larger than in the inputs it was generated from, so that its blocks are big enough.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(const std::vector<TensorShape>& input_shapes) const;
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(const std::vector<TensorShape>& input_shapes) const;
 
   /**
   Set generated memory pattern with a given input shapes. 
+  Replaces a cached pattern for the same bucket that can't be used for input_shape. If the cache is full the
+  least recently used pattern is evicted.
   Const as it's an internal cache update only.
   */
   Status UpdateMemoryPatternGroupCache(const std::vector<TensorShape>& input_shape,
                                        std::unique_ptr<MemoryPatternGroup> mem_patterns) const;
 
+  /**
+  Set the maximum number of memory patterns to cache. Defaults to kDefaultMaxMemoryPatternGroups.
+  */
+  void SetMaxMemoryPatternGroups(size_t max_mem_pattern_groups);
+
+  struct MemoryPatternCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+  };
+
+  /**
+  Get the number of memory pattern cache lookups that were hits and misses, and the number of patterns evicted.
+  */
+  MemoryPatternCacheStats GetMemoryPatternCacheStats() const;
+
+  static constexpr size_t kDefaultMaxMemoryPatternGroups = 16;
+
+  /**
+  Set the planner used to generate memory patterns from the shapes inferred for the graph.
+  */
+  void SetSymbolicMemPatternPlanner(std::unique_ptr<SymbolicMemPatternPlanner> planner);
+
+  /**
+  Generate the memory pattern for the feeds from the shapes inferred for the graph, and cache it. This avoids
+  tracing a run to generate a pattern for new input shapes.
+  @returns nullptr if there is no symbolic planner or it can't generate a pattern for the feeds.
+  Const as it's an internal cache update only.
+  */
+  std::shared_ptr<const MemoryPatternGroup> GenerateMemoryPatternGroup(const std::vector<TensorShape>& input_shapes,
+                                                                       const std::vector<int>& feed_mlvalue_idxs,
+                                                                       const std::vector<MLValue>& feeds) const;
+
+  /**
+  Get the FeedsFetchesManager cached for the given feed and output names. The lookup is lock-free so
+  concurrent Run calls do not serialize on it.
+  @returns nullptr if no FeedsFetchesManager has been cached for the names.
+  */
+  const FeedsFetchesManager* GetCachedFeedsFetchesManager(const std::vector<std::string>& feed_names,
+                                                          const std::vector<std::string>& output_names) const;
+
+  /**
+  Cache a FeedsFetchesManager that was used in a successful execution so its MLValue indexes and device copy
+  info can be re-used by subsequent executions with the same feed and output names.
+  The FeedsFetchesManager is discarded if an entry for the names already exists or the cache is full.
+  Const as it's an internal cache update only.
+  */
+  void CacheFeedsFetchesManager(std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager) const;
+
   struct NodeInfo {
     /**
      *
@@ -176,6 +238,13 @@ class SessionState {
   void SetThreadPool(TaskThreadPool* p_pool) { thread_pool_ = p_pool; }
 #endif
 
+  /**
+  Get the intra-op thread pool shared by all the kernels in the session. May be nullptr in which case
+  kernels should run on the calling thread.
+  */
+  concurrency::ThreadPool* GetIntraOpThreadPool() const { return intra_op_thread_pool_; }
+  void SetIntraOpThreadPool(concurrency::ThreadPool* p_pool) { intra_op_thread_pool_ = p_pool; }
+
   bool ExportDll() const { return export_fused_dll_; }
   void SetExportDllFlag(bool flag) { export_fused_dll_ = flag; }
 
@@ -190,6 +259,13 @@ class SessionState {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SessionState);
 
+  void ClearCachedFeedsFetchesManagers();
+
+  // add mem_patterns to the cache. returns the pattern to use for input_shape, which is the cached pattern if that
+  // was generated from larger inputs.
+  std::shared_ptr<const MemoryPatternGroup> CacheMemoryPatternGroup(
+      const std::vector<TensorShape>& input_shape, std::shared_ptr<const MemoryPatternGroup> mem_patterns) const;
+
   // cache of the constructed kernels to avoid spending construction
   // time per executor
   std::unordered_map<NodeIndex, std::unique_ptr<OpKernel>> session_kernels_;
@@ -211,8 +287,23 @@ class SessionState {
 
   // lock for the mem_patterns_
   mutable OrtMutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  mutable std::map<int64_t, std::unique_ptr<MemoryPatternGroup>> mem_patterns_;
+
+  struct MemoryPatternCacheEntry {
+    // bucketed input shapes
+    std::vector<int64_t> key;
+    // shapes of the inputs the patterns were generated from
+    std::vector<TensorShape> input_shapes;
+    std::shared_ptr<const MemoryPatternGroup> mem_patterns;
+  };
+
+  // cache for the generated mem_patterns, ordered from most to least recently used.
+  mutable std::list<MemoryPatternCacheEntry> mem_patterns_;
+  // lookup into mem_patterns_. key is calculated based on the bucketed input shapes.
+  mutable std::map<std::vector<int64_t>, std::list<MemoryPatternCacheEntry>::iterator> mem_patterns_index_;
+  size_t max_mem_pattern_groups_ = kDefaultMaxMemoryPatternGroups;
+  mutable MemoryPatternCacheStats mem_pattern_cache_stats_;
+
+  std::unique_ptr<SymbolicMemPatternPlanner> symbolic_mem_pattern_planner_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -229,11 +320,25 @@ class SessionState {
   TaskThreadPool* thread_pool_ = nullptr;
 #endif
 
+  // owned by InferenceSession
+  concurrency::ThreadPool* intra_op_thread_pool_ = nullptr;
+
   bool export_fused_dll_ = false;
   FuncManager fused_funcs_mgr_;
 
   std::unique_ptr<NodeIndexInfo> node_index_info_;
-  std::multimap<int, std::unique_ptr<FeedsFetchesManager>> cached_feeds_fetches_managers_;
+
+  // lock-free cache of FeedsFetchesManager instances keyed by feed and output names.
+  // entries are only ever pushed to the front of the list, and are not freed until the SessionState is destroyed,
+  // so a pointer returned from a lookup remains valid without any locking.
+  struct CachedFeedsFetchesManager {
+    std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager;
+    CachedFeedsFetchesManager* next;
+  };
+
+  static constexpr int kMaxCachedFeedsFetchesManagers = 32;
+  mutable std::atomic<CachedFeedsFetchesManager*> cached_feeds_fetches_managers_{nullptr};
+  mutable std::atomic<int> num_cached_feeds_fetches_managers_{0};
 };
 
 }  // namespace onnxruntime
@@ -4,20 +4,27 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/framework/session_state_initializer.h"
 
+#include <algorithm>
+#include <exception>
 #include <functional>
 #include <limits>
 #include <core/common/status.h>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
+#include "core/common/threadpool.h"
 
+#include "core/graph/constants.h"
 #include "core/graph/graph_viewer.h"
+#include "core/framework/environment.h"
 #include "core/framework/graph_partitioner.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/ml_value_patterns_planner.h"
 #include "core/framework/mlvalue_name_idx_map.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializer_store.h"
+#include "core/framework/symbolic_mem_pattern_planner.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/framework/mem_buffer.h"
@@ -36,11 +43,15 @@ static common::Status SaveInitializedTensors(const Env& env, const std::basic_st
                                              const ExecutionProviders& exec_providers,
                                              const MLValueNameIdxMap& mlvalue_name_idx_map,
                                              std::map<OrtAllocatorInfo, BufferUniquePtr>& weights_buffers,
+                                             bool map_external_initializers,
+                                             SharedInitializerStore* shared_initializers,
+                                             concurrency::ThreadPool* thread_pool,
                                              const T& save_tensor_func, const logging::Logger& logger);
 
 static common::Status SaveKernels(const ExecutionProviders& execution_providers,
                                   SessionState& session_state,
                                   const KernelRegistryManager& custom_registry_manager,
+                                  concurrency::ThreadPool* thread_pool,
                                   const logging::Logger& logger);
 
 static common::Status SaveInputOutputNamesToNodeMapping(const onnxruntime::Graph& graph,
@@ -86,7 +97,13 @@ common::Status SessionStateInitializer::CreatePlan(const std::vector<NodeArg*>&
         SequentialPlanner::CreatePlan(*graph_viewer, valid_outer_scope_node_args, execution_providers_,
                                       kernel_registry_manager_, mlvalue_name_idx_map, exec_plan));
 
+    // the memory patterns for the sequential execution order can be generated from the inferred shapes
+    std::unique_ptr<SymbolicMemPatternPlanner> mem_pattern_planner;
+    ORT_RETURN_IF_ERROR(SymbolicMemPatternPlanner::Create(*graph_viewer, *exec_plan, mlvalue_name_idx_map,
+                                                          mem_pattern_planner));
+
     session_state_.SetExecutionPlan(std::move(exec_plan));
+    session_state_.SetSymbolicMemPatternPlanner(std::move(mem_pattern_planner));
   } else {
     // Parallel execution still uses same allocation plan, but has limitation of memory buffer reuse.
     SequentialPlannerContext context(true /* enable parallel execution */);
@@ -102,7 +119,9 @@ common::Status SessionStateInitializer::CreatePlan(const std::vector<NodeArg*>&
   return Status::OK();
 }
 
-common::Status SessionStateInitializer::InitializeAndSave(const std::vector<NodeArg*>* implicit_inputs) {
+common::Status SessionStateInitializer::InitializeAndSave(const std::vector<NodeArg*>* implicit_inputs,
+                                                          bool map_external_initializers,
+                                                          bool share_initializers) {
   const auto* exec_plan_ptr = session_state_.GetExecutionPlan();
   ORT_ENFORCE(exec_plan_ptr, "Execution plan was not found in SessionState. CreatePlan must be called first.");
 
@@ -113,7 +132,9 @@ common::Status SessionStateInitializer::InitializeAndSave(const std::vector<Node
   const Env& env = Env::Default();
   ORT_RETURN_IF_ERROR(
       SaveInitializedTensors(env, graph_loc_, graph_, exec_plan, execution_providers_, mlvalue_name_idx_map,
-                             session_state_.GetMutableWeightsBuffers(),
+                             session_state_.GetMutableWeightsBuffers(), map_external_initializers,
+                             share_initializers ? &Environment::GetSharedInitializerStore() : nullptr,
+                             session_state_.GetIntraOpThreadPool(),
                              [this](int idx, const onnxruntime::MLValue& value, const OrtCallback& d) -> Status {
                                return session_state_.AddInitializedTensor(idx, value, &d);
                              },
@@ -123,7 +144,8 @@ common::Status SessionStateInitializer::InitializeAndSave(const std::vector<Node
   // TODO: make it better
   graph_.CleanAllInitializedTensors();
 
-  ORT_RETURN_IF_ERROR(SaveKernels(execution_providers_, session_state_, kernel_registry_manager_, logger_));
+  ORT_RETURN_IF_ERROR(SaveKernels(execution_providers_, session_state_, kernel_registry_manager_,
+                                  session_state_.GetIntraOpThreadPool(), logger_));
   ORT_RETURN_IF_ERROR(SaveInputOutputNamesToNodeMapping(graph_, kernel_registry_manager_, session_state_,
                                                         implicit_inputs));
 
@@ -303,12 +325,44 @@ static common::Status GetPreallocatedBuffer(const MemoryPatternGroup& mem_patter
   return Status::OK();
 }
 
+static void ORT_API_CALL ReleaseSharedInitializer(void* param) noexcept {
+  delete static_cast<std::shared_ptr<const SharedInitializer>*>(param);
+}
+
+// create an initializer that doesn't use any memory owned by the session, so it can be shared with other sessions
+static common::Status CreateSharedInitializer(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
+                                              const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                              const OrtAllocatorInfo& location, bool map_external_initializers,
+                                              const AllocatorPtr& allocator,
+                                              std::unique_ptr<SharedInitializer>& initializer) {
+  MLValue mlvalue;
+  OrtCallback deleter;
+  if (map_external_initializers &&
+      tensor_proto.data_location() == ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL &&
+      utils::MappedExternalDataTensorProtoToMLValue(env, proto_path.c_str(), tensor_proto, location, mlvalue, deleter)
+          .IsOK()) {
+    initializer = std::make_unique<SharedInitializer>(mlvalue, BufferUniquePtr(), deleter);
+    return Status::OK();
+  }
+
+  size_t len;
+  ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &len));
+  BufferUniquePtr buffer(len > 0 ? allocator->Alloc(len) : nullptr, BufferDeleter(allocator));
+  ORT_RETURN_IF_ERROR(utils::TensorProtoToMLValue(env, proto_path.c_str(), tensor_proto,
+                                                  MemBuffer(buffer.get(), len, location), mlvalue, deleter));
+  initializer = std::make_unique<SharedInitializer>(mlvalue, std::move(buffer), deleter);
+  return Status::OK();
+}
+
 template <typename T>
 common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                                       const Graph& graph, const SequentialExecutionPlan& execution_plan,
                                       const ExecutionProviders& exec_providers,
                                       const MLValueNameIdxMap& mlvalue_name_idx_map,
                                       std::map<OrtAllocatorInfo, BufferUniquePtr>& weights_buffers,
+                                      bool map_external_initializers,
+                                      SharedInitializerStore* shared_initializers,
+                                      concurrency::ThreadPool* thread_pool,
                                       const T& save_tensor_func, const logging::Logger& logger) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   static constexpr int alignment = 256;
@@ -324,6 +378,81 @@ common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PA
     ORT_RETURN_IF_ERROR(mlvalue_name_idx_map.GetIdx(entry.first, mlvalue_index));
     id_to_initialized_tensor[mlvalue_index] = entry.second;
   }
+
+  // use the copy of the CPU initializers that other sessions share, or create one for them to use. the reference
+  // to the shared initializer is released by the deleter when the session is destroyed.
+  // the initializer is created before looking for a shared copy so the key and the comparison use the actual data,
+  // which for external data may have changed since another session read the file.
+  if (shared_initializers) {
+    for (auto it = id_to_initialized_tensor.begin(); it != id_to_initialized_tensor.end();) {
+      const ONNX_NAMESPACE::TensorProto& tensor_proto = *it->second;
+      const auto& location = execution_plan.allocation_plan[it->first].location;
+      if (tensor_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING ||
+          strcmp(location.name, CPU) != 0 || location.mem_type != OrtMemTypeDefault) {
+        ++it;
+        continue;
+      }
+
+      std::unique_ptr<SharedInitializer> new_initializer;
+      Status st = CreateSharedInitializer(env, graph_loc, tensor_proto, location, map_external_initializers,
+                                          shared_initializers->GetAllocator(), new_initializer);
+      if (!st.IsOK()) {
+        return Status(st.Category(), st.Code(),
+                      "Deserialize tensor " + tensor_proto.name() + " failed." + st.ErrorMessage());
+      }
+
+      auto key = SharedInitializerStore::MakeKey(graph_loc, tensor_proto.name(),
+                                                 new_initializer->Value().Get<Tensor>());
+      auto initializer = shared_initializers->Add(key, std::move(new_initializer));
+
+      OrtCallback deleter{ReleaseSharedInitializer, new std::shared_ptr<const SharedInitializer>(initializer)};
+      st = save_tensor_func(it->first, initializer->Value(), deleter);
+      if (!st.IsOK()) {
+        deleter.f(deleter.param);
+        return st;
+      }
+
+      VLOGS(logger, 1) << "Added weight with name : " << tensor_proto.name() << " with index: " << it->first
+                       << " using the shared initializer";
+      it = id_to_initialized_tensor.erase(it);
+    }
+  }
+
+  // use the external data of CPU initializers directly by mapping it into memory, rather than copying it into
+  // the planned weights buffer. fall back to copying if that's not possible.
+  if (map_external_initializers) {
+    for (auto it = id_to_initialized_tensor.begin(); it != id_to_initialized_tensor.end();) {
+      const ONNX_NAMESPACE::TensorProto& tensor_proto = *it->second;
+      const auto& location = execution_plan.allocation_plan[it->first].location;
+      if (tensor_proto.data_location() != ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL ||
+          (strcmp(location.name, CPU) != 0 && location.mem_type != OrtMemTypeCPUOutput)) {
+        ++it;
+        continue;
+      }
+
+      MLValue mlvalue;
+      OrtCallback deleter;
+      Status st = utils::MappedExternalDataTensorProtoToMLValue(env, graph_loc.c_str(), tensor_proto, location,
+                                                                mlvalue, deleter);
+      if (!st.IsOK()) {
+        LOGS(logger, INFO) << "External data for initializer '" << tensor_proto.name()
+                           << "' will be copied as it can't be mapped into memory. " << st.ErrorMessage();
+        ++it;
+        continue;
+      }
+
+      st = save_tensor_func(it->first, mlvalue, deleter);
+      if (!st.IsOK()) {
+        if (deleter.f) deleter.f(deleter.param);
+        return st;
+      }
+
+      VLOGS(logger, 1) << "Added weight with name : " << tensor_proto.name() << " with index: " << it->first
+                       << " using memory mapped external data";
+      it = id_to_initialized_tensor.erase(it);
+    }
+  }
+
   for (const auto& entry : id_to_initialized_tensor) {
     size_t len;
     ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<alignment>(*entry.second, &len));
@@ -334,35 +463,88 @@ common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PA
   MemoryPatternGroup mem_patterns;
   ORT_RETURN_IF_ERROR(planner.GeneratePatterns(&mem_patterns));
   ORT_RETURN_IF_ERROR(AllocatePlannedBuffers(mem_patterns, exec_providers, weights_buffers));
-  OrtCallback deleter;
-  //3. create weight tensors based on weights buffer
-  for (const auto& entry : id_to_initialized_tensor) {
-    int mlvalue_index = entry.first;
-    const char* name = entry.second->has_name() ? entry.second->name().c_str() : "";
-    const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
-
-    auto& location = execution_plan.allocation_plan[mlvalue_index].location;
-    void* buffer = nullptr;
-    size_t len = 0;
-    // TODO: if the tensor need be copied, does it have enough room?
-    ORT_RETURN_IF_ERROR(
-        GetPreallocatedBuffer(mem_patterns, location, mlvalue_index, weights_buffers, name, buffer, len));
+
+  //3. create weight tensors based on weights buffer.
+  // each tensor is deserialized into its own part of the weights buffer, so the tensors on CPU are deserialized in
+  // parallel. the tensors for other devices are deserialized serially as the copy to the device may not be
+  // thread-safe. the tensors are saved in the order of their MLValue index so the result doesn't depend on the
+  // scheduling.
+  std::vector<std::pair<int, const ONNX_NAMESPACE::TensorProto*>> initializers(id_to_initialized_tensor.begin(),
+                                                                               id_to_initialized_tensor.end());
+  std::sort(initializers.begin(), initializers.end(),
+            [](const std::pair<int, const ONNX_NAMESPACE::TensorProto*>& a,
+               const std::pair<int, const ONNX_NAMESPACE::TensorProto*>& b) { return a.first < b.first; });
+
+  const size_t num_initializers = initializers.size();
+  std::vector<MLValue> mlvalues(num_initializers);
+  std::vector<OrtCallback> deleters(num_initializers);
+  std::vector<Status> statuses(num_initializers);
+  std::vector<std::exception_ptr> exceptions(num_initializers);
+
+  auto deserialize = [&](size_t i) {
+    try {
+      int mlvalue_index = initializers[i].first;
+      const ONNX_NAMESPACE::TensorProto& tensor_proto = *initializers[i].second;
+      const char* name = tensor_proto.has_name() ? tensor_proto.name().c_str() : "";
+
+      auto& location = execution_plan.allocation_plan[mlvalue_index].location;
+      void* buffer = nullptr;
+      size_t len = 0;
+      // TODO: if the tensor need be copied, does it have enough room?
+      statuses[i] = GetPreallocatedBuffer(mem_patterns, location, mlvalue_index, weights_buffers, name, buffer, len);
+      if (!statuses[i].IsOK()) {
+        return;
+      }
 #ifndef NDEBUG
-    ORT_ENFORCE(buffer != nullptr || len == 0);
+      ORT_ENFORCE(buffer != nullptr || len == 0);
 #endif
 
-    MemBuffer m(buffer, len, location);
-    MLValue mlvalue;
-    Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, m, exec_providers, mlvalue, deleter);
-    if (!st.IsOK()) {
-      std::ostringstream oss;
-      oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
-      return Status(st.Category(), st.Code(), oss.str());
+      MemBuffer m(buffer, len, location);
+      Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, m, exec_providers, mlvalues[i], deleters[i]);
+      if (!st.IsOK()) {
+        std::ostringstream oss;
+        oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
+        statuses[i] = Status(st.Category(), st.Code(), oss.str());
+      }
+    } catch (...) {
+      exceptions[i] = std::current_exception();
+    }
+  };
+
+  std::vector<size_t> cpu_initializers;
+  for (size_t i = 0; i < num_initializers; ++i) {
+    const auto& location = execution_plan.allocation_plan[initializers[i].first].location;
+    if (strcmp(location.name, CPU) == 0 || location.mem_type == OrtMemTypeCPUOutput) {
+      cpu_initializers.push_back(i);
+    } else {
+      deserialize(i);
+    }
+  }
+
+  concurrency::ThreadPool::TryParallelFor(thread_pool, static_cast<int32_t>(cpu_initializers.size()),
+                                          [&](int32_t i) { deserialize(cpu_initializers[i]); });
+
+  for (size_t i = 0; i < num_initializers; ++i) {
+    Status st = statuses[i];
+    if (exceptions[i] == nullptr && st.IsOK()) {
+      st = save_tensor_func(initializers[i].first, mlvalues[i], deleters[i]);
     }
 
-    ORT_RETURN_IF_ERROR(save_tensor_func(mlvalue_index, mlvalue, deleter));
+    if (exceptions[i] != nullptr || !st.IsOK()) {
+      // release the tensors that weren't saved
+      for (size_t j = i; j < num_initializers; ++j) {
+        if (deleters[j].f) deleters[j].f(deleters[j].param);
+      }
 
-    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << mlvalue_index;
+      if (exceptions[i] != nullptr) {
+        std::rethrow_exception(exceptions[i]);
+      }
+
+      return st;
+    }
+
+    VLOGS(logger, 1) << "Added weight with name : " << initializers[i].second->name()
+                     << " with index: " << initializers[i].first;
   }
 
   LOGS(logger, INFO) << "Done saving initialized tensors";
@@ -394,14 +576,50 @@ static common::Status CreateOpKernel(const onnxruntime::Node& node, const Execut
 common::Status SaveKernels(const ExecutionProviders& execution_providers,
                            SessionState& session_state,
                            const KernelRegistryManager& custom_registry_manager,
+                           concurrency::ThreadPool* thread_pool,
                            const logging::Logger& logger) {
   LOGS(logger, INFO) << "Saving kernels.";
 
+  std::vector<const Node*> nodes;
   for (auto& node : session_state.GetGraphViewer()->Nodes()) {
-    // construct and save the kernels
-    std::unique_ptr<OpKernel> op_kernel;
-    ORT_RETURN_IF_ERROR(CreateOpKernel(node, execution_providers, session_state, custom_registry_manager, op_kernel));
-    session_state.AddKernel(node.Index(), std::move(op_kernel));
+    nodes.push_back(&node);
+  }
+
+  const size_t num_nodes = nodes.size();
+  std::vector<std::unique_ptr<OpKernel>> kernels(num_nodes);
+  std::vector<Status> statuses(num_nodes);
+  std::vector<std::exception_ptr> exceptions(num_nodes);
+
+  auto create_kernel = [&](size_t i) {
+    try {
+      statuses[i] = CreateOpKernel(*nodes[i], execution_providers, session_state, custom_registry_manager, kernels[i]);
+    } catch (...) {
+      exceptions[i] = std::current_exception();
+    }
+  };
+
+  // the CPU kernels are constructed in parallel. the kernels of other execution providers are constructed
+  // serially, as their constructors may use the device or compile fused nodes and aren't known to be thread-safe.
+  std::vector<size_t> cpu_nodes;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    if (nodes[i]->GetExecutionProviderType() == kCpuExecutionProvider) {
+      cpu_nodes.push_back(i);
+    } else {
+      create_kernel(i);
+    }
+  }
+
+  concurrency::ThreadPool::TryParallelFor(thread_pool, static_cast<int32_t>(cpu_nodes.size()),
+                                          [&](int32_t i) { create_kernel(cpu_nodes[i]); });
+
+  // save the kernels in node order, and report the error of the first node that failed
+  for (size_t i = 0; i < num_nodes; ++i) {
+    if (exceptions[i] != nullptr) {
+      std::rethrow_exception(exceptions[i]);
+    }
+
+    ORT_RETURN_IF_ERROR(statuses[i]);
+    session_state.AddKernel(nodes[i]->Index(), std::move(kernels[i]));
   }
 
   LOGS(logger, INFO) << "Done saving kernels.";
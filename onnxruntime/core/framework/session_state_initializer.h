@@ -38,7 +38,13 @@ class SessionStateInitializer {
 
   // initialize tensors, and save. save kernels and input/output node mappings
   // \param implicit_inputs could be NULL
-  common::Status InitializeAndSave(const std::vector<NodeArg*>* implicit_inputs);
+  // \param map_external_initializers use the external data of initializers by mapping it into memory instead of
+  //                                  copying it, where possible.
+  // \param share_initializers use the initializers on CPU from Environment::GetSharedInitializerStore, and add
+  //                           the ones that aren't there yet, instead of creating copies owned by the session.
+  common::Status InitializeAndSave(const std::vector<NodeArg*>* implicit_inputs,
+                                   bool map_external_initializers = false,
+                                   bool share_initializers = false);
 
  private:
   const std::basic_string<PATH_CHAR_TYPE>& graph_loc_;
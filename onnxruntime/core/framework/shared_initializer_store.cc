@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializer_store.h"
+
+#include <cstring>
+#include <functional>
+
+#include "core/framework/allocator.h"
+
+namespace onnxruntime {
+
+static void HashCombine(size_t& seed, size_t value) {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+SharedInitializerStore::SharedInitializerStore() : allocator_{std::make_shared<CPUAllocator>()} {}
+
+SharedInitializerStore::Key SharedInitializerStore::MakeKey(const std::basic_string<PATH_CHAR_TYPE>& model_path,
+                                                            const std::string& name, const Tensor& tensor) {
+  size_t hash = std::hash<const void*>{}(tensor.DataType());
+  for (auto dim : tensor.Shape().GetDims()) {
+    HashCombine(hash, std::hash<int64_t>{}(dim));
+  }
+
+  // hash the data a word at a time
+  const size_t size = tensor.Size();
+  const auto* data = static_cast<const char*>(tensor.DataRaw());
+  size_t i = 0;
+  for (; i + sizeof(size_t) <= size; i += sizeof(size_t)) {
+    size_t word;
+    memcpy(&word, data + i, sizeof(size_t));
+    HashCombine(hash, word);
+  }
+
+  for (; i < size; ++i) {
+    HashCombine(hash, static_cast<size_t>(static_cast<unsigned char>(data[i])));
+  }
+
+  return Key{model_path, name, hash};
+}
+
+static bool HasSameContent(const SharedInitializer& a, const SharedInitializer& b) {
+  const auto& tensor_a = a.Value().Get<Tensor>();
+  const auto& tensor_b = b.Value().Get<Tensor>();
+  if (tensor_a.DataType() != tensor_b.DataType() || tensor_a.Shape() != tensor_b.Shape()) {
+    return false;
+  }
+
+  const size_t size = tensor_a.Size();
+  return size == 0 || memcmp(tensor_a.DataRaw(), tensor_b.DataRaw(), size) == 0;
+}
+
+std::shared_ptr<const SharedInitializer> SharedInitializerStore::Add(const Key& key,
+                                                                     std::unique_ptr<SharedInitializer> initializer) {
+  std::shared_ptr<const SharedInitializer> added{std::move(initializer)};
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto& entry = initializers_[key];
+  auto existing = entry.lock();
+  if (existing) {
+    // the hash matched, but only share the initializer if the content does too
+    return HasSameContent(*existing, *added) ? existing : added;
+  }
+
+  entry = added;
+
+  // drop the entries of initializers that are no longer used by any session
+  for (auto it = initializers_.begin(); it != initializers_.end();) {
+    if (it->second.expired()) {
+      it = initializers_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  return added;
+}
+
+size_t SharedInitializerStore::Size() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  size_t size = 0;
+  for (const auto& entry : initializers_) {
+    if (!entry.second.expired()) {
+      ++size;
+    }
+  }
+
+  return size;
+}
+}  // namespace onnxruntime
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/framework/callback.h"
+#include "core/framework/ml_value.h"
+#include "core/framework/path_lib.h"
+#include "core/framework/tensor.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// An immutable initializer on CPU that is shared by the sessions that load the same weights.
+// The buffer and the deleter are released when the last session using it releases its reference.
+class SharedInitializer {
+ public:
+  SharedInitializer(const MLValue& value, BufferUniquePtr buffer, const OrtCallback& deleter)
+      : value_{value}, buffer_{std::move(buffer)}, deleter_(deleter) {}
+
+  ~SharedInitializer() {
+    if (deleter_.f) deleter_.f(deleter_.param);
+  }
+
+  const MLValue& Value() const { return value_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedInitializer);
+
+  MLValue value_;
+  BufferUniquePtr buffer_;
+  OrtCallback deleter_;
+};
+
+/**
+  * Store of the initializers shared between sessions, so that a process hosting many sessions of the same model
+  * keeps a single copy of each weight.
+  * Initializers are keyed by model path, tensor name and a hash of the tensor content. The content of an initializer
+  * is compared with the content of the one in the store before it's shared, so a hash collision doesn't share
+  * different weights. The store only holds weak references; each session holds a reference to the initializers it
+  * uses, so an initializer is released when the last session using it is destroyed.
+  * The store is thread-safe.
+  */
+class SharedInitializerStore {
+ public:
+  struct Key {
+    std::basic_string<PATH_CHAR_TYPE> model_path;
+    std::string name;
+    size_t content_hash;
+
+    bool operator<(const Key& other) const {
+      if (content_hash != other.content_hash) return content_hash < other.content_hash;
+      if (name != other.name) return name < other.name;
+      return model_path < other.model_path;
+    }
+  };
+
+  SharedInitializerStore();
+
+  // The hash covers the data type, the shape and the data of tensor, so for external data it's the content of the
+  // file rather than its location.
+  static Key MakeKey(const std::basic_string<PATH_CHAR_TYPE>& model_path, const std::string& name,
+                     const Tensor& tensor);
+
+  // The allocator for the buffers of new shared initializers. It's independent of any session.
+  const AllocatorPtr& GetAllocator() const { return allocator_; }
+
+  // Add initializer for key.
+  // If a session holds an initializer with the same key and content, that initializer is returned and the one passed
+  // in is released. If the content differs the hash collided, and the initializer passed in is returned without
+  // being shared.
+  std::shared_ptr<const SharedInitializer> Add(const Key& key, std::unique_ptr<SharedInitializer> initializer);
+
+  // Number of initializers that are currently held by a session.
+  size_t Size() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedInitializerStore);
+
+  AllocatorPtr allocator_;
+
+  mutable OrtMutex mutex_;
+  std::map<Key, std::weak_ptr<const SharedInitializer>> initializers_;
+};
+}  // namespace onnxruntime
@@ -0,0 +1,173 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/symbolic_mem_pattern_planner.h"
+
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+#include "core/framework/allocator.h"
+#include "core/framework/ml_value_patterns_planner.h"
+#include "core/framework/mlvalue_name_idx_map.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/framework/tensor.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+// tensors that are allocated during execution and traced by ExecutionFrame. strings are not traced.
+static bool IsTracedValue(const AllocPlanPerValue& alloc_plan) {
+  if (alloc_plan.alloc_kind != AllocKind::kAllocate || alloc_plan.value_type == nullptr ||
+      !alloc_plan.value_type->IsTensorType()) {
+    return false;
+  }
+
+  auto element_type = static_cast<const TensorTypeBase*>(alloc_plan.value_type)->GetElementType();
+  return element_type != DataTypeImpl::GetType<std::string>();
+}
+
+Status SymbolicMemPatternPlanner::Create(const GraphViewer& graph_viewer,
+                                         const SequentialExecutionPlan& execution_plan,
+                                         const MLValueNameIdxMap& mlvalue_name_idx_map,
+                                         std::unique_ptr<SymbolicMemPatternPlanner>& planner) {
+  planner = nullptr;
+
+  std::unique_ptr<SymbolicMemPatternPlanner> new_planner{new SymbolicMemPatternPlanner(execution_plan)};
+
+  // the graph input dims that each symbolic dim can be resolved from
+  std::unordered_map<std::string, Symbol> symbol_sources;
+  for (const auto* input : graph_viewer.GetInputs()) {
+    const auto* shape = input->Shape();
+    if (shape == nullptr) {
+      continue;
+    }
+
+    int mlvalue_idx;
+    ORT_RETURN_IF_ERROR(mlvalue_name_idx_map.GetIdx(input->Name(), mlvalue_idx));
+
+    for (int axis = 0, end = shape->dim_size(); axis < end; ++axis) {
+      const auto& dim = shape->dim(axis);
+      if (dim.has_dim_param() && symbol_sources.find(dim.dim_param()) == symbol_sources.end()) {
+        symbol_sources[dim.dim_param()] = Symbol{mlvalue_idx, static_cast<size_t>(axis)};
+      }
+    }
+  }
+
+  // the symbolic dims used by the planned values. index is the symbol id
+  std::unordered_map<std::string, size_t> symbol_ids;
+
+  const auto& allocation_plan = execution_plan.allocation_plan;
+  std::vector<bool> is_traced(allocation_plan.size(), false);
+
+  for (const auto& node_plan : execution_plan.execution_plan) {
+    const auto* node = graph_viewer.GetNode(node_plan.node_index);
+    ORT_ENFORCE(node, "Node not found in graph. Index:", node_plan.node_index);
+
+    for (const auto* output_def : node->OutputDefs()) {
+      if (!output_def->Exists()) {
+        continue;
+      }
+
+      int mlvalue_idx;
+      ORT_RETURN_IF_ERROR(mlvalue_name_idx_map.GetIdx(output_def->Name(), mlvalue_idx));
+      const auto& alloc_plan = allocation_plan[mlvalue_idx];
+      if (!IsTracedValue(alloc_plan)) {
+        continue;
+      }
+
+      const auto* shape = output_def->Shape();
+      if (shape == nullptr) {
+        return Status::OK();
+      }
+
+      ValueSize value_size{static_cast<const TensorTypeBase*>(alloc_plan.value_type)->GetElementType()->Size(), 1, {}};
+      for (const auto& dim : shape->dim()) {
+        if (dim.has_dim_value()) {
+          value_size.num_static_elements *= dim.dim_value();
+        } else if (dim.has_dim_param() && symbol_sources.find(dim.dim_param()) != symbol_sources.end()) {
+          auto id = symbol_ids.find(dim.dim_param());
+          if (id == symbol_ids.end()) {
+            id = symbol_ids.insert({dim.dim_param(), new_planner->symbols_.size()}).first;
+            new_planner->symbols_.push_back(symbol_sources[dim.dim_param()]);
+          }
+
+          value_size.symbols.push_back(id->second);
+        } else {
+          // the size of this value can't be calculated before it is produced during execution
+          return Status::OK();
+        }
+      }
+
+      new_planner->steps_.push_back({false, mlvalue_idx, new_planner->values_.size()});
+      new_planner->values_.push_back(std::move(value_size));
+      is_traced[mlvalue_idx] = true;
+    }
+
+    for (int i = node_plan.free_from_index; i <= node_plan.free_to_index; ++i) {
+      auto mlvalue_idx = execution_plan.to_be_freed[i];
+      if (is_traced[mlvalue_idx]) {
+        new_planner->steps_.push_back({true, mlvalue_idx, 0});
+      }
+    }
+  }
+
+  planner = std::move(new_planner);
+  return Status::OK();
+}
+
+Status SymbolicMemPatternPlanner::GeneratePatterns(const std::vector<int>& feed_mlvalue_idxs,
+                                                   const std::vector<MLValue>& feeds,
+                                                   MemoryPatternGroup* out) const {
+  if (!out) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT);
+  }
+
+  std::vector<int64_t> symbol_values;
+  symbol_values.reserve(symbols_.size());
+  for (const auto& symbol : symbols_) {
+    const Tensor* input = nullptr;
+    for (size_t i = 0, end = feed_mlvalue_idxs.size(); i < end; ++i) {
+      if (feed_mlvalue_idxs[i] == symbol.mlvalue_idx && feeds[i].IsTensor()) {
+        input = &feeds[i].Get<Tensor>();
+        break;
+      }
+    }
+
+    if (input == nullptr || input->Shape().NumDimensions() <= symbol.axis) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Input dim for symbolic dim was not provided. MLValue index:",
+                             symbol.mlvalue_idx, " axis:", symbol.axis);
+    }
+
+    symbol_values.push_back(input->Shape()[symbol.axis]);
+  }
+
+  MLValuePatternPlanner planner{execution_plan_};
+  for (const auto& step : steps_) {
+    if (step.is_free) {
+      ORT_RETURN_IF_ERROR(planner.TraceFree(step.mlvalue_idx));
+      continue;
+    }
+
+    const auto& value_size = values_[step.value];
+    int64_t len = value_size.num_static_elements;
+    for (auto symbol : value_size.symbols) {
+      auto dim = symbol_values[symbol];
+      if (dim < 0 || (dim > 0 && len > std::numeric_limits<int64_t>::max() / dim)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Invalid size for MLValue index:", step.mlvalue_idx);
+      }
+
+      len *= dim;
+    }
+
+    size_t size;
+    if (!IAllocator::CalcMemSizeForArrayWithAlignment<64>(static_cast<size_t>(len), value_size.element_size, &size)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Size overflow for MLValue index:", step.mlvalue_idx);
+    }
+
+    ORT_RETURN_IF_ERROR(planner.TraceAllocation(step.mlvalue_idx, size));
+  }
+
+  return planner.GeneratePatterns(out);
+}
+}  // namespace onnxruntime
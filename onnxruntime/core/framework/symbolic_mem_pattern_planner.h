@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/ml_value.h"
+
+namespace onnxruntime {
+class GraphViewer;
+class MLValueNameIdxMap;
+struct MemoryPatternGroup;
+struct SequentialExecutionPlan;
+
+// SymbolicMemPatternPlanner generates a memory pattern from the shapes inferred for the graph, instead of by
+// tracing the allocations made during a run.
+// The size of each value allocated during execution is stored as a formula of the graph input dims. Symbolic dims
+// are resolved using the graph input dims with the same dim_param. Given the feeds for a run, the sizes are
+// evaluated and the allocations and frees from the execution plan are replayed to generate the pattern, so a new
+// set of input shapes doesn't need a warm-up run.
+class SymbolicMemPatternPlanner {
+ public:
+  // Create a planner for the graph.
+  // planner is set to nullptr if the size of some value allocated during execution can't be expressed in terms
+  // of the graph input dims.
+  static Status Create(const GraphViewer& graph_viewer,
+                       const SequentialExecutionPlan& execution_plan,
+                       const MLValueNameIdxMap& mlvalue_name_idx_map,
+                       std::unique_ptr<SymbolicMemPatternPlanner>& planner);
+
+  // Generate the memory patterns for the given feeds.
+  // Returns an error if the feeds don't provide all the input dims that are required.
+  Status GeneratePatterns(const std::vector<int>& feed_mlvalue_idxs,
+                          const std::vector<MLValue>& feeds,
+                          MemoryPatternGroup* out) const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SymbolicMemPatternPlanner);
+
+  explicit SymbolicMemPatternPlanner(const SequentialExecutionPlan& execution_plan)
+      : execution_plan_{execution_plan} {}
+
+  // a symbolic dim, and the graph input dim it is resolved from
+  struct Symbol {
+    int mlvalue_idx;
+    size_t axis;
+  };
+
+  // the number of elements is num_static_elements multiplied by the value of each symbol in symbols
+  struct ValueSize {
+    size_t element_size;
+    int64_t num_static_elements;
+    std::vector<size_t> symbols;
+  };
+
+  // an allocation of the MLValue with index mlvalue_idx, with the size from values_[value], or a free of it.
+  // the steps are in execution order.
+  struct TraceStep {
+    bool is_free;
+    int mlvalue_idx;
+    size_t value;
+  };
+
+  const SequentialExecutionPlan& execution_plan_;
+  std::vector<Symbol> symbols_;
+  std::vector<ValueSize> values_;
+  std::vector<TraceStep> steps_;
+};
+}  // namespace onnxruntime
@@ -400,6 +400,53 @@ ORT_API(void, OrtUninitializeBuffer, _In_opt_ void* input, size_t input_len, enu
 }
 
 
+// get the path of the file with the external data for tensor_proto, and the offset and length of the data in it.
+// length is 0 if it wasn't specified.
+static Status GetExternalDataLocation(const ORTCHAR_T* tensor_proto_path,
+                                      const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                      std::basic_string<ORTCHAR_T>& full_path, size_t& offset, size_t& length) {
+  std::unique_ptr<ExternalDataInfo> external_data_info;
+  ORT_RETURN_IF_ERROR(ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info));
+  if (external_data_info->GetOffset() < 0 || external_data_info->GetLength() < 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Invalid external data offset or length");
+  }
+
+  if (tensor_proto_path != nullptr) {
+    ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(tensor_proto_path, full_path));
+    full_path = ConcatPathComponent<ORTCHAR_T>(full_path, external_data_info->GetRelPath());
+  } else {
+    full_path = external_data_info->GetRelPath();
+  }
+
+  offset = static_cast<size_t>(external_data_info->GetOffset());
+  length = static_cast<size_t>(external_data_info->GetLength());
+  return Status::OK();
+}
+
+#define CASE_ELEMENT_TYPE(X, Y)                                        \
+  case ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_##X: \
+    return DataTypeImpl::GetType<Y>();
+
+static MLDataType GetElementType(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  switch (tensor_proto.data_type()) {
+    CASE_ELEMENT_TYPE(FLOAT, float);
+    CASE_ELEMENT_TYPE(DOUBLE, double);
+    CASE_ELEMENT_TYPE(BOOL, bool);
+    CASE_ELEMENT_TYPE(INT8, int8_t);
+    CASE_ELEMENT_TYPE(INT16, int16_t);
+    CASE_ELEMENT_TYPE(INT32, int32_t);
+    CASE_ELEMENT_TYPE(INT64, int64_t);
+    CASE_ELEMENT_TYPE(UINT8, uint8_t);
+    CASE_ELEMENT_TYPE(UINT16, uint16_t);
+    CASE_ELEMENT_TYPE(UINT32, uint32_t);
+    CASE_ELEMENT_TYPE(UINT64, uint64_t);
+    CASE_ELEMENT_TYPE(FLOAT16, MLFloat16);
+    CASE_ELEMENT_TYPE(BFLOAT16, BFloat16);
+    default:
+      return nullptr;
+  }
+}
+
 Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
                             const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer& m, MLValue& value,
                             OrtCallback& deleter) {
@@ -432,23 +479,19 @@ Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
       if (ele_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING)
         return Status(common::ONNXRUNTIME, common::FAIL, "string tensor can not have raw data");
 
-      std::unique_ptr<ExternalDataInfo> external_data_info;
-      ORT_RETURN_IF_ERROR(ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info));
-      if (external_data_info->GetOffset() > 0) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Cannot support tensor data with offset > 0");
-      }
       std::basic_string<ORTCHAR_T> full_path;
-      if (tensor_proto_path != nullptr) {
-        ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(tensor_proto_path, full_path));
-        full_path = ConcatPathComponent<ORTCHAR_T>(full_path, external_data_info->GetRelPath());
-      } else {
-        full_path = external_data_info->GetRelPath();
-      }
+      size_t offset;
+      size_t length;
+      ORT_RETURN_IF_ERROR(GetExternalDataLocation(tensor_proto_path, tensor_proto, full_path, offset, length));
 
       // load the file
       ORT_RETURN_IF_ERROR(env.ReadFileAsString(full_path.c_str(), &raw_data_from_file));
-      raw_data = raw_data_from_file.data();
-      raw_data_len = raw_data_from_file.size();
+      if (offset > raw_data_from_file.size() || (length > 0 && length > raw_data_from_file.size() - offset)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "External data offset ", offset, " and length ", length,
+                               " are out of range for file with size ", raw_data_from_file.size());
+      }
+      raw_data = raw_data_from_file.data() + offset;
+      raw_data_len = length > 0 ? length : raw_data_from_file.size() - offset;
     } else if (tensor_proto.has_raw_data()) {
       if (ele_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING)
         return Status(common::ONNXRUNTIME, common::FAIL, "string tensor can not have raw data");
@@ -483,6 +526,58 @@ Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
   return Status::OK();
 }
 
+Status MappedExternalDataTensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
+                                              const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                              const OrtAllocatorInfo& alloc_info, MLValue& value,
+                                              OrtCallback& deleter) {
+  deleter.f = nullptr;
+  deleter.param = nullptr;
+
+  if (tensor_proto.data_location() != TensorProto_DataLocation_EXTERNAL) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Tensor does not have external data");
+  }
+
+  // the data is used as-is, so it must already be in the format of the tensor in memory
+  MLDataType element_type = GetElementType(tensor_proto);
+  if (element_type == nullptr || !IsLittleEndianOrder()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "External data of type ", tensor_proto.data_type(),
+                           " can't be used directly");
+  }
+
+  std::basic_string<ORTCHAR_T> full_path;
+  size_t offset;
+  size_t length;
+  ORT_RETURN_IF_ERROR(GetExternalDataLocation(tensor_proto_path, tensor_proto, full_path, offset, length));
+
+  // the mapped memory is page aligned, so data at an offset that is a multiple of the element size is aligned
+  if (offset % element_type->Size() != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "External data offset ", offset,
+                           " is not aligned for elements of size ", element_type->Size());
+  }
+
+  TensorShape tensor_shape{GetTensorShapeFromTensorProto(tensor_proto)};
+  size_t tensor_length;
+  if (tensor_shape.Size() < 0 ||
+      !IAllocator::CalcMemSizeForArrayWithAlignment<0>(static_cast<size_t>(tensor_shape.Size()), element_type->Size(),
+                                                       &tensor_length)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid shape ", tensor_shape);
+  }
+
+  if (length > 0 && length != tensor_length) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "External data length ", length, " does not match the tensor size ",
+                           tensor_length);
+  }
+
+  void* mapped_memory;
+  ORT_RETURN_IF_ERROR(env.MapFileIntoMemory(full_path.c_str(), offset, tensor_length, &mapped_memory, deleter));
+
+  std::unique_ptr<Tensor> p_tensor = std::make_unique<Tensor>(element_type, tensor_shape, mapped_memory, alloc_info);
+  value.Init(p_tensor.release(),
+             DataTypeImpl::GetType<Tensor>(),
+             DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return Status::OK();
+}
+
 ONNXTensorElementDataType GetTensorElementType(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
   switch (tensor_proto.data_type()) {
     case TensorProto_DataType_FLOAT:
@@ -556,6 +651,27 @@ TensorProto::DataType GetTensorProtoType(const Tensor& tensor) {
   return dtype;
 }
 
+TensorProto TensorToTensorProto(const Tensor& tensor, const std::string& tensor_proto_name) {
+  TensorProto tensor_proto;
+  tensor_proto.set_name(tensor_proto_name);
+  for (auto dim : tensor.Shape().GetDims()) {
+    tensor_proto.add_dims(dim);
+  }
+
+  if (tensor.DataType() == DataTypeImpl::GetType<std::string>()) {
+    tensor_proto.set_data_type(TensorProto_DataType_STRING);
+    const auto* data = tensor.Data<std::string>();
+    for (int64_t i = 0, end = tensor.Shape().Size(); i < end; ++i) {
+      tensor_proto.add_string_data(data[i]);
+    }
+  } else {
+    tensor_proto.set_data_type(GetTensorProtoType(tensor));
+    tensor_proto.set_raw_data(tensor.DataRaw(), tensor.Size());
+  }
+
+  return tensor_proto;
+}
+
 template common::Status GetSizeInBytesFromTensorProto<256>(const ONNX_NAMESPACE::TensorProto& tensor_proto,
                                                            size_t* out);
 template common::Status GetSizeInBytesFromTensorProto<0>(const ONNX_NAMESPACE::TensorProto& tensor_proto, size_t* out);
@@ -34,9 +34,26 @@ std::vector<int64_t> GetTensorShapeFromTensorShapeProto(const ONNX_NAMESPACE::Te
 common::Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
                                     const ONNX_NAMESPACE::TensorProto& input, const MemBuffer& m, MLValue& value,
                                     OrtCallback& deleter);
+
+/**
+ * Create a tensor for a TensorProto with external data, using the data mapped into memory from the file instead of
+ * copying it into a buffer. The mapping is copy-on-write, so writes to the tensor data are not written to the file.
+ * \param deleter Unmaps the memory. Must be run after the tensor is no longer used.
+ * Returns NOT_IMPLEMENTED if the data can't be used directly. e.g. for a string tensor, if the data is not aligned
+ * for the element type, or if the platform doesn't support mapping files into memory.
+ */
+common::Status MappedExternalDataTensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
+                                                      const ONNX_NAMESPACE::TensorProto& input,
+                                                      const OrtAllocatorInfo& alloc_info, MLValue& value,
+                                                      OrtCallback& deleter);
+
 // This function doesn't support string tensors
 ONNX_NAMESPACE::TensorProto::DataType GetTensorProtoType(const Tensor& tensor);
 
+// Create a TensorProto with the data of tensor. Non-string data is stored in raw_data.
+// The data type of the TensorProto is UNDEFINED if the element type of tensor isn't supported.
+ONNX_NAMESPACE::TensorProto TensorToTensorProto(const Tensor& tensor, const std::string& tensor_proto_name);
+
 ONNXTensorElementDataType GetTensorElementType(const ONNX_NAMESPACE::TensorProto& tensor_proto);
 
 // How much memory it will need for putting the content of this tensor into a plain array
@@ -441,17 +441,23 @@ static DeviceCopyCheck CheckExecutionProviders(const ExecutionProviders& executi
   return all_cpu ? DeviceCopyCheck::NoCopy : DeviceCopyCheck::Unknown;
 }
 
-// execute graph with cached info from FeedsFetchesManager.
-common::Status ExecuteGraphWithCachedInfo(const SessionState& session_state,
-                                          const FeedsFetchesManager& feeds_fetches_manager,
+// run the executor for the graph, reusing the ExecutionFrame in reusable_frame if provided.
+static common::Status ExecuteWithExecutor(const SessionState& session_state,
+                                          const std::vector<int>& feed_mlvalue_idxs,
                                           const std::vector<MLValue>& feeds,
+                                          const std::vector<int>& fetch_mlvalue_idxs,
                                           std::vector<MLValue>& fetches,
                                           const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                                           bool sequential_execution,
                                           const bool& terminate_flag,
-                                          const logging::Logger& logger) {
-  const auto& feeds_fetches_info = feeds_fetches_manager.GetFeedsFetchesInfo();
-  auto device_copy_checks = feeds_fetches_manager.GetDeviceCopyChecks();
+                                          const logging::Logger& logger,
+                                          std::unique_ptr<ExecutionFrame>* reusable_frame) {
+  if (reusable_frame) {
+    ORT_ENFORCE(sequential_execution, "An ExecutionFrame can only be reused with sequential execution.");
+    SequentialExecutor executor(terminate_flag);
+    return executor.Execute(session_state, feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators,
+                            *reusable_frame, logger);
+  }
 
   std::unique_ptr<IExecutor> p_exec;
   if (sequential_execution) {
@@ -460,11 +466,29 @@ common::Status ExecuteGraphWithCachedInfo(const SessionState& session_state,
     p_exec = std::unique_ptr<IExecutor>(new ParallelExecutor(session_state, terminate_flag));
   }
 
+  return p_exec->Execute(session_state, feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators,
+                         logger);
+}
+
+// execute graph with cached info from FeedsFetchesManager.
+common::Status ExecuteGraphWithCachedInfo(const SessionState& session_state,
+                                          const FeedsFetchesManager& feeds_fetches_manager,
+                                          const std::vector<MLValue>& feeds,
+                                          std::vector<MLValue>& fetches,
+                                          const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                                          bool sequential_execution,
+                                          const bool& terminate_flag,
+                                          const logging::Logger& logger,
+                                          std::unique_ptr<ExecutionFrame>* reusable_frame) {
+  const auto& feeds_fetches_info = feeds_fetches_manager.GetFeedsFetchesInfo();
+  auto device_copy_checks = feeds_fetches_manager.GetDeviceCopyChecks();
+
   if (device_copy_checks.status == DeviceCopyCheck::NoCopy) {
     // no device copies are needed so simple execute
-    ORT_RETURN_IF_ERROR(p_exec->Execute(session_state,
-                                        feeds_fetches_info.feeds_mlvalue_idxs, feeds,
-                                        feeds_fetches_info.fetches_mlvalue_idxs, fetches, fetch_allocators, logger));
+    ORT_RETURN_IF_ERROR(ExecuteWithExecutor(session_state,
+                                            feeds_fetches_info.feeds_mlvalue_idxs, feeds,
+                                            feeds_fetches_info.fetches_mlvalue_idxs, fetches, fetch_allocators,
+                                            sequential_execution, terminate_flag, logger, reusable_frame));
   } else {
     const std::vector<MLValue>* p_feeds = &feeds;
     std::vector<MLValue>* p_fetches = &fetches;
@@ -491,10 +515,10 @@ common::Status ExecuteGraphWithCachedInfo(const SessionState& session_state,
       p_fetches = &device_fetches;
     }
 
-    ORT_RETURN_IF_ERROR(p_exec->Execute(session_state,
-                                        feeds_fetches_info.feeds_mlvalue_idxs, *p_feeds,
-                                        feeds_fetches_info.fetches_mlvalue_idxs, *p_fetches, fetch_allocators,
-                                        logger));
+    ORT_RETURN_IF_ERROR(ExecuteWithExecutor(session_state,
+                                            feeds_fetches_info.feeds_mlvalue_idxs, *p_feeds,
+                                            feeds_fetches_info.fetches_mlvalue_idxs, *p_fetches, fetch_allocators,
+                                            sequential_execution, terminate_flag, logger, reusable_frame));
 
     if (device_copy_checks.output_copy_needed == DeviceCopyCheck::Copy) {
       ORT_RETURN_IF_ERROR(CachedCopyOutputsAcrossDevices(*p_fetches, fetches,
@@ -514,28 +538,23 @@ common::Status ExecuteGraph(const SessionState& session_state,
                             bool sequential_execution,
                             const bool& terminate_flag,
                             const logging::Logger& logger,
-                            bool cache_copy_info) {
+                            bool cache_copy_info,
+                            std::unique_ptr<ExecutionFrame>* reusable_frame) {
   const auto& feeds_fetches_info = feeds_fetches_manager.GetFeedsFetchesInfo();
   auto device_copy_checks = feeds_fetches_manager.GetDeviceCopyChecks();
 
   ORT_ENFORCE(device_copy_checks.status == DeviceCopyCheck::Unknown);
 
-  std::unique_ptr<IExecutor> p_exec;
-  if (sequential_execution) {
-    p_exec = std::unique_ptr<IExecutor>(new SequentialExecutor(terminate_flag));
-  } else {
-    p_exec = std::unique_ptr<IExecutor>(new ParallelExecutor(session_state, terminate_flag));
-  }
-
   // see if we can skip copies due to the types of execution providers available
   if (CheckExecutionProviders(session_state.GetExecutionProviders()) == DeviceCopyCheck::NoCopy) {
     device_copy_checks.input_copy_needed = DeviceCopyCheck::NoCopy;
     device_copy_checks.output_copy_needed = DeviceCopyCheck::NoCopy;
 
     // no device copies are needed so simple execute
-    ORT_RETURN_IF_ERROR(p_exec->Execute(session_state,
-                                        feeds_fetches_info.feeds_mlvalue_idxs, feeds,
-                                        feeds_fetches_info.fetches_mlvalue_idxs, fetches, fetch_allocators, logger));
+    ORT_RETURN_IF_ERROR(ExecuteWithExecutor(session_state,
+                                            feeds_fetches_info.feeds_mlvalue_idxs, feeds,
+                                            feeds_fetches_info.fetches_mlvalue_idxs, fetches, fetch_allocators,
+                                            sequential_execution, terminate_flag, logger, reusable_frame));
   } else {
     bool copy_needed = false;
 
@@ -571,10 +590,10 @@ common::Status ExecuteGraph(const SessionState& session_state,
                                                use_provided_fetch_flags));
     p_fetches = &device_fetches;
 
-    ORT_RETURN_IF_ERROR(p_exec->Execute(session_state,
-                                        feeds_fetches_info.feeds_mlvalue_idxs, *p_feeds,
-                                        feeds_fetches_info.fetches_mlvalue_idxs, *p_fetches, fetch_allocators,
-                                        logger));
+    ORT_RETURN_IF_ERROR(ExecuteWithExecutor(session_state,
+                                            feeds_fetches_info.feeds_mlvalue_idxs, *p_feeds,
+                                            feeds_fetches_info.fetches_mlvalue_idxs, *p_fetches, fetch_allocators,
+                                            sequential_execution, terminate_flag, logger, reusable_frame));
 
     copiers = cache_copy_info ? &feeds_fetches_manager.GetMutableFetchesDeviceCopiers() : nullptr;
     ORT_RETURN_IF_ERROR(CopyOutputsAcrossDevices(session_state, *p_fetches, fetches, copy_needed, copiers));
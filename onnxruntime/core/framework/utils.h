@@ -11,6 +11,7 @@
 #include "core/framework/session_state.h"
 
 namespace onnxruntime {
+class ExecutionFrame;
 class ExecutionProviders;
 class FeedsFetchesManager;
 class Graph;
@@ -45,6 +46,8 @@ common::Status CopyOneInputAcrossDevices(const SessionState& session_state,
 
 // ExecuteGraph, writing cache info to FeedsFetchesManager to optimize feed and fetch usage across invocations when the
 // order and location of the feeds and fetches is unchanged.
+// If reusable_frame is provided the graph is executed sequentially using the ExecutionFrame it holds, which is created
+// on the first call. Control flow nodes use this to avoid creating a new frame for every execution of a subgraph.
 common::Status ExecuteGraph(const SessionState& session_state,
                             FeedsFetchesManager& feeds_fetches_manager,
                             const std::vector<MLValue>& feeds,
@@ -53,7 +56,8 @@ common::Status ExecuteGraph(const SessionState& session_state,
                             bool sequential_execution,
                             const bool& terminate_flag,
                             const logging::Logger& logger,
-                            bool cache_copy_info = true);
+                            bool cache_copy_info = true,
+                            std::unique_ptr<ExecutionFrame>* reusable_frame = nullptr);
 
 // ExecuteGraph used the cached information in feeds_fetches_manager.
 common::Status ExecuteGraphWithCachedInfo(const SessionState& session_state,
@@ -63,7 +67,8 @@ common::Status ExecuteGraphWithCachedInfo(const SessionState& session_state,
                                           const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                                           bool sequential_execution,
                                           const bool& terminate_flag,
-                                          const logging::Logger& logger);
+                                          const logging::Logger& logger,
+                                          std::unique_ptr<ExecutionFrame>* reusable_frame = nullptr);
 
 #define DispatchOnTensorType(tensor_type, function, ...)      \
   if (tensor_type == DataTypeImpl::GetType<float>())          \
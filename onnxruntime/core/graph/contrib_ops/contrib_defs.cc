@@ -336,6 +336,164 @@ activation.)DOC")
         ONNX_NAMESPACE::convPoolTypeAndShapeInference(ctx, false, true);
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(ReorderInput)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use. Reorders a tensor from the NCHW layout to the NCHWc layout.)DOC")
+      .Input(0, "X", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasInputShape(ctx, 0)) {
+          return;
+        }
+        // The channel dimension is padded to the platform specific block size.
+        const auto& input_shape = ctx.getInputType(0)->tensor_type().shape();
+        if (input_shape.dim_size() != 4) {
+          fail_shape_inference("Input tensor must have rank 4.");
+        }
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        *output_shape->add_dim() = input_shape.dim(0);
+        output_shape->add_dim();
+        *output_shape->add_dim() = input_shape.dim(2);
+        *output_shape->add_dim() = input_shape.dim(3);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(ReorderOutput)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use. Reorders a tensor from the NCHWc layout to the NCHW layout.)DOC")
+      .Attr(
+          "channels",
+          "The number of channels of the output tensor.",
+          AttributeProto::INT)
+      .Input(0, "X", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasInputShape(ctx, 0)) {
+          return;
+        }
+        const auto& input_shape = ctx.getInputType(0)->tensor_type().shape();
+        if (input_shape.dim_size() != 4) {
+          fail_shape_inference("Input tensor must have rank 4.");
+        }
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        *output_shape->add_dim() = input_shape.dim(0);
+        output_shape->add_dim()->set_dim_value(getAttribute(ctx, "channels", 0));
+        *output_shape->add_dim() = input_shape.dim(2);
+        *output_shape->add_dim() = input_shape.dim(3);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NchwcConv)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use. The NchwcConv operator computes a two dimensional convolution
+of tensors in the NCHWc layout. The filter and bias tensors are reordered for the NCHWc layout
+and the channel counts are padded to the block size. The optional Sum tensor is added to the
+convolution output before the activation is applied.)DOC")
+      .Attr(
+          "auto_pad",
+          "",
+          AttributeProto::STRING,
+          std::string("NOTSET"))
+      .Attr(
+          "kernel_shape",
+          "",
+          AttributeProto::INTS,
+          OPTIONAL)
+      .Attr(
+          "dilations",
+          "",
+          AttributeProto::INTS,
+          OPTIONAL)
+      .Attr(
+          "strides", "", AttributeProto::INTS, OPTIONAL)
+      .Attr("pads",
+            "",
+            AttributeProto::INTS, OPTIONAL)
+      .Attr(
+          "group",
+          "",
+          AttributeProto::INT,
+          static_cast<int64_t>(1))
+      .Attr(
+          "activation",
+          "",
+          AttributeProto::STRING,
+          OPTIONAL)
+      .Attr(
+          "alpha",
+          "",
+          AttributeProto::FLOAT,
+          OPTIONAL)
+      .Input(0, "X", "", "T")
+      .Input(1, "W", "", "T")
+      .Input(2, "B", "", "T", OpSchema::Optional)
+      .Input(3, "Sum", "", "T", OpSchema::Optional)
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        ONNX_NAMESPACE::convPoolTypeAndShapeInference(ctx, true, false);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NchwcMaxPool)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use. Computes a two dimensional max pooling of a tensor in the NCHWc layout.)DOC")
+      .Attr(
+          "auto_pad",
+          "",
+          AttributeProto::STRING,
+          std::string("NOTSET"))
+      .Attr(
+          "kernel_shape",
+          "",
+          AttributeProto::INTS)
+      .Attr("pads",
+            "",
+            AttributeProto::INTS, OPTIONAL)
+      .Attr(
+          "strides", "", AttributeProto::INTS, OPTIONAL)
+      .Input(0, "X", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        ONNX_NAMESPACE::convPoolTypeAndShapeInference(ctx, false, true);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NchwcAveragePool)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use. Computes a two dimensional average pooling of a tensor in the NCHWc layout.)DOC")
+      .Attr(
+          "auto_pad",
+          "",
+          AttributeProto::STRING,
+          std::string("NOTSET"))
+      .Attr(
+          "kernel_shape",
+          "",
+          AttributeProto::INTS)
+      .Attr("pads",
+            "",
+            AttributeProto::INTS, OPTIONAL)
+      .Attr(
+          "strides", "", AttributeProto::INTS, OPTIONAL)
+      .Attr(
+          "count_include_pad",
+          "",
+          AttributeProto::INT,
+          static_cast<int64_t>(0))
+      .Input(0, "X", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        ONNX_NAMESPACE::convPoolTypeAndShapeInference(ctx, false, true);
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(FusedGemm)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -426,6 +584,43 @@ activation and leaky_relu_alpha.)DOC")
         }
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(FusedElementwise)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use. The FusedElementwise operator evaluates an expression of
+element-wise operations, as inserted by the ElementwiseFusion transformer. The expression is a list
+of steps given by the ops attribute. Each step reads its operands from the inputs of the operator
+or from the results of earlier steps, as given by the operands attribute. The result of the last
+step is the output. Each input must be broadcastable to the output by prepending dimensions, so
+that the input repeats along the leading dimensions of the output.)DOC")
+      .Attr(
+          "ops",
+          "The element-wise operation of each step, such as Add, Mul or Tanh.",
+          AttributeProto::STRINGS)
+      .Attr(
+          "operands",
+          "Two operand indices for each step. An index less than the input count refers to an input, "
+          "otherwise it refers to the result of the step at the index minus the input count. "
+          "The second index of a unary operation is -1.",
+          AttributeProto::INTS)
+      .Input(0, "inputs", "The inputs of the expression.", "T", OpSchema::Variadic)
+      .Output(0, "Y", "The result of the expression.", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        const size_t input_count = ctx.getNumInputs();
+        if (!hasNInputShapes(ctx, static_cast<int>(input_count))) {
+          return;
+        }
+        ONNX_NAMESPACE::TensorShapeProto output_shape = getInputShape(ctx, 0);
+        for (size_t i = 1; i < input_count; i++) {
+          ONNX_NAMESPACE::TensorShapeProto broadcast_shape;
+          bidirectionalBroadcastShapeInference(output_shape, getInputShape(ctx, i), broadcast_shape);
+          output_shape = broadcast_shape;
+        }
+        *ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape() = output_shape;
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(ExpandDims)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -106,5 +106,14 @@ bool RemoveSingleInSingleOutNode(Graph& graph, Node& node) {
   return true;
 }
 
+void RemoveNodeOutputEdges(Graph& graph, Node& node) {
+  // Copy the edges first, as removing an edge modifies the edge set of the node.
+  std::vector<Node::EdgeEnd> output_edges(node.OutputEdgesBegin(), node.OutputEdgesEnd());
+  for (const auto& output_edge : output_edges) {
+    graph.RemoveEdge(node.Index(), output_edge.GetNode().Index(),
+                     output_edge.GetSrcArgIndex(), output_edge.GetDstArgIndex());
+  }
+}
+
 }  // namespace utils
 }  // namespace onnxruntime
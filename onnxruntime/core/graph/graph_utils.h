@@ -40,5 +40,9 @@ bool GetRepeatedNodeAttributeValues(const Node& node,
 /** Remove the given single-input-single-output Node from the Graph. */
 bool RemoveSingleInSingleOutNode(Graph& graph, Node& node);
 
+/** Remove the output edges of a Node, so that the Node can be removed from the Graph
+    after its outputs have been rewired to be produced by another Node. */
+void RemoveNodeOutputEdges(Graph& graph, Node& node);
+
 }  // namespace utils
 }  // namespace onnxruntime
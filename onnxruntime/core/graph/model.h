@@ -75,6 +75,8 @@ class Model {
   void SetDocString(const std::string& doc_string);
 
   const ModelMetaData& MetaData() const noexcept;
+  // Add a metadata property to the model, or replace the value of an existing one.
+  void SetMetaDataProperty(const std::string& key, const std::string& value);
 
   // Get model's main graph.
   Graph& MainGraph() noexcept;
@@ -43,6 +43,27 @@ typedef enum { CblasNonUnit=131, CblasUnit=132 } CBLAS_DIAG;
 typedef enum { CblasLeft=141, CblasRight=142} CBLAS_SIDE;
 #endif
 
+//
+// Forward declare the thread pool implementation class.
+//
+// N.B. Avoid including onnxruntime headers here to keep the dependencies for
+// standalone MLAS test executables smaller.
+//
+
+namespace onnxruntime {
+    namespace concurrency {
+        class ThreadPool;
+    }
+}
+
+//
+// Define the optional thread pool used to parallelize MLAS operations. If the
+// caller supplies a null thread pool, the operation executes on the calling
+// thread.
+//
+
+using MLAS_THREADPOOL = onnxruntime::concurrency::ThreadPool;
+
 //
 // Activiation routines.
 //
@@ -75,6 +96,16 @@ MlasActivation(
 //
 // Single precision matrix/matrix multiply routine.
 //
+// The optional post-processing parameters add a bias vector to each row of
+// matrix C and then apply an activation. These are applied to each block of
+// matrix C as the block is completed, instead of making extra passes over the
+// output.
+//
+
+struct MLAS_SGEMM_POSTPROCESS {
+    const float* Bias;
+    const MLAS_ACTIVATION* Activation;
+};
 
 void
 MLASCALL
@@ -91,7 +122,218 @@ MlasSgemm(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Batched single precision matrix/matrix multiply routine. The matrices of
+// each batch are separated by a fixed stride; a stride of zero shares the
+// matrix across the batch.
+//
+
+void
+MLASCALL
+MlasSgemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    size_t StrideA,
+    const float* B,
+    size_t ldb,
+    size_t StrideB,
+    float beta,
+    float* C,
+    size_t ldc,
+    size_t StrideC,
+    size_t BatchCount,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Single precision matrix/matrix multiply routines using a pre-packed matrix
+// B. Packing a constant matrix B once avoids repacking it on every call.
+//
+
+size_t
+MLASCALL
+MlasSgemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasSgemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Double precision matrix/matrix multiply routine.
+//
+
+void
+MLASCALL
+MlasDgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    double alpha,
+    const double* A,
+    size_t lda,
+    const double* B,
+    size_t ldb,
+    double beta,
+    double* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Integer matrix/matrix multiply routines. The products and sums wrap around
+// on overflow.
+//
+
+void
+MLASCALL
+MlasIgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    int32_t alpha,
+    const int32_t* A,
+    size_t lda,
+    const int32_t* B,
+    size_t ldb,
+    int32_t beta,
+    int32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasIgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    uint32_t alpha,
+    const uint32_t* A,
+    size_t lda,
+    const uint32_t* B,
+    size_t ldb,
+    uint32_t beta,
+    uint32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasIgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    int64_t alpha,
+    const int64_t* A,
+    size_t lda,
+    const int64_t* B,
+    size_t ldb,
+    int64_t beta,
+    int64_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasIgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    uint64_t alpha,
+    const uint64_t* A,
+    size_t lda,
+    const uint64_t* B,
+    size_t ldb,
+    uint64_t beta,
+    uint64_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Quantized integer matrix/matrix multiply routine.
+//
+// The optional requantize parameters convert the 32-bit accumulators to
+// unsigned 8-bit values as each block of matrix C is completed. The scale is
+// applied using the same fixed point arithmetic as gemmlowp.
+//
+
+struct MLAS_QGEMM_REQUANTIZE {
+    const int32_t* Bias;
+    float Scale;
+    uint8_t ZeroPoint;
+    uint8_t* Output;
+    size_t ldo;
+};
+
+void
+MLASCALL
+MlasQgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    bool BIsSigned,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_REQUANTIZE* Requantize,
+    MLAS_THREADPOOL* ThreadPool
     );
 
 //
@@ -102,6 +344,8 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmWinograd,
+    MlasConvAlgorithmDirect,
 };
 
 struct MLAS_CONV_PARAMETERS {
@@ -129,6 +373,18 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t TileSize;
+            size_t TileCountH;
+            size_t TileCountW;
+            size_t SegmentTileRows;
+            size_t ThreadCount;
+        } Winograd;
+        struct {
+            size_t PaddedInputHeight;
+            size_t PhaseWidth;
+            size_t ThreadCount;
+        } Direct;
     } u;
 };
 
@@ -148,7 +404,8 @@ MlasConvPrepare(
     const int64_t* OutputShape,
     size_t FilterCount,
     const MLAS_ACTIVATION* Activation,
-    size_t* WorkingBufferSize
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
     );
 
 void
@@ -159,7 +416,8 @@ MlasConv(
     const float* Filter,
     const float* Bias,
     float* WorkingBuffer,
-    float* Output
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
     );
 
 //
@@ -183,7 +441,86 @@ MlasPool(
     const int64_t* StrideShape,
     const int64_t* OutputShape,
     const float* Input,
-    float* Output
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Convolution and pooling routines for the NCHWc tensor layout, where the
+// channels are split into blocks of MlasNchwcGetBlockSize() channels that
+// are stored contiguously for each spatial element. A block size of 1
+// indicates that the platform does not support the NCHWc tensor layout.
+//
+
+size_t
+MLASCALL
+MlasNchwcGetBlockSize(
+    void
+    );
+
+void
+MLASCALL
+MlasNchwcConv(
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    size_t GroupCount,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    const MLAS_ACTIVATION* Activation,
+    bool ZeroMode,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasNchwcPool(
+    MLAS_POOLING_KIND PoolingKind,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasReorderInput(
+    const int64_t* InputShape,
+    const float* S,
+    float* D
+    );
+
+void
+MLASCALL
+MlasReorderOutput(
+    const int64_t* OutputShape,
+    const float* S,
+    float* D
+    );
+
+void
+MLASCALL
+MlasReorderFilterOIHWBiBo(
+    const int64_t* FilterShape,
+    const float* S,
+    float* D
+    );
+
+void
+MLASCALL
+MlasReorderFilterOIHWBo(
+    const int64_t* FilterShape,
+    const float* S,
+    float* D
     );
 
 //
@@ -206,6 +543,41 @@ MlasComputeTanh(
     size_t N
     );
 
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeLog(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeErf(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Half-precision floating-point routines.
 //
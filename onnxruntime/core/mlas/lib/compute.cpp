@@ -0,0 +1,871 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute.cpp
+
+Abstract:
+
+    This module implements routines to compute the exponential, natural
+    logarithm and error functions and the softmax operation.
+
+    The kernels are implemented in compute_kernel.h. The implementation below
+    targets the base instruction set (typically SSE2 or NEON) while the
+    instruction set specific modules target newer instruction sets (such as
+    FMA3 and AVX512F).
+
+--*/
+
+#include "mlasi.h"
+#include "compute_kernel.h"
+
+//
+// Define the number of elements of a softmax row that are processed as a
+// block while the block is resident in the L1 cache.
+//
+
+#define MLAS_SOFTMAX_BLOCK_SIZE                     2048
+
+//
+// Define the maximum number of blocks that a softmax row is split into.
+//
+
+#define MLAS_SOFTMAX_MAXIMUM_BLOCKS                 64
+
+//
+// Define the target number of per-thread elements of a softmax operation
+// before using another thread to perform additional work.
+//
+
+#define MLAS_SOFTMAX_THREAD_COMPLEXITY              (64 * 1024)
+
+struct MLAS_COMPUTE_KERNEL
+{
+    typedef MLAS_FLOAT32X4 Vector;
+
+#if defined(MLAS_NEON_INTRINSICS)
+    typedef int32x4_t IntegerVector;
+    typedef uint32x4_t Mask;
+#elif defined(MLAS_SSE2_INTRINSICS)
+    typedef __m128i IntegerVector;
+    typedef __m128 Mask;
+#endif
+
+    static constexpr size_t VectorLength = 4;
+
+    static Vector Zero()
+    {
+        return MlasZeroFloat32x4();
+    }
+
+    static Vector Load(const float* Buffer)
+    {
+        return MlasLoadFloat32x4(Buffer);
+    }
+
+    static void Store(float* Buffer, Vector Value)
+    {
+        MlasStoreFloat32x4(Buffer, Value);
+    }
+
+    static Vector Broadcast(float Value)
+    {
+        return MlasBroadcastFloat32x4(Value);
+    }
+
+    static Vector Add(Vector Vector1, Vector Vector2)
+    {
+        return MlasAddFloat32x4(Vector1, Vector2);
+    }
+
+    static Vector Subtract(Vector Vector1, Vector Vector2)
+    {
+        return MlasSubtractFloat32x4(Vector1, Vector2);
+    }
+
+    static Vector Multiply(Vector Vector1, Vector Vector2)
+    {
+        return MlasMultiplyFloat32x4(Vector1, Vector2);
+    }
+
+    static Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3)
+    {
+        return MlasMultiplyAddFloat32x4(Vector1, Vector2, Vector3);
+    }
+
+    static Vector Maximum(Vector Vector1, Vector Vector2)
+    {
+        return MlasMaximumFloat32x4(Vector1, Vector2);
+    }
+
+    static Vector Minimum(Vector Vector1, Vector Vector2)
+    {
+        return MlasMinimumFloat32x4(Vector1, Vector2);
+    }
+
+    static float ReduceAdd(Vector Value)
+    {
+        return MlasExtractLaneFloat32x4<0>(Value) + MlasExtractLaneFloat32x4<1>(Value) +
+            MlasExtractLaneFloat32x4<2>(Value) + MlasExtractLaneFloat32x4<3>(Value);
+    }
+
+    static float ReduceMaximum(Vector Value)
+    {
+        return (std::max)((std::max)(MlasExtractLaneFloat32x4<0>(Value), MlasExtractLaneFloat32x4<1>(Value)),
+            (std::max)(MlasExtractLaneFloat32x4<2>(Value), MlasExtractLaneFloat32x4<3>(Value)));
+    }
+
+#if defined(MLAS_NEON_INTRINSICS)
+
+    static Mask CompareEqual(Vector Vector1, Vector Vector2)
+    {
+        return vceqq_f32(Vector1, Vector2);
+    }
+
+    static Mask CompareLessThan(Vector Vector1, Vector Vector2)
+    {
+        return vcltq_f32(Vector1, Vector2);
+    }
+
+    static Mask CompareNotGreaterEqual(Vector Vector1, Vector Vector2)
+    {
+        return vmvnq_u32(vcgeq_f32(Vector1, Vector2));
+    }
+
+    static Vector Blend(Mask Selector, Vector IfFalse, Vector IfTrue)
+    {
+        return vbslq_f32(Selector, IfTrue, IfFalse);
+    }
+
+    static IntegerVector CastToInt32(Vector Value)
+    {
+        return vreinterpretq_s32_f32(Value);
+    }
+
+    static Vector CastToFloat(IntegerVector Value)
+    {
+        return vreinterpretq_f32_s32(Value);
+    }
+
+    static Vector ConvertInt32ToFloat(IntegerVector Value)
+    {
+        return vcvtq_f32_s32(Value);
+    }
+
+    static IntegerVector BroadcastInt32(int32_t Value)
+    {
+        return vdupq_n_s32(Value);
+    }
+
+    static IntegerVector AddInt32(IntegerVector Vector1, IntegerVector Vector2)
+    {
+        return vaddq_s32(Vector1, Vector2);
+    }
+
+    static IntegerVector SubtractInt32(IntegerVector Vector1, IntegerVector Vector2)
+    {
+        return vsubq_s32(Vector1, Vector2);
+    }
+
+    static IntegerVector AndInt32(IntegerVector Vector1, IntegerVector Vector2)
+    {
+        return vandq_s32(Vector1, Vector2);
+    }
+
+    static IntegerVector OrInt32(IntegerVector Vector1, IntegerVector Vector2)
+    {
+        return vorrq_s32(Vector1, Vector2);
+    }
+
+    template<int Count>
+    static IntegerVector ShiftLeftInt32(IntegerVector Value)
+    {
+        return vshlq_n_s32(Value, Count);
+    }
+
+    template<int Count>
+    static IntegerVector ShiftRightInt32(IntegerVector Value)
+    {
+        return vshrq_n_s32(Value, Count);
+    }
+
+#elif defined(MLAS_SSE2_INTRINSICS)
+
+    static Mask CompareEqual(Vector Vector1, Vector Vector2)
+    {
+        return _mm_cmpeq_ps(Vector1, Vector2);
+    }
+
+    static Mask CompareLessThan(Vector Vector1, Vector Vector2)
+    {
+        return _mm_cmplt_ps(Vector1, Vector2);
+    }
+
+    static Mask CompareNotGreaterEqual(Vector Vector1, Vector Vector2)
+    {
+        return _mm_cmpnge_ps(Vector1, Vector2);
+    }
+
+    static Vector Blend(Mask Selector, Vector IfFalse, Vector IfTrue)
+    {
+        return _mm_or_ps(_mm_andnot_ps(Selector, IfFalse), _mm_and_ps(Selector, IfTrue));
+    }
+
+    static IntegerVector CastToInt32(Vector Value)
+    {
+        return _mm_castps_si128(Value);
+    }
+
+    static Vector CastToFloat(IntegerVector Value)
+    {
+        return _mm_castsi128_ps(Value);
+    }
+
+    static Vector ConvertInt32ToFloat(IntegerVector Value)
+    {
+        return _mm_cvtepi32_ps(Value);
+    }
+
+    static IntegerVector BroadcastInt32(int32_t Value)
+    {
+        return _mm_set1_epi32(Value);
+    }
+
+    static IntegerVector AddInt32(IntegerVector Vector1, IntegerVector Vector2)
+    {
+        return _mm_add_epi32(Vector1, Vector2);
+    }
+
+    static IntegerVector SubtractInt32(IntegerVector Vector1, IntegerVector Vector2)
+    {
+        return _mm_sub_epi32(Vector1, Vector2);
+    }
+
+    static IntegerVector AndInt32(IntegerVector Vector1, IntegerVector Vector2)
+    {
+        return _mm_and_si128(Vector1, Vector2);
+    }
+
+    static IntegerVector OrInt32(IntegerVector Vector1, IntegerVector Vector2)
+    {
+        return _mm_or_si128(Vector1, Vector2);
+    }
+
+    template<int Count>
+    static IntegerVector ShiftLeftInt32(IntegerVector Value)
+    {
+        return _mm_slli_epi32(Value, Count);
+    }
+
+    template<int Count>
+    static IntegerVector ShiftRightInt32(IntegerVector Value)
+    {
+        return _mm_srai_epi32(Value, Count);
+    }
+
+#endif
+};
+
+void
+MLASCALL
+MlasExpKernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnary<MLAS_COMPUTE_KERNEL, MlasExpVector<MLAS_COMPUTE_KERNEL>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasLogKernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the natural logarithm
+    function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnary<MLAS_COMPUTE_KERNEL, MlasLogVector<MLAS_COMPUTE_KERNEL>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasErfKernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the error function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnary<MLAS_COMPUTE_KERNEL, MlasErfVector<MLAS_COMPUTE_KERNEL>>(Input, Output, N);
+}
+
+float
+MLASCALL
+MlasReduceMaximumKernel(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to find the maximum value of
+    a buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the maximum value.
+
+--*/
+{
+    return MlasReduceMaximum<MLAS_COMPUTE_KERNEL>(Input, N);
+}
+
+float
+MLASCALL
+MlasComputeSumExpKernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float Bias
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to compute the exponential
+    function of each element of a buffer plus a bias and the sum of the
+    results.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Optionally supplies the output buffer to receive the exponential
+        of each element.
+
+    N - Supplies the number of elements to process.
+
+    Bias - Supplies the value to add to each element.
+
+Return Value:
+
+    Returns the sum of the exponential function of the elements.
+
+--*/
+{
+    return MlasComputeSumExp<MLAS_COMPUTE_KERNEL>(Input, Output, N, Bias);
+}
+
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer. The output buffer may be the same as
+        the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ExpKernelRoutine(Input, Output, N);
+#else
+    MlasExpKernel(Input, Output, N);
+#endif
+}
+
+void
+MLASCALL
+MlasComputeLog(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the natural logarithm function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer. The output buffer may be the same as
+        the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.LogKernelRoutine(Input, Output, N);
+#else
+    MlasLogKernel(Input, Output, N);
+#endif
+}
+
+void
+MLASCALL
+MlasComputeErf(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the error function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer. The output buffer may be the same as
+        the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ErfKernelRoutine(Input, Output, N);
+#else
+    MlasErfKernel(Input, Output, N);
+#endif
+}
+
+void
+MlasComputeSoftmaxOutput(
+    float* Output,
+    size_t N,
+    float Scale
+    )
+/*++
+
+Routine Description:
+
+    This routine scales the exponential of each element of a softmax row by
+    the reciprocal of the sum of the row.
+
+Arguments:
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the reciprocal of the sum of the row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasMultiplyFloat32x4(MlasLoadFloat32x4(Output), ScaleVector));
+
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output++ *= Scale;
+
+        N -= 1;
+    }
+}
+
+void
+MlasComputeLogSoftmaxOutput(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float Bias
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the log softmax output of a row as the input plus
+    the negated maximum and the negated logarithm of the sum of the row.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Bias - Supplies the value to add to each element.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 BiasVector = MlasBroadcastFloat32x4(Bias);
+
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasAddFloat32x4(MlasLoadFloat32x4(Input), BiasVector));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output++ = *Input++ + Bias;
+
+        N -= 1;
+    }
+}
+
+void
+MlasComputeSoftmaxRows(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax operation for a range of
+    rows of a matrix.
+
+    Each row is split into blocks that fit in the L1 cache. The maximum value
+    and the sum of the exponential function are accumulated over the blocks
+    in one pass over the row: the maximum of a block is found and the block
+    is then read again from the cache to accumulate the sum. When a block
+    raises the running maximum, the running sum is rescaled to the new
+    maximum. A second pass over the row produces the output.
+
+Arguments:
+
+    Input - Supplies the input matrix of N rows and D columns.
+
+    Output - Supplies the output matrix. The output matrix may be the same as
+        the input matrix.
+
+    N - Supplies the number of rows.
+
+    D - Supplies the number of columns.
+
+    LogSoftmax - Supplies true to compute the log softmax operation, else
+        false to compute the softmax operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Limit the number of blocks so that the running maximum of each block
+    // can be kept on the stack. Very long rows use larger blocks.
+    //
+
+    size_t BlockSize = (D + MLAS_SOFTMAX_MAXIMUM_BLOCKS - 1) / MLAS_SOFTMAX_MAXIMUM_BLOCKS;
+
+    if (BlockSize < MLAS_SOFTMAX_BLOCK_SIZE) {
+        BlockSize = MLAS_SOFTMAX_BLOCK_SIZE;
+    }
+
+    float BlockMaximum[MLAS_SOFTMAX_MAXIMUM_BLOCKS];
+
+    for (size_t n = 0; n < N; n++) {
+
+        float Maximum = std::numeric_limits<float>::lowest();
+        float Accumulation = 0.0f;
+        size_t BlockCount = 0;
+
+        for (size_t d = 0; d < D; d += BlockSize) {
+
+            const size_t CountD = (std::min)(BlockSize, D - d);
+
+#if defined(MLAS_TARGET_AMD64)
+            const float Maximum2 = MlasPlatform.ReduceMaximumKernelRoutine(Input + d, CountD);
+#else
+            const float Maximum2 = MlasReduceMaximumKernel(Input + d, CountD);
+#endif
+
+            if (Maximum2 > Maximum) {
+                Accumulation *= std::exp(Maximum - Maximum2);
+                Maximum = Maximum2;
+            }
+
+            //
+            // The softmax operation stores the exponential function of the
+            // block relative to the running maximum, which is corrected to
+            // the maximum of the row when the output is scaled.
+            //
+
+            float* OutputBlock = LogSoftmax ? nullptr : Output + d;
+
+#if defined(MLAS_TARGET_AMD64)
+            Accumulation += MlasPlatform.ComputeSumExpKernelRoutine(Input + d, OutputBlock, CountD, -Maximum);
+#else
+            Accumulation += MlasComputeSumExpKernel(Input + d, OutputBlock, CountD, -Maximum);
+#endif
+
+            BlockMaximum[BlockCount++] = Maximum;
+        }
+
+        if (LogSoftmax) {
+
+            MlasComputeLogSoftmaxOutput(Input, Output, D, -Maximum - std::log(Accumulation));
+
+        } else {
+
+            const float Scale = 1.0f / Accumulation;
+
+            for (size_t b = 0; b < BlockCount; b++) {
+
+                const size_t d = b * BlockSize;
+                const size_t CountD = (std::min)(BlockSize, D - d);
+
+                MlasComputeSoftmaxOutput(Output + d, CountD, std::exp(BlockMaximum[b] - Maximum) * Scale);
+            }
+        }
+
+        Input += D;
+        Output += D;
+    }
+}
+
+//
+// Define the parameters to execute segments of the rows of a softmax
+// operation on worker threads.
+//
+
+struct MLAS_SOFTMAX_WORK_BLOCK {
+    const float* Input;
+    float* Output;
+    size_t N;
+    size_t D;
+    bool LogSoftmax;
+    int32_t TargetThreadCount;
+};
+
+void
+MlasComputeSoftmaxThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    softmax or log softmax operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_SOFTMAX_WORK_BLOCK* WorkBlock = (MLAS_SOFTMAX_WORK_BLOCK*)Context;
+
+    size_t RowStart;
+    size_t RowCount;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount, WorkBlock->N, &RowStart, &RowCount);
+
+    if (RowCount == 0) {
+        return;
+    }
+
+    const size_t D = WorkBlock->D;
+
+    MlasComputeSoftmaxRows(WorkBlock->Input + RowStart * D, WorkBlock->Output + RowStart * D,
+        RowCount, D, WorkBlock->LogSoftmax);
+}
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax operation for each row
+    of a matrix.
+
+Arguments:
+
+    Input - Supplies the input matrix of N rows and D columns.
+
+    Output - Supplies the output matrix. The output matrix may be the same as
+        the input matrix.
+
+    N - Supplies the number of rows.
+
+    D - Supplies the number of columns.
+
+    LogSoftmax - Supplies true to compute the log softmax operation, else
+        false to compute the softmax operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        operation should execute on the calling thread.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Each thread processes a contiguous range of rows.
+    //
+
+    const double Complexity = double(N) * double(D);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SOFTMAX_THREAD_COMPLEXITY) * double(MlasGetMaximumThreadCount(ThreadPool))) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SOFTMAX_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+    }
+
+    if (size_t(TargetThreadCount) >= N) {
+        TargetThreadCount = int32_t(N);
+    }
+
+    if (TargetThreadCount <= 1) {
+        MlasComputeSoftmaxRows(Input, Output, N, D, LogSoftmax);
+        return;
+    }
+
+    MLAS_SOFTMAX_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+    WorkBlock.LogSoftmax = LogSoftmax;
+    WorkBlock.TargetThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasComputeSoftmaxThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
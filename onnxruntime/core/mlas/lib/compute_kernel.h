@@ -0,0 +1,537 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute_kernel.h
+
+Abstract:
+
+    This module implements the kernels for the exponential, natural logarithm
+    and error functions and the reductions used by the softmax operation.
+
+    The kernels are templated on a kernel type that supplies the vector type
+    and the vector operations for a specific instruction set. The instruction
+    set specific modules include this header and instantiate the kernels.
+
+    The exponential and natural logarithm functions use the same polynomial
+    approximations as found in Cephes. The error function uses the polynomial
+    approximations as found in Sleef.
+
+--*/
+
+#pragma once
+
+//
+// Constants for the exponential function.
+//
+// The input is clamped to a range where the result is the same as for an
+// input beyond the range: zero below and infinity above.
+//
+
+struct MLAS_EXP_CONSTANTS {
+    static constexpr float LowerRange = -104.0f;
+    static constexpr float UpperRange = 89.0f;
+    static constexpr float RoundingBias = 12582912.0f;
+    static constexpr float Log2Reciprocal = 1.44269504088896341f;
+    static constexpr float Log2High = -6.93359375e-1f;
+    static constexpr float Log2Low = 2.12194440e-4f;
+    static constexpr float poly_0 = 1.9875691500e-4f;
+    static constexpr float poly_1 = 1.3981999507e-3f;
+    static constexpr float poly_2 = 8.3334519073e-3f;
+    static constexpr float poly_3 = 4.1665795894e-2f;
+    static constexpr float poly_4 = 1.6666665459e-1f;
+    static constexpr float poly_5 = 5.0000001201e-1f;
+    static constexpr float one = 1.0f;
+    static constexpr int32_t RoundingBiasBits = 0x4B400000;
+    static constexpr int32_t ExponentBias = 127;
+};
+
+//
+// Constants for the natural logarithm function.
+//
+
+struct MLAS_LOG_CONSTANTS {
+    static constexpr float MinimumNormal = 1.17549435e-38f;
+    static constexpr float SquareRootHalf = 0.707106781186547524f;
+    static constexpr float poly_0 = 7.0376836292e-2f;
+    static constexpr float poly_1 = -1.1514610310e-1f;
+    static constexpr float poly_2 = 1.1676998740e-1f;
+    static constexpr float poly_3 = -1.2420140846e-1f;
+    static constexpr float poly_4 = 1.4249322787e-1f;
+    static constexpr float poly_5 = -1.6668057665e-1f;
+    static constexpr float poly_6 = 2.0000714765e-1f;
+    static constexpr float poly_7 = -2.4999993993e-1f;
+    static constexpr float poly_8 = 3.3333331174e-1f;
+    static constexpr float Log2High = 0.693359375f;
+    static constexpr float Log2Low = -2.12194440e-4f;
+    static constexpr float one = 1.0f;
+    static constexpr float one_half = 0.5f;
+    static constexpr int32_t MantissaMask = 0x007FFFFF;
+    static constexpr int32_t HalfBits = 0x3F000000;
+    static constexpr int32_t ExponentBias = 126;
+};
+
+//
+// Constants for the error function.
+//
+
+struct MLAS_ERF_CONSTANTS {
+    static constexpr float UpperAbsRange = 3.925f;
+    static constexpr float SplitBoundary = 0.921875f;
+    static constexpr float SmallP0 = -5.99104969e-4f;
+    static constexpr float SmallP1 = 4.99339588e-3f;
+    static constexpr float SmallP2 = -2.67667342e-2f;
+    static constexpr float SmallP3 = 1.12818025e-1f;
+    static constexpr float SmallP4 = -3.76124859e-1f;
+    static constexpr float SmallP5 = 1.28379151e-1f;
+    static constexpr float BigP0 = 1.72948930e-5f;
+    static constexpr float BigP1 = -3.83208680e-4f;
+    static constexpr float BigP2 = 3.88393435e-3f;
+    static constexpr float BigP3 = -2.42545605e-2f;
+    static constexpr float BigP4 = 1.06777847e-1f;
+    static constexpr float BigP5 = 6.34846687e-1f;
+    static constexpr float BigP6 = 1.28717512e-1f;
+    static constexpr float one = 1.0f;
+    static constexpr int32_t SignMask = int32_t(0x80000000);
+    static constexpr int32_t AbsoluteMask = 0x7FFFFFFF;
+};
+
+template<typename KernelType>
+inline
+typename KernelType::Vector
+MlasExpVector(
+    typename KernelType::Vector Value
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for a vector of elements.
+
+    The input is reduced to r = x - n * ln(2) for the integer n nearest to
+    x / ln(2) and the result is p(r) * 2^n. The scale is applied as two
+    factors, so that the results that overflow or underflow are produced by
+    the floating point multiplies.
+
+Arguments:
+
+    Value - Supplies the input vector.
+
+Return Value:
+
+    Returns the output vector.
+
+--*/
+{
+    typedef typename KernelType::Vector Vector;
+    typedef typename KernelType::IntegerVector IntegerVector;
+    typedef MLAS_EXP_CONSTANTS Constants;
+
+    Value = KernelType::Minimum(KernelType::Broadcast(Constants::UpperRange),
+        KernelType::Maximum(KernelType::Broadcast(Constants::LowerRange), Value));
+
+    //
+    // Round x / ln(2) to the nearest integer by adding a bias that aligns the
+    // integer part to the low bits of the mantissa.
+    //
+
+    Vector Biased = KernelType::MultiplyAdd(Value, KernelType::Broadcast(Constants::Log2Reciprocal),
+        KernelType::Broadcast(Constants::RoundingBias));
+    Vector m = KernelType::Subtract(Biased, KernelType::Broadcast(Constants::RoundingBias));
+
+    Value = KernelType::MultiplyAdd(m, KernelType::Broadcast(Constants::Log2High), Value);
+    Value = KernelType::MultiplyAdd(m, KernelType::Broadcast(Constants::Log2Low), Value);
+
+    Vector ValueSquared = KernelType::Multiply(Value, Value);
+
+    Vector p;
+    p = KernelType::MultiplyAdd(Value, KernelType::Broadcast(Constants::poly_0),
+        KernelType::Broadcast(Constants::poly_1));
+    p = KernelType::MultiplyAdd(p, Value, KernelType::Broadcast(Constants::poly_2));
+    p = KernelType::MultiplyAdd(p, Value, KernelType::Broadcast(Constants::poly_3));
+    p = KernelType::MultiplyAdd(p, Value, KernelType::Broadcast(Constants::poly_4));
+    p = KernelType::MultiplyAdd(p, Value, KernelType::Broadcast(Constants::poly_5));
+    p = KernelType::MultiplyAdd(p, ValueSquared, Value);
+    p = KernelType::Add(p, KernelType::Broadcast(Constants::one));
+
+    //
+    // Split the exponent n into n1 + n2 and build the scale factors 2^n1 and
+    // 2^n2 in the exponent field.
+    //
+
+    IntegerVector n = KernelType::SubtractInt32(KernelType::CastToInt32(Biased),
+        KernelType::BroadcastInt32(Constants::RoundingBiasBits));
+    IntegerVector n1 = KernelType::template ShiftRightInt32<1>(n);
+    IntegerVector n2 = KernelType::SubtractInt32(n, n1);
+
+    IntegerVector ExponentBias = KernelType::BroadcastInt32(Constants::ExponentBias);
+    Vector Scale1 = KernelType::CastToFloat(KernelType::template ShiftLeftInt32<23>(KernelType::AddInt32(n1, ExponentBias)));
+    Vector Scale2 = KernelType::CastToFloat(KernelType::template ShiftLeftInt32<23>(KernelType::AddInt32(n2, ExponentBias)));
+
+    return KernelType::Multiply(KernelType::Multiply(p, Scale1), Scale2);
+}
+
+template<typename KernelType>
+inline
+typename KernelType::Vector
+MlasLogVector(
+    typename KernelType::Vector Value
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the natural logarithm function for a vector of
+    elements.
+
+    The input is split into a mantissa m in [sqrt(0.5), sqrt(2)) and an
+    exponent e, and the result is log(m) + e * ln(2).
+
+Arguments:
+
+    Value - Supplies the input vector.
+
+Return Value:
+
+    Returns the output vector.
+
+--*/
+{
+    typedef typename KernelType::Vector Vector;
+    typedef typename KernelType::IntegerVector IntegerVector;
+    typedef MLAS_LOG_CONSTANTS Constants;
+
+    //
+    // Denormal inputs are treated as the minimum normal value.
+    //
+
+    Vector x = KernelType::Maximum(KernelType::Broadcast(Constants::MinimumNormal), Value);
+
+    IntegerVector Bits = KernelType::CastToInt32(x);
+
+    Vector e = KernelType::ConvertInt32ToFloat(KernelType::SubtractInt32(
+        KernelType::template ShiftRightInt32<23>(Bits), KernelType::BroadcastInt32(Constants::ExponentBias)));
+
+    Vector m = KernelType::CastToFloat(KernelType::OrInt32(
+        KernelType::AndInt32(Bits, KernelType::BroadcastInt32(Constants::MantissaMask)),
+        KernelType::BroadcastInt32(Constants::HalfBits)));
+
+    //
+    // Scale the mantissa from [0.5, 1) to [sqrt(0.5), sqrt(2)) and subtract
+    // one.
+    //
+
+    auto SmallMantissa = KernelType::CompareLessThan(m, KernelType::Broadcast(Constants::SquareRootHalf));
+
+    e = KernelType::Subtract(e, KernelType::Blend(SmallMantissa, KernelType::Zero(), KernelType::Broadcast(Constants::one)));
+    x = KernelType::Add(KernelType::Subtract(m, KernelType::Broadcast(Constants::one)),
+        KernelType::Blend(SmallMantissa, KernelType::Zero(), m));
+
+    Vector xSquared = KernelType::Multiply(x, x);
+
+    Vector p;
+    p = KernelType::MultiplyAdd(x, KernelType::Broadcast(Constants::poly_0), KernelType::Broadcast(Constants::poly_1));
+    p = KernelType::MultiplyAdd(p, x, KernelType::Broadcast(Constants::poly_2));
+    p = KernelType::MultiplyAdd(p, x, KernelType::Broadcast(Constants::poly_3));
+    p = KernelType::MultiplyAdd(p, x, KernelType::Broadcast(Constants::poly_4));
+    p = KernelType::MultiplyAdd(p, x, KernelType::Broadcast(Constants::poly_5));
+    p = KernelType::MultiplyAdd(p, x, KernelType::Broadcast(Constants::poly_6));
+    p = KernelType::MultiplyAdd(p, x, KernelType::Broadcast(Constants::poly_7));
+    p = KernelType::MultiplyAdd(p, x, KernelType::Broadcast(Constants::poly_8));
+    p = KernelType::Multiply(KernelType::Multiply(p, x), xSquared);
+
+    p = KernelType::MultiplyAdd(e, KernelType::Broadcast(Constants::Log2Low), p);
+    p = KernelType::MultiplyAdd(xSquared, KernelType::Broadcast(-Constants::one_half), p);
+    x = KernelType::Add(x, p);
+    x = KernelType::MultiplyAdd(e, KernelType::Broadcast(Constants::Log2High), x);
+
+    //
+    // Handle the special cases: the result is NaN for a negative or NaN
+    // input, negative infinity for zero and infinity for infinity.
+    //
+
+    x = KernelType::Blend(KernelType::CompareEqual(Value, KernelType::Zero()), x,
+        KernelType::Broadcast(-std::numeric_limits<float>::infinity()));
+    x = KernelType::Blend(KernelType::CompareEqual(Value, KernelType::Broadcast(std::numeric_limits<float>::infinity())), x,
+        KernelType::Broadcast(std::numeric_limits<float>::infinity()));
+    x = KernelType::Blend(KernelType::CompareNotGreaterEqual(Value, KernelType::Zero()), x,
+        KernelType::Broadcast(std::numeric_limits<float>::quiet_NaN()));
+
+    return x;
+}
+
+template<typename KernelType>
+inline
+typename KernelType::Vector
+MlasErfVector(
+    typename KernelType::Vector Value
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the error function for a vector of elements.
+
+    The result is computed for the absolute value of the input and the sign
+    of the input is then applied. Below the split boundary, the result is a
+    polynomial of the input. Above the split boundary, the result is one
+    minus the exponential of a polynomial of the input.
+
+Arguments:
+
+    Value - Supplies the input vector.
+
+Return Value:
+
+    Returns the output vector.
+
+--*/
+{
+    typedef typename KernelType::Vector Vector;
+    typedef typename KernelType::IntegerVector IntegerVector;
+    typedef MLAS_ERF_CONSTANTS Constants;
+
+    IntegerVector Bits = KernelType::CastToInt32(Value);
+    IntegerVector SignBits = KernelType::AndInt32(Bits, KernelType::BroadcastInt32(Constants::SignMask));
+
+    Vector AbsValue = KernelType::CastToFloat(KernelType::AndInt32(Bits, KernelType::BroadcastInt32(Constants::AbsoluteMask)));
+    AbsValue = KernelType::Minimum(KernelType::Broadcast(Constants::UpperAbsRange), AbsValue);
+
+    Vector AbsValueSquared = KernelType::Multiply(AbsValue, AbsValue);
+
+    Vector Small;
+    Small = KernelType::MultiplyAdd(AbsValueSquared, KernelType::Broadcast(Constants::SmallP0), KernelType::Broadcast(Constants::SmallP1));
+    Small = KernelType::MultiplyAdd(Small, AbsValueSquared, KernelType::Broadcast(Constants::SmallP2));
+    Small = KernelType::MultiplyAdd(Small, AbsValueSquared, KernelType::Broadcast(Constants::SmallP3));
+    Small = KernelType::MultiplyAdd(Small, AbsValueSquared, KernelType::Broadcast(Constants::SmallP4));
+    Small = KernelType::MultiplyAdd(Small, AbsValueSquared, KernelType::Broadcast(Constants::SmallP5));
+    Small = KernelType::MultiplyAdd(Small, AbsValue, AbsValue);
+
+    Vector Big;
+    Big = KernelType::MultiplyAdd(AbsValue, KernelType::Broadcast(Constants::BigP0), KernelType::Broadcast(Constants::BigP1));
+    Big = KernelType::MultiplyAdd(Big, AbsValue, KernelType::Broadcast(Constants::BigP2));
+    Big = KernelType::MultiplyAdd(Big, AbsValue, KernelType::Broadcast(Constants::BigP3));
+    Big = KernelType::MultiplyAdd(Big, AbsValue, KernelType::Broadcast(Constants::BigP4));
+    Big = KernelType::MultiplyAdd(Big, AbsValue, KernelType::Broadcast(Constants::BigP5));
+    Big = KernelType::MultiplyAdd(Big, AbsValue, KernelType::Broadcast(Constants::BigP6));
+    Big = KernelType::MultiplyAdd(Big, AbsValue, AbsValue);
+    Big = KernelType::Subtract(KernelType::Broadcast(Constants::one),
+        MlasExpVector<KernelType>(KernelType::Subtract(KernelType::Zero(), Big)));
+
+    Vector Result = KernelType::Blend(KernelType::CompareLessThan(AbsValue, KernelType::Broadcast(Constants::SplitBoundary)), Big, Small);
+
+    return KernelType::CastToFloat(KernelType::OrInt32(KernelType::CastToInt32(Result), SignBits));
+}
+
+template<typename KernelType, typename KernelType::Vector (*VectorRoutine)(typename KernelType::Vector)>
+inline
+void
+MlasComputeUnary(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine applies a vector function to a buffer of elements.
+
+    The remaining elements that do not fill a vector are copied through a
+    local buffer, so that the same vector function computes every element.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer. The output buffer may be the same as
+        the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t VectorLength = KernelType::VectorLength;
+
+    while (N >= VectorLength) {
+
+        KernelType::Store(Output, VectorRoutine(KernelType::Load(Input)));
+
+        Input += VectorLength;
+        Output += VectorLength;
+        N -= VectorLength;
+    }
+
+    if (N > 0) {
+
+        MLAS_DECLSPEC_ALIGN(float Buffer[VectorLength], 64);
+
+        std::fill_n(Buffer, VectorLength, 0.0f);
+        std::copy_n(Input, N, Buffer);
+
+        KernelType::Store(Buffer, VectorRoutine(KernelType::Load(Buffer)));
+
+        std::copy_n(Buffer, N, Output);
+    }
+}
+
+template<typename KernelType>
+inline
+float
+MlasReduceMaximum(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the maximum value of a buffer of elements.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the maximum value.
+
+--*/
+{
+    typedef typename KernelType::Vector Vector;
+
+    constexpr size_t VectorLength = KernelType::VectorLength;
+
+    Vector Maximum0 = KernelType::Broadcast(std::numeric_limits<float>::lowest());
+    Vector Maximum1 = Maximum0;
+
+    while (N >= 2 * VectorLength) {
+
+        Maximum0 = KernelType::Maximum(Maximum0, KernelType::Load(Input));
+        Maximum1 = KernelType::Maximum(Maximum1, KernelType::Load(Input + VectorLength));
+
+        Input += 2 * VectorLength;
+        N -= 2 * VectorLength;
+    }
+
+    if (N >= VectorLength) {
+
+        Maximum0 = KernelType::Maximum(Maximum0, KernelType::Load(Input));
+
+        Input += VectorLength;
+        N -= VectorLength;
+    }
+
+    float Maximum = KernelType::ReduceMaximum(KernelType::Maximum(Maximum0, Maximum1));
+
+    while (N > 0) {
+
+        Maximum = (std::max)(Maximum, *Input++);
+
+        N -= 1;
+    }
+
+    return Maximum;
+}
+
+template<typename KernelType>
+inline
+float
+MlasComputeSumExp(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float Bias
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function of each element of a
+    buffer plus a bias and returns the sum of the results.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Optionally supplies the output buffer to receive the exponential
+        of each element. The output buffer may be the same as the input
+        buffer.
+
+    N - Supplies the number of elements to process.
+
+    Bias - Supplies the value to add to each element before computing the
+        exponential function, typically the negated maximum of the input.
+
+Return Value:
+
+    Returns the sum of the exponential function of the elements.
+
+--*/
+{
+    typedef typename KernelType::Vector Vector;
+
+    constexpr size_t VectorLength = KernelType::VectorLength;
+
+    Vector BiasVector = KernelType::Broadcast(Bias);
+    Vector Accumulator0 = KernelType::Zero();
+    Vector Accumulator1 = KernelType::Zero();
+
+    while (N >= 2 * VectorLength) {
+
+        Vector Value0 = MlasExpVector<KernelType>(KernelType::Add(KernelType::Load(Input), BiasVector));
+        Vector Value1 = MlasExpVector<KernelType>(KernelType::Add(KernelType::Load(Input + VectorLength), BiasVector));
+
+        Accumulator0 = KernelType::Add(Accumulator0, Value0);
+        Accumulator1 = KernelType::Add(Accumulator1, Value1);
+
+        if (Output != nullptr) {
+            KernelType::Store(Output, Value0);
+            KernelType::Store(Output + VectorLength, Value1);
+            Output += 2 * VectorLength;
+        }
+
+        Input += 2 * VectorLength;
+        N -= 2 * VectorLength;
+    }
+
+    //
+    // The remaining elements are copied through a local buffer that is padded
+    // with negative infinity, which contributes zero to the sum.
+    //
+
+    while (N > 0) {
+
+        const size_t Count = (std::min)(N, VectorLength);
+
+        MLAS_DECLSPEC_ALIGN(float Buffer[VectorLength], 64);
+
+        std::fill_n(Buffer, VectorLength, -std::numeric_limits<float>::infinity());
+        std::copy_n(Input, Count, Buffer);
+
+        Vector Value = MlasExpVector<KernelType>(KernelType::Add(KernelType::Load(Buffer), BiasVector));
+
+        Accumulator0 = KernelType::Add(Accumulator0, Value);
+
+        if (Output != nullptr) {
+            KernelType::Store(Buffer, Value);
+            std::copy_n(Buffer, Count, Output);
+            Output += Count;
+        }
+
+        Input += Count;
+        N -= Count;
+    }
+
+    return KernelType::ReduceAdd(KernelType::Add(Accumulator0, Accumulator1));
+}
@@ -0,0 +1,329 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute_kernel_avx512f.cpp
+
+Abstract:
+
+    This module implements the kernels for the exponential, natural logarithm
+    and error functions and the reductions used by the softmax operation
+    using AVX512F instructions.
+
+--*/
+
+#include "mlasi.h"
+#include "compute_kernel.h"
+
+struct MLAS_COMPUTE_KERNEL_AVX512F
+{
+    typedef __m512 Vector;
+    typedef __m512i IntegerVector;
+    typedef __mmask16 Mask;
+
+    static constexpr size_t VectorLength = 16;
+
+    static Vector Zero()
+    {
+        return _mm512_setzero_ps();
+    }
+
+    static Vector Load(const float* Buffer)
+    {
+        return _mm512_loadu_ps(Buffer);
+    }
+
+    static void Store(float* Buffer, Vector Value)
+    {
+        _mm512_storeu_ps(Buffer, Value);
+    }
+
+    static Vector Broadcast(float Value)
+    {
+        return _mm512_set1_ps(Value);
+    }
+
+    static Vector Add(Vector Vector1, Vector Vector2)
+    {
+        return _mm512_add_ps(Vector1, Vector2);
+    }
+
+    static Vector Subtract(Vector Vector1, Vector Vector2)
+    {
+        return _mm512_sub_ps(Vector1, Vector2);
+    }
+
+    static Vector Multiply(Vector Vector1, Vector Vector2)
+    {
+        return _mm512_mul_ps(Vector1, Vector2);
+    }
+
+    static Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3)
+    {
+        return _mm512_fmadd_ps(Vector1, Vector2, Vector3);
+    }
+
+    static Vector Maximum(Vector Vector1, Vector Vector2)
+    {
+        return _mm512_max_ps(Vector1, Vector2);
+    }
+
+    static Vector Minimum(Vector Vector1, Vector Vector2)
+    {
+        return _mm512_min_ps(Vector1, Vector2);
+    }
+
+    //
+    // N.B. The upper half of the vector is extracted as a double precision
+    // vector, because extracting it as a single precision vector requires
+    // AVX512DQ.
+    //
+
+    static float ReduceAdd(Vector Value)
+    {
+        __m256 Sum = _mm256_add_ps(_mm512_castps512_ps256(Value),
+            _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(Value), 1)));
+        __m128 Sum128 = _mm_add_ps(_mm256_castps256_ps128(Sum), _mm256_extractf128_ps(Sum, 1));
+        Sum128 = _mm_add_ps(Sum128, _mm_movehl_ps(Sum128, Sum128));
+        Sum128 = _mm_add_ss(Sum128, _mm_shuffle_ps(Sum128, Sum128, _MM_SHUFFLE(1, 1, 1, 1)));
+        return _mm_cvtss_f32(Sum128);
+    }
+
+    static float ReduceMaximum(Vector Value)
+    {
+        __m256 Maximum = _mm256_max_ps(_mm512_castps512_ps256(Value),
+            _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(Value), 1)));
+        __m128 Maximum128 = _mm_max_ps(_mm256_castps256_ps128(Maximum), _mm256_extractf128_ps(Maximum, 1));
+        Maximum128 = _mm_max_ps(Maximum128, _mm_movehl_ps(Maximum128, Maximum128));
+        Maximum128 = _mm_max_ss(Maximum128, _mm_shuffle_ps(Maximum128, Maximum128, _MM_SHUFFLE(1, 1, 1, 1)));
+        return _mm_cvtss_f32(Maximum128);
+    }
+
+    static Mask CompareEqual(Vector Vector1, Vector Vector2)
+    {
+        return _mm512_cmp_ps_mask(Vector1, Vector2, _CMP_EQ_OQ);
+    }
+
+    static Mask CompareLessThan(Vector Vector1, Vector Vector2)
+    {
+        return _mm512_cmp_ps_mask(Vector1, Vector2, _CMP_LT_OQ);
+    }
+
+    static Mask CompareNotGreaterEqual(Vector Vector1, Vector Vector2)
+    {
+        return _mm512_cmp_ps_mask(Vector1, Vector2, _CMP_NGE_UQ);
+    }
+
+    static Vector Blend(Mask Selector, Vector IfFalse, Vector IfTrue)
+    {
+        return _mm512_mask_blend_ps(Selector, IfFalse, IfTrue);
+    }
+
+    static IntegerVector CastToInt32(Vector Value)
+    {
+        return _mm512_castps_si512(Value);
+    }
+
+    static Vector CastToFloat(IntegerVector Value)
+    {
+        return _mm512_castsi512_ps(Value);
+    }
+
+    static Vector ConvertInt32ToFloat(IntegerVector Value)
+    {
+        return _mm512_cvtepi32_ps(Value);
+    }
+
+    static IntegerVector BroadcastInt32(int32_t Value)
+    {
+        return _mm512_set1_epi32(Value);
+    }
+
+    static IntegerVector AddInt32(IntegerVector Vector1, IntegerVector Vector2)
+    {
+        return _mm512_add_epi32(Vector1, Vector2);
+    }
+
+    static IntegerVector SubtractInt32(IntegerVector Vector1, IntegerVector Vector2)
+    {
+        return _mm512_sub_epi32(Vector1, Vector2);
+    }
+
+    static IntegerVector AndInt32(IntegerVector Vector1, IntegerVector Vector2)
+    {
+        return _mm512_and_si512(Vector1, Vector2);
+    }
+
+    static IntegerVector OrInt32(IntegerVector Vector1, IntegerVector Vector2)
+    {
+        return _mm512_or_si512(Vector1, Vector2);
+    }
+
+    template<int Count>
+    static IntegerVector ShiftLeftInt32(IntegerVector Value)
+    {
+        return _mm512_slli_epi32(Value, Count);
+    }
+
+    template<int Count>
+    static IntegerVector ShiftRightInt32(IntegerVector Value)
+    {
+        return _mm512_srai_epi32(Value, Count);
+    }
+};
+
+void
+MLASCALL
+MlasExpKernelAvx512F(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the kernel for the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnary<MLAS_COMPUTE_KERNEL_AVX512F, MlasExpVector<MLAS_COMPUTE_KERNEL_AVX512F>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasLogKernelAvx512F(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the kernel for the natural logarithm function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnary<MLAS_COMPUTE_KERNEL_AVX512F, MlasLogVector<MLAS_COMPUTE_KERNEL_AVX512F>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasErfKernelAvx512F(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the kernel for the error function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnary<MLAS_COMPUTE_KERNEL_AVX512F, MlasErfVector<MLAS_COMPUTE_KERNEL_AVX512F>>(Input, Output, N);
+}
+
+float
+MLASCALL
+MlasReduceMaximumKernelAvx512F(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the kernel to find the maximum value of a buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the maximum value.
+
+--*/
+{
+    return MlasReduceMaximum<MLAS_COMPUTE_KERNEL_AVX512F>(Input, N);
+}
+
+float
+MLASCALL
+MlasComputeSumExpKernelAvx512F(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float Bias
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the kernel to compute the exponential function of
+    each element of a buffer plus a bias and the sum of the results.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Optionally supplies the output buffer to receive the exponential
+        of each element.
+
+    N - Supplies the number of elements to process.
+
+    Bias - Supplies the value to add to each element.
+
+Return Value:
+
+    Returns the sum of the exponential function of the elements.
+
+--*/
+{
+    return MlasComputeSumExp<MLAS_COMPUTE_KERNEL_AVX512F>(Input, Output, N, Bias);
+}
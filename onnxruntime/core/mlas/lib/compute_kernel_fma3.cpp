@@ -0,0 +1,319 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute_kernel_fma3.cpp
+
+Abstract:
+
+    This module implements the kernels for the exponential, natural logarithm
+    and error functions and the reductions used by the softmax operation
+    using AVX2 and FMA3 instructions.
+
+--*/
+
+#include "mlasi.h"
+#include "compute_kernel.h"
+
+struct MLAS_COMPUTE_KERNEL_FMA3
+{
+    typedef __m256 Vector;
+    typedef __m256i IntegerVector;
+    typedef __m256 Mask;
+
+    static constexpr size_t VectorLength = 8;
+
+    static Vector Zero()
+    {
+        return _mm256_setzero_ps();
+    }
+
+    static Vector Load(const float* Buffer)
+    {
+        return _mm256_loadu_ps(Buffer);
+    }
+
+    static void Store(float* Buffer, Vector Value)
+    {
+        _mm256_storeu_ps(Buffer, Value);
+    }
+
+    static Vector Broadcast(float Value)
+    {
+        return _mm256_set1_ps(Value);
+    }
+
+    static Vector Add(Vector Vector1, Vector Vector2)
+    {
+        return _mm256_add_ps(Vector1, Vector2);
+    }
+
+    static Vector Subtract(Vector Vector1, Vector Vector2)
+    {
+        return _mm256_sub_ps(Vector1, Vector2);
+    }
+
+    static Vector Multiply(Vector Vector1, Vector Vector2)
+    {
+        return _mm256_mul_ps(Vector1, Vector2);
+    }
+
+    static Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3)
+    {
+        return _mm256_fmadd_ps(Vector1, Vector2, Vector3);
+    }
+
+    static Vector Maximum(Vector Vector1, Vector Vector2)
+    {
+        return _mm256_max_ps(Vector1, Vector2);
+    }
+
+    static Vector Minimum(Vector Vector1, Vector Vector2)
+    {
+        return _mm256_min_ps(Vector1, Vector2);
+    }
+
+    static float ReduceAdd(Vector Value)
+    {
+        __m128 Sum = _mm_add_ps(_mm256_castps256_ps128(Value), _mm256_extractf128_ps(Value, 1));
+        Sum = _mm_add_ps(Sum, _mm_movehl_ps(Sum, Sum));
+        Sum = _mm_add_ss(Sum, _mm_shuffle_ps(Sum, Sum, _MM_SHUFFLE(1, 1, 1, 1)));
+        return _mm_cvtss_f32(Sum);
+    }
+
+    static float ReduceMaximum(Vector Value)
+    {
+        __m128 Maximum = _mm_max_ps(_mm256_castps256_ps128(Value), _mm256_extractf128_ps(Value, 1));
+        Maximum = _mm_max_ps(Maximum, _mm_movehl_ps(Maximum, Maximum));
+        Maximum = _mm_max_ss(Maximum, _mm_shuffle_ps(Maximum, Maximum, _MM_SHUFFLE(1, 1, 1, 1)));
+        return _mm_cvtss_f32(Maximum);
+    }
+
+    static Mask CompareEqual(Vector Vector1, Vector Vector2)
+    {
+        return _mm256_cmp_ps(Vector1, Vector2, _CMP_EQ_OQ);
+    }
+
+    static Mask CompareLessThan(Vector Vector1, Vector Vector2)
+    {
+        return _mm256_cmp_ps(Vector1, Vector2, _CMP_LT_OQ);
+    }
+
+    static Mask CompareNotGreaterEqual(Vector Vector1, Vector Vector2)
+    {
+        return _mm256_cmp_ps(Vector1, Vector2, _CMP_NGE_UQ);
+    }
+
+    static Vector Blend(Mask Selector, Vector IfFalse, Vector IfTrue)
+    {
+        return _mm256_blendv_ps(IfFalse, IfTrue, Selector);
+    }
+
+    static IntegerVector CastToInt32(Vector Value)
+    {
+        return _mm256_castps_si256(Value);
+    }
+
+    static Vector CastToFloat(IntegerVector Value)
+    {
+        return _mm256_castsi256_ps(Value);
+    }
+
+    static Vector ConvertInt32ToFloat(IntegerVector Value)
+    {
+        return _mm256_cvtepi32_ps(Value);
+    }
+
+    static IntegerVector BroadcastInt32(int32_t Value)
+    {
+        return _mm256_set1_epi32(Value);
+    }
+
+    static IntegerVector AddInt32(IntegerVector Vector1, IntegerVector Vector2)
+    {
+        return _mm256_add_epi32(Vector1, Vector2);
+    }
+
+    static IntegerVector SubtractInt32(IntegerVector Vector1, IntegerVector Vector2)
+    {
+        return _mm256_sub_epi32(Vector1, Vector2);
+    }
+
+    static IntegerVector AndInt32(IntegerVector Vector1, IntegerVector Vector2)
+    {
+        return _mm256_and_si256(Vector1, Vector2);
+    }
+
+    static IntegerVector OrInt32(IntegerVector Vector1, IntegerVector Vector2)
+    {
+        return _mm256_or_si256(Vector1, Vector2);
+    }
+
+    template<int Count>
+    static IntegerVector ShiftLeftInt32(IntegerVector Value)
+    {
+        return _mm256_slli_epi32(Value, Count);
+    }
+
+    template<int Count>
+    static IntegerVector ShiftRightInt32(IntegerVector Value)
+    {
+        return _mm256_srai_epi32(Value, Count);
+    }
+};
+
+void
+MLASCALL
+MlasExpKernelFma3(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the kernel for the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnary<MLAS_COMPUTE_KERNEL_FMA3, MlasExpVector<MLAS_COMPUTE_KERNEL_FMA3>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasLogKernelFma3(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the kernel for the natural logarithm function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnary<MLAS_COMPUTE_KERNEL_FMA3, MlasLogVector<MLAS_COMPUTE_KERNEL_FMA3>>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasErfKernelFma3(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the kernel for the error function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeUnary<MLAS_COMPUTE_KERNEL_FMA3, MlasErfVector<MLAS_COMPUTE_KERNEL_FMA3>>(Input, Output, N);
+}
+
+float
+MLASCALL
+MlasReduceMaximumKernelFma3(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the kernel to find the maximum value of a buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the maximum value.
+
+--*/
+{
+    return MlasReduceMaximum<MLAS_COMPUTE_KERNEL_FMA3>(Input, N);
+}
+
+float
+MLASCALL
+MlasComputeSumExpKernelFma3(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float Bias
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the kernel to compute the exponential function of
+    each element of a buffer plus a bias and the sum of the results.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Optionally supplies the output buffer to receive the exponential
+        of each element.
+
+    N - Supplies the number of elements to process.
+
+    Bias - Supplies the value to add to each element.
+
+Return Value:
+
+    Returns the sum of the exponential function of the elements.
+
+--*/
+{
+    return MlasComputeSumExp<MLAS_COMPUTE_KERNEL_FMA3>(Input, Output, N, Bias);
+}
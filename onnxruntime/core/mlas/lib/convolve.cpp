@@ -23,6 +23,24 @@ Abstract:
 #define MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD \
     (MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK)
 
+//
+// Define the minimum number of input channels, filters, and output elements
+// for a Winograd convolution and the target number of tiles transformed by
+// each thread segment.
+//
+
+#define MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS         16
+#define MLAS_CONV_WINOGRAD_MINIMUM_OUTPUT           256
+#define MLAS_CONV_WINOGRAD_SEGMENT_TILES            64
+
+//
+// Define the maximum number of filters and filter elements (K) for a direct
+// convolution. Larger convolutions are better served by the GEMM.
+//
+
+#define MLAS_CONV_DIRECT_MAXIMUM_FILTERS            16
+#define MLAS_CONV_DIRECT_MAXIMUM_K                  256
+
 //
 // Define the parameters to execute segments of a convolution operation on
 // worker threads.
@@ -35,10 +53,6 @@ struct MLAS_CONV_WORK_BLOCK {
     const float* Bias;
     float* WorkingBuffer;
     float* Output;
-    struct SEGMENT {
-        size_t StartN;
-        size_t CountN;
-    } Segments[MLAS_MAXIMUM_THREAD_COUNT];
     int32_t TargetThreadCount;
 };
 
@@ -592,7 +606,7 @@ Return Value:
 
             MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountN,
                 CountK, 1.0f, Filter + k, K, ColumnBuffer, CountN, beta,
-                SegmentOutput, OutputSize);
+                SegmentOutput, OutputSize, nullptr);
 
             beta = 1.0f;
         }
@@ -632,14 +646,24 @@ Return Value:
 {
     MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
 
-    MLAS_CONV_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    //
+    // Compute the slice of the N dimension that is owned by this thread.
+    //
+
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t ThreadStrideN = Parameters->u.ExpandThenGemmSegmented.ThreadStrideN;
+
+    const size_t SegmentStartN = size_t(Index) * ThreadStrideN;
+    const size_t SegmentCountN = std::min(OutputSize - SegmentStartN, ThreadStrideN);
 
     float* ColumnBuffer =
         WorkBlock->WorkingBuffer + Index * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
 
-    MlasConvOperation(WorkBlock->Parameters, WorkBlock->Input, WorkBlock->Filter,
-        WorkBlock->Bias, ColumnBuffer, WorkBlock->Output, Segment->StartN,
-        Segment->CountN);
+    MlasConvOperation(Parameters, WorkBlock->Input, WorkBlock->Filter,
+        WorkBlock->Bias, ColumnBuffer, WorkBlock->Output, SegmentStartN,
+        SegmentCountN);
 }
 
 void
@@ -677,21 +701,13 @@ Return Value:
     const size_t GroupCount = Parameters->GroupCount;
     const size_t BatchGroupCount = Parameters->BatchCount * GroupCount;
 
-    const size_t TargetThreadCount = WorkBlock->TargetThreadCount;
-
-    const size_t BatchGroupCountPerThread = BatchGroupCount / TargetThreadCount;
-    const size_t BatchGroupCountExtra = BatchGroupCount % TargetThreadCount;
-
     size_t BatchGroupStart;
-    size_t BatchGroupEnd;
+    size_t BatchGroupRemaining;
 
-    if (uint32_t(Index) < BatchGroupCountExtra) {
-        BatchGroupStart = (BatchGroupCountPerThread + 1) * Index;
-        BatchGroupEnd = BatchGroupStart + BatchGroupCountPerThread + 1;
-    } else {
-        BatchGroupStart = BatchGroupCountPerThread * Index + BatchGroupCountExtra;
-        BatchGroupEnd = BatchGroupStart + BatchGroupCountPerThread;
-    }
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount, BatchGroupCount,
+        &BatchGroupStart, &BatchGroupRemaining);
+
+    size_t BatchGroupEnd = BatchGroupStart + BatchGroupRemaining;
 
     //
     // Iterate over the batch and groups allocated to this thread.
@@ -719,7 +735,7 @@ Return Value:
 
         MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
             OutputSize, K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, 0.0f,
-            output, OutputSize);
+            output, OutputSize, nullptr);
 
         //
         // Apply the activation with optional bias.
@@ -736,128 +752,314 @@ Return Value:
     }
 }
 
+//
+// Define the Winograd minimal filtering transforms F(2x2, 3x3) and F(4x4, 3x3).
+//
+// Each transform is the one dimensional transform that is applied to the
+// columns and then to the rows of a tile. The input and output transforms
+// operate on vectors where each lane holds the same element from adjacent
+// tiles along the width of the image.
+//
+
+template<size_t TileSize>
+struct MLAS_CONV_WINOGRAD_TRANSFORM;
+
+template<>
+struct MLAS_CONV_WINOGRAD_TRANSFORM<2>
+{
+    static constexpr size_t InputTileSize = 4;
+
+    static
+    void
+    TransformFilter(
+        const MLAS_FLOAT32X4* g,
+        size_t gs,
+        MLAS_FLOAT32X4* u,
+        size_t us
+        )
+    {
+        const MLAS_FLOAT32X4 Half = MlasBroadcastFloat32x4(0.5f);
+
+        MLAS_FLOAT32X4 t0 = MlasAddFloat32x4(g[0 * gs], g[2 * gs]);
+
+        u[0 * us] = g[0 * gs];
+        u[1 * us] = MlasMultiplyFloat32x4(MlasAddFloat32x4(t0, g[1 * gs]), Half);
+        u[2 * us] = MlasMultiplyFloat32x4(MlasSubtractFloat32x4(t0, g[1 * gs]), Half);
+        u[3 * us] = g[2 * gs];
+    }
+
+    static
+    void
+    TransformInput(
+        const MLAS_FLOAT32X4* d,
+        size_t ds,
+        MLAS_FLOAT32X4* v,
+        size_t vs
+        )
+    {
+        v[0 * vs] = MlasSubtractFloat32x4(d[0 * ds], d[2 * ds]);
+        v[1 * vs] = MlasAddFloat32x4(d[1 * ds], d[2 * ds]);
+        v[2 * vs] = MlasSubtractFloat32x4(d[2 * ds], d[1 * ds]);
+        v[3 * vs] = MlasSubtractFloat32x4(d[1 * ds], d[3 * ds]);
+    }
+
+    static
+    void
+    TransformOutput(
+        const MLAS_FLOAT32X4* m,
+        size_t ms,
+        MLAS_FLOAT32X4* y,
+        size_t ys
+        )
+    {
+        y[0 * ys] = MlasAddFloat32x4(MlasAddFloat32x4(m[0 * ms], m[1 * ms]), m[2 * ms]);
+        y[1 * ys] = MlasSubtractFloat32x4(MlasSubtractFloat32x4(m[1 * ms], m[2 * ms]), m[3 * ms]);
+    }
+};
+
+template<>
+struct MLAS_CONV_WINOGRAD_TRANSFORM<4>
+{
+    static constexpr size_t InputTileSize = 6;
+
+    static
+    void
+    TransformFilter(
+        const MLAS_FLOAT32X4* g,
+        size_t gs,
+        MLAS_FLOAT32X4* u,
+        size_t us
+        )
+    {
+        MLAS_FLOAT32X4 t0 = MlasAddFloat32x4(g[0 * gs], g[2 * gs]);
+        MLAS_FLOAT32X4 t1 = MlasMultiplyAddFloat32x4(g[0 * gs], MlasBroadcastFloat32x4(1.0f / 24.0f),
+            MlasMultiplyFloat32x4(g[2 * gs], MlasBroadcastFloat32x4(1.0f / 6.0f)));
+        MLAS_FLOAT32X4 t2 = MlasMultiplyFloat32x4(g[1 * gs], MlasBroadcastFloat32x4(1.0f / 12.0f));
+
+        const MLAS_FLOAT32X4 MinusOneSixth = MlasBroadcastFloat32x4(-1.0f / 6.0f);
+
+        u[0 * us] = MlasMultiplyFloat32x4(g[0 * gs], MlasBroadcastFloat32x4(1.0f / 4.0f));
+        u[1 * us] = MlasMultiplyFloat32x4(MlasAddFloat32x4(t0, g[1 * gs]), MinusOneSixth);
+        u[2 * us] = MlasMultiplyFloat32x4(MlasSubtractFloat32x4(t0, g[1 * gs]), MinusOneSixth);
+        u[3 * us] = MlasAddFloat32x4(t1, t2);
+        u[4 * us] = MlasSubtractFloat32x4(t1, t2);
+        u[5 * us] = g[2 * gs];
+    }
+
+    static
+    void
+    TransformInput(
+        const MLAS_FLOAT32X4* d,
+        size_t ds,
+        MLAS_FLOAT32X4* v,
+        size_t vs
+        )
+    {
+        const MLAS_FLOAT32X4 Four = MlasBroadcastFloat32x4(4.0f);
+        const MLAS_FLOAT32X4 MinusFour = MlasBroadcastFloat32x4(-4.0f);
+        const MLAS_FLOAT32X4 MinusFive = MlasBroadcastFloat32x4(-5.0f);
+
+        MLAS_FLOAT32X4 t0 = MlasMultiplyAddFloat32x4(d[2 * ds], MinusFour, d[4 * ds]);
+        MLAS_FLOAT32X4 t1 = MlasMultiplyAddFloat32x4(d[1 * ds], MinusFour, d[3 * ds]);
+        MLAS_FLOAT32X4 t2 = MlasSubtractFloat32x4(d[4 * ds], d[2 * ds]);
+        MLAS_FLOAT32X4 t3 = MlasSubtractFloat32x4(d[3 * ds], d[1 * ds]);
+
+        t3 = MlasAddFloat32x4(t3, t3);
+
+        v[0 * vs] = MlasMultiplyAddFloat32x4(d[0 * ds], Four, MlasMultiplyAddFloat32x4(d[2 * ds], MinusFive, d[4 * ds]));
+        v[1 * vs] = MlasAddFloat32x4(t0, t1);
+        v[2 * vs] = MlasSubtractFloat32x4(t0, t1);
+        v[3 * vs] = MlasAddFloat32x4(t2, t3);
+        v[4 * vs] = MlasSubtractFloat32x4(t2, t3);
+        v[5 * vs] = MlasMultiplyAddFloat32x4(d[1 * ds], Four, MlasMultiplyAddFloat32x4(d[3 * ds], MinusFive, d[5 * ds]));
+    }
+
+    static
+    void
+    TransformOutput(
+        const MLAS_FLOAT32X4* m,
+        size_t ms,
+        MLAS_FLOAT32X4* y,
+        size_t ys
+        )
+    {
+        const MLAS_FLOAT32X4 Two = MlasBroadcastFloat32x4(2.0f);
+        const MLAS_FLOAT32X4 Four = MlasBroadcastFloat32x4(4.0f);
+        const MLAS_FLOAT32X4 Eight = MlasBroadcastFloat32x4(8.0f);
+
+        MLAS_FLOAT32X4 t0 = MlasAddFloat32x4(m[1 * ms], m[2 * ms]);
+        MLAS_FLOAT32X4 t1 = MlasSubtractFloat32x4(m[1 * ms], m[2 * ms]);
+        MLAS_FLOAT32X4 t2 = MlasAddFloat32x4(m[3 * ms], m[4 * ms]);
+        MLAS_FLOAT32X4 t3 = MlasSubtractFloat32x4(m[3 * ms], m[4 * ms]);
+
+        y[0 * ys] = MlasAddFloat32x4(MlasAddFloat32x4(m[0 * ms], t0), t2);
+        y[1 * ys] = MlasMultiplyAddFloat32x4(t3, Two, t1);
+        y[2 * ys] = MlasMultiplyAddFloat32x4(t2, Four, t0);
+        y[3 * ys] = MlasAddFloat32x4(MlasMultiplyAddFloat32x4(t3, Eight, t1), m[5 * ms]);
+    }
+};
+
 inline
-bool
-MlasConvTryMultithread(
-    const MLAS_CONV_PARAMETERS* Parameters,
-    const float* Input,
-    const float* Filter,
-    const float* Bias,
-    float* WorkingBuffer,
-    float* Output
+size_t
+MlasConvWinogradThreadBufferSize(
+    const MLAS_CONV_PARAMETERS* Parameters
     )
 /*++
 
 Routine Description:
 
-    This routine attempts to launch a convolution operation across multiple
-    threads.
+    This routine computes the number of working buffer elements used by each
+    thread of a Winograd convolution to transform a segment of tiles.
 
 Arguments:
 
     Parameters - Supplies the structure that contains the convolution
         parameters.
 
-    Input - Supplies the input tensor.
+Return Value:
 
-    Filter - Supplies the filter tensor.
+    Returns the number of working buffer elements.
 
-    Bias - Optionally supplies the bias vector.
+--*/
+{
+    const size_t TileSize = Parameters->u.Winograd.TileSize;
+    const size_t InputTileSize = TileSize + 2;
+    const size_t TileCountW = Parameters->u.Winograd.TileCountW;
+    const size_t SegmentTileCount = Parameters->u.Winograd.SegmentTileRows * TileCountW;
 
-    WorkingBuffer - Supplies a working buffer sized to the number of elements
-        returned by MlasConvPrepare.
+    //
+    // Each thread stores the transformed input tiles, the transformed output
+    // tiles, and a staging buffer for a single row of tiles.
+    //
 
-    Output - Supplies the output tensor.
+    return InputTileSize * InputTileSize * (Parameters->InputChannels + Parameters->FilterCount) *
+        SegmentTileCount + InputTileSize * TileSize * (TileCountW + 1);
+}
 
-Return Value:
+template<size_t TileSize>
+void
+MlasConvWinogradTransformFilter(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Filter,
+    float* TransformedFilter,
+    size_t FilterStart,
+    size_t FilterCount
+    )
+/*++
 
-    Returns true if the operation was completed across multiple threads, else
-    false if the operation should fall back to a single thread.
+Routine Description:
 
---*/
-{
+    This routine transforms a range of 3x3 filters to the Winograd domain.
 
-#if defined(MLAS_HAS_THREADING_SUPPORT)
+    The transformed filters are stored as InputTileSize^2 interleaved matrices
+    of FilterCount rows by InputChannels columns, so that each matrix can be
+    used as the A operand of a GEMM with a leading dimension of
+    InputTileSize^2 * InputChannels. This keeps the transformed elements of
+    each filter contiguous.
 
-    MLAS_CONV_WORK_BLOCK WorkBlock;
+Arguments:
 
-    const size_t OutputSize = Parameters->OutputSize;
-    const size_t ThreadStrideN = Parameters->u.ExpandThenGemmSegmented.ThreadStrideN;
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
 
-    if (ThreadStrideN >= OutputSize) {
-        return false;
-    }
+    Filter - Supplies the filter tensor.
 
-    //
-    // Initialize the common fields of the work block.
-    //
+    TransformedFilter - Supplies the buffer to receive the transformed filters.
 
-    WorkBlock.Parameters = Parameters;
-    WorkBlock.Input = Input;
-    WorkBlock.Filter = Filter;
-    WorkBlock.Bias = Bias;
-    WorkBlock.WorkingBuffer = WorkingBuffer;
-    WorkBlock.Output = Output;
+    FilterStart - Supplies the index of the first filter to transform.
 
-    //
-    // Segment the operation across multiple threads.
-    //
+    FilterCount - Supplies the number of filters to transform.
+
+Return Value:
 
-    int32_t Index = 0;
-    size_t SegmentCountN;
+    None.
 
-    for (size_t SegmentStartN = 0; SegmentStartN < OutputSize; SegmentStartN += SegmentCountN) {
+--*/
+{
+    typedef MLAS_CONV_WINOGRAD_TRANSFORM<TileSize> Transform;
 
-        SegmentCountN = OutputSize - SegmentStartN;
+    constexpr size_t InputTileSize = Transform::InputTileSize;
+    constexpr size_t MatrixCount = InputTileSize * InputTileSize;
 
-        if (SegmentCountN > ThreadStrideN) {
-            SegmentCountN = ThreadStrideN;
-        }
+    const size_t InputChannels = Parameters->InputChannels;
 
-        WorkBlock.Segments[Index].StartN = SegmentStartN;
-        WorkBlock.Segments[Index].CountN = SegmentCountN;
+    for (size_t f = FilterStart; f < FilterStart + FilterCount; f++) {
 
-        Index++;
-    }
+        const float* filter = Filter + f * InputChannels * 9;
+        float* output = TransformedFilter + f * MatrixCount * InputChannels;
 
-    MlasExecuteThreaded(MlasConvOperationThreaded, &WorkBlock, Index);
+        //
+        // Transform the filters for four input channels at a time, with the
+        // vector lanes holding the elements from each input channel.
+        //
 
-    return true;
+        for (size_t c = 0; c < InputChannels; c += 4) {
 
-#else
+            const size_t ChannelCount = std::min(InputChannels - c, size_t(4));
 
-    //
-    // No threading implementation is available.
-    //
+            MLAS_DECLSPEC_ALIGN(float Elements[9][4], 16);
+
+            for (size_t i = 0; i < 9; i++) {
+                for (size_t lane = 0; lane < 4; lane++) {
+                    Elements[i][lane] = (lane < ChannelCount) ? filter[(c + lane) * 9 + i] : 0.0f;
+                }
+            }
 
-    MLAS_UNREFERENCED_PARAMETER(Parameters);
-    MLAS_UNREFERENCED_PARAMETER(Input);
-    MLAS_UNREFERENCED_PARAMETER(Filter);
-    MLAS_UNREFERENCED_PARAMETER(Bias);
-    MLAS_UNREFERENCED_PARAMETER(WorkingBuffer);
-    MLAS_UNREFERENCED_PARAMETER(Output);
+            MLAS_FLOAT32X4 g[9];
+            MLAS_FLOAT32X4 t[InputTileSize][3];
+            MLAS_FLOAT32X4 u[InputTileSize][InputTileSize];
 
-    return false;
+            for (size_t i = 0; i < 9; i++) {
+                g[i] = MlasLoadFloat32x4(Elements[i]);
+            }
 
-#endif
+            for (size_t j = 0; j < 3; j++) {
+                Transform::TransformFilter(&g[j], 3, &t[0][j], 3);
+            }
+
+            for (size_t i = 0; i < InputTileSize; i++) {
+                Transform::TransformFilter(&t[i][0], 1, &u[i][0], 1);
+            }
+
+            for (size_t i = 0; i < InputTileSize; i++) {
+                for (size_t j = 0; j < InputTileSize; j++) {
 
+                    float* transformed = output + (i * InputTileSize + j) * InputChannels + c;
+
+                    if (ChannelCount == 4) {
+                        MlasStoreFloat32x4(transformed, u[i][j]);
+                    } else {
+                        MlasStoreAlignedFloat32x4(Elements[0], u[i][j]);
+                        std::copy_n(Elements[0], ChannelCount, transformed);
+                    }
+                }
+            }
+        }
+    }
 }
 
+template<size_t TileSize>
 void
-MLASCALL
-MlasConv(
+MlasConvWinogradOperation(
     const MLAS_CONV_PARAMETERS* Parameters,
     const float* Input,
-    const float* Filter,
+    const float* TransformedFilter,
     const float* Bias,
     float* WorkingBuffer,
-    float* Output
+    float* Output,
+    size_t TileRowStart,
+    size_t TileRowCount
     )
 /*++
 
 Routine Description:
 
-    This routine implements the convolution operation.
+    This routine computes a segment of rows of output tiles for a Winograd
+    convolution.
+
+    The input tiles are transformed to InputTileSize^2 matrices of
+    InputChannels rows by tile count columns, multiplied by the transformed
+    filters, and then the products are transformed back to output tiles.
 
 Arguments:
 
@@ -866,161 +1068,1129 @@ Arguments:
 
     Input - Supplies the input tensor.
 
-    Filter - Supplies the filter tensor.
+    TransformedFilter - Supplies the filters returned from
+        MlasConvWinogradTransformFilter.
 
     Bias - Optionally supplies the bias vector.
 
-    WorkingBuffer - Supplies a working buffer sized to the number of elements
-        returned by MlasConvPrepare.
+    WorkingBuffer - Supplies the working buffer for this segment sized by
+        MlasConvWinogradThreadBufferSize.
 
     Output - Supplies the output tensor.
 
+    TileRowStart - Supplies the first row of tiles to compute.
+
+    TileRowCount - Supplies the number of rows of tiles to compute.
+
 Return Value:
 
     None.
 
 --*/
 {
+    typedef MLAS_CONV_WINOGRAD_TRANSFORM<TileSize> Transform;
+
+    constexpr size_t InputTileSize = Transform::InputTileSize;
+    constexpr size_t MatrixCount = InputTileSize * InputTileSize;
+
+    const size_t InputChannels = Parameters->InputChannels;
     const size_t FilterCount = Parameters->FilterCount;
+
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
     const size_t OutputSize = Parameters->OutputSize;
-    const size_t K = Parameters->K;
 
-    const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
-    const size_t OutputGroupSize = FilterCount * OutputSize;
-    const size_t FilterGroupSize = FilterCount * K;
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
 
-    const size_t BatchCount = Parameters->BatchCount;
-    const size_t GroupCount = Parameters->GroupCount;
+    //
+    // The tile count along the width is padded to a multiple of the vector
+    // width. The padded tiles are computed from zeros and are not stored.
+    //
 
-    const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
+    const size_t TileCountW = Parameters->u.Winograd.TileCountW;
+    const size_t TileCount = TileRowCount * TileCountW;
+    const size_t StageCountW = TileCountW + 1;
 
-#if defined(MLAS_HAS_THREADING_SUPPORT)
+    float* TransformedInput = WorkingBuffer;
+    float* TransformedOutput = TransformedInput + MatrixCount * InputChannels * TileCount;
+    float* Stage = TransformedOutput + MatrixCount * FilterCount * TileCount;
 
     //
-    // Schedule batches of GEMMs across multiple threads.
+    // Transform the input tiles.
+    //
+    // Each row of input required by a row of tiles is split into TileSize
+    // phases, so that the input tiles for adjacent output tiles can be loaded
+    // as vectors.
     //
 
-    if (Algorithm == MlasConvAlgorithmGemmDirect && ((BatchCount > 1) || (GroupCount > 1))) {
+    for (size_t c = 0; c < InputChannels; c++) {
 
-        const size_t BatchGroupCount = BatchCount * GroupCount;
+        const float* input = Input + c * InputSize;
 
-        int32_t TargetThreadCount = MlasPlatform.GetMaximumThreadCount();
+        for (size_t r = 0; r < TileRowCount; r++) {
 
-        if (size_t(TargetThreadCount) >= BatchGroupCount) {
-            TargetThreadCount = int32_t(BatchGroupCount);
-        }
+            size_t InputY = (TileRowStart + r) * TileSize - PaddingTop;
 
-        MLAS_CONV_WORK_BLOCK WorkBlock;
+            for (size_t i = 0; i < InputTileSize; i++, InputY++) {
 
-        WorkBlock.Parameters = Parameters;
-        WorkBlock.Input = Input;
-        WorkBlock.Filter = Filter;
-        WorkBlock.Bias = Bias;
-        WorkBlock.WorkingBuffer = nullptr;
-        WorkBlock.Output = Output;
-        WorkBlock.TargetThreadCount = TargetThreadCount;
+                float* stage = Stage + i * TileSize * StageCountW;
 
-        MlasExecuteThreaded(MlasConvGemmDirectThreaded, &WorkBlock, TargetThreadCount);
+                if (InputY < InputHeight) {
 
-        return;
-    }
+                    const float* InputRow = input + InputY * InputWidth;
+                    size_t InputX = 0 - PaddingLeft;
 
-#endif
+                    for (size_t x = 0; x < StageCountW; x++) {
+                        for (size_t phase = 0; phase < TileSize; phase++, InputX++) {
+                            stage[phase * StageCountW + x] = (InputX < InputWidth) ? InputRow[InputX] : 0.0f;
+                        }
+                    }
 
-    //
-    // Iterate over each batch and group.
-    //
+                } else {
 
-    for (size_t batch = 0; batch < BatchCount; batch++) {
+                    std::fill_n(stage, TileSize * StageCountW, 0.0f);
+                }
+            }
 
-        const float* filter = Filter;
-        const float* bias = Bias;
+            for (size_t x = 0; x < TileCountW; x += 4) {
 
-        for (size_t group = 0; group < GroupCount; group++) {
+                MLAS_FLOAT32X4 d[InputTileSize][InputTileSize];
+                MLAS_FLOAT32X4 t[InputTileSize][InputTileSize];
 
-            //
-            // Dispatch the convolution.
-            //
+                for (size_t i = 0; i < InputTileSize; i++) {
+                    for (size_t j = 0; j < InputTileSize; j++) {
+                        d[i][j] = MlasLoadFloat32x4(Stage + ((i * TileSize) + (j % TileSize)) * StageCountW + (j / TileSize) + x);
+                    }
+                }
 
-            switch (Algorithm) {
+                for (size_t j = 0; j < InputTileSize; j++) {
+                    Transform::TransformInput(&d[0][j], InputTileSize, &t[0][j], InputTileSize);
+                }
 
-                case MlasConvAlgorithmGemmDirect:
-                {
-                    //
-                    // Invoke the threaded GEMM directly with the input tensor.
-                    //
+                for (size_t i = 0; i < InputTileSize; i++) {
+                    Transform::TransformInput(&t[i][0], 1, &d[i][0], 1);
+                }
 
-                    MlasSgemm(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
-                        OutputSize, K, 1.0f, filter, K, Input, Parameters->u.GemmDirect.ldb, 0.0f,
-                        Output, OutputSize);
+                float* v = TransformedInput + c * TileCount + r * TileCountW + x;
 
-                    //
-                    // Apply the activation with optional bias.
-                    //
+                for (size_t i = 0; i < InputTileSize; i++) {
+                    for (size_t j = 0; j < InputTileSize; j++) {
+                        MlasStoreFloat32x4(v + (i * InputTileSize + j) * InputChannels * TileCount, d[i][j]);
+                    }
+                }
+            }
+        }
+    }
 
-                    MlasActivation(Parameters->Activation, Output, bias, FilterCount, Output,
-                        OutputSize, OutputSize);
+    //
+    // Multiply the transformed filters by the transformed input tiles.
+    //
 
-                    break;
-                }
+    for (size_t i = 0; i < MatrixCount; i++) {
 
-                case MlasConvAlgorithmExpandThenGemm:
-                {
-                    //
-                    // Expand the input tensor to the working buffer and then invoke the
-                    // threaded GEMM.
-                    //
+        MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, TileCount,
+            InputChannels, 1.0f, TransformedFilter + i * InputChannels,
+            MatrixCount * InputChannels, TransformedInput + i * InputChannels * TileCount, TileCount,
+            0.0f, TransformedOutput + i * FilterCount * TileCount, TileCount, nullptr);
+    }
 
-                    if (Parameters->Dimensions == 2) {
-                        MlasConvIm2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
-                    } else {
-                        MlasConvVol2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
-                    }
+    //
+    // Transform the products to the output tiles.
+    //
 
-                    MlasSgemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f, filter,
-                        K, WorkingBuffer, OutputSize, 0.0f, Output, OutputSize);
+    const size_t OutputYStart = TileRowStart * TileSize;
+    const size_t OutputYEnd = std::min(OutputYStart + TileRowCount * TileSize, OutputHeight);
 
-                    //
-                    // Apply the activation with optional bias.
-                    //
+    for (size_t f = 0; f < FilterCount; f++) {
 
-                    MlasActivation(Parameters->Activation, Output, bias, FilterCount, Output,
-                        OutputSize, OutputSize);
+        float* output = Output + f * OutputSize;
 
-                    break;
-                }
+        for (size_t r = 0; r < TileRowCount; r++) {
 
-                case MlasConvAlgorithmExpandThenGemmSegmented:
-                {
-                    //
-                    // Attempt to launch the convolution across multiple threads or fall
-                    // back to a single thread.
-                    //
+            for (size_t x = 0; x < TileCountW; x += 4) {
 
-                    if (!MlasConvTryMultithread(Parameters, Input, filter, bias, WorkingBuffer,
-                        Output)) {
-                        MlasConvOperation(Parameters, Input, filter, bias, WorkingBuffer,
-                            Output, 0, OutputSize);
+                MLAS_FLOAT32X4 m[InputTileSize][InputTileSize];
+                MLAS_FLOAT32X4 s[TileSize][InputTileSize];
+                MLAS_FLOAT32X4 y[TileSize][TileSize];
+
+                const float* p = TransformedOutput + f * TileCount + r * TileCountW + x;
+
+                for (size_t i = 0; i < InputTileSize; i++) {
+                    for (size_t j = 0; j < InputTileSize; j++) {
+                        m[i][j] = MlasLoadFloat32x4(p + (i * InputTileSize + j) * FilterCount * TileCount);
                     }
+                }
 
-                    break;
+                for (size_t j = 0; j < InputTileSize; j++) {
+                    Transform::TransformOutput(&m[0][j], InputTileSize, &s[0][j], InputTileSize);
+                }
+
+                for (size_t i = 0; i < TileSize; i++) {
+                    Transform::TransformOutput(&s[i][0], 1, &y[i][0], 1);
+                }
+
+                for (size_t i = 0; i < TileSize; i++) {
+                    for (size_t j = 0; j < TileSize; j++) {
+                        MlasStoreFloat32x4(Stage + (i * TileSize + j) * TileCountW + x, y[i][j]);
+                    }
                 }
             }
 
             //
-            // Advance the buffer pointers.
+            // Copy the output tiles to the output rows, skipping any padded
+            // tiles beyond the output dimensions.
             //
 
-            if (bias != nullptr) {
-                bias += FilterCount;
-            }
+            size_t OutputY = (TileRowStart + r) * TileSize;
 
-            filter += FilterGroupSize;
-            Input += InputGroupSize;
-            Output += OutputGroupSize;
-        }
-    }
-}
+            for (size_t i = 0; i < TileSize && OutputY < OutputHeight; i++, OutputY++) {
+
+                float* OutputRow = output + OutputY * OutputWidth;
+                const float* stage = Stage + i * TileSize * TileCountW;
+
+                for (size_t OutputX = 0; OutputX < OutputWidth; OutputX++) {
+                    OutputRow[OutputX] = stage[(OutputX % TileSize) * TileCountW + (OutputX / TileSize)];
+                }
+            }
+        }
+    }
+
+    //
+    // Apply the activation with optional bias to the rows of this segment.
+    //
+
+    float* SegmentOutput = Output + OutputYStart * OutputWidth;
+
+    MlasActivation(Parameters->Activation, SegmentOutput, Bias, FilterCount,
+        SegmentOutput, (OutputYEnd - OutputYStart) * OutputWidth, OutputSize);
+}
+
+void
+MlasConvWinogradTransformFilterThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to transform a range of
+    filters for a Winograd convolution.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    size_t FilterStart;
+    size_t FilterRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount, Parameters->FilterCount,
+        &FilterStart, &FilterRemaining);
+
+    if (Parameters->u.Winograd.TileSize == 4) {
+        MlasConvWinogradTransformFilter<4>(Parameters, WorkBlock->Filter,
+            WorkBlock->WorkingBuffer, FilterStart, FilterRemaining);
+    } else {
+        MlasConvWinogradTransformFilter<2>(Parameters, WorkBlock->Filter,
+            WorkBlock->WorkingBuffer, FilterStart, FilterRemaining);
+    }
+}
+
+void
+MlasConvWinogradThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to compute the segments of
+    tile rows for a Winograd convolution.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t TileSize = Parameters->u.Winograd.TileSize;
+    const size_t InputTileSize = TileSize + 2;
+    const size_t TileCountH = Parameters->u.Winograd.TileCountH;
+    const size_t SegmentTileRows = Parameters->u.Winograd.SegmentTileRows;
+
+    //
+    // The transformed filters are stored at the start of the working buffer,
+    // followed by the per-thread buffers.
+    //
+
+    const float* TransformedFilter = WorkBlock->WorkingBuffer;
+
+    float* ThreadBuffer = WorkBlock->WorkingBuffer +
+        InputTileSize * InputTileSize * Parameters->FilterCount * Parameters->InputChannels +
+        Index * MlasConvWinogradThreadBufferSize(Parameters);
+
+    //
+    // Compute the range of segments to use for this thread.
+    //
+
+    const size_t SegmentCount = (TileCountH + SegmentTileRows - 1) / SegmentTileRows;
+
+    size_t SegmentStart;
+    size_t SegmentRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount, SegmentCount,
+        &SegmentStart, &SegmentRemaining);
+
+    for (size_t segment = SegmentStart; segment < SegmentStart + SegmentRemaining; segment++) {
+
+        const size_t TileRowStart = segment * SegmentTileRows;
+        const size_t TileRowCount = std::min(TileCountH - TileRowStart, SegmentTileRows);
+
+        if (TileSize == 4) {
+            MlasConvWinogradOperation<4>(Parameters, WorkBlock->Input, TransformedFilter,
+                WorkBlock->Bias, ThreadBuffer, WorkBlock->Output, TileRowStart, TileRowCount);
+        } else {
+            MlasConvWinogradOperation<2>(Parameters, WorkBlock->Input, TransformedFilter,
+                WorkBlock->Bias, ThreadBuffer, WorkBlock->Output, TileRowStart, TileRowCount);
+        }
+    }
+}
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a 3x3 convolution with unit strides and dilations
+    for a single batch and group using the Winograd minimal filtering
+    algorithm.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        operation should execute on the calling thread.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.Output = Output;
+
+    //
+    // Transform the filters and then compute the segments of tile rows. Both
+    // phases are partitioned across the threads reserved by MlasConvPrepare.
+    //
+
+    int32_t ThreadCount = int32_t(Parameters->u.Winograd.ThreadCount);
+
+    WorkBlock.TargetThreadCount = std::min(ThreadCount, int32_t(Parameters->FilterCount));
+
+    MlasExecuteThreaded(MlasConvWinogradTransformFilterThreaded, &WorkBlock,
+        WorkBlock.TargetThreadCount, ThreadPool);
+
+    WorkBlock.TargetThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasConvWinogradThreaded, &WorkBlock, ThreadCount, ThreadPool);
+}
+
+template<size_t FilterCount, size_t VectorCount>
+inline
+void
+MlasConvDirectKernelBlock(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StoreCount,
+    size_t InputChannels,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t InputStrideChannel,
+    size_t InputStrideKernelY,
+    size_t PhaseWidth,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterStride,
+    size_t OutputStrideFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of VectorCount vectors of adjacent output
+    elements for FilterCount filters.
+
+Arguments:
+
+    StoreCount - Supplies the number of output elements to store.
+
+    See MlasConvDirectKernel for the remaining arguments.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 Accumulators[FilterCount][VectorCount];
+
+    for (size_t f = 0; f < FilterCount; f++) {
+        for (size_t v = 0; v < VectorCount; v++) {
+            Accumulators[f][v] = MlasZeroFloat32x4();
+        }
+    }
+
+    const size_t DilationPhase = DilationWidth % StrideWidth;
+    const size_t DilationOffset = DilationWidth / StrideWidth;
+
+    for (size_t c = 0; c < InputChannels; c++) {
+
+        const float* InputRow = Input + c * InputStrideChannel;
+
+        for (size_t ky = 0; ky < KernelHeight; ky++) {
+
+            size_t Phase = 0;
+            size_t Offset = 0;
+
+            for (size_t kx = 0; kx < KernelWidth; kx++) {
+
+                const float* input = InputRow + Phase * PhaseWidth + Offset;
+
+                MLAS_FLOAT32X4 InputElements[VectorCount];
+
+                for (size_t v = 0; v < VectorCount; v++) {
+                    InputElements[v] = MlasLoadFloat32x4(input + v * 4);
+                }
+
+                for (size_t f = 0; f < FilterCount; f++) {
+
+                    MLAS_FLOAT32X4 FilterElement = MlasBroadcastFloat32x4(Filter + f * FilterStride);
+
+                    for (size_t v = 0; v < VectorCount; v++) {
+                        Accumulators[f][v] = MlasMultiplyAddFloat32x4(InputElements[v], FilterElement, Accumulators[f][v]);
+                    }
+                }
+
+                Filter++;
+
+                Phase += DilationPhase;
+                Offset += DilationOffset;
+
+                if (Phase >= StrideWidth) {
+                    Phase -= StrideWidth;
+                    Offset++;
+                }
+            }
+
+            InputRow += InputStrideKernelY;
+        }
+    }
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        float* output = Output + f * OutputStrideFilter;
+
+        if (StoreCount == VectorCount * 4) {
+
+            for (size_t v = 0; v < VectorCount; v++) {
+                MlasStoreFloat32x4(output + v * 4, Accumulators[f][v]);
+            }
+
+        } else {
+
+            MLAS_DECLSPEC_ALIGN(float Results[VectorCount * 4], 16);
+
+            for (size_t v = 0; v < VectorCount; v++) {
+                MlasStoreAlignedFloat32x4(&Results[v * 4], Accumulators[f][v]);
+            }
+
+            std::copy_n(Results, StoreCount, output);
+        }
+    }
+}
+
+template<size_t FilterCount>
+void
+MlasConvDirectKernelRow(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t OutputCount,
+    size_t InputChannels,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t InputStrideChannel,
+    size_t InputStrideKernelY,
+    size_t PhaseWidth,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterStride,
+    size_t OutputStrideFilter
+    )
+{
+    while (OutputCount > 0) {
+
+        const size_t StoreCount = std::min(OutputCount, size_t(8));
+
+        MlasConvDirectKernelBlock<FilterCount, 2>(Input, Filter, Output, StoreCount,
+            InputChannels, KernelHeight, KernelWidth, InputStrideChannel,
+            InputStrideKernelY, PhaseWidth, StrideWidth, DilationWidth, FilterStride,
+            OutputStrideFilter);
+
+        Input += StoreCount;
+        Output += StoreCount;
+        OutputCount -= StoreCount;
+    }
+}
+
+void
+MLASCALL
+MlasConvDirectKernel(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t FilterCount,
+    size_t OutputCount,
+    size_t InputChannels,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t InputStrideChannel,
+    size_t InputStrideKernelY,
+    size_t PhaseWidth,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterStride,
+    size_t OutputStrideFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a row of output elements for
+    a block of filters with a direct convolution.
+
+    The vector lanes hold adjacent output elements. Each row of the padded
+    input has been split into StrideWidth phases, so that the input elements
+    for adjacent output elements are contiguous for any stride.
+
+Arguments:
+
+    Input - Supplies the address of the padded input for the first output
+        element of the row.
+
+    Filter - Supplies the address of the first filter.
+
+    Output - Supplies the address of the first output element of the first
+        filter.
+
+    FilterCount - Supplies the number of filters to compute, up to
+        MLAS_CONV_DIRECT_FILTER_BLOCK.
+
+    OutputCount - Supplies the number of output elements in the row.
+
+    InputChannels - Supplies the number of input channels.
+
+    KernelHeight - Supplies the height of the kernel.
+
+    KernelWidth - Supplies the width of the kernel.
+
+    InputStrideChannel - Supplies the number of elements between padded input
+        channels.
+
+    InputStrideKernelY - Supplies the number of elements between padded input
+        rows for adjacent rows of the kernel.
+
+    PhaseWidth - Supplies the number of elements in each phase of a padded
+        input row.
+
+    StrideWidth - Supplies the stride along the width.
+
+    DilationWidth - Supplies the dilation along the width.
+
+    FilterStride - Supplies the number of elements between filters.
+
+    OutputStrideFilter - Supplies the number of elements between output
+        channels.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (FilterCount) {
+
+        case 4:
+            MlasConvDirectKernelRow<4>(Input, Filter, Output, OutputCount, InputChannels,
+                KernelHeight, KernelWidth, InputStrideChannel, InputStrideKernelY,
+                PhaseWidth, StrideWidth, DilationWidth, FilterStride, OutputStrideFilter);
+            break;
+
+        case 3:
+            MlasConvDirectKernelRow<3>(Input, Filter, Output, OutputCount, InputChannels,
+                KernelHeight, KernelWidth, InputStrideChannel, InputStrideKernelY,
+                PhaseWidth, StrideWidth, DilationWidth, FilterStride, OutputStrideFilter);
+            break;
+
+        case 2:
+            MlasConvDirectKernelRow<2>(Input, Filter, Output, OutputCount, InputChannels,
+                KernelHeight, KernelWidth, InputStrideChannel, InputStrideKernelY,
+                PhaseWidth, StrideWidth, DilationWidth, FilterStride, OutputStrideFilter);
+            break;
+
+        default:
+            MlasConvDirectKernelRow<1>(Input, Filter, Output, OutputCount, InputChannels,
+                KernelHeight, KernelWidth, InputStrideChannel, InputStrideKernelY,
+                PhaseWidth, StrideWidth, DilationWidth, FilterStride, OutputStrideFilter);
+            break;
+    }
+}
+
+void
+MlasConvDirectThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to compute a range of output
+    rows for blocks of filters with a direct convolution.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t K = Parameters->K;
+
+    const size_t KernelHeight = Parameters->KernelShape[0];
+    const size_t KernelWidth = Parameters->KernelShape[1];
+    const size_t DilationHeight = Parameters->DilationShape[0];
+    const size_t DilationWidth = Parameters->DilationShape[1];
+    const size_t StrideHeight = Parameters->StrideShape[0];
+    const size_t StrideWidth = Parameters->StrideShape[1];
+
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+
+    const size_t PhaseWidth = Parameters->u.Direct.PhaseWidth;
+    const size_t InputStrideRow = StrideWidth * PhaseWidth;
+    const size_t InputStrideChannel = Parameters->u.Direct.PaddedInputHeight * InputStrideRow;
+    const size_t InputStrideKernelY = DilationHeight * InputStrideRow;
+
+    //
+    // Compute the range of filter blocks and output rows to use for this
+    // thread.
+    //
+
+    const size_t FilterBlockCount =
+        (FilterCount + MLAS_CONV_DIRECT_FILTER_BLOCK - 1) / MLAS_CONV_DIRECT_FILTER_BLOCK;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount, FilterBlockCount * OutputHeight,
+        &WorkIndex, &WorkRemaining);
+
+#if defined(MLAS_TARGET_AMD64)
+    PMLAS_CONV_DIRECT_KERNEL_ROUTINE KernelRoutine = MlasPlatform.ConvDirectKernelRoutine;
+#else
+    PMLAS_CONV_DIRECT_KERNEL_ROUTINE KernelRoutine = MlasConvDirectKernel;
+#endif
+
+    for (size_t WorkEnd = WorkIndex + WorkRemaining; WorkIndex < WorkEnd; WorkIndex++) {
+
+        const size_t FilterStart = (WorkIndex / OutputHeight) * MLAS_CONV_DIRECT_FILTER_BLOCK;
+        const size_t FilterBlockSize = std::min(FilterCount - FilterStart, size_t(MLAS_CONV_DIRECT_FILTER_BLOCK));
+        const size_t OutputY = WorkIndex % OutputHeight;
+
+        const float* input = WorkBlock->Input + OutputY * StrideHeight * InputStrideRow;
+        float* output = WorkBlock->Output + FilterStart * OutputSize + OutputY * OutputWidth;
+
+        KernelRoutine(input, WorkBlock->Filter + FilterStart * K, output, FilterBlockSize,
+            OutputWidth, InputChannels, KernelHeight, KernelWidth, InputStrideChannel,
+            InputStrideKernelY, PhaseWidth, StrideWidth, DilationWidth, K, OutputSize);
+
+        //
+        // Apply the activation with optional bias.
+        //
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += FilterStart;
+        }
+
+        MlasActivation(Parameters->Activation, output, bias, FilterBlockSize, output,
+            OutputWidth, OutputSize);
+    }
+}
+
+void
+MlasConvDirect(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a two dimensional convolution for a single batch
+    and group by directly accumulating the products of the input and the
+    filter, without expanding the input to convolution patches.
+
+    The input is first copied to a zero padded buffer with each row split
+    into StrideWidth phases, so that the kernel requires no bounds checks and
+    loads the input for adjacent output elements as vectors.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        operation should execute on the calling thread.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputChannels = Parameters->InputChannels;
+
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+
+    const size_t StrideWidth = Parameters->StrideShape[1];
+
+    const size_t PaddedInputHeight = Parameters->u.Direct.PaddedInputHeight;
+    const size_t PhaseWidth = Parameters->u.Direct.PhaseWidth;
+    const size_t InputStrideRow = StrideWidth * PhaseWidth;
+
+    //
+    // Copy the input to the padded buffer. Element x of a padded input row is
+    // stored at phase (x % StrideWidth) and offset (x / StrideWidth).
+    //
+
+    float* PaddedInput = WorkingBuffer;
+
+    std::fill_n(PaddedInput, InputChannels * PaddedInputHeight * InputStrideRow, 0.0f);
+
+    for (size_t c = 0; c < InputChannels; c++) {
+
+        const float* input = Input + c * InputSize;
+        float* padded = PaddedInput + (c * PaddedInputHeight + PaddingTop) * InputStrideRow;
+
+        for (size_t y = 0; y < InputHeight; y++) {
+
+            if (StrideWidth == 1) {
+
+                std::copy_n(input, InputWidth, padded + PaddingLeft);
+
+            } else {
+
+                size_t Phase = PaddingLeft % StrideWidth;
+                size_t Offset = PaddingLeft / StrideWidth;
+
+                for (size_t x = 0; x < InputWidth; x++) {
+
+                    padded[Phase * PhaseWidth + Offset] = input[x];
+
+                    if (++Phase == StrideWidth) {
+                        Phase = 0;
+                        Offset++;
+                    }
+                }
+            }
+
+            input += InputWidth;
+            padded += InputStrideRow;
+        }
+    }
+
+    MLAS_CONV_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = PaddedInput;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = nullptr;
+    WorkBlock.Output = Output;
+    WorkBlock.TargetThreadCount = int32_t(Parameters->u.Direct.ThreadCount);
+
+    MlasExecuteThreaded(MlasConvDirectThreaded, &WorkBlock, WorkBlock.TargetThreadCount, ThreadPool);
+}
+
+inline
+bool
+MlasConvTryMultithread(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine attempts to launch a convolution operation across multiple
+    threads.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        operation should execute on the calling thread.
+
+Return Value:
+
+    Returns true if the operation was completed across multiple threads, else
+    false if the operation should fall back to a single thread.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK WorkBlock;
+
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t ThreadStrideN = Parameters->u.ExpandThenGemmSegmented.ThreadStrideN;
+
+    if (ThreadStrideN >= OutputSize || ThreadPool == nullptr) {
+        return false;
+    }
+
+    //
+    // Initialize the common fields of the work block.
+    //
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.Output = Output;
+
+    //
+    // Segment the operation across multiple threads. The thread stride was
+    // computed by MlasConvPrepare such that the number of segments does not
+    // exceed the number of per-thread working buffers.
+    //
+
+    int32_t ThreadCount = int32_t((OutputSize + ThreadStrideN - 1) / ThreadStrideN);
+
+    WorkBlock.TargetThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasConvOperationThreaded, &WorkBlock, ThreadCount, ThreadPool);
+
+    return true;
+}
+
+void
+MLASCALL
+MlasConv(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the convolution operation.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        operation should execute on the calling thread. This should be the
+        same thread pool that was supplied to MlasConvPrepare.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
+    const size_t OutputGroupSize = FilterCount * OutputSize;
+    const size_t FilterGroupSize = FilterCount * K;
+
+    const size_t BatchCount = Parameters->BatchCount;
+    const size_t GroupCount = Parameters->GroupCount;
+
+    const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
+
+    //
+    // Schedule batches of GEMMs across multiple threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmGemmDirect && ((BatchCount > 1) || (GroupCount > 1))) {
+
+        const size_t BatchGroupCount = BatchCount * GroupCount;
+
+        int32_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+        if (size_t(TargetThreadCount) >= BatchGroupCount) {
+            TargetThreadCount = int32_t(BatchGroupCount);
+        }
+
+        MLAS_CONV_WORK_BLOCK WorkBlock;
+
+        WorkBlock.Parameters = Parameters;
+        WorkBlock.Input = Input;
+        WorkBlock.Filter = Filter;
+        WorkBlock.Bias = Bias;
+        WorkBlock.WorkingBuffer = nullptr;
+        WorkBlock.Output = Output;
+        WorkBlock.TargetThreadCount = TargetThreadCount;
+
+        MlasExecuteThreaded(MlasConvGemmDirectThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+
+        return;
+    }
+
+    //
+    // Iterate over each batch and group.
+    //
+
+    for (size_t batch = 0; batch < BatchCount; batch++) {
+
+        const float* filter = Filter;
+        const float* bias = Bias;
+
+        for (size_t group = 0; group < GroupCount; group++) {
+
+            //
+            // Dispatch the convolution.
+            //
+
+            switch (Algorithm) {
+
+                case MlasConvAlgorithmGemmDirect:
+                {
+                    //
+                    // Invoke the threaded GEMM directly with the input tensor.
+                    //
+
+                    MlasSgemm(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
+                        OutputSize, K, 1.0f, filter, K, Input, Parameters->u.GemmDirect.ldb, 0.0f,
+                        Output, OutputSize, nullptr, ThreadPool);
+
+                    //
+                    // Apply the activation with optional bias.
+                    //
+
+                    MlasActivation(Parameters->Activation, Output, bias, FilterCount, Output,
+                        OutputSize, OutputSize);
+
+                    break;
+                }
+
+                case MlasConvAlgorithmExpandThenGemm:
+                {
+                    //
+                    // Expand the input tensor to the working buffer and then invoke the
+                    // threaded GEMM.
+                    //
+
+                    if (Parameters->Dimensions == 2) {
+                        MlasConvIm2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
+                    } else {
+                        MlasConvVol2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
+                    }
+
+                    MlasSgemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f, filter,
+                        K, WorkingBuffer, OutputSize, 0.0f, Output, OutputSize, nullptr, ThreadPool);
+
+                    //
+                    // Apply the activation with optional bias.
+                    //
+
+                    MlasActivation(Parameters->Activation, Output, bias, FilterCount, Output,
+                        OutputSize, OutputSize);
+
+                    break;
+                }
+
+                case MlasConvAlgorithmExpandThenGemmSegmented:
+                {
+                    //
+                    // Attempt to launch the convolution across multiple threads or fall
+                    // back to a single thread.
+                    //
+
+                    if (!MlasConvTryMultithread(Parameters, Input, filter, bias, WorkingBuffer,
+                        Output, ThreadPool)) {
+                        MlasConvOperation(Parameters, Input, filter, bias, WorkingBuffer,
+                            Output, 0, OutputSize);
+                    }
+
+                    break;
+                }
+
+                case MlasConvAlgorithmWinograd:
+                {
+                    MlasConvWinograd(Parameters, Input, filter, bias, WorkingBuffer,
+                        Output, ThreadPool);
+
+                    break;
+                }
+
+                case MlasConvAlgorithmDirect:
+                {
+                    MlasConvDirect(Parameters, Input, filter, bias, WorkingBuffer,
+                        Output, ThreadPool);
+
+                    break;
+                }
+            }
+
+            //
+            // Advance the buffer pointers.
+            //
+
+            if (bias != nullptr) {
+                bias += FilterCount;
+            }
+
+            filter += FilterGroupSize;
+            Input += InputGroupSize;
+            Output += OutputGroupSize;
+        }
+    }
+}
 
 void
 MLASCALL
@@ -1038,7 +2208,8 @@ MlasConvPrepare(
     const int64_t* OutputShape,
     size_t FilterCount,
     const MLAS_ACTIVATION* Activation,
-    size_t* WorkingBufferSize
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
     )
 /*++
 
@@ -1082,6 +2253,10 @@ Arguments:
     WorkingBufferSize - Receives the number of elements to allocate for the
         working buffer for intermediate results.
 
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        operation should execute on the calling thread. The working buffer is
+        sized for the number of threads available from this thread pool.
+
 Return Value:
 
     None.
@@ -1179,43 +2354,146 @@ Return Value:
         }
     }
 
-    if (FilterCount > OutputSize) {
+    //
+    // Compute the number of target threads given the complexity of the
+    // convolution operation. Small requests should run using the single
+    // threaded path.
+    //
 
-        //
-        // The filter count is larger than the output dimensions, so perform the
-        // full matrix expansion and then invoke the threaded GEMM.
-        //
+    const int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
 
-        Parameters->Algorithm = MlasConvAlgorithmExpandThenGemm;
+    const double Complexity = double(FilterCount) * double(OutputSize) * double(K);
 
-        *WorkingBufferSize = OutputSize * K;
+    int32_t TargetThreadCount;
 
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY) * double(MaximumThreadCount)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
     } else {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (Dimensions == 2 && AllStridesAreOne && AllDilationsAreOne &&
+        Parameters->KernelShape[0] == 3 && Parameters->KernelShape[1] == 3 &&
+        InputChannels >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS &&
+        FilterCount >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS &&
+        OutputSize >= MLAS_CONV_WINOGRAD_MINIMUM_OUTPUT) {
 
         //
-        // Segment the operation across multiple threads by slicing the N
-        // dimension (see MlasSgemmTryMultithread).
+        // Use the Winograd algorithm for a 3x3 convolution with enough
+        // channels and output tiles to amortize the cost of the transforms.
+        // The larger 4x4 output tiles reduce the number of multiplies further,
+        // but waste more of the computation on the padded tiles of smaller
+        // images.
+        //
+
+        const size_t OutputHeight = Parameters->OutputShape[0];
+        const size_t OutputWidth = Parameters->OutputShape[1];
+
+        const size_t TileSize = (OutputHeight >= 8 && OutputWidth >= 8) ? 4 : 2;
+        const size_t InputTileSize = TileSize + 2;
+
+        const size_t TileCountH = (OutputHeight + TileSize - 1) / TileSize;
+        const size_t TileCountW = (((OutputWidth + TileSize - 1) / TileSize) + 3) & ~size_t(3);
+
         //
-        // Compute the number of target threads given the complexity of the
-        // convolution operation. Small requests should run using the single
-        // threaded path.
+        // Slice the rows of tiles into segments that are distributed across
+        // the threads.
         //
 
-        int32_t TargetThreadCount;
-        double Complexity = double(FilterCount) * double(OutputSize) * double(K);
+        size_t SegmentTileRows = std::max(size_t(1), MLAS_CONV_WINOGRAD_SEGMENT_TILES / TileCountW);
 
-        if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
-            TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
-        } else {
-            TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+        if (TargetThreadCount > 1) {
+            SegmentTileRows = std::min(SegmentTileRows, (TileCountH + TargetThreadCount - 1) / TargetThreadCount);
+        }
+
+        const size_t SegmentCount = (TileCountH + SegmentTileRows - 1) / SegmentTileRows;
+
+        if (size_t(TargetThreadCount) > SegmentCount) {
+            TargetThreadCount = int32_t(SegmentCount);
         }
 
-        int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+        Parameters->Algorithm = MlasConvAlgorithmWinograd;
+        Parameters->u.Winograd.TileSize = TileSize;
+        Parameters->u.Winograd.TileCountH = TileCountH;
+        Parameters->u.Winograd.TileCountW = TileCountW;
+        Parameters->u.Winograd.SegmentTileRows = SegmentTileRows;
+        Parameters->u.Winograd.ThreadCount = size_t(TargetThreadCount);
+
+        *WorkingBufferSize = InputTileSize * InputTileSize * FilterCount * InputChannels +
+            TargetThreadCount * MlasConvWinogradThreadBufferSize(Parameters);
+
+        return;
+    }
+
+    if (Dimensions == 2 && FilterCount <= MLAS_CONV_DIRECT_MAXIMUM_FILTERS &&
+        K <= MLAS_CONV_DIRECT_MAXIMUM_K) {
+
+        //
+        // Use the direct algorithm for a convolution with few filters and
+        // filter elements, such as a depthwise convolution, where the cost of
+        // expanding the input to convolution patches is not amortized by the
+        // GEMM.
+        //
+
+        const size_t StrideWidth = Parameters->StrideShape[1];
+
+        //
+        // The padded input must also cover the receptive field of every output
+        // element, which may extend beyond the padding if the output shape was
+        // rounded up.
+        //
+
+        const size_t PaddedInputHeight = std::max(
+            Parameters->InputShape[0] + Parameters->Padding[0] + Parameters->Padding[2],
+            (Parameters->OutputShape[0] - 1) * Parameters->StrideShape[0] +
+                (Parameters->KernelShape[0] - 1) * Parameters->DilationShape[0] + 1);
+        const size_t PaddedInputWidth = std::max(
+            Parameters->InputShape[1] + Parameters->Padding[1] + Parameters->Padding[3],
+            (Parameters->OutputShape[1] - 1) * StrideWidth +
+                (Parameters->KernelShape[1] - 1) * Parameters->DilationShape[1] + 1);
+
+        //
+        // Each phase of a padded input row is extended so that the kernel can
+        // load a full block of output elements beyond the end of the row.
+        //
+
+        const size_t PhaseWidth = (PaddedInputWidth + StrideWidth - 1) / StrideWidth +
+            MLAS_CONV_DIRECT_PHASE_PADDING;
 
-        if (TargetThreadCount >= MaximumThreadCount) {
-            TargetThreadCount = MaximumThreadCount;
+        const size_t FilterBlockCount =
+            (FilterCount + MLAS_CONV_DIRECT_FILTER_BLOCK - 1) / MLAS_CONV_DIRECT_FILTER_BLOCK;
+        const size_t TotalWork = FilterBlockCount * Parameters->OutputShape[0];
+
+        if (size_t(TargetThreadCount) > TotalWork) {
+            TargetThreadCount = int32_t(TotalWork);
         }
 
+        Parameters->Algorithm = MlasConvAlgorithmDirect;
+        Parameters->u.Direct.PaddedInputHeight = PaddedInputHeight;
+        Parameters->u.Direct.PhaseWidth = PhaseWidth;
+        Parameters->u.Direct.ThreadCount = size_t(TargetThreadCount);
+
+        *WorkingBufferSize = InputChannels * PaddedInputHeight * StrideWidth * PhaseWidth;
+
+        return;
+    }
+
+    if (FilterCount > OutputSize) {
+
+        //
+        // The filter count is larger than the output dimensions, so perform the
+        // full matrix expansion and then invoke the threaded GEMM.
+        //
+
+        Parameters->Algorithm = MlasConvAlgorithmExpandThenGemm;
+
+        *WorkingBufferSize = OutputSize * K;
+
+    } else {
+
+        //
+        // Segment the operation across multiple threads by slicing the N
+        // dimension (see MlasSgemmTryMultithread).
         //
         // Compute the thread stride for slicing the N dimension.
         //
@@ -0,0 +1,241 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convolve_kernel_avx512f.cpp
+
+Abstract:
+
+    This module implements the kernel for the direct convolution operation
+    using AVX512F instructions.
+
+--*/
+
+#include "mlasi.h"
+
+template<size_t FilterCount, size_t VectorCount>
+inline
+void
+MlasConvDirectKernelAvx512FBlock(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    __mmask16 LastStoreMask,
+    size_t InputChannels,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t InputStrideChannel,
+    size_t InputStrideKernelY,
+    size_t PhaseWidth,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterStride,
+    size_t OutputStrideFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of VectorCount vectors of adjacent output
+    elements for FilterCount filters.
+
+Arguments:
+
+    LastStoreMask - Supplies the mask of output elements to store for the
+        last vector of the block.
+
+    See MlasConvDirectKernel for the remaining arguments.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    __m512 Accumulators[FilterCount][VectorCount];
+
+    for (size_t f = 0; f < FilterCount; f++) {
+        for (size_t v = 0; v < VectorCount; v++) {
+            Accumulators[f][v] = _mm512_setzero_ps();
+        }
+    }
+
+    const size_t DilationPhase = DilationWidth % StrideWidth;
+    const size_t DilationOffset = DilationWidth / StrideWidth;
+
+    for (size_t c = 0; c < InputChannels; c++) {
+
+        const float* InputRow = Input + c * InputStrideChannel;
+
+        for (size_t ky = 0; ky < KernelHeight; ky++) {
+
+            size_t Phase = 0;
+            size_t Offset = 0;
+
+            for (size_t kx = 0; kx < KernelWidth; kx++) {
+
+                const float* input = InputRow + Phase * PhaseWidth + Offset;
+
+                __m512 InputElements[VectorCount];
+
+                for (size_t v = 0; v < VectorCount; v++) {
+                    InputElements[v] = _mm512_loadu_ps(input + v * 16);
+                }
+
+                for (size_t f = 0; f < FilterCount; f++) {
+
+                    __m512 FilterElement = _mm512_set1_ps(Filter[f * FilterStride]);
+
+                    for (size_t v = 0; v < VectorCount; v++) {
+                        Accumulators[f][v] = _mm512_fmadd_ps(InputElements[v], FilterElement, Accumulators[f][v]);
+                    }
+                }
+
+                Filter++;
+
+                Phase += DilationPhase;
+                Offset += DilationOffset;
+
+                if (Phase >= StrideWidth) {
+                    Phase -= StrideWidth;
+                    Offset++;
+                }
+            }
+
+            InputRow += InputStrideKernelY;
+        }
+    }
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        float* output = Output + f * OutputStrideFilter;
+
+        for (size_t v = 0; v < VectorCount - 1; v++) {
+            _mm512_storeu_ps(output + v * 16, Accumulators[f][v]);
+        }
+
+        _mm512_mask_storeu_ps(output + (VectorCount - 1) * 16, LastStoreMask,
+            Accumulators[f][VectorCount - 1]);
+    }
+}
+
+template<size_t FilterCount>
+void
+MlasConvDirectKernelAvx512FRow(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t OutputCount,
+    size_t InputChannels,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t InputStrideChannel,
+    size_t InputStrideKernelY,
+    size_t PhaseWidth,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterStride,
+    size_t OutputStrideFilter
+    )
+{
+    //
+    // Compute blocks of four vectors to hide the latency of the accumulator
+    // dependency chains, then compute the remaining output elements a vector
+    // at a time.
+    //
+
+    while (OutputCount >= 64) {
+
+        MlasConvDirectKernelAvx512FBlock<FilterCount, 4>(Input, Filter, Output, 0xFFFF,
+            InputChannels, KernelHeight, KernelWidth, InputStrideChannel,
+            InputStrideKernelY, PhaseWidth, StrideWidth, DilationWidth, FilterStride,
+            OutputStrideFilter);
+
+        Input += 64;
+        Output += 64;
+        OutputCount -= 64;
+    }
+
+    while (OutputCount > 0) {
+
+        const size_t StoreCount = std::min(OutputCount, size_t(16));
+        const __mmask16 StoreMask = __mmask16((1u << StoreCount) - 1);
+
+        MlasConvDirectKernelAvx512FBlock<FilterCount, 1>(Input, Filter, Output, StoreMask,
+            InputChannels, KernelHeight, KernelWidth, InputStrideChannel,
+            InputStrideKernelY, PhaseWidth, StrideWidth, DilationWidth, FilterStride,
+            OutputStrideFilter);
+
+        Input += StoreCount;
+        Output += StoreCount;
+        OutputCount -= StoreCount;
+    }
+}
+
+void
+MLASCALL
+MlasConvDirectKernelAvx512F(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t FilterCount,
+    size_t OutputCount,
+    size_t InputChannels,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t InputStrideChannel,
+    size_t InputStrideKernelY,
+    size_t PhaseWidth,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterStride,
+    size_t OutputStrideFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a row of output elements for
+    a block of filters with a direct convolution.
+
+Arguments:
+
+    See MlasConvDirectKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (FilterCount) {
+
+        case 4:
+            MlasConvDirectKernelAvx512FRow<4>(Input, Filter, Output, OutputCount, InputChannels,
+                KernelHeight, KernelWidth, InputStrideChannel, InputStrideKernelY,
+                PhaseWidth, StrideWidth, DilationWidth, FilterStride, OutputStrideFilter);
+            break;
+
+        case 3:
+            MlasConvDirectKernelAvx512FRow<3>(Input, Filter, Output, OutputCount, InputChannels,
+                KernelHeight, KernelWidth, InputStrideChannel, InputStrideKernelY,
+                PhaseWidth, StrideWidth, DilationWidth, FilterStride, OutputStrideFilter);
+            break;
+
+        case 2:
+            MlasConvDirectKernelAvx512FRow<2>(Input, Filter, Output, OutputCount, InputChannels,
+                KernelHeight, KernelWidth, InputStrideChannel, InputStrideKernelY,
+                PhaseWidth, StrideWidth, DilationWidth, FilterStride, OutputStrideFilter);
+            break;
+
+        default:
+            MlasConvDirectKernelAvx512FRow<1>(Input, Filter, Output, OutputCount, InputChannels,
+                KernelHeight, KernelWidth, InputStrideChannel, InputStrideKernelY,
+                PhaseWidth, StrideWidth, DilationWidth, FilterStride, OutputStrideFilter);
+            break;
+    }
+}
@@ -0,0 +1,236 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convolve_kernel_fma3.cpp
+
+Abstract:
+
+    This module implements the kernel for the direct convolution operation
+    using AVX2 and FMA3 instructions.
+
+--*/
+
+#include "mlasi.h"
+
+template<size_t FilterCount, size_t VectorCount>
+inline
+void
+MlasConvDirectKernelFma3Block(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StoreCount,
+    size_t InputChannels,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t InputStrideChannel,
+    size_t InputStrideKernelY,
+    size_t PhaseWidth,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterStride,
+    size_t OutputStrideFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of VectorCount vectors of adjacent output
+    elements for FilterCount filters.
+
+Arguments:
+
+    StoreCount - Supplies the number of output elements to store.
+
+    See MlasConvDirectKernel for the remaining arguments.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    __m256 Accumulators[FilterCount][VectorCount];
+
+    for (size_t f = 0; f < FilterCount; f++) {
+        for (size_t v = 0; v < VectorCount; v++) {
+            Accumulators[f][v] = _mm256_setzero_ps();
+        }
+    }
+
+    const size_t DilationPhase = DilationWidth % StrideWidth;
+    const size_t DilationOffset = DilationWidth / StrideWidth;
+
+    for (size_t c = 0; c < InputChannels; c++) {
+
+        const float* InputRow = Input + c * InputStrideChannel;
+
+        for (size_t ky = 0; ky < KernelHeight; ky++) {
+
+            size_t Phase = 0;
+            size_t Offset = 0;
+
+            for (size_t kx = 0; kx < KernelWidth; kx++) {
+
+                const float* input = InputRow + Phase * PhaseWidth + Offset;
+
+                __m256 InputElements[VectorCount];
+
+                for (size_t v = 0; v < VectorCount; v++) {
+                    InputElements[v] = _mm256_loadu_ps(input + v * 8);
+                }
+
+                for (size_t f = 0; f < FilterCount; f++) {
+
+                    __m256 FilterElement = _mm256_set1_ps(Filter[f * FilterStride]);
+
+                    for (size_t v = 0; v < VectorCount; v++) {
+                        Accumulators[f][v] = _mm256_fmadd_ps(InputElements[v], FilterElement, Accumulators[f][v]);
+                    }
+                }
+
+                Filter++;
+
+                Phase += DilationPhase;
+                Offset += DilationOffset;
+
+                if (Phase >= StrideWidth) {
+                    Phase -= StrideWidth;
+                    Offset++;
+                }
+            }
+
+            InputRow += InputStrideKernelY;
+        }
+    }
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        float* output = Output + f * OutputStrideFilter;
+
+        if (StoreCount == VectorCount * 8) {
+
+            for (size_t v = 0; v < VectorCount; v++) {
+                _mm256_storeu_ps(output + v * 8, Accumulators[f][v]);
+            }
+
+        } else {
+
+            MLAS_DECLSPEC_ALIGN(float Results[VectorCount * 8], 32);
+
+            for (size_t v = 0; v < VectorCount; v++) {
+                _mm256_store_ps(&Results[v * 8], Accumulators[f][v]);
+            }
+
+            std::copy_n(Results, StoreCount, output);
+        }
+    }
+}
+
+template<size_t FilterCount>
+void
+MlasConvDirectKernelFma3Row(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t OutputCount,
+    size_t InputChannels,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t InputStrideChannel,
+    size_t InputStrideKernelY,
+    size_t PhaseWidth,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterStride,
+    size_t OutputStrideFilter
+    )
+{
+    //
+    // Compute blocks of two vectors. The accumulators for a block of four
+    // filters use half of the available registers.
+    //
+
+    while (OutputCount > 0) {
+
+        const size_t StoreCount = std::min(OutputCount, size_t(16));
+
+        MlasConvDirectKernelFma3Block<FilterCount, 2>(Input, Filter, Output, StoreCount,
+            InputChannels, KernelHeight, KernelWidth, InputStrideChannel,
+            InputStrideKernelY, PhaseWidth, StrideWidth, DilationWidth, FilterStride,
+            OutputStrideFilter);
+
+        Input += StoreCount;
+        Output += StoreCount;
+        OutputCount -= StoreCount;
+    }
+}
+
+void
+MLASCALL
+MlasConvDirectKernelFma3(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t FilterCount,
+    size_t OutputCount,
+    size_t InputChannels,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t InputStrideChannel,
+    size_t InputStrideKernelY,
+    size_t PhaseWidth,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterStride,
+    size_t OutputStrideFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a row of output elements for
+    a block of filters with a direct convolution.
+
+Arguments:
+
+    See MlasConvDirectKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (FilterCount) {
+
+        case 4:
+            MlasConvDirectKernelFma3Row<4>(Input, Filter, Output, OutputCount, InputChannels,
+                KernelHeight, KernelWidth, InputStrideChannel, InputStrideKernelY,
+                PhaseWidth, StrideWidth, DilationWidth, FilterStride, OutputStrideFilter);
+            break;
+
+        case 3:
+            MlasConvDirectKernelFma3Row<3>(Input, Filter, Output, OutputCount, InputChannels,
+                KernelHeight, KernelWidth, InputStrideChannel, InputStrideKernelY,
+                PhaseWidth, StrideWidth, DilationWidth, FilterStride, OutputStrideFilter);
+            break;
+
+        case 2:
+            MlasConvDirectKernelFma3Row<2>(Input, Filter, Output, OutputCount, InputChannels,
+                KernelHeight, KernelWidth, InputStrideChannel, InputStrideKernelY,
+                PhaseWidth, StrideWidth, DilationWidth, FilterStride, OutputStrideFilter);
+            break;
+
+        default:
+            MlasConvDirectKernelFma3Row<1>(Input, Filter, Output, OutputCount, InputChannels,
+                KernelHeight, KernelWidth, InputStrideChannel, InputStrideKernelY,
+                PhaseWidth, StrideWidth, DilationWidth, FilterStride, OutputStrideFilter);
+            break;
+    }
+}
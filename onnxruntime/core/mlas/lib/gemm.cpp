@@ -0,0 +1,824 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    gemm.cpp
+
+Abstract:
+
+    This module implements the double precision (DGEMM) and the 32-bit and
+    64-bit integer (IGEMM) matrix/matrix multiply operations.
+
+    The operations share the structure of the single precision SGEMM: matrix
+    B is packed into panels sized to stay resident in the L2 cache, a kernel
+    computes a block of rows of matrix C against each panel, and large
+    operations are segmented across threads along the M or N dimension.
+
+    The kernel is written in portable C++. The accumulators for a block of
+    matrix C are held in a fixed size array that the compiler maps to vector
+    registers.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of rows of matrix C that are computed by a single
+// invocation of the kernel.
+//
+
+#define MLAS_GEMM_KERNEL_ROWS                       4
+
+//
+// Define the size in bytes of a packed panel of matrix B. The N stride is
+// derived from the element size so that each panel uses the same amount of
+// the L2 cache as a SGEMM panel.
+//
+
+#define MLAS_GEMM_STRIDEK                           128
+#define MLAS_GEMM_PANEL_BYTES                       (MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK * sizeof(float))
+
+template<typename T>
+struct MLAS_GEMM_STRIDES
+{
+    //
+    // The kernel computes a block of columns that spans two 128-bit vectors
+    // for each row, so the accumulators for the block fit in the registers
+    // of every target. Packed panels of matrix B are padded to a multiple of
+    // the column count.
+    //
+
+    static constexpr size_t KernelColumns = 32 / sizeof(T);
+
+    static constexpr size_t StrideK = MLAS_GEMM_STRIDEK;
+    static constexpr size_t StrideN = MLAS_GEMM_PANEL_BYTES / (MLAS_GEMM_STRIDEK * sizeof(T));
+
+    static_assert(StrideN % KernelColumns == 0, "StrideN must be a multiple of the kernel columns");
+};
+
+//
+// Define the parameters to execute segments of a GEMM operation on worker
+// threads.
+//
+
+template<typename T>
+struct MLAS_GEMM_WORK_BLOCK {
+    CBLAS_TRANSPOSE TransA;
+    CBLAS_TRANSPOSE TransB;
+    size_t M;
+    size_t N;
+    size_t K;
+    T alpha;
+    const T* A;
+    size_t lda;
+    const T* B;
+    size_t ldb;
+    T beta;
+    T* C;
+    size_t ldc;
+    size_t ThreadStrideM;
+    size_t ThreadStrideN;
+    int32_t ThreadCountN;
+};
+
+template<typename T>
+void
+MlasGemmMultiplyBeta(
+    T* C,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    T beta
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies all elements of the output matrix by the beta
+    scalar value. A beta of zero stores zero, so that any values already in
+    the output matrix such as NaNs are not propagated.
+
+Arguments:
+
+    C - Supplies the address of matrix C.
+
+    CountM - Supplies the number of rows from matrix C.
+
+    CountN - Supplies the number of columns from matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    beta - Supplies the scaler beta multiplier (see GEMM definition).
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (CountM-- > 0) {
+
+        if (beta == T(0)) {
+            std::fill_n(C, CountN, T(0));
+        } else {
+            for (size_t n = 0; n < CountN; n++) {
+                C[n] *= beta;
+            }
+        }
+
+        C += ldc;
+    }
+}
+
+template<typename T>
+void
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    T* D,
+    const T* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+    )
+/*++
+
+Routine Description:
+
+    This routine copies or transposes elements from matrix B to the packed
+    panel buffer. The panel is stored as blocks of the kernel columns, where
+    each block holds CountK rows of contiguous columns. The last block is
+    padded with zeroes.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    D - Supplies the address of the packed panel buffer.
+
+    B - Supplies the address of the source matrix.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    CountN - Supplies the number of columns of matrix B to pack.
+
+    CountK - Supplies the number of rows of matrix B to pack.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t KernelColumns = MLAS_GEMM_STRIDES<T>::KernelColumns;
+
+    for (size_t n = 0; n < CountN; n += KernelColumns) {
+
+        const size_t CountColumns = std::min(CountN - n, KernelColumns);
+
+        for (size_t k = 0; k < CountK; k++) {
+
+            if (TransB == CblasNoTrans) {
+                std::copy_n(B + k * ldb + n, CountColumns, D);
+            } else {
+                for (size_t c = 0; c < CountColumns; c++) {
+                    D[c] = B[(n + c) * ldb + k];
+                }
+            }
+
+            std::fill(D + CountColumns, D + KernelColumns, T(0));
+
+            D += KernelColumns;
+        }
+    }
+}
+
+template<typename T, size_t RowCount>
+void
+MlasGemmKernel(
+    const T* A,
+    size_t StrideAM,
+    size_t StrideAK,
+    const T* PanelB,
+    T* C,
+    size_t ldc,
+    size_t CountN,
+    size_t CountK,
+    T alpha,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of RowCount rows of matrix C by multiplying
+    the rows of matrix A by a packed panel of matrix B.
+
+Arguments:
+
+    A - Supplies the address of the first row of matrix A.
+
+    StrideAM - Supplies the number of elements between rows of matrix A.
+
+    StrideAK - Supplies the number of elements between columns of matrix A.
+
+    PanelB - Supplies the address of the packed panel of matrix B.
+
+    C - Supplies the address of the first row of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    CountN - Supplies the number of columns of matrix C to compute.
+
+    CountK - Supplies the number of columns of matrix A and the number of rows
+        of the packed panel.
+
+    alpha - Supplies the scaler alpha multiplier (see GEMM definition).
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t KernelColumns = MLAS_GEMM_STRIDES<T>::KernelColumns;
+
+    const T* b = PanelB;
+
+    for (size_t n = 0; n < CountN; n += KernelColumns) {
+
+        T Accumulators[RowCount][KernelColumns] = {};
+
+        const T* a = A;
+
+        for (size_t k = 0; k < CountK; k++) {
+
+            for (size_t r = 0; r < RowCount; r++) {
+
+                const T ak = a[r * StrideAM];
+
+                for (size_t c = 0; c < KernelColumns; c++) {
+                    Accumulators[r][c] += ak * b[c];
+                }
+            }
+
+            a += StrideAK;
+            b += KernelColumns;
+        }
+
+        //
+        // Store the block of matrix C. The panel is padded with zeroes, so
+        // only the valid columns are written.
+        //
+
+        const size_t CountColumns = std::min(CountN - n, KernelColumns);
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            T* c = C + r * ldc + n;
+
+            for (size_t j = 0; j < CountColumns; j++) {
+                T Value = Accumulators[r][j] * alpha;
+                c[j] = ZeroMode ? Value : c[j] + Value;
+            }
+        }
+    }
+}
+
+template<typename T>
+void
+MlasGemmOperation(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    T alpha,
+    const T* A,
+    size_t lda,
+    const T* B,
+    size_t ldb,
+    T beta,
+    T* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single threaded matrix/matrix multiply
+    operation for the double precision and integer data types.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scaler alpha multiplier (see GEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scaler beta multiplier (see GEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t StrideN = MLAS_GEMM_STRIDES<T>::StrideN;
+    constexpr size_t StrideK = MLAS_GEMM_STRIDES<T>::StrideK;
+
+    MLAS_DECLSPEC_ALIGN(T PanelB[StrideN * StrideK], 64);
+
+    //
+    // Matrix A is read in place, so a transposed matrix A only swaps the
+    // strides used to step through its rows and columns.
+    //
+
+    const size_t StrideAM = (TransA == CblasNoTrans) ? lda : 1;
+    const size_t StrideAK = (TransA == CblasNoTrans) ? 1 : lda;
+
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+
+    size_t CountN;
+    size_t CountK;
+
+    for (size_t n = 0; n < N; n += CountN) {
+
+        CountN = std::min(N - n, StrideN);
+
+        //
+        // Multiply the output matrix by beta as needed. A zero beta is handled
+        // by the kernel storing the first slice along the K dimension, unless
+        // there is no K dimension at all.
+        //
+
+        if ((beta != T(0) && beta != T(1)) || (beta == T(0) && K == 0)) {
+            MlasGemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension.
+        //
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = std::min(K - k, StrideK);
+
+            const T* b = (TransB == CblasNoTrans) ? B + n + k * ldb : B + k + n * ldb;
+
+            MlasGemmPackB(TransB, PanelB, b, ldb, CountN, CountK);
+
+            const bool ZeroMode = (k == 0 && beta == T(0));
+
+            //
+            // Step through each block of rows of matrix A.
+            //
+
+            const T* a = A + k * StrideAK;
+            T* c = C + n;
+
+            size_t RowsRemaining = M;
+
+            while (RowsRemaining >= MLAS_GEMM_KERNEL_ROWS) {
+
+                MlasGemmKernel<T, MLAS_GEMM_KERNEL_ROWS>(a, StrideAM, StrideAK, PanelB, c, ldc,
+                    CountN, CountK, alpha, ZeroMode);
+
+                a += StrideAM * MLAS_GEMM_KERNEL_ROWS;
+                c += ldc * MLAS_GEMM_KERNEL_ROWS;
+
+                RowsRemaining -= MLAS_GEMM_KERNEL_ROWS;
+            }
+
+            switch (RowsRemaining) {
+
+                case 3:
+                    MlasGemmKernel<T, 3>(a, StrideAM, StrideAK, PanelB, c, ldc, CountN, CountK, alpha, ZeroMode);
+                    break;
+
+                case 2:
+                    MlasGemmKernel<T, 2>(a, StrideAM, StrideAK, PanelB, c, ldc, CountN, CountK, alpha, ZeroMode);
+                    break;
+
+                case 1:
+                    MlasGemmKernel<T, 1>(a, StrideAM, StrideAK, PanelB, c, ldc, CountN, CountK, alpha, ZeroMode);
+                    break;
+            }
+        }
+    }
+}
+
+template<typename T>
+void
+MlasGemmOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    GEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_GEMM_WORK_BLOCK<T>* WorkBlock = (MLAS_GEMM_WORK_BLOCK<T>*)Context;
+
+    //
+    // Compute the segment of matrix C that is owned by this thread.
+    //
+
+    const size_t m = size_t(Index / WorkBlock->ThreadCountN) * WorkBlock->ThreadStrideM;
+    const size_t n = size_t(Index % WorkBlock->ThreadCountN) * WorkBlock->ThreadStrideN;
+
+    const size_t CountM = std::min(WorkBlock->M - m, WorkBlock->ThreadStrideM);
+    const size_t CountN = std::min(WorkBlock->N - n, WorkBlock->ThreadStrideN);
+
+    const size_t plda = (WorkBlock->TransA == CblasNoTrans) ? WorkBlock->lda : 1;
+    const size_t pldb = (WorkBlock->TransB == CblasNoTrans) ? 1 : WorkBlock->ldb;
+
+    MlasGemmOperation<T>(WorkBlock->TransA, WorkBlock->TransB, CountM, CountN,
+        WorkBlock->K, WorkBlock->alpha, WorkBlock->A + m * plda, WorkBlock->lda,
+        WorkBlock->B + n * pldb, WorkBlock->ldb, WorkBlock->beta,
+        WorkBlock->C + m * WorkBlock->ldc + n, WorkBlock->ldc);
+}
+
+template<typename T>
+void
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    T alpha,
+    const T* A,
+    size_t lda,
+    const T* B,
+    size_t ldb,
+    T beta,
+    T* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the matrix/matrix multiply operation for the
+    double precision and integer data types.
+
+    The operation is segmented across threads in the same way as SGEMM by
+    slicing the larger of the M or N dimensions.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scaler alpha multiplier (see GEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scaler beta multiplier (see GEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        operation should execute on the calling thread.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Compute the number of target threads given the complexity of the GEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K);
+
+    int32_t TargetThreadCount;
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY) * double(MaximumThreadCount)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+        MlasGemmOperation<T>(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+        return;
+    }
+
+    MLAS_GEMM_WORK_BLOCK<T> WorkBlock;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = TransB;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.alpha = alpha;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.B = B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.beta = beta;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+
+    //
+    // Segment the operation across multiple threads by slicing the larger of
+    // the M or N dimensions. Segments along the N dimension are aligned to the
+    // kernel columns.
+    //
+
+    constexpr size_t KernelColumns = MLAS_GEMM_STRIDES<T>::KernelColumns;
+
+    int32_t ThreadCount;
+
+    if (N > M) {
+
+        size_t StrideN = (N + TargetThreadCount - 1) / TargetThreadCount;
+
+        StrideN = (StrideN + KernelColumns - 1) & ~(KernelColumns - 1);
+
+        WorkBlock.ThreadStrideM = M;
+        WorkBlock.ThreadStrideN = StrideN;
+        WorkBlock.ThreadCountN = int32_t((N + StrideN - 1) / StrideN);
+
+        ThreadCount = WorkBlock.ThreadCountN;
+
+    } else {
+
+        size_t StrideM = (M + TargetThreadCount - 1) / TargetThreadCount;
+
+        WorkBlock.ThreadStrideM = StrideM;
+        WorkBlock.ThreadStrideN = N;
+        WorkBlock.ThreadCountN = 1;
+
+        ThreadCount = int32_t((M + StrideM - 1) / StrideM);
+    }
+
+    MlasExecuteThreaded(MlasGemmOperationThreaded<T>, &WorkBlock, ThreadCount, ThreadPool);
+}
+
+void
+MLASCALL
+MlasDgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    double alpha,
+    const double* A,
+    size_t lda,
+    const double* B,
+    size_t ldb,
+    double beta,
+    double* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the double precision matrix/matrix multiply
+    operation (DGEMM).
+
+Arguments:
+
+    See MlasGemm.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGemm<double>(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, ThreadPool);
+}
+
+void
+MLASCALL
+MlasIgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    int32_t alpha,
+    const int32_t* A,
+    size_t lda,
+    const int32_t* B,
+    size_t ldb,
+    int32_t beta,
+    int32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the signed 32-bit integer matrix/matrix multiply
+    operation (IGEMM). The products and sums wrap around on overflow.
+
+Arguments:
+
+    See MlasGemm.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Compute with unsigned values so that overflow has defined wrap around
+    // behavior. The two's complement results are identical.
+    //
+
+    MlasGemm<uint32_t>(TransA, TransB, M, N, K, uint32_t(alpha), (const uint32_t*)A, lda,
+        (const uint32_t*)B, ldb, uint32_t(beta), (uint32_t*)C, ldc, ThreadPool);
+}
+
+void
+MLASCALL
+MlasIgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    uint32_t alpha,
+    const uint32_t* A,
+    size_t lda,
+    const uint32_t* B,
+    size_t ldb,
+    uint32_t beta,
+    uint32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the unsigned 32-bit integer matrix/matrix multiply
+    operation (IGEMM). The products and sums wrap around on overflow.
+
+Arguments:
+
+    See MlasGemm.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGemm<uint32_t>(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, ThreadPool);
+}
+
+void
+MLASCALL
+MlasIgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    int64_t alpha,
+    const int64_t* A,
+    size_t lda,
+    const int64_t* B,
+    size_t ldb,
+    int64_t beta,
+    int64_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the signed 64-bit integer matrix/matrix multiply
+    operation (IGEMM). The products and sums wrap around on overflow.
+
+Arguments:
+
+    See MlasGemm.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Compute with unsigned values so that overflow has defined wrap around
+    // behavior. The two's complement results are identical.
+    //
+
+    MlasGemm<uint64_t>(TransA, TransB, M, N, K, uint64_t(alpha), (const uint64_t*)A, lda,
+        (const uint64_t*)B, ldb, uint64_t(beta), (uint64_t*)C, ldc, ThreadPool);
+}
+
+void
+MLASCALL
+MlasIgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    uint64_t alpha,
+    const uint64_t* A,
+    size_t lda,
+    const uint64_t* B,
+    size_t ldb,
+    uint64_t beta,
+    uint64_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the unsigned 64-bit integer matrix/matrix multiply
+    operation (IGEMM). The products and sums wrap around on overflow.
+
+Arguments:
+
+    See MlasGemm.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGemm<uint64_t>(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, ThreadPool);
+}
@@ -21,6 +21,7 @@ Abstract:
 #include <mlas.h>
 #include <memory.h>
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
 #if defined(_WIN32)
@@ -75,25 +76,6 @@ Abstract:
 #define MLAS_TARGET_ARM
 #endif
 
-//
-// Select the threading model.
-//
-
-#if defined(_OPENMP)
-#include <omp.h>
-#define MLAS_USE_OPENMP
-#define MLAS_HAS_THREADING_SUPPORT
-#elif defined(_WIN32)
-#define MLAS_USE_WIN32_THREADPOOL
-#define MLAS_HAS_THREADING_SUPPORT
-#endif
-
-//
-// Define the maximum number of threads supported by this implementation.
-//
-
-#define MLAS_MAXIMUM_THREAD_COUNT                   16
-
 //
 // Define the default strides to step through slices of the input matrices.
 //
@@ -112,6 +94,47 @@ Abstract:
 
 #define MLAS_SGEMM_STRIDEN_THREAD_ALIGN             16
 
+//
+// Define the strides to step through slices of the input matrices for the
+// quantized integer matrix/matrix multiply operation (QGEMM). The K stride
+// must be a multiple of the 4 values that are packed together for each column
+// of matrix B.
+//
+
+#define MLAS_QGEMM_STRIDEM                          16
+#define MLAS_QGEMM_STRIDEN                          128
+#define MLAS_QGEMM_STRIDEK                          256
+
+//
+// Define the number of columns of matrix B that are packed together in a
+// panel. Each panel stores groups of 4 values along the K dimension for each
+// column, matching the layout consumed by the AVX512 VNNI instruction vpdpbusd.
+//
+
+#define MLAS_QGEMM_PANEL_N                          16
+
+//
+// Define the number of filters computed by each invocation of the direct
+// convolution kernel and the number of elements that each phase of a padded
+// input row extends beyond the input, so that the kernels can load a full
+// block of vectors at the end of a row.
+//
+
+#define MLAS_CONV_DIRECT_FILTER_BLOCK               4
+#define MLAS_CONV_DIRECT_PHASE_PADDING              64
+
+//
+// Define the maximum number of channels in a block of the NCHWc tensor layout,
+// the number of output channel blocks computed by each invocation of the
+// NCHWc convolution kernels, and the number of filter elements that are
+// reused across a segment of output rows before advancing to the next chunk
+// of input channels.
+//
+
+#define MLAS_NCHWC_MAXIMUM_BLOCK_SIZE               16
+#define MLAS_NCHWC_FILTER_SET_SIZE                  4
+#define MLAS_NCHWC_FILTER_CHUNK_ELEMENTS            (32 * 1024)
+
 //
 // Define the prototypes of the platform optimized routines.
 //
@@ -176,6 +199,132 @@ void
 
 typedef MLAS_TANH_KERNEL_ROUTINE* PMLAS_TANH_KERNEL_ROUTINE;
 
+typedef
+void
+(MLASCALL MLAS_EXP_KERNEL_ROUTINE)(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+typedef MLAS_EXP_KERNEL_ROUTINE* PMLAS_EXP_KERNEL_ROUTINE;
+
+typedef
+void
+(MLASCALL MLAS_LOG_KERNEL_ROUTINE)(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+typedef MLAS_LOG_KERNEL_ROUTINE* PMLAS_LOG_KERNEL_ROUTINE;
+
+typedef
+void
+(MLASCALL MLAS_ERF_KERNEL_ROUTINE)(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+typedef MLAS_ERF_KERNEL_ROUTINE* PMLAS_ERF_KERNEL_ROUTINE;
+
+typedef
+float
+(MLASCALL MLAS_REDUCE_MAXIMUM_KERNEL_ROUTINE)(
+    const float* Input,
+    size_t N
+    );
+
+typedef MLAS_REDUCE_MAXIMUM_KERNEL_ROUTINE* PMLAS_REDUCE_MAXIMUM_KERNEL_ROUTINE;
+
+typedef
+float
+(MLASCALL MLAS_COMPUTE_SUM_EXP_KERNEL_ROUTINE)(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float Bias
+    );
+
+typedef MLAS_COMPUTE_SUM_EXP_KERNEL_ROUTINE* PMLAS_COMPUTE_SUM_EXP_KERNEL_ROUTINE;
+
+typedef
+size_t
+(MLASCALL MLAS_QGEMM_KERNEL_ROUTINE)(
+    const uint8_t* A,
+    const int8_t* B,
+    int32_t* C,
+    size_t PackedCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumBuffer,
+    const int32_t* ColumnSumBuffer,
+    bool ZeroMode
+    );
+
+typedef MLAS_QGEMM_KERNEL_ROUTINE* PMLAS_QGEMM_KERNEL_ROUTINE;
+
+typedef
+void
+(MLASCALL MLAS_CONV_DIRECT_KERNEL_ROUTINE)(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t FilterCount,
+    size_t OutputCount,
+    size_t InputChannels,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t InputStrideChannel,
+    size_t InputStrideKernelY,
+    size_t PhaseWidth,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterStride,
+    size_t OutputStrideFilter
+    );
+
+typedef MLAS_CONV_DIRECT_KERNEL_ROUTINE* PMLAS_CONV_DIRECT_KERNEL_ROUTINE;
+
+//
+// Define the parameters for a single row of an NCHWc convolution. The input
+// and filter addresses are advanced to the first kernel row that overlaps the
+// unpadded input.
+//
+
+struct MLAS_CONV_NCHWC_ROW {
+    const float* Input;
+    const float* Filter;
+    const float* Bias;
+    float* Output;
+    size_t FilterCount;
+    size_t InputChannelBlocks;
+    size_t InputWidth;
+    size_t InputStrideBlock;
+    size_t InputStrideKernelRow;
+    size_t FilterStrideBlock;
+    size_t FilterStrideInputBlock;
+    size_t KernelHeight;
+    size_t KernelWidth;
+    size_t DilationWidth;
+    size_t StrideWidth;
+    size_t PaddingLeftWidth;
+    size_t OutputWidth;
+    size_t OutputStrideBlock;
+    bool Accumulate;
+    bool ReluActivation;
+};
+
+typedef
+void
+(MLASCALL MLAS_CONV_NCHWC_KERNEL_ROUTINE)(
+    const MLAS_CONV_NCHWC_ROW* Row
+    );
+
+typedef MLAS_CONV_NCHWC_KERNEL_ROUTINE* PMLAS_CONV_NCHWC_KERNEL_ROUTINE;
+
 extern "C" {
 
     MLAS_SGEMM_KERNEL_ROUTINE MlasSgemmKernelZero;
@@ -210,6 +359,43 @@ extern "C" {
     MLAS_TANH_KERNEL_ROUTINE MlasTanhKernelFma3;
 #endif
 
+    MLAS_EXP_KERNEL_ROUTINE MlasExpKernel;
+    MLAS_LOG_KERNEL_ROUTINE MlasLogKernel;
+    MLAS_ERF_KERNEL_ROUTINE MlasErfKernel;
+    MLAS_REDUCE_MAXIMUM_KERNEL_ROUTINE MlasReduceMaximumKernel;
+    MLAS_COMPUTE_SUM_EXP_KERNEL_ROUTINE MlasComputeSumExpKernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_EXP_KERNEL_ROUTINE MlasExpKernelFma3;
+    MLAS_LOG_KERNEL_ROUTINE MlasLogKernelFma3;
+    MLAS_ERF_KERNEL_ROUTINE MlasErfKernelFma3;
+    MLAS_REDUCE_MAXIMUM_KERNEL_ROUTINE MlasReduceMaximumKernelFma3;
+    MLAS_COMPUTE_SUM_EXP_KERNEL_ROUTINE MlasComputeSumExpKernelFma3;
+    MLAS_EXP_KERNEL_ROUTINE MlasExpKernelAvx512F;
+    MLAS_LOG_KERNEL_ROUTINE MlasLogKernelAvx512F;
+    MLAS_ERF_KERNEL_ROUTINE MlasErfKernelAvx512F;
+    MLAS_REDUCE_MAXIMUM_KERNEL_ROUTINE MlasReduceMaximumKernelAvx512F;
+    MLAS_COMPUTE_SUM_EXP_KERNEL_ROUTINE MlasComputeSumExpKernelAvx512F;
+#endif
+
+    MLAS_QGEMM_KERNEL_ROUTINE MlasQgemmKernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_QGEMM_KERNEL_ROUTINE MlasQgemmKernelAvx2;
+    MLAS_QGEMM_KERNEL_ROUTINE MlasQgemmKernelAvx512Vnni;
+#endif
+
+    MLAS_CONV_DIRECT_KERNEL_ROUTINE MlasConvDirectKernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_CONV_DIRECT_KERNEL_ROUTINE MlasConvDirectKernelFma3;
+    MLAS_CONV_DIRECT_KERNEL_ROUTINE MlasConvDirectKernelAvx512F;
+#endif
+
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_CONV_NCHWC_KERNEL_ROUTINE MlasConvNchwcKernelFma3;
+    MLAS_CONV_NCHWC_KERNEL_ROUTINE MlasConvDepthwiseNchwcKernelFma3;
+    MLAS_CONV_NCHWC_KERNEL_ROUTINE MlasConvNchwcKernelAvx512F;
+    MLAS_CONV_NCHWC_KERNEL_ROUTINE MlasConvDepthwiseNchwcKernelAvx512F;
+#endif
+
 }
 
 //
@@ -221,15 +407,11 @@ extern "C" {
 // that workload. See EvaluateThreadingPerformance() in the unit test.
 //
 
-#if defined(MLAS_USE_OPENMP)
-#define MLAS_SGEMM_THREAD_COMPLEXITY                (64 * 1024)
-#else
 #if defined(MLAS_TARGET_AMD64)
 #define MLAS_SGEMM_THREAD_COMPLEXITY                (2 * 1024 * 1024)
 #else
 #define MLAS_SGEMM_THREAD_COMPLEXITY                (1 * 1024 * 1024)
 #endif
-#endif
 
 //
 // Single-threaded single precision matrix/matrix multiply operation.
@@ -249,7 +431,8 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess
     );
 
 //
@@ -271,25 +454,19 @@ struct MLAS_PLATFORM {
     PMLAS_SGEMM_TRANSPOSE_PACKB_BLOCK_ROUTINE TransposePackB16x4Routine;
     PMLAS_LOGISTIC_KERNEL_ROUTINE LogisticKernelRoutine;
     PMLAS_TANH_KERNEL_ROUTINE TanhKernelRoutine;
+    PMLAS_EXP_KERNEL_ROUTINE ExpKernelRoutine;
+    PMLAS_LOG_KERNEL_ROUTINE LogKernelRoutine;
+    PMLAS_ERF_KERNEL_ROUTINE ErfKernelRoutine;
+    PMLAS_REDUCE_MAXIMUM_KERNEL_ROUTINE ReduceMaximumKernelRoutine;
+    PMLAS_COMPUTE_SUM_EXP_KERNEL_ROUTINE ComputeSumExpKernelRoutine;
+    PMLAS_QGEMM_KERNEL_ROUTINE QgemmKernelRoutine;
+    PMLAS_CONV_DIRECT_KERNEL_ROUTINE ConvDirectKernelRoutine;
+    PMLAS_CONV_NCHWC_KERNEL_ROUTINE ConvNchwcKernelRoutine;
+    PMLAS_CONV_NCHWC_KERNEL_ROUTINE ConvDepthwiseNchwcKernelRoutine;
 #endif
 
-#if defined(MLAS_USE_WIN32_THREADPOOL)
-    int32_t MaximumThreadCount;
-#endif
+    size_t NchwcBlockSize;
 
-    int32_t
-    GetMaximumThreadCount(
-        void
-        )
-    {
-#if defined(MLAS_USE_OPENMP)
-        return (omp_get_num_threads() == 1) ? omp_get_max_threads() : 1;
-#elif defined(MLAS_USE_WIN32_THREADPOOL)
-        return MaximumThreadCount;
-#else
-        return 1;
-#endif
-    }
 };
 
 extern MLAS_PLATFORM MlasPlatform;
@@ -311,9 +488,63 @@ void
 MlasExecuteThreaded(
     PMLAS_THREADED_ROUTINE ThreadedRoutine,
     void* Context,
-    int32_t Iterations
+    int32_t Iterations,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+int32_t
+MlasGetMaximumThreadCount(
+    MLAS_THREADPOOL* ThreadPool
     );
 
+inline
+void
+MlasPartitionWork(
+    int32_t ThreadId,
+    int32_t ThreadCount,
+    size_t TotalWork,
+    size_t* WorkIndex,
+    size_t* WorkRemaining
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the contiguous range of work items assigned to a
+    thread when the total work is evenly partitioned across a number of
+    threads. The first (TotalWork % ThreadCount) threads are assigned one
+    additional work item.
+
+Arguments:
+
+    ThreadId - Supplies the index of the thread.
+
+    ThreadCount - Supplies the number of threads sharing the work.
+
+    TotalWork - Supplies the total number of work items.
+
+    WorkIndex - Receives the index of the first work item for the thread.
+
+    WorkRemaining - Receives the number of work items for the thread.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t WorkPerThread = TotalWork / size_t(ThreadCount);
+    const size_t WorkPerThreadExtra = TotalWork % size_t(ThreadCount);
+
+    if (size_t(ThreadId) < WorkPerThreadExtra) {
+        *WorkIndex = (WorkPerThread + 1) * size_t(ThreadId);
+        *WorkRemaining = WorkPerThread + 1;
+    } else {
+        *WorkIndex = WorkPerThread * size_t(ThreadId) + WorkPerThreadExtra;
+        *WorkRemaining = WorkPerThread;
+    }
+}
+
 //
 // Define the missing ARM64 NEON intrinsic macros from arm64_neon.h that enable
 // cross-compiler support.
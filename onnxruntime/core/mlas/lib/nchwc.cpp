@@ -0,0 +1,902 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    nchwc.cpp
+
+Abstract:
+
+    This module implements the convolution and pooling operations for the
+    NCHWc tensor layout and the routines to reorder tensors to and from the
+    NCHWc tensor layout.
+
+    The channels of an NCHWc tensor are split into blocks of channels that
+    are stored contiguously for each spatial element, so that a single vector
+    holds a block of channels. The number of channels is padded to a multiple
+    of the block size.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the parameters to execute segments of an NCHWc convolution operation
+// on worker threads.
+//
+
+struct MLAS_NCHWC_CONV_WORK_BLOCK {
+    const float* Input;
+    const float* Filter;
+    const float* Bias;
+    float* Output;
+    const MLAS_ACTIVATION* Activation;
+    size_t BatchCount;
+    size_t GroupCount;
+    size_t InputChannelBlocks;
+    size_t OutputChannelBlocks;
+    size_t FilterSetCount;
+    size_t InputShape[2];
+    size_t KernelShape[2];
+    size_t DilationShape[2];
+    size_t Padding[4];
+    size_t StrideShape[2];
+    size_t OutputShape[2];
+    bool Depthwise;
+    bool ZeroMode;
+    int32_t ThreadCount;
+};
+
+//
+// Define the parameters to execute segments of an NCHWc pooling operation on
+// worker threads.
+//
+
+struct MLAS_NCHWC_POOL_WORK_BLOCK {
+    MLAS_POOLING_KIND PoolingKind;
+    const float* Input;
+    float* Output;
+    size_t TotalChannelBlocks;
+    size_t InputShape[2];
+    size_t KernelShape[2];
+    size_t Padding[4];
+    size_t StrideShape[2];
+    size_t OutputShape[2];
+    int32_t ThreadCount;
+};
+
+size_t
+MLASCALL
+MlasNchwcGetBlockSize(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of channels in a block of the NCHWc tensor
+    layout for the current platform.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns the block size, or 1 if the platform does not support the NCHWc
+    tensor layout.
+
+--*/
+{
+    return MlasPlatform.NchwcBlockSize;
+}
+
+void
+MlasNchwcConvThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of an
+    NCHWc convolution operation.
+
+    The work is partitioned into rows of output elements for each set of
+    output channel blocks. The rows of a segment that share a set of filters
+    are computed together for each chunk of input channel blocks.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_NCHWC_CONV_WORK_BLOCK* WorkBlock = (const MLAS_NCHWC_CONV_WORK_BLOCK*)Context;
+
+    const size_t BlockSize = MlasPlatform.NchwcBlockSize;
+
+    const size_t InputHeight = WorkBlock->InputShape[0];
+    const size_t InputWidth = WorkBlock->InputShape[1];
+    const size_t InputSize = InputHeight * InputWidth;
+    const size_t OutputHeight = WorkBlock->OutputShape[0];
+    const size_t OutputWidth = WorkBlock->OutputShape[1];
+    const size_t OutputSize = OutputHeight * OutputWidth;
+
+    const size_t KernelHeight = WorkBlock->KernelShape[0];
+    const size_t KernelWidth = WorkBlock->KernelShape[1];
+    const size_t DilationHeight = WorkBlock->DilationShape[0];
+    const size_t PaddingTop = WorkBlock->Padding[0];
+    const size_t StrideHeight = WorkBlock->StrideShape[0];
+
+    const size_t GroupCount = WorkBlock->GroupCount;
+    const size_t InputChannelBlocks = WorkBlock->InputChannelBlocks;
+    const size_t OutputChannelBlocks = WorkBlock->OutputChannelBlocks;
+    const size_t FilterSetCount = WorkBlock->FilterSetCount;
+    const bool Depthwise = WorkBlock->Depthwise;
+
+    //
+    // Depthwise filters hold a single input channel for each output channel.
+    //
+
+    const size_t FilterStrideKernel = KernelHeight * KernelWidth * BlockSize;
+    const size_t FilterStrideInputBlock = Depthwise ? 0 : FilterStrideKernel * BlockSize;
+    const size_t FilterStrideBlock = Depthwise ? FilterStrideKernel : FilterStrideInputBlock * InputChannelBlocks;
+    const size_t FilterStrideKernelRow = Depthwise ? KernelWidth * BlockSize : KernelWidth * BlockSize * BlockSize;
+
+    const MLAS_ACTIVATION_KIND ActivationKind = WorkBlock->Activation->ActivationKind;
+
+#if defined(MLAS_TARGET_AMD64)
+    PMLAS_CONV_NCHWC_KERNEL_ROUTINE KernelRoutine = Depthwise ?
+        MlasPlatform.ConvDepthwiseNchwcKernelRoutine : MlasPlatform.ConvNchwcKernelRoutine;
+#else
+    PMLAS_CONV_NCHWC_KERNEL_ROUTINE KernelRoutine = nullptr;
+#endif
+
+    //
+    // Split the reduction over the input channel blocks into chunks, so that
+    // the filter for a chunk stays in the cache while it is applied to all of
+    // the output rows of the segment.
+    //
+
+    const size_t InputChannelChunk = Depthwise ? 1 : (std::max)(size_t(1),
+        size_t(MLAS_NCHWC_FILTER_CHUNK_ELEMENTS) / (MLAS_NCHWC_FILTER_SET_SIZE * FilterStrideInputBlock));
+
+    MLAS_CONV_NCHWC_ROW Row;
+
+    Row.InputWidth = InputWidth;
+    Row.InputStrideBlock = InputSize * BlockSize;
+    Row.InputStrideKernelRow = DilationHeight * InputWidth * BlockSize;
+    Row.FilterStrideBlock = FilterStrideBlock;
+    Row.FilterStrideInputBlock = FilterStrideInputBlock;
+    Row.KernelWidth = KernelWidth;
+    Row.DilationWidth = WorkBlock->DilationShape[1];
+    Row.StrideWidth = WorkBlock->StrideShape[1];
+    Row.PaddingLeftWidth = WorkBlock->Padding[1];
+    Row.OutputWidth = OutputWidth;
+    Row.OutputStrideBlock = OutputSize * BlockSize;
+
+    //
+    // Partition the work across the threads.
+    //
+
+    const size_t TotalWork = WorkBlock->BatchCount * GroupCount * FilterSetCount * OutputHeight;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, TotalWork, &WorkIndex, &WorkRemaining);
+
+    size_t phStart = WorkIndex % OutputHeight;
+    size_t FilterSet = (WorkIndex / OutputHeight) % FilterSetCount;
+    size_t BatchGroup = WorkIndex / (OutputHeight * FilterSetCount);
+
+    while (WorkRemaining > 0) {
+
+        //
+        // Compute the segment of output rows that share the same set of
+        // filters.
+        //
+
+        const size_t RowCount = (std::min)(WorkRemaining, OutputHeight - phStart);
+
+        const size_t Batch = BatchGroup / GroupCount;
+        const size_t Group = BatchGroup % GroupCount;
+
+        const size_t FilterBlock = Group * OutputChannelBlocks + FilterSet * MLAS_NCHWC_FILTER_SET_SIZE;
+        const size_t FilterCount = (std::min)(OutputChannelBlocks - FilterSet * MLAS_NCHWC_FILTER_SET_SIZE,
+            size_t(MLAS_NCHWC_FILTER_SET_SIZE));
+        const size_t InputBlock = Depthwise ? FilterBlock : Group * InputChannelBlocks;
+        const size_t ChannelBlocks = Depthwise ? 1 : InputChannelBlocks;
+
+        const float* Input = WorkBlock->Input + (Batch * GroupCount * InputChannelBlocks + InputBlock) * InputSize * BlockSize;
+        const float* Filter = WorkBlock->Filter + FilterBlock * FilterStrideBlock;
+        float* Output = WorkBlock->Output + (Batch * GroupCount * OutputChannelBlocks + FilterBlock) * OutputSize * BlockSize;
+
+        Row.FilterCount = FilterCount;
+
+        for (size_t ic = 0; ic < ChannelBlocks; ic += InputChannelChunk) {
+
+            const bool FirstChunk = (ic == 0);
+            const bool LastChunk = (ic + InputChannelChunk >= ChannelBlocks);
+
+            Row.InputChannelBlocks = (std::min)(InputChannelChunk, ChannelBlocks - ic);
+            Row.Bias = (FirstChunk && WorkBlock->Bias != nullptr) ? WorkBlock->Bias + FilterBlock * BlockSize : nullptr;
+            Row.Accumulate = !FirstChunk || !WorkBlock->ZeroMode;
+            Row.ReluActivation = LastChunk && (ActivationKind == MlasReluActivation);
+
+            for (size_t ph = phStart; ph < phStart + RowCount; ph++) {
+
+                //
+                // Compute the first kernel row and the number of kernel rows
+                // that overlap the unpadded input.
+                //
+
+                const ptrdiff_t ihStart = ptrdiff_t(ph * StrideHeight) - ptrdiff_t(PaddingTop);
+
+                size_t khStart = 0;
+                size_t khEnd = KernelHeight;
+
+                if (ihStart < 0) {
+                    khStart = (size_t(-ihStart) + DilationHeight - 1) / DilationHeight;
+                }
+
+                while (khEnd > khStart && size_t(ihStart + ptrdiff_t((khEnd - 1) * DilationHeight)) >= InputHeight) {
+                    khEnd--;
+                }
+
+                khStart = (std::min)(khStart, khEnd);
+
+                const size_t ih = (khStart < khEnd) ? size_t(ihStart + ptrdiff_t(khStart * DilationHeight)) : 0;
+
+                Row.Input = Input + ic * InputSize * BlockSize + ih * InputWidth * BlockSize;
+                Row.Filter = Filter + ic * FilterStrideInputBlock + khStart * FilterStrideKernelRow;
+                Row.Output = Output + ph * OutputWidth * BlockSize;
+                Row.KernelHeight = khEnd - khStart;
+
+                KernelRoutine(&Row);
+
+                //
+                // Apply the activations that are not handled by the kernel.
+                //
+
+                if (LastChunk && ActivationKind != MlasIdentityActivation && ActivationKind != MlasReluActivation) {
+                    MlasActivation(WorkBlock->Activation, Row.Output, nullptr, FilterCount, Row.Output,
+                        OutputWidth * BlockSize, Row.OutputStrideBlock);
+                }
+            }
+        }
+
+        //
+        // Advance to the next segment.
+        //
+
+        phStart += RowCount;
+
+        if (phStart == OutputHeight) {
+
+            phStart = 0;
+
+            if (++FilterSet == FilterSetCount) {
+                FilterSet = 0;
+                BatchGroup++;
+            }
+        }
+
+        WorkRemaining -= RowCount;
+    }
+}
+
+void
+MLASCALL
+MlasNchwcConv(
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    size_t GroupCount,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    const MLAS_ACTIVATION* Activation,
+    bool ZeroMode,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the NCHWc convolution operation.
+
+Arguments:
+
+    InputShape - Supplies the shape of the input tensor in NCHW order. The
+        number of channels is a multiple of the block size.
+
+    KernelShape - Supplies the shape of the kernel transform.
+
+    DilationShape - Supplies the shape of the dilation.
+
+    Padding - Supplies the number of padding elements at the edge of the input
+        tensor.
+
+    StrideShape - Supplies the shape of the stride.
+
+    OutputShape - Supplies the shape of the output tensor in NCHW order. The
+        number of channels is a multiple of the block size.
+
+    GroupCount - Supplies the number of channel groups. If the group count
+        equals the number of input and output channels, then the filter is
+        in the OIHWBo format from MlasReorderFilterOIHWBo, else the number of
+        input and output channels of each group must be a multiple of the
+        block size and the filter is in the OIHWBiBo format from
+        MlasReorderFilterOIHWBiBo.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the reordered filter tensor.
+
+    Bias - Supplies the optional bias vector, padded to the number of output
+        channels.
+
+    Output - Supplies the output tensor.
+
+    Activation - Supplies the parameters for the activation to apply to the
+        convolution output.
+
+    ZeroMode - Supplies true if the output tensor must be zero initialized
+        first, else false to accumulate the convolution into the existing
+        contents of the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasPlatform.NchwcBlockSize;
+
+    MLAS_NCHWC_CONV_WORK_BLOCK WorkBlock;
+
+    const size_t InputChannels = size_t(InputShape[1]);
+    const size_t OutputChannels = size_t(OutputShape[1]);
+
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Output = Output;
+    WorkBlock.Activation = Activation;
+    WorkBlock.BatchCount = size_t(InputShape[0]);
+    WorkBlock.Depthwise = (GroupCount > 1 && GroupCount == InputChannels && GroupCount == OutputChannels);
+    WorkBlock.ZeroMode = ZeroMode;
+
+    //
+    // A depthwise convolution is executed as a single group with a filter
+    // block for each block of channels.
+    //
+
+    if (WorkBlock.Depthwise) {
+        WorkBlock.GroupCount = 1;
+        WorkBlock.InputChannelBlocks = InputChannels / BlockSize;
+        WorkBlock.OutputChannelBlocks = OutputChannels / BlockSize;
+    } else {
+        WorkBlock.GroupCount = GroupCount;
+        WorkBlock.InputChannelBlocks = InputChannels / GroupCount / BlockSize;
+        WorkBlock.OutputChannelBlocks = OutputChannels / GroupCount / BlockSize;
+    }
+
+    WorkBlock.FilterSetCount = (WorkBlock.OutputChannelBlocks + MLAS_NCHWC_FILTER_SET_SIZE - 1) /
+        MLAS_NCHWC_FILTER_SET_SIZE;
+
+    for (size_t dim = 0; dim < 2; dim++) {
+        WorkBlock.InputShape[dim] = size_t(InputShape[dim + 2]);
+        WorkBlock.KernelShape[dim] = size_t(KernelShape[dim]);
+        WorkBlock.DilationShape[dim] = size_t(DilationShape[dim]);
+        WorkBlock.Padding[dim] = size_t(Padding[dim]);
+        WorkBlock.Padding[dim + 2] = size_t(Padding[dim + 2]);
+        WorkBlock.StrideShape[dim] = size_t(StrideShape[dim]);
+        WorkBlock.OutputShape[dim] = size_t(OutputShape[dim + 2]);
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // convolution operation. Small requests should run using the single
+    // threaded path.
+    //
+
+    const size_t OutputRows = WorkBlock.BatchCount * WorkBlock.GroupCount * WorkBlock.FilterSetCount *
+        WorkBlock.OutputShape[0];
+
+    const double InputChannelsPerGroup = WorkBlock.Depthwise ? 1.0 : double(InputChannels / GroupCount);
+    const double Complexity = double(WorkBlock.BatchCount) * double(OutputChannels) *
+        double(WorkBlock.OutputShape[0]) * double(WorkBlock.OutputShape[1]) *
+        InputChannelsPerGroup * double(WorkBlock.KernelShape[0]) * double(WorkBlock.KernelShape[1]);
+
+    int32_t TargetThreadCount;
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY) * double(MaximumThreadCount)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) > OutputRows) {
+        TargetThreadCount = int32_t(OutputRows);
+    }
+
+    WorkBlock.ThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasNchwcConvThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
+
+void
+MlasNchwcPoolThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of an
+    NCHWc pooling operation.
+
+    The work is partitioned into rows of output elements for each block of
+    channels.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_NCHWC_POOL_WORK_BLOCK* WorkBlock = (const MLAS_NCHWC_POOL_WORK_BLOCK*)Context;
+
+    const size_t BlockSize = MlasPlatform.NchwcBlockSize;
+    const size_t VectorCount = BlockSize / 4;
+
+    const MLAS_POOLING_KIND PoolingKind = WorkBlock->PoolingKind;
+
+    const size_t InputHeight = WorkBlock->InputShape[0];
+    const size_t InputWidth = WorkBlock->InputShape[1];
+    const size_t InputSize = InputHeight * InputWidth;
+    const size_t OutputHeight = WorkBlock->OutputShape[0];
+    const size_t OutputWidth = WorkBlock->OutputShape[1];
+    const size_t OutputSize = OutputHeight * OutputWidth;
+
+    const size_t KernelHeight = WorkBlock->KernelShape[0];
+    const size_t KernelWidth = WorkBlock->KernelShape[1];
+    const size_t PaddingTop = WorkBlock->Padding[0];
+    const size_t PaddingLeft = WorkBlock->Padding[1];
+    const size_t StrideHeight = WorkBlock->StrideShape[0];
+    const size_t StrideWidth = WorkBlock->StrideShape[1];
+
+    const MLAS_FLOAT32X4 InitialVector = (PoolingKind == MlasMaximumPooling) ?
+        MlasBroadcastFloat32x4(std::numeric_limits<float>::lowest()) : MlasZeroFloat32x4();
+
+    //
+    // Partition the work across the threads.
+    //
+
+    const size_t TotalWork = WorkBlock->TotalChannelBlocks * OutputHeight;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, TotalWork, &WorkIndex, &WorkRemaining);
+
+    while (WorkRemaining > 0) {
+
+        const size_t ChannelBlock = WorkIndex / OutputHeight;
+        const size_t ph = WorkIndex % OutputHeight;
+
+        const float* Input = WorkBlock->Input + ChannelBlock * InputSize * BlockSize;
+        float* Output = WorkBlock->Output + ChannelBlock * OutputSize * BlockSize + ph * OutputWidth * BlockSize;
+
+        const ptrdiff_t ihStart64 = ptrdiff_t(ph * StrideHeight) - ptrdiff_t(PaddingTop);
+        const size_t ihStart = size_t((std::max)(ihStart64, ptrdiff_t(0)));
+        const size_t ihEnd = size_t((std::max)((std::min)(ihStart64 + ptrdiff_t(KernelHeight), ptrdiff_t(InputHeight)), ptrdiff_t(ihStart)));
+
+        for (size_t pw = 0; pw < OutputWidth; pw++) {
+
+            const ptrdiff_t iwStart64 = ptrdiff_t(pw * StrideWidth) - ptrdiff_t(PaddingLeft);
+            const size_t iwStart = size_t((std::max)(iwStart64, ptrdiff_t(0)));
+            const size_t iwEnd = size_t((std::max)((std::min)(iwStart64 + ptrdiff_t(KernelWidth), ptrdiff_t(InputWidth)), ptrdiff_t(iwStart)));
+
+            MLAS_FLOAT32X4 Reduction[MLAS_NCHWC_MAXIMUM_BLOCK_SIZE / 4];
+
+            for (size_t v = 0; v < VectorCount; v++) {
+                Reduction[v] = InitialVector;
+            }
+
+            for (size_t ih = ihStart; ih < ihEnd; ih++) {
+
+                const float* input = Input + (ih * InputWidth + iwStart) * BlockSize;
+
+                for (size_t iw = iwStart; iw < iwEnd; iw++) {
+
+                    for (size_t v = 0; v < VectorCount; v++) {
+
+                        MLAS_FLOAT32X4 InputVector = MlasLoadFloat32x4(input + v * 4);
+
+                        if (PoolingKind == MlasMaximumPooling) {
+                            Reduction[v] = MlasMaximumFloat32x4(Reduction[v], InputVector);
+                        } else {
+                            Reduction[v] = MlasAddFloat32x4(Reduction[v], InputVector);
+                        }
+                    }
+
+                    input += BlockSize;
+                }
+            }
+
+            if (PoolingKind != MlasMaximumPooling) {
+
+                size_t Divisor;
+
+                if (PoolingKind == MlasAveragePoolingExcludePad) {
+                    Divisor = (ihEnd - ihStart) * (iwEnd - iwStart);
+                } else {
+                    Divisor = KernelHeight * KernelWidth;
+                }
+
+                MLAS_FLOAT32X4 DivisorVector = MlasBroadcastFloat32x4(float(unsigned(Divisor)));
+
+                for (size_t v = 0; v < VectorCount; v++) {
+                    Reduction[v] = MlasDivideFloat32x4(Reduction[v], DivisorVector);
+                }
+            }
+
+            for (size_t v = 0; v < VectorCount; v++) {
+                MlasStoreFloat32x4(Output + v * 4, Reduction[v]);
+            }
+
+            Output += BlockSize;
+        }
+
+        WorkIndex++;
+        WorkRemaining--;
+    }
+}
+
+void
+MLASCALL
+MlasNchwcPool(
+    MLAS_POOLING_KIND PoolingKind,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the NCHWc pooling operation.
+
+Arguments:
+
+    PoolingKind - Supplies the kind of pooling operation to perform.
+
+    InputShape - Supplies the shape of the input tensor in NCHW order. The
+        number of channels is a multiple of the block size.
+
+    KernelShape - Supplies the shape of the kernel transform.
+
+    Padding - Supplies the number of padding elements at the edge of the input
+        tensor.
+
+    StrideShape - Supplies the shape of the stride.
+
+    OutputShape - Supplies the shape of the output tensor in NCHW order.
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasPlatform.NchwcBlockSize;
+
+    MLAS_NCHWC_POOL_WORK_BLOCK WorkBlock;
+
+    WorkBlock.PoolingKind = PoolingKind;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.TotalChannelBlocks = size_t(InputShape[0]) * size_t(InputShape[1]) / BlockSize;
+
+    for (size_t dim = 0; dim < 2; dim++) {
+        WorkBlock.InputShape[dim] = size_t(InputShape[dim + 2]);
+        WorkBlock.KernelShape[dim] = size_t(KernelShape[dim]);
+        WorkBlock.Padding[dim] = size_t(Padding[dim]);
+        WorkBlock.Padding[dim + 2] = size_t(Padding[dim + 2]);
+        WorkBlock.StrideShape[dim] = size_t(StrideShape[dim]);
+        WorkBlock.OutputShape[dim] = size_t(OutputShape[dim + 2]);
+    }
+
+    //
+    // Use a thread per output row, limited by the maximum thread count.
+    //
+
+    const size_t TotalWork = WorkBlock.TotalChannelBlocks * WorkBlock.OutputShape[0];
+
+    int32_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(TargetThreadCount) > TotalWork) {
+        TargetThreadCount = int32_t(TotalWork);
+    }
+
+    WorkBlock.ThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasNchwcPoolThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
+
+void
+MLASCALL
+MlasReorderInput(
+    const int64_t* InputShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders an input tensor from the NCHW tensor layout to the
+    NCHWc tensor layout. The padding channels of the last block are zero
+    filled.
+
+Arguments:
+
+    InputShape - Supplies the shape of the input tensor in NCHW order.
+
+    S - Supplies the address of the source tensor.
+
+    D - Supplies the address of the destination tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasPlatform.NchwcBlockSize;
+
+    const size_t BatchCount = size_t(InputShape[0]);
+    const size_t InputChannels = size_t(InputShape[1]);
+    const size_t InputSize = size_t(InputShape[2]) * size_t(InputShape[3]);
+
+    for (size_t n = 0; n < BatchCount; n++) {
+
+        for (size_t c = 0; c < InputChannels; c += BlockSize) {
+
+            const size_t ChannelCount = (std::min)(InputChannels - c, BlockSize);
+
+            for (size_t i = 0; i < InputSize; i++) {
+
+                const float* s = S + i;
+
+                for (size_t bc = 0; bc < ChannelCount; bc++) {
+                    D[bc] = s[bc * InputSize];
+                }
+
+                for (size_t bc = ChannelCount; bc < BlockSize; bc++) {
+                    D[bc] = 0.0f;
+                }
+
+                D += BlockSize;
+            }
+
+            S += ChannelCount * InputSize;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasReorderOutput(
+    const int64_t* OutputShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders an output tensor from the NCHWc tensor layout to the
+    NCHW tensor layout. The padding channels of the last block are discarded.
+
+Arguments:
+
+    OutputShape - Supplies the shape of the output tensor in NCHW order.
+
+    S - Supplies the address of the source tensor.
+
+    D - Supplies the address of the destination tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasPlatform.NchwcBlockSize;
+
+    const size_t BatchCount = size_t(OutputShape[0]);
+    const size_t OutputChannels = size_t(OutputShape[1]);
+    const size_t OutputSize = size_t(OutputShape[2]) * size_t(OutputShape[3]);
+
+    for (size_t n = 0; n < BatchCount; n++) {
+
+        for (size_t c = 0; c < OutputChannels; c += BlockSize) {
+
+            const size_t ChannelCount = (std::min)(OutputChannels - c, BlockSize);
+
+            for (size_t i = 0; i < OutputSize; i++) {
+
+                float* d = D + i;
+
+                for (size_t bc = 0; bc < ChannelCount; bc++) {
+                    d[bc * OutputSize] = S[bc];
+                }
+
+                S += BlockSize;
+            }
+
+            D += ChannelCount * OutputSize;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasReorderFilterOIHWBiBo(
+    const int64_t* FilterShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders a filter tensor from the OIHW format to the OIHWBiBo
+    format used by MlasNchwcConv, where each block of output channels stores
+    a block of output channel values for each input channel of a block of
+    input channels. The padding channels are zero filled.
+
+Arguments:
+
+    FilterShape - Supplies the shape of the filter tensor in OIHW order.
+
+    S - Supplies the address of the source tensor.
+
+    D - Supplies the address of the destination tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasPlatform.NchwcBlockSize;
+
+    const size_t OutputChannels = size_t(FilterShape[0]);
+    const size_t InputChannels = size_t(FilterShape[1]);
+    const size_t KernelSize = size_t(FilterShape[2]) * size_t(FilterShape[3]);
+
+    for (size_t o = 0; o < OutputChannels; o += BlockSize) {
+
+        const size_t OutputCount = (std::min)(OutputChannels - o, BlockSize);
+
+        for (size_t i = 0; i < InputChannels; i += BlockSize) {
+
+            const size_t InputCount = (std::min)(InputChannels - i, BlockSize);
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                for (size_t bi = 0; bi < BlockSize; bi++) {
+
+                    for (size_t bo = 0; bo < BlockSize; bo++) {
+
+                        if (bi < InputCount && bo < OutputCount) {
+                            *D++ = S[((o + bo) * InputChannels + (i + bi)) * KernelSize + k];
+                        } else {
+                            *D++ = 0.0f;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasReorderFilterOIHWBo(
+    const int64_t* FilterShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders a filter tensor from the OIHW format to the OIHWBo
+    format used by MlasNchwcConv for depthwise convolutions, where each block
+    of output channels stores a block of output channel values for each
+    input channel. The padding channels are zero filled.
+
+Arguments:
+
+    FilterShape - Supplies the shape of the filter tensor in OIHW order.
+
+    S - Supplies the address of the source tensor.
+
+    D - Supplies the address of the destination tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasPlatform.NchwcBlockSize;
+
+    const size_t OutputChannels = size_t(FilterShape[0]);
+    const size_t InputChannels = size_t(FilterShape[1]);
+    const size_t KernelSize = size_t(FilterShape[2]) * size_t(FilterShape[3]);
+
+    for (size_t o = 0; o < OutputChannels; o += BlockSize) {
+
+        const size_t OutputCount = (std::min)(OutputChannels - o, BlockSize);
+
+        for (size_t i = 0; i < InputChannels; i++) {
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                for (size_t bo = 0; bo < BlockSize; bo++) {
+
+                    if (bo < OutputCount) {
+                        *D++ = S[((o + bo) * InputChannels + i) * KernelSize + k];
+                    } else {
+                        *D++ = 0.0f;
+                    }
+                }
+            }
+        }
+    }
+}
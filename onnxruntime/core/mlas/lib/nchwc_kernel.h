@@ -0,0 +1,493 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    nchwc_kernel.h
+
+Abstract:
+
+    This module implements the convolution kernels for the NCHWc tensor
+    layout.
+
+    The kernels are templated on a kernel type that supplies the vector type
+    and the vector operations for a specific instruction set, where a single
+    vector holds one block of channels. The instruction set specific modules
+    include this header and instantiate the kernels.
+
+--*/
+
+#pragma once
+
+template<typename KernelType, size_t FilterCount, size_t OutputCount, bool CheckBounds>
+inline
+void
+MlasConvNchwcKernelBlock(
+    const MLAS_CONV_NCHWC_ROW* Row,
+    size_t OutputIndex
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of OutputCount adjacent output elements for
+    FilterCount blocks of output channels.
+
+    The accumulators hold the entire reduction over the input channels and
+    the kernel, so each output element is stored exactly once.
+
+Arguments:
+
+    Row - Supplies the parameters for the row of the convolution.
+
+    OutputIndex - Supplies the index of the first output element of the row.
+
+    CheckBounds - Supplies true if the input columns of the kernel may be
+        outside of the input row. Only a single output element is computed
+        when bounds checking is enabled.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    typedef typename KernelType::Vector Vector;
+
+    constexpr size_t BlockSize = KernelType::BlockSize;
+
+    static_assert(!CheckBounds || OutputCount == 1, "bounds checking computes a single output");
+
+    const size_t StrideWidth = Row->StrideWidth;
+    const size_t DilationWidth = Row->DilationWidth;
+    const size_t KernelWidth = Row->KernelWidth;
+    const size_t FilterStrideBlock = Row->FilterStrideBlock;
+
+    float* Output = Row->Output + OutputIndex * BlockSize;
+
+    //
+    // Initialize the accumulators from the existing output, the bias, or
+    // zero.
+    //
+
+    Vector Accumulators[FilterCount][OutputCount];
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        Vector Initial;
+
+        if (Row->Bias != nullptr) {
+            Initial = KernelType::Load(Row->Bias + f * BlockSize);
+        } else {
+            Initial = KernelType::Zero();
+        }
+
+        for (size_t o = 0; o < OutputCount; o++) {
+            if (Row->Accumulate) {
+                Accumulators[f][o] = KernelType::Add(Initial,
+                    KernelType::Load(Output + f * Row->OutputStrideBlock + o * BlockSize));
+            } else {
+                Accumulators[f][o] = Initial;
+            }
+        }
+    }
+
+    //
+    // The first input column of the kernel is signed, because the output
+    // element may overlap the left padding.
+    //
+
+    const ptrdiff_t InputColumn = ptrdiff_t(OutputIndex * StrideWidth) - ptrdiff_t(Row->PaddingLeftWidth);
+
+    const float* InputBlock = Row->Input;
+    const float* FilterBlock = Row->Filter;
+
+    for (size_t ib = 0; ib < Row->InputChannelBlocks; ib++) {
+
+        const float* InputRow = InputBlock;
+        const float* FilterRow = FilterBlock;
+
+        for (size_t kh = 0; kh < Row->KernelHeight; kh++) {
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                const ptrdiff_t iw = InputColumn + ptrdiff_t(kw * DilationWidth);
+
+                if (CheckBounds && (iw < 0 || size_t(iw) >= Row->InputWidth)) {
+                    continue;
+                }
+
+                const float* input = InputRow + iw * ptrdiff_t(BlockSize);
+                const float* filter = FilterRow + kw * BlockSize * BlockSize;
+
+                for (size_t bi = 0; bi < BlockSize; bi++) {
+
+                    Vector FilterElements[FilterCount];
+
+                    for (size_t f = 0; f < FilterCount; f++) {
+                        FilterElements[f] = KernelType::Load(filter + f * FilterStrideBlock);
+                    }
+
+                    for (size_t o = 0; o < OutputCount; o++) {
+
+                        Vector InputElement = KernelType::Broadcast(input + o * StrideWidth * BlockSize);
+
+                        for (size_t f = 0; f < FilterCount; f++) {
+                            Accumulators[f][o] = KernelType::MultiplyAdd(InputElement,
+                                FilterElements[f], Accumulators[f][o]);
+                        }
+                    }
+
+                    input += 1;
+                    filter += BlockSize;
+                }
+            }
+
+            InputRow += Row->InputStrideKernelRow;
+            FilterRow += KernelWidth * BlockSize * BlockSize;
+        }
+
+        InputBlock += Row->InputStrideBlock;
+        FilterBlock += Row->FilterStrideInputBlock;
+    }
+
+    //
+    // Apply the optional activation and store the output elements.
+    //
+
+    for (size_t f = 0; f < FilterCount; f++) {
+        for (size_t o = 0; o < OutputCount; o++) {
+
+            Vector Result = Accumulators[f][o];
+
+            if (Row->ReluActivation) {
+                Result = KernelType::Maximum(Result, KernelType::Zero());
+            }
+
+            KernelType::Store(Output + f * Row->OutputStrideBlock + o * BlockSize, Result);
+        }
+    }
+}
+
+template<typename KernelType, size_t OutputCount, bool CheckBounds>
+inline
+void
+MlasConvDepthwiseNchwcKernelBlock(
+    const MLAS_CONV_NCHWC_ROW* Row,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    size_t OutputIndex
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of OutputCount adjacent output elements for
+    a single block of channels of a depthwise convolution.
+
+Arguments:
+
+    Row - Supplies the parameters for the row of the convolution.
+
+    Input - Supplies the address of the input block.
+
+    Filter - Supplies the address of the filter block.
+
+    Bias - Supplies the optional address of the bias block.
+
+    Output - Supplies the address of the output row of the block.
+
+    OutputIndex - Supplies the index of the first output element of the row.
+
+    CheckBounds - Supplies true if the input columns of the kernel may be
+        outside of the input row. Only a single output element is computed
+        when bounds checking is enabled.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    typedef typename KernelType::Vector Vector;
+
+    constexpr size_t BlockSize = KernelType::BlockSize;
+
+    static_assert(!CheckBounds || OutputCount == 1, "bounds checking computes a single output");
+
+    const size_t StrideWidth = Row->StrideWidth;
+    const size_t DilationWidth = Row->DilationWidth;
+    const size_t KernelWidth = Row->KernelWidth;
+
+    Output += OutputIndex * BlockSize;
+
+    Vector Accumulators[OutputCount];
+
+    Vector Initial = (Bias != nullptr) ? KernelType::Load(Bias) : KernelType::Zero();
+
+    for (size_t o = 0; o < OutputCount; o++) {
+        if (Row->Accumulate) {
+            Accumulators[o] = KernelType::Add(Initial, KernelType::Load(Output + o * BlockSize));
+        } else {
+            Accumulators[o] = Initial;
+        }
+    }
+
+    const ptrdiff_t InputColumn = ptrdiff_t(OutputIndex * StrideWidth) - ptrdiff_t(Row->PaddingLeftWidth);
+
+    for (size_t kh = 0; kh < Row->KernelHeight; kh++) {
+
+        for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+            const ptrdiff_t iw = InputColumn + ptrdiff_t(kw * DilationWidth);
+
+            if (CheckBounds && (iw < 0 || size_t(iw) >= Row->InputWidth)) {
+                continue;
+            }
+
+            const float* input = Input + iw * ptrdiff_t(BlockSize);
+
+            Vector FilterElements = KernelType::Load(Filter + kw * BlockSize);
+
+            for (size_t o = 0; o < OutputCount; o++) {
+                Accumulators[o] = KernelType::MultiplyAdd(KernelType::Load(input + o * StrideWidth * BlockSize),
+                    FilterElements, Accumulators[o]);
+            }
+        }
+
+        Input += Row->InputStrideKernelRow;
+        Filter += KernelWidth * BlockSize;
+    }
+
+    for (size_t o = 0; o < OutputCount; o++) {
+
+        Vector Result = Accumulators[o];
+
+        if (Row->ReluActivation) {
+            Result = KernelType::Maximum(Result, KernelType::Zero());
+        }
+
+        KernelType::Store(Output + o * BlockSize, Result);
+    }
+}
+
+inline
+void
+MlasConvNchwcComputeOutputRanges(
+    const MLAS_CONV_NCHWC_ROW* Row,
+    size_t* OutputCountLeftPad,
+    size_t* OutputCountRightPad
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of output elements at the left and right
+    edges of the row where the kernel overlaps the padding of the input row.
+    The remaining output elements can be computed without bounds checking.
+
+Arguments:
+
+    Row - Supplies the parameters for the row of the convolution.
+
+    OutputCountLeftPad - Receives the number of output elements at the left
+        edge of the row that overlap the padding.
+
+    OutputCountRightPad - Receives the number of output elements at the
+        right edge of the row that overlap the padding.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t OutputWidth = Row->OutputWidth;
+    const size_t StrideWidth = Row->StrideWidth;
+    const size_t PaddingLeftWidth = Row->PaddingLeftWidth;
+    const size_t SpanWidth = (Row->KernelWidth - 1) * Row->DilationWidth + 1;
+
+    size_t OutputStart = (PaddingLeftWidth + StrideWidth - 1) / StrideWidth;
+    size_t OutputEnd = 0;
+
+    if (Row->InputWidth + PaddingLeftWidth >= SpanWidth) {
+        OutputEnd = (Row->InputWidth + PaddingLeftWidth - SpanWidth) / StrideWidth + 1;
+    }
+
+    OutputStart = (std::min)(OutputStart, OutputWidth);
+    OutputEnd = (std::max)((std::min)(OutputEnd, OutputWidth), OutputStart);
+
+    *OutputCountLeftPad = OutputStart;
+    *OutputCountRightPad = OutputWidth - OutputEnd;
+}
+
+template<typename KernelType, size_t FilterCount>
+void
+MlasConvNchwcKernelRow(
+    const MLAS_CONV_NCHWC_ROW* Row
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a row of output elements for FilterCount blocks of
+    output channels.
+
+Arguments:
+
+    Row - Supplies the parameters for the row of the convolution.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t OutputBlock = KernelType::OutputBlock;
+
+    size_t OutputCountLeftPad;
+    size_t OutputCountRightPad;
+
+    MlasConvNchwcComputeOutputRanges(Row, &OutputCountLeftPad, &OutputCountRightPad);
+
+    const size_t OutputEnd = Row->OutputWidth - OutputCountRightPad;
+
+    size_t ow = 0;
+
+    for (; ow < OutputCountLeftPad; ow++) {
+        MlasConvNchwcKernelBlock<KernelType, FilterCount, 1, true>(Row, ow);
+    }
+
+    for (; ow + OutputBlock <= OutputEnd; ow += OutputBlock) {
+        MlasConvNchwcKernelBlock<KernelType, FilterCount, OutputBlock, false>(Row, ow);
+    }
+
+    //
+    // Compute a partial block for the remaining unpadded output elements,
+    // which is the common case for the small spatial dimensions at the end
+    // of a network, before falling back to single output elements.
+    //
+
+    constexpr size_t HalfOutputBlock = OutputBlock / 2;
+
+    if (HalfOutputBlock > 1 && ow + HalfOutputBlock <= OutputEnd) {
+        MlasConvNchwcKernelBlock<KernelType, FilterCount, HalfOutputBlock, false>(Row, ow);
+        ow += HalfOutputBlock;
+    }
+
+    for (; ow < OutputEnd; ow++) {
+        MlasConvNchwcKernelBlock<KernelType, FilterCount, 1, false>(Row, ow);
+    }
+
+    for (; ow < Row->OutputWidth; ow++) {
+        MlasConvNchwcKernelBlock<KernelType, FilterCount, 1, true>(Row, ow);
+    }
+}
+
+template<typename KernelType>
+void
+MlasConvNchwcKernel(
+    const MLAS_CONV_NCHWC_ROW* Row
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a row of output elements for a set of blocks of
+    output channels.
+
+Arguments:
+
+    Row - Supplies the parameters for the row of the convolution. The filter
+        count is at most MLAS_NCHWC_FILTER_SET_SIZE.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (Row->FilterCount) {
+
+        case 4:
+            MlasConvNchwcKernelRow<KernelType, 4>(Row);
+            break;
+
+        case 3:
+            MlasConvNchwcKernelRow<KernelType, 3>(Row);
+            break;
+
+        case 2:
+            MlasConvNchwcKernelRow<KernelType, 2>(Row);
+            break;
+
+        default:
+            MlasConvNchwcKernelRow<KernelType, 1>(Row);
+            break;
+    }
+}
+
+template<typename KernelType>
+void
+MlasConvDepthwiseNchwcKernel(
+    const MLAS_CONV_NCHWC_ROW* Row
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a row of output elements for a set of blocks of
+    channels of a depthwise convolution. Each block of output channels reads
+    the block of input channels at the same index.
+
+Arguments:
+
+    Row - Supplies the parameters for the row of the convolution.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = KernelType::BlockSize;
+    constexpr size_t OutputBlock = KernelType::DepthwiseOutputBlock;
+
+    size_t OutputCountLeftPad;
+    size_t OutputCountRightPad;
+
+    MlasConvNchwcComputeOutputRanges(Row, &OutputCountLeftPad, &OutputCountRightPad);
+
+    const size_t OutputEnd = Row->OutputWidth - OutputCountRightPad;
+
+    for (size_t f = 0; f < Row->FilterCount; f++) {
+
+        const float* Input = Row->Input + f * Row->InputStrideBlock;
+        const float* Filter = Row->Filter + f * Row->FilterStrideBlock;
+        const float* Bias = (Row->Bias != nullptr) ? Row->Bias + f * BlockSize : nullptr;
+        float* Output = Row->Output + f * Row->OutputStrideBlock;
+
+        size_t ow = 0;
+
+        for (; ow < OutputCountLeftPad; ow++) {
+            MlasConvDepthwiseNchwcKernelBlock<KernelType, 1, true>(Row, Input, Filter, Bias, Output, ow);
+        }
+
+        for (; ow + OutputBlock <= OutputEnd; ow += OutputBlock) {
+            MlasConvDepthwiseNchwcKernelBlock<KernelType, OutputBlock, false>(Row, Input, Filter, Bias, Output, ow);
+        }
+
+        for (; ow < OutputEnd; ow++) {
+            MlasConvDepthwiseNchwcKernelBlock<KernelType, 1, false>(Row, Input, Filter, Bias, Output, ow);
+        }
+
+        for (; ow < Row->OutputWidth; ow++) {
+            MlasConvDepthwiseNchwcKernelBlock<KernelType, 1, true>(Row, Input, Filter, Bias, Output, ow);
+        }
+    }
+}
@@ -0,0 +1,119 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    nchwc_kernel_avx512f.cpp
+
+Abstract:
+
+    This module implements the convolution kernels for the NCHWc tensor
+    layout using AVX512F instructions.
+
+--*/
+
+#include "mlasi.h"
+#include "nchwc_kernel.h"
+
+struct MLAS_NCHWC_KERNEL_AVX512F
+{
+    typedef __m512 Vector;
+
+    static constexpr size_t BlockSize = 16;
+
+    //
+    // Define the number of output elements computed by each iteration of the
+    // kernels. A full set of filters uses 24 of the 32 vector registers for
+    // the accumulators.
+    //
+
+    static constexpr size_t OutputBlock = 6;
+    static constexpr size_t DepthwiseOutputBlock = 8;
+
+    static Vector Zero()
+    {
+        return _mm512_setzero_ps();
+    }
+
+    static Vector Load(const float* Buffer)
+    {
+        return _mm512_loadu_ps(Buffer);
+    }
+
+    static void Store(float* Buffer, Vector Value)
+    {
+        _mm512_storeu_ps(Buffer, Value);
+    }
+
+    static Vector Broadcast(const float* Value)
+    {
+        return _mm512_set1_ps(*Value);
+    }
+
+    static Vector Add(Vector Vector1, Vector Vector2)
+    {
+        return _mm512_add_ps(Vector1, Vector2);
+    }
+
+    static Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3)
+    {
+        return _mm512_fmadd_ps(Vector1, Vector2, Vector3);
+    }
+
+    static Vector Maximum(Vector Vector1, Vector Vector2)
+    {
+        return _mm512_max_ps(Vector1, Vector2);
+    }
+};
+
+void
+MLASCALL
+MlasConvNchwcKernelAvx512F(
+    const MLAS_CONV_NCHWC_ROW* Row
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a row of output elements of an NCHWc convolution.
+
+Arguments:
+
+    Row - Supplies the parameters for the row of the convolution.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvNchwcKernel<MLAS_NCHWC_KERNEL_AVX512F>(Row);
+}
+
+void
+MLASCALL
+MlasConvDepthwiseNchwcKernelAvx512F(
+    const MLAS_CONV_NCHWC_ROW* Row
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a row of output elements of an NCHWc depthwise
+    convolution.
+
+Arguments:
+
+    Row - Supplies the parameters for the row of the convolution.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvDepthwiseNchwcKernel<MLAS_NCHWC_KERNEL_AVX512F>(Row);
+}
@@ -0,0 +1,119 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    nchwc_kernel_fma3.cpp
+
+Abstract:
+
+    This module implements the convolution kernels for the NCHWc tensor
+    layout using FMA3 instructions.
+
+--*/
+
+#include "mlasi.h"
+#include "nchwc_kernel.h"
+
+struct MLAS_NCHWC_KERNEL_FMA3
+{
+    typedef __m256 Vector;
+
+    static constexpr size_t BlockSize = 8;
+
+    //
+    // Define the number of output elements computed by each iteration of the
+    // kernels. A full set of filters uses 12 of the 16 vector registers for
+    // the accumulators.
+    //
+
+    static constexpr size_t OutputBlock = 3;
+    static constexpr size_t DepthwiseOutputBlock = 4;
+
+    static Vector Zero()
+    {
+        return _mm256_setzero_ps();
+    }
+
+    static Vector Load(const float* Buffer)
+    {
+        return _mm256_loadu_ps(Buffer);
+    }
+
+    static void Store(float* Buffer, Vector Value)
+    {
+        _mm256_storeu_ps(Buffer, Value);
+    }
+
+    static Vector Broadcast(const float* Value)
+    {
+        return _mm256_set1_ps(*Value);
+    }
+
+    static Vector Add(Vector Vector1, Vector Vector2)
+    {
+        return _mm256_add_ps(Vector1, Vector2);
+    }
+
+    static Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3)
+    {
+        return _mm256_fmadd_ps(Vector1, Vector2, Vector3);
+    }
+
+    static Vector Maximum(Vector Vector1, Vector Vector2)
+    {
+        return _mm256_max_ps(Vector1, Vector2);
+    }
+};
+
+void
+MLASCALL
+MlasConvNchwcKernelFma3(
+    const MLAS_CONV_NCHWC_ROW* Row
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a row of output elements of an NCHWc convolution.
+
+Arguments:
+
+    Row - Supplies the parameters for the row of the convolution.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvNchwcKernel<MLAS_NCHWC_KERNEL_FMA3>(Row);
+}
+
+void
+MLASCALL
+MlasConvDepthwiseNchwcKernelFma3(
+    const MLAS_CONV_NCHWC_ROW* Row
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a row of output elements of an NCHWc depthwise
+    convolution.
+
+Arguments:
+
+    Row - Supplies the parameters for the row of the convolution.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvDepthwiseNchwcKernel<MLAS_NCHWC_KERNEL_FMA3>(Row);
+}
@@ -43,6 +43,13 @@ Return Value:
 --*/
 {
 
+    //
+    // Default to no support for the NCHWc tensor layout. The block size is
+    // updated below if the platform supports the NCHWc kernels.
+    //
+
+    this->NchwcBlockSize = 1;
+
 #if defined(MLAS_TARGET_AMD64_IX86)
 
     //
@@ -55,6 +62,13 @@ Return Value:
     this->TransposePackB16x4Routine = MlasSgemmTransposePackB16x4Sse;
     this->LogisticKernelRoutine = MlasLogisticKernel;
     this->TanhKernelRoutine = MlasTanhKernel;
+    this->ExpKernelRoutine = MlasExpKernel;
+    this->LogKernelRoutine = MlasLogKernel;
+    this->ErfKernelRoutine = MlasErfKernel;
+    this->ReduceMaximumKernelRoutine = MlasReduceMaximumKernel;
+    this->ComputeSumExpKernelRoutine = MlasComputeSumExpKernel;
+    this->QgemmKernelRoutine = MlasQgemmKernel;
+    this->ConvDirectKernelRoutine = MlasConvDirectKernel;
 #endif
 
     //
@@ -106,14 +120,44 @@ Return Value:
                 if (((Cpuid7[1] & 0x10000) != 0) && ((xcr0 & 0xE0) == 0xE0)) {
                     this->KernelZeroRoutine = MlasSgemmKernelZeroAvx512F;
                     this->KernelAddRoutine = MlasSgemmKernelAddAvx512F;
+                    this->ConvDirectKernelRoutine = MlasConvDirectKernelAvx512F;
+                    this->ConvNchwcKernelRoutine = MlasConvNchwcKernelAvx512F;
+                    this->ConvDepthwiseNchwcKernelRoutine = MlasConvDepthwiseNchwcKernelAvx512F;
+                    this->NchwcBlockSize = 16;
+                    this->ExpKernelRoutine = MlasExpKernelAvx512F;
+                    this->LogKernelRoutine = MlasLogKernelAvx512F;
+                    this->ErfKernelRoutine = MlasErfKernelAvx512F;
+                    this->ReduceMaximumKernelRoutine = MlasReduceMaximumKernelAvx512F;
+                    this->ComputeSumExpKernelRoutine = MlasComputeSumExpKernelAvx512F;
                 } else {
                     this->KernelZeroRoutine = MlasSgemmKernelZeroFma3;
                     this->KernelAddRoutine = MlasSgemmKernelAddFma3;
+                    this->ConvDirectKernelRoutine = MlasConvDirectKernelFma3;
+                    this->ConvNchwcKernelRoutine = MlasConvNchwcKernelFma3;
+                    this->ConvDepthwiseNchwcKernelRoutine = MlasConvDepthwiseNchwcKernelFma3;
+                    this->NchwcBlockSize = 8;
+                    this->ExpKernelRoutine = MlasExpKernelFma3;
+                    this->LogKernelRoutine = MlasLogKernelFma3;
+                    this->ErfKernelRoutine = MlasErfKernelFma3;
+                    this->ReduceMaximumKernelRoutine = MlasReduceMaximumKernelFma3;
+                    this->ComputeSumExpKernelRoutine = MlasComputeSumExpKernelFma3;
                 }
 
                 this->LogisticKernelRoutine = MlasLogisticKernelFma3;
                 this->TanhKernelRoutine = MlasTanhKernelFma3;
 
+                //
+                // Check if the processor supports AVX512F and AVX512 VNNI for
+                // the quantized integer GEMM kernel.
+                //
+
+                if (((Cpuid7[1] & 0x10000) != 0) && ((xcr0 & 0xE0) == 0xE0) &&
+                    ((Cpuid7[2] & 0x800) != 0)) {
+                    this->QgemmKernelRoutine = MlasQgemmKernelAvx512Vnni;
+                } else {
+                    this->QgemmKernelRoutine = MlasQgemmKernelAvx2;
+                }
+
             } else {
 
                 this->KernelZeroRoutine = MlasSgemmKernelZeroAvx;
@@ -131,22 +175,4 @@ Return Value:
 
 #endif
 
-#if defined(MLAS_USE_WIN32_THREADPOOL)
-
-    //
-    // Retrieve the number of processors in the system.
-    //
-
-    SYSTEM_INFO SystemInfo;
-
-    GetSystemInfo(&SystemInfo);
-
-    if (SystemInfo.dwNumberOfProcessors <= MLAS_MAXIMUM_THREAD_COUNT) {
-        this->MaximumThreadCount = int32_t(SystemInfo.dwNumberOfProcessors);
-    } else {
-        this->MaximumThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
-    }
-
-#endif
-
 }
@@ -1125,6 +1125,64 @@ Return Value:
     }
 }
 
+//
+// Define the parameters to execute segments of the channels of a pooling
+// operation on worker threads.
+//
+
+struct MLAS_POOL_THREADED_WORK_BLOCK {
+    const MLAS_WORK_BLOCK* WorkBlock;
+    PMLAS_POOL_KERNEL_ROUTINE PoolKernelRoutine;
+    const float* Input;
+    float* Output;
+    size_t OutputSize;
+    size_t TotalChannelCount;
+    int32_t TargetThreadCount;
+};
+
+void
+MlasPoolThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    pooling operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_POOL_THREADED_WORK_BLOCK* ThreadedWorkBlock = (MLAS_POOL_THREADED_WORK_BLOCK*)Context;
+
+    size_t ChannelStart;
+    size_t ChannelCount;
+
+    MlasPartitionWork(Index, ThreadedWorkBlock->TargetThreadCount,
+        ThreadedWorkBlock->TotalChannelCount, &ChannelStart, &ChannelCount);
+
+    if (ChannelCount == 0) {
+        return;
+    }
+
+    const MLAS_WORK_BLOCK* WorkBlock = ThreadedWorkBlock->WorkBlock;
+
+    ThreadedWorkBlock->PoolKernelRoutine(WorkBlock, ChannelCount,
+        ThreadedWorkBlock->Input + ChannelStart * WorkBlock->InputSize,
+        ThreadedWorkBlock->Output + ChannelStart * ThreadedWorkBlock->OutputSize);
+}
+
 //
 // Stores pointers to the pooling kernel routines.
 //
@@ -1182,7 +1240,8 @@ MlasPool(
     const int64_t* StrideShape,
     const int64_t* OutputShape,
     const float* Input,
-    float* Output
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
     )
 /*++
 
@@ -1211,6 +1270,9 @@ Arguments:
 
     Output - Supplies the output tensor.
 
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        operation should execute on the calling thread.
+
 Return Value:
 
     None.
@@ -1316,20 +1378,30 @@ Return Value:
     }
 
     //
-    // Execute the pooling kernel routine.
+    // Execute the pooling kernel routine, partitioning the channels across the
+    // available threads.
     //
 
-#if defined(MLAS_USE_OPENMP)
+    int32_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
 
-    #pragma omp parallel for
-    for (int64_t c = 0; c < int64_t(TotalChannelCount); c++) {
-        PoolKernelRoutine(&WorkBlock, 1, Input + c * InputSize, Output + c * OutputSize);
+    if (size_t(TargetThreadCount) >= TotalChannelCount) {
+        TargetThreadCount = int32_t(TotalChannelCount);
     }
 
-#else
+    if (TargetThreadCount <= 1) {
+        PoolKernelRoutine(&WorkBlock, TotalChannelCount, Input, Output);
+        return;
+    }
 
-    PoolKernelRoutine(&WorkBlock, TotalChannelCount, Input, Output);
+    MLAS_POOL_THREADED_WORK_BLOCK ThreadedWorkBlock;
 
-#endif
+    ThreadedWorkBlock.WorkBlock = &WorkBlock;
+    ThreadedWorkBlock.PoolKernelRoutine = PoolKernelRoutine;
+    ThreadedWorkBlock.Input = Input;
+    ThreadedWorkBlock.Output = Output;
+    ThreadedWorkBlock.OutputSize = OutputSize;
+    ThreadedWorkBlock.TotalChannelCount = TotalChannelCount;
+    ThreadedWorkBlock.TargetThreadCount = TargetThreadCount;
 
+    MlasExecuteThreaded(MlasPoolThreaded, &ThreadedWorkBlock, TargetThreadCount, ThreadPool);
 }
@@ -0,0 +1,812 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm.cpp
+
+Abstract:
+
+    This module implements the quantized integer matrix/matrix multiply
+    operation (QGEMM).
+
+    Matrix A is an unsigned 8-bit matrix and matrix B is an unsigned or
+    signed 8-bit matrix. Matrix B is packed as signed 8-bit values: unsigned
+    values are biased by -128 and the zero point of matrix B is adjusted to
+    compensate. The kernels compute the product of the packed values and the
+    zero point terms are folded into the accumulators using the row sums of
+    matrix A and the column sums of matrix B:
+
+        C = A*B - offb*RowSum(A) - offa*ColumnSum(B) + K*offa*offb
+
+--*/
+
+#include "mlasi.h"
+#include <cmath>
+
+//
+// Define the parameters to execute segments of a QGEMM operation on worker
+// threads.
+//
+
+struct MLAS_QGEMM_WORK_BLOCK {
+    size_t M;
+    size_t N;
+    size_t K;
+    const uint8_t* A;
+    size_t lda;
+    int32_t offa;
+    const uint8_t* B;
+    size_t ldb;
+    int32_t offb;
+    bool BIsSigned;
+    int32_t* C;
+    size_t ldc;
+    const MLAS_QGEMM_REQUANTIZE* Requantize;
+    int32_t RequantizeMultiplier;
+    int32_t RequantizeShift;
+    size_t ThreadStrideM;
+    size_t ThreadStrideN;
+    int32_t ThreadCountN;
+};
+
+void
+MlasQgemmComputeMultiplier(
+    float Scale,
+    int32_t* Multiplier,
+    int32_t* RightShift
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a floating point scale to a fixed point multiplier
+    in the range [0.5, 1) and a right shift, using the same rounding as the
+    gemmlowp based kernels this routine replaces.
+
+Arguments:
+
+    Scale - Supplies the positive scale to convert.
+
+    Multiplier - Receives the fixed point multiplier.
+
+    RightShift - Receives the right shift to apply after the multiply.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    uint32_t ScaleBits;
+    memcpy(&ScaleBits, &Scale, sizeof(float));
+
+    const int32_t Exponent = int32_t(ScaleBits >> 23);
+
+    uint32_t NormalizedBits = (ScaleBits & 0x007FFFFF) | 0x3F000000;
+    float Normalized;
+    memcpy(&Normalized, &NormalizedBits, sizeof(float));
+
+    int64_t FixedPoint = int64_t(std::round(Normalized * float(1ll << 31)));
+    int32_t Shift = 126 - Exponent;
+
+    //
+    // Rounding may carry into the next power of two.
+    //
+
+    if (FixedPoint == (1ll << 31)) {
+        FixedPoint /= 2;
+        Shift--;
+    }
+
+    *Multiplier = int32_t(FixedPoint);
+    *RightShift = Shift;
+}
+
+inline
+int32_t
+MlasQgemmRequantizeValue(
+    int32_t Value,
+    int32_t Multiplier,
+    int32_t RightShift
+    )
+/*++
+
+Routine Description:
+
+    This routine scales an accumulator by a fixed point multiplier followed
+    by a rounding right shift.
+
+Arguments:
+
+    Value - Supplies the accumulator value.
+
+    Multiplier - Supplies the fixed point multiplier.
+
+    RightShift - Supplies the right shift. A negative value is applied as a
+        saturating left shift before the multiply.
+
+Return Value:
+
+    Returns the scaled value.
+
+--*/
+{
+    if (RightShift < 0) {
+        int64_t Shifted = int64_t(Value) * (int64_t(1) << std::min(-RightShift, 31));
+        Shifted = std::max<int64_t>(Shifted, std::numeric_limits<int32_t>::min());
+        Shifted = std::min<int64_t>(Shifted, std::numeric_limits<int32_t>::max());
+        Value = int32_t(Shifted);
+        RightShift = 0;
+    }
+
+    //
+    // Saturating rounding doubling high multiply.
+    //
+
+    int32_t HighMul;
+
+    if (Value == std::numeric_limits<int32_t>::min() && Multiplier == Value) {
+        HighMul = std::numeric_limits<int32_t>::max();
+    } else {
+        int64_t Product = int64_t(Value) * int64_t(Multiplier);
+        int32_t Nudge = (Product >= 0) ? (1 << 30) : (1 - (1 << 30));
+        HighMul = int32_t((Product + Nudge) / (int64_t(1) << 31));
+    }
+
+    //
+    // Rounding divide by a power of two with ties rounded away from zero.
+    //
+
+    RightShift = std::min(RightShift, 31);
+
+    const int32_t Mask = int32_t((int64_t(1) << RightShift) - 1);
+    const int32_t Remainder = HighMul & Mask;
+    const int32_t Threshold = (Mask >> 1) + ((HighMul < 0) ? 1 : 0);
+
+    return (HighMul >> RightShift) + ((Remainder > Threshold) ? 1 : 0);
+}
+
+void
+MlasQgemmRequantizeOutput(
+    const MLAS_QGEMM_WORK_BLOCK* WorkBlock,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a completed block of matrix C to unsigned 8-bit
+    values and stores them to the requantize output.
+
+Arguments:
+
+    WorkBlock - Supplies the QGEMM operation.
+
+    StartM - Supplies the first row of the block.
+
+    StartN - Supplies the first column of the block.
+
+    CountM - Supplies the number of rows of the block.
+
+    CountN - Supplies the number of columns of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_QGEMM_REQUANTIZE* Requantize = WorkBlock->Requantize;
+
+    const int32_t Multiplier = WorkBlock->RequantizeMultiplier;
+    const int32_t RightShift = WorkBlock->RequantizeShift;
+    const int32_t ZeroPoint = int32_t(Requantize->ZeroPoint);
+
+    const int32_t* C = WorkBlock->C + StartM * WorkBlock->ldc + StartN;
+    uint8_t* Output = Requantize->Output + StartM * Requantize->ldo + StartN;
+
+    for (size_t m = 0; m < CountM; m++) {
+
+        const int32_t Bias = (Requantize->Bias != nullptr) ? Requantize->Bias[StartM + m] : 0;
+
+        for (size_t n = 0; n < CountN; n++) {
+
+            int32_t Value = MlasQgemmRequantizeValue(C[n] + Bias, Multiplier, RightShift) + ZeroPoint;
+
+            Value = std::max(Value, int32_t(0));
+            Value = std::min(Value, int32_t(255));
+
+            Output[n] = uint8_t(Value);
+        }
+
+        C += WorkBlock->ldc;
+        Output += Requantize->ldo;
+    }
+}
+
+void
+MlasQgemmPackA(
+    uint8_t* D,
+    const uint8_t* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK,
+    int32_t* RowSumBuffer
+    )
+/*++
+
+Routine Description:
+
+    This routine copies a block of matrix A to a local buffer with the rows
+    padded to a multiple of 4 values and computes the sum of each row.
+
+Arguments:
+
+    D - Supplies the address of the destination buffer.
+
+    A - Supplies the address of the source matrix.
+
+    lda - Supplies the number of elements per row of the source matrix.
+
+    CountM - Supplies the number of rows to copy.
+
+    CountK - Supplies the number of columns to copy.
+
+    RowSumBuffer - Receives the sum of each row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedCountK = (CountK + 3) & ~size_t(3);
+
+    for (size_t m = 0; m < CountM; m++) {
+
+        int32_t RowSum = 0;
+
+        for (size_t k = 0; k < CountK; k++) {
+            D[k] = A[k];
+            RowSum += int32_t(A[k]);
+        }
+
+        for (size_t k = CountK; k < AlignedCountK; k++) {
+            D[k] = 0;
+        }
+
+        RowSumBuffer[m] = RowSum;
+
+        A += lda;
+        D += AlignedCountK;
+    }
+}
+
+void
+MlasQgemmPackB(
+    int8_t* D,
+    const uint8_t* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK,
+    bool BIsSigned,
+    int32_t* ColumnSumBuffer
+    )
+/*++
+
+Routine Description:
+
+    This routine copies a block of matrix B to a local buffer as panels of
+    MLAS_QGEMM_PANEL_N columns. Each panel stores groups of 4 consecutive
+    values along the K dimension for each column. Unsigned values are biased
+    by -128 to form signed values.
+
+Arguments:
+
+    D - Supplies the address of the destination buffer.
+
+    B - Supplies the address of the source matrix.
+
+    ldb - Supplies the number of elements per row of the source matrix.
+
+    CountN - Supplies the number of columns to copy.
+
+    CountK - Supplies the number of rows to copy.
+
+    BIsSigned - Supplies true if the source matrix is signed.
+
+    ColumnSumBuffer - Receives the sum of each packed column.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const uint8_t BitFlipValue = BIsSigned ? 0 : 0x80;
+    const size_t PackedCountK = (CountK + 3) / 4;
+
+    for (size_t n = 0; n < CountN; n += MLAS_QGEMM_PANEL_N) {
+
+        const size_t CountPanelN = std::min(CountN - n, size_t(MLAS_QGEMM_PANEL_N));
+
+        int8_t* d = D + n * PackedCountK * 4;
+
+        memset(d, 0, PackedCountK * 4 * MLAS_QGEMM_PANEL_N);
+
+        for (size_t nn = 0; nn < CountPanelN; nn++) {
+            ColumnSumBuffer[n + nn] = 0;
+        }
+
+        const uint8_t* b = B + n;
+
+        for (size_t k = 0; k < CountK; k++) {
+
+            int8_t* dk = d + (k / 4) * 4 * MLAS_QGEMM_PANEL_N + (k % 4);
+
+            for (size_t nn = 0; nn < CountPanelN; nn++) {
+                int8_t Value = int8_t(b[nn] ^ BitFlipValue);
+                dk[nn * 4] = Value;
+                ColumnSumBuffer[n + nn] += int32_t(Value);
+            }
+
+            b += ldb;
+        }
+    }
+}
+
+size_t
+MLASCALL
+MlasQgemmKernel(
+    const uint8_t* A,
+    const int8_t* B,
+    int32_t* C,
+    size_t PackedCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumBuffer,
+    const int32_t* ColumnSumBuffer,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A. The matrix data has been packed
+        using MlasQgemmPackA.
+
+    B - Supplies the address of matrix B. The matrix data has been packed
+        using MlasQgemmPackB.
+
+    C - Supplies the address of matrix C.
+
+    PackedCountK - Supplies the number of packed groups of 4 columns from
+        matrix A and rows from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    RowSumBuffer - Supplies the zero point terms for each row of matrix C.
+
+    ColumnSumBuffer - Supplies the zero point terms for each column of
+        matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    const size_t PackedRowStride = PackedCountK * 4;
+
+    for (size_t m = 0; m < CountM; m++) {
+
+        const uint8_t* a = A + m * PackedRowStride;
+        int32_t* c = C + m * ldc;
+
+        for (size_t n = 0; n < CountN; n++) {
+
+            const int8_t* b = B + (n / MLAS_QGEMM_PANEL_N) * PackedCountK * 4 * MLAS_QGEMM_PANEL_N +
+                (n % MLAS_QGEMM_PANEL_N) * 4;
+
+            int32_t Accumulator = RowSumBuffer[m] + ColumnSumBuffer[n];
+
+            for (size_t k = 0; k < PackedCountK; k++) {
+                Accumulator += int32_t(a[k * 4 + 0]) * int32_t(b[0]);
+                Accumulator += int32_t(a[k * 4 + 1]) * int32_t(b[1]);
+                Accumulator += int32_t(a[k * 4 + 2]) * int32_t(b[2]);
+                Accumulator += int32_t(a[k * 4 + 3]) * int32_t(b[3]);
+                b += 4 * MLAS_QGEMM_PANEL_N;
+            }
+
+            if (!ZeroMode) {
+                Accumulator += c[n];
+            }
+
+            c[n] = Accumulator;
+        }
+    }
+
+    return CountM;
+}
+
+void
+MlasQgemmOperation(
+    const MLAS_QGEMM_WORK_BLOCK* WorkBlock,
+    size_t StartM,
+    size_t StartN,
+    size_t RangeCountM,
+    size_t RangeCountN
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM) for a segment of matrix C.
+
+Arguments:
+
+    WorkBlock - Supplies the QGEMM operation.
+
+    StartM - Supplies the first row of the segment.
+
+    StartN - Supplies the first column of the segment.
+
+    RangeCountM - Supplies the number of rows of the segment.
+
+    RangeCountN - Supplies the number of columns of the segment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(uint8_t PanelA[MLAS_QGEMM_STRIDEM * MLAS_QGEMM_STRIDEK], 64);
+    MLAS_DECLSPEC_ALIGN(int8_t PanelB[MLAS_QGEMM_STRIDEN * MLAS_QGEMM_STRIDEK], 64);
+    MLAS_DECLSPEC_ALIGN(int32_t RowSumBuffer[MLAS_QGEMM_STRIDEM], 64);
+    MLAS_DECLSPEC_ALIGN(int32_t ColumnSumBuffer[MLAS_QGEMM_STRIDEN], 64);
+
+#if defined(MLAS_TARGET_AMD64)
+    PMLAS_QGEMM_KERNEL_ROUTINE KernelRoutine = MlasPlatform.QgemmKernelRoutine;
+#else
+    PMLAS_QGEMM_KERNEL_ROUTINE KernelRoutine = MlasQgemmKernel;
+#endif
+
+    const size_t K = WorkBlock->K;
+    const int32_t offa = WorkBlock->offa;
+    const int32_t offb = WorkBlock->offb;
+
+    //
+    // Expand the K stride if N is small for better utilization of the B
+    // panel. The M stride is reduced to keep the A panel the same size.
+    //
+
+    size_t StrideM = MLAS_QGEMM_STRIDEM;
+    size_t StrideN = MLAS_QGEMM_STRIDEN;
+    size_t StrideK = MLAS_QGEMM_STRIDEK;
+
+    while (StrideN > MLAS_QGEMM_PANEL_N && StrideN / 2 >= RangeCountN && StrideK < K) {
+        StrideK *= 2;
+        StrideN /= 2;
+        StrideM /= 2;
+    }
+
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+
+    size_t CountN;
+    size_t CountK;
+    size_t CountM;
+
+    for (size_t n = 0; n < RangeCountN; n += CountN) {
+
+        CountN = std::min(RangeCountN - n, StrideN);
+
+        //
+        // Step through each slice of matrix B along the K dimension.
+        //
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = std::min(K - k, StrideK);
+
+            const size_t PackedCountK = (CountK + 3) / 4;
+
+            MlasQgemmPackB(PanelB, WorkBlock->B + k * WorkBlock->ldb + StartN + n,
+                WorkBlock->ldb, CountN, CountK, WorkBlock->BIsSigned, ColumnSumBuffer);
+
+            for (size_t nn = 0; nn < CountN; nn++) {
+                ColumnSumBuffer[nn] *= -offa;
+            }
+
+            //
+            // Step through each slice of matrix A along the M dimension.
+            //
+
+            for (size_t m = 0; m < RangeCountM; m += CountM) {
+
+                CountM = std::min(RangeCountM - m, StrideM);
+
+                MlasQgemmPackA(PanelA, WorkBlock->A + (StartM + m) * WorkBlock->lda + k,
+                    WorkBlock->lda, CountM, CountK, RowSumBuffer);
+
+                for (size_t mm = 0; mm < CountM; mm++) {
+                    RowSumBuffer[mm] = RowSumBuffer[mm] * -offb + int32_t(CountK) * offa * offb;
+                }
+
+                int32_t* c = WorkBlock->C + (StartM + m) * WorkBlock->ldc + StartN + n;
+
+                const uint8_t* pa = PanelA;
+                int32_t* pc = c;
+                const int32_t* RowSums = RowSumBuffer;
+                size_t RowsRemaining = CountM;
+
+                while (RowsRemaining > 0) {
+
+                    size_t RowsHandled = KernelRoutine(pa, PanelB, pc, PackedCountK,
+                        RowsRemaining, CountN, WorkBlock->ldc, RowSums, ColumnSumBuffer, k == 0);
+
+                    pa += RowsHandled * PackedCountK * 4;
+                    pc += RowsHandled * WorkBlock->ldc;
+                    RowSums += RowsHandled;
+                    RowsRemaining -= RowsHandled;
+                }
+
+                //
+                // Requantize the block of matrix C while it is still in the
+                // cache once all of the K dimension has been accumulated.
+                //
+
+                if (WorkBlock->Requantize != nullptr && k + CountK == K) {
+                    MlasQgemmRequantizeOutput(WorkBlock, StartM + m, StartN + n, CountM, CountN);
+                }
+            }
+        }
+    }
+}
+
+void
+MlasQgemmOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    QGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_QGEMM_WORK_BLOCK* WorkBlock = (MLAS_QGEMM_WORK_BLOCK*)Context;
+
+    //
+    // Compute the segment of matrix C that is owned by this thread.
+    //
+
+    const size_t m = size_t(Index / WorkBlock->ThreadCountN) * WorkBlock->ThreadStrideM;
+    const size_t n = size_t(Index % WorkBlock->ThreadCountN) * WorkBlock->ThreadStrideN;
+
+    const size_t CountM = std::min(WorkBlock->M - m, WorkBlock->ThreadStrideM);
+    const size_t CountN = std::min(WorkBlock->N - n, WorkBlock->ThreadStrideN);
+
+    MlasQgemmOperation(WorkBlock, m, n, CountM, CountN);
+}
+
+void
+MLASCALL
+MlasQgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    bool BIsSigned,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_REQUANTIZE* Requantize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM):
+
+        C = (A - offa) * (B - offb)
+
+    If requantize parameters are supplied, matrix C is used as an
+    intermediate buffer and the output is additionally computed as:
+
+        Output = Saturate(Scale * (C + Bias) + ZeroPoint)
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    offb - Supplies the zero point offset of matrix B.
+
+    BIsSigned - Supplies true if matrix B and its zero point offset are
+        signed 8-bit values, else false if they are unsigned.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Requantize - Optionally supplies the parameters to convert matrix C to
+        unsigned 8-bit values. The bias is indexed by the row of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        operation should execute on the calling thread.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_QGEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.offa = int32_t(offa);
+    WorkBlock.B = B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.BIsSigned = BIsSigned;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.Requantize = Requantize;
+    WorkBlock.RequantizeMultiplier = 0;
+    WorkBlock.RequantizeShift = 0;
+
+    //
+    // The packed matrix B stores unsigned values biased by -128, so adjust
+    // the zero point offset to match.
+    //
+
+    if (BIsSigned) {
+        WorkBlock.offb = int32_t(int8_t(offb));
+    } else {
+        WorkBlock.offb = int32_t(offb) - 128;
+    }
+
+    if (Requantize != nullptr) {
+        MlasQgemmComputeMultiplier(Requantize->Scale, &WorkBlock.RequantizeMultiplier,
+            &WorkBlock.RequantizeShift);
+    }
+
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    //
+    // Handle the special case of an empty K dimension.
+    //
+
+    if (K == 0) {
+
+        for (size_t m = 0; m < M; m++) {
+            std::fill_n(C + m * ldc, N, 0);
+        }
+
+        if (Requantize != nullptr) {
+            MlasQgemmRequantizeOutput(&WorkBlock, 0, 0, M, N);
+        }
+
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the QGEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    double Complexity = double(M) * double(N) * double(K);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY) * double(MaximumThreadCount)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+        MlasQgemmOperation(&WorkBlock, 0, 0, M, N);
+        return;
+    }
+
+    //
+    // Segment the operation across multiple threads by slicing the larger of
+    // the M or N dimensions.
+    //
+
+    int32_t ThreadCount;
+
+    if (N > M) {
+
+        size_t StrideN = (N + TargetThreadCount - 1) / TargetThreadCount;
+
+        StrideN =
+            (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+        WorkBlock.ThreadStrideM = M;
+        WorkBlock.ThreadStrideN = StrideN;
+        WorkBlock.ThreadCountN = int32_t((N + StrideN - 1) / StrideN);
+
+        ThreadCount = WorkBlock.ThreadCountN;
+
+    } else {
+
+        size_t StrideM = (M + TargetThreadCount - 1) / TargetThreadCount;
+
+        WorkBlock.ThreadStrideM = StrideM;
+        WorkBlock.ThreadStrideN = N;
+        WorkBlock.ThreadCountN = 1;
+
+        ThreadCount = int32_t((M + StrideM - 1) / StrideM);
+    }
+
+    MlasExecuteThreaded(MlasQgemmOperationThreaded, &WorkBlock, ThreadCount, ThreadPool);
+}
@@ -0,0 +1,239 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the kernel for the quantized integer matrix/matrix
+    multiply operation (QGEMM) using AVX2 instructions.
+
+    The packed signed 8-bit values of matrix B are widened to 16-bit values
+    and multiplied with the widened values of matrix A using vpmaddwd, which
+    accumulates the products exactly, unlike vpmaddubsw which saturates the
+    sum of adjacent products.
+
+--*/
+
+#include "mlasi.h"
+
+template<size_t RowCount>
+inline
+void
+MlasQgemmKernelAvx2Panel(
+    const uint8_t* A,
+    const int8_t* B,
+    int32_t* C,
+    size_t PackedCountK,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumBuffer,
+    const int32_t* ColumnSumBuffer,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of RowCount rows by up to 16 columns of
+    matrix C from a single panel of the packed matrix B.
+
+Arguments:
+
+    A - Supplies the address of the packed matrix A.
+
+    B - Supplies the address of the packed panel of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    PackedCountK - Supplies the number of packed groups of 4 values along the
+        K dimension.
+
+    CountN - Supplies the number of columns to store to matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    RowSumBuffer - Supplies the zero point terms for each row of matrix C.
+
+    ColumnSumBuffer - Supplies the zero point terms for each column of
+        matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t lda = PackedCountK * 4;
+
+    //
+    // Each accumulator holds the partial sums of 4 columns, with the sums of
+    // the even and odd pairs of values along the K dimension in adjacent
+    // elements.
+    //
+
+    __m256i Accumulators[RowCount][4];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t i = 0; i < 4; i++) {
+            Accumulators[r][i] = _mm256_setzero_si256();
+        }
+    }
+
+    for (size_t k = 0; k < PackedCountK; k++) {
+
+        __m256i ABroadcast[RowCount];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            int32_t Value;
+            memcpy(&Value, A + r * lda + k * 4, sizeof(int32_t));
+            __m128i AWidened = _mm_cvtepu8_epi16(_mm_cvtsi32_si128(Value));
+            ABroadcast[r] = _mm256_broadcastq_epi64(AWidened);
+        }
+
+        for (size_t i = 0; i < 4; i++) {
+
+            __m256i BWidened = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(B + i * 16)));
+
+            for (size_t r = 0; r < RowCount; r++) {
+                Accumulators[r][i] = _mm256_add_epi32(Accumulators[r][i],
+                    _mm256_madd_epi16(ABroadcast[r], BWidened));
+            }
+        }
+
+        B += 4 * MLAS_QGEMM_PANEL_N;
+    }
+
+    //
+    // Reduce the pairs of partial sums and add the zero point terms.
+    //
+    // N.B. The column sum buffer is sized to a multiple of the panel width, so
+    // the loads beyond CountN stay inside the buffer.
+    //
+
+    __m256i ColumnSums0 = _mm256_loadu_si256((const __m256i*)&ColumnSumBuffer[0]);
+    __m256i ColumnSums1 = _mm256_loadu_si256((const __m256i*)&ColumnSumBuffer[8]);
+
+    for (size_t r = 0; r < RowCount; r++) {
+
+        __m256i RowSums = _mm256_set1_epi32(RowSumBuffer[r]);
+
+        __m256i Result0 = _mm256_hadd_epi32(Accumulators[r][0], Accumulators[r][1]);
+        __m256i Result1 = _mm256_hadd_epi32(Accumulators[r][2], Accumulators[r][3]);
+
+        Result0 = _mm256_permute4x64_epi64(Result0, 0xD8);
+        Result1 = _mm256_permute4x64_epi64(Result1, 0xD8);
+
+        Result0 = _mm256_add_epi32(Result0, _mm256_add_epi32(RowSums, ColumnSums0));
+        Result1 = _mm256_add_epi32(Result1, _mm256_add_epi32(RowSums, ColumnSums1));
+
+        int32_t* c = C + r * ldc;
+
+        if (CountN >= MLAS_QGEMM_PANEL_N) {
+
+            if (!ZeroMode) {
+                Result0 = _mm256_add_epi32(Result0, _mm256_loadu_si256((const __m256i*)&c[0]));
+                Result1 = _mm256_add_epi32(Result1, _mm256_loadu_si256((const __m256i*)&c[8]));
+            }
+
+            _mm256_storeu_si256((__m256i*)&c[0], Result0);
+            _mm256_storeu_si256((__m256i*)&c[8], Result1);
+
+        } else {
+
+            MLAS_DECLSPEC_ALIGN(int32_t Results[MLAS_QGEMM_PANEL_N], 32);
+
+            _mm256_store_si256((__m256i*)&Results[0], Result0);
+            _mm256_store_si256((__m256i*)&Results[8], Result1);
+
+            for (size_t n = 0; n < CountN; n++) {
+                c[n] = ZeroMode ? Results[n] : c[n] + Results[n];
+            }
+        }
+    }
+}
+
+template<size_t RowCount>
+void
+MlasQgemmKernelAvx2Rows(
+    const uint8_t* A,
+    const int8_t* B,
+    int32_t* C,
+    size_t PackedCountK,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumBuffer,
+    const int32_t* ColumnSumBuffer,
+    bool ZeroMode
+    )
+{
+    while (CountN > 0) {
+
+        MlasQgemmKernelAvx2Panel<RowCount>(A, B, C, PackedCountK, CountN, ldc,
+            RowSumBuffer, ColumnSumBuffer, ZeroMode);
+
+        if (CountN <= MLAS_QGEMM_PANEL_N) {
+            break;
+        }
+
+        B += PackedCountK * 4 * MLAS_QGEMM_PANEL_N;
+        C += MLAS_QGEMM_PANEL_N;
+        ColumnSumBuffer += MLAS_QGEMM_PANEL_N;
+        CountN -= MLAS_QGEMM_PANEL_N;
+    }
+}
+
+size_t
+MLASCALL
+MlasQgemmKernelAvx2(
+    const uint8_t* A,
+    const int8_t* B,
+    int32_t* C,
+    size_t PackedCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumBuffer,
+    const int32_t* ColumnSumBuffer,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    See MlasQgemmKernel.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    size_t RowsHandled;
+
+    if (CountM >= 3) {
+        MlasQgemmKernelAvx2Rows<3>(A, B, C, PackedCountK, CountN, ldc, RowSumBuffer, ColumnSumBuffer, ZeroMode);
+        RowsHandled = 3;
+    } else if (CountM >= 2) {
+        MlasQgemmKernelAvx2Rows<2>(A, B, C, PackedCountK, CountN, ldc, RowSumBuffer, ColumnSumBuffer, ZeroMode);
+        RowsHandled = 2;
+    } else {
+        MlasQgemmKernelAvx2Rows<1>(A, B, C, PackedCountK, CountN, ldc, RowSumBuffer, ColumnSumBuffer, ZeroMode);
+        RowsHandled = 1;
+    }
+
+    return RowsHandled;
+}
@@ -0,0 +1,169 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm_kernel_avx512vnni.cpp
+
+Abstract:
+
+    This module implements the kernel for the quantized integer matrix/matrix
+    multiply operation (QGEMM) using AVX512 VNNI instructions.
+
+    The vpdpbusd instruction multiplies groups of 4 unsigned 8-bit values from
+    matrix A with 4 signed 8-bit values from the packed matrix B and adds the
+    sum of the products to each 32-bit accumulator.
+
+--*/
+
+#include "mlasi.h"
+
+template<size_t RowCount>
+void
+MlasQgemmKernelAvx512VnniRows(
+    const uint8_t* A,
+    const int8_t* B,
+    int32_t* C,
+    size_t PackedCountK,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumBuffer,
+    const int32_t* ColumnSumBuffer,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of RowCount rows of matrix C, one panel of
+    16 columns of the packed matrix B at a time.
+
+Arguments:
+
+    See MlasQgemmKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t lda = PackedCountK * 4;
+
+    while (CountN > 0) {
+
+        __m512i Accumulators[RowCount];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            Accumulators[r] = _mm512_setzero_si512();
+        }
+
+        const uint8_t* a = A;
+        const int8_t* b = B;
+
+        for (size_t k = 0; k < PackedCountK; k++) {
+
+            __m512i BElements = _mm512_loadu_si512(b);
+
+            for (size_t r = 0; r < RowCount; r++) {
+                int32_t Value;
+                memcpy(&Value, a + r * lda, sizeof(int32_t));
+                Accumulators[r] = _mm512_dpbusd_epi32(Accumulators[r], _mm512_set1_epi32(Value), BElements);
+            }
+
+            a += 4;
+            b += 4 * MLAS_QGEMM_PANEL_N;
+        }
+
+        //
+        // Add the zero point terms and store the block of matrix C.
+        //
+        // N.B. The column sum buffer is sized to a multiple of the panel
+        // width, so the load beyond CountN stays inside the buffer.
+        //
+
+        __mmask16 StoreMask = 0xFFFF;
+
+        if (CountN < MLAS_QGEMM_PANEL_N) {
+            StoreMask = __mmask16((1u << CountN) - 1);
+        }
+
+        __m512i ColumnSums = _mm512_loadu_si512(ColumnSumBuffer);
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            __m512i Result = _mm512_add_epi32(Accumulators[r],
+                _mm512_add_epi32(_mm512_set1_epi32(RowSumBuffer[r]), ColumnSums));
+
+            int32_t* c = C + r * ldc;
+
+            if (!ZeroMode) {
+                Result = _mm512_add_epi32(Result, _mm512_maskz_loadu_epi32(StoreMask, c));
+            }
+
+            _mm512_mask_storeu_epi32(c, StoreMask, Result);
+        }
+
+        if (CountN <= MLAS_QGEMM_PANEL_N) {
+            break;
+        }
+
+        B += PackedCountK * 4 * MLAS_QGEMM_PANEL_N;
+        C += MLAS_QGEMM_PANEL_N;
+        ColumnSumBuffer += MLAS_QGEMM_PANEL_N;
+        CountN -= MLAS_QGEMM_PANEL_N;
+    }
+}
+
+size_t
+MLASCALL
+MlasQgemmKernelAvx512Vnni(
+    const uint8_t* A,
+    const int8_t* B,
+    int32_t* C,
+    size_t PackedCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumBuffer,
+    const int32_t* ColumnSumBuffer,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    See MlasQgemmKernel.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    size_t RowsHandled;
+
+    if (CountM >= 6) {
+        MlasQgemmKernelAvx512VnniRows<6>(A, B, C, PackedCountK, CountN, ldc, RowSumBuffer, ColumnSumBuffer, ZeroMode);
+        RowsHandled = 6;
+    } else if (CountM >= 4) {
+        MlasQgemmKernelAvx512VnniRows<4>(A, B, C, PackedCountK, CountN, ldc, RowSumBuffer, ColumnSumBuffer, ZeroMode);
+        RowsHandled = 4;
+    } else if (CountM >= 2) {
+        MlasQgemmKernelAvx512VnniRows<2>(A, B, C, PackedCountK, CountN, ldc, RowSumBuffer, ColumnSumBuffer, ZeroMode);
+        RowsHandled = 2;
+    } else {
+        MlasQgemmKernelAvx512VnniRows<1>(A, B, C, PackedCountK, CountN, ldc, RowSumBuffer, ColumnSumBuffer, ZeroMode);
+        RowsHandled = 1;
+    }
+
+    return RowsHandled;
+}
@@ -26,6 +26,13 @@ Abstract:
 
 #define MLAS_SGEMM_TRANSA_ROWS              12
 
+//
+// Define the alignment of the panels inside a packed matrix B buffer. The
+// kernels use aligned loads from the packed panels.
+//
+
+#define MLAS_SGEMM_PACKED_B_ALIGNMENT       64
+
 //
 // Define the parameters to execute segments of a SGEMM operation on worker
 // threads.
@@ -40,13 +47,22 @@ struct MLAS_SGEMM_WORK_BLOCK {
     size_t ldc;
     float alpha;
     float beta;
-    struct SEGMENT {
-        size_t M;
-        size_t N;
-        const float* A;
-        const float* B;
-        float* C;
-    } Segments[MLAS_MAXIMUM_THREAD_COUNT];
+    size_t M;
+    size_t N;
+    const float* A;
+    const float* B;
+    const float* PackedB;
+    float* C;
+    const MLAS_SGEMM_POSTPROCESS* PostProcess;
+    size_t StrideA;
+    size_t StrideB;
+    size_t StrideC;
+    size_t BatchCount;
+    size_t ThreadStrideM;
+    size_t ThreadStrideN;
+    int32_t ThreadCountM;
+    int32_t ThreadCountN;
+    int32_t ThreadCountBatch;
 };
 
 #if defined(MLAS_TARGET_AMD64_IX86)
@@ -772,6 +788,264 @@ Return Value:
     }
 }
 
+inline
+float*
+MlasSgemmAlignPackedB(
+    const void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the aligned start of a packed matrix B buffer.
+
+Arguments:
+
+    PackedB - Supplies the address of the packed buffer.
+
+Return Value:
+
+    Returns the address of the first packed panel.
+
+--*/
+{
+    return (float*)(((uintptr_t)PackedB + MLAS_SGEMM_PACKED_B_ALIGNMENT - 1) &
+        ~uintptr_t(MLAS_SGEMM_PACKED_B_ALIGNMENT - 1));
+}
+
+void
+MlasSgemmPostProcessOutput(
+    const MLAS_SGEMM_POSTPROCESS* PostProcess,
+    size_t StartN,
+    size_t M,
+    size_t N,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine adds the bias vector to a block of matrix C and then applies
+    the activation. The block has just been produced by the kernel, so it is
+    still resident in the L1 cache.
+
+Arguments:
+
+    PostProcess - Supplies the post-processing parameters.
+
+    StartN - Supplies the column of the block relative to the start of the
+        bias vector.
+
+    M - Supplies the number of rows of the block.
+
+    N - Supplies the number of columns of the block.
+
+    C - Supplies the address of the block of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (PostProcess->Bias != nullptr) {
+
+        const float* Bias = PostProcess->Bias + StartN;
+        float* c = C;
+
+        for (size_t m = 0; m < M; m++) {
+
+            size_t n = 0;
+
+            for (; n + 4 <= N; n += 4) {
+                MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(c + n);
+                MlasStoreFloat32x4(c + n, MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Bias + n)));
+            }
+
+            for (; n < N; n++) {
+                c[n] += Bias[n];
+            }
+
+            c += ldc;
+        }
+    }
+
+    if (PostProcess->Activation != nullptr) {
+        MlasActivation(PostProcess->Activation, C, nullptr, M, C, N, ldc);
+    }
+}
+
+void
+MlasSgemmMultiplyPanelB(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PanelB,
+    float* C,
+    size_t ldc,
+    bool ZeroMode,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess,
+    size_t StartN
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a slice of matrix A by a packed panel of matrix B
+    and stores or accumulates the result into a slice of matrix C.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    CountN - Supplies the number of columns of the packed panel and matrix C.
+
+    CountK - Supplies the number of columns of matrix A and the number of rows
+        of the packed panel.
+
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the slice of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PanelB - Supplies the address of the packed panel of matrix B.
+
+    C - Supplies the address of the slice of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+    PostProcess - Optionally supplies the post-processing to apply to each
+        block of rows as the kernel completes it. This is only supplied for
+        the last panel along the K dimension.
+
+    StartN - Supplies the column of the slice of matrix C relative to the
+        start of the post-processing bias vector.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
+
+    //
+    // Select the kernel routine to use for this panel.
+    //
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+    PMLAS_SGEMM_KERNEL_ROUTINE SgemmKernelRoutine =
+        ZeroMode ? MlasPlatform.KernelZeroRoutine : MlasPlatform.KernelAddRoutine;
+#endif
+
+    //
+    // Step through each slice of matrix A along the M dimension.
+    //
+
+    float* c = C;
+
+    size_t RowsRemaining = M;
+    size_t RowsHandled;
+
+    if (TransA == CblasNoTrans) {
+
+        const float* a = A;
+
+        //
+        // Step through the rows of matrix A.
+        //
+
+        do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+            RowsHandled = SgemmKernelRoutine(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+#else
+            if (ZeroMode) {
+                RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            } else {
+                RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            }
+#endif
+
+            if (PostProcess != nullptr) {
+                MlasSgemmPostProcessOutput(PostProcess, StartN, RowsHandled, CountN, c, ldc);
+            }
+
+            c += ldc * RowsHandled;
+            a += lda * RowsHandled;
+
+            RowsRemaining -= RowsHandled;
+
+        } while (RowsRemaining > 0);
+
+    } else {
+
+        const float* a = A;
+
+        do {
+
+            //
+            // Transpose elements from matrix A into a local buffer.
+            //
+
+            size_t RowsTransposed = RowsRemaining;
+
+            if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
+                RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
+            }
+
+            RowsRemaining -= RowsTransposed;
+
+            MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+
+            a += RowsTransposed;
+
+            //
+            // Step through the rows of the local buffer.
+            //
+
+            const float* pa = PanelA;
+
+            do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+                RowsHandled = SgemmKernelRoutine(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+#else
+                if (ZeroMode) {
+                    RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                } else {
+                    RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                }
+#endif
+
+                if (PostProcess != nullptr) {
+                    MlasSgemmPostProcessOutput(PostProcess, StartN, RowsHandled, CountN, c, ldc);
+                }
+
+                c += ldc * RowsHandled;
+                pa += CountK * RowsHandled;
+
+                RowsTransposed -= RowsHandled;
+
+            } while (RowsTransposed > 0);
+
+        } while (RowsRemaining > 0);
+    }
+}
+
 void
 MlasSgemmOperation(
     CBLAS_TRANSPOSE TransA,
@@ -786,7 +1060,8 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess
     )
 /*++
 
@@ -824,13 +1099,15 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    PostProcess - Optionally supplies the bias and activation to apply to
+        matrix C as its blocks are completed.
+
 Return Value:
 
     None.
 
 --*/
 {
-    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
     MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
 
     //
@@ -852,7 +1129,13 @@ Return Value:
         }
 
         if (SgemmKernelM1Routine != nullptr) {
+
             SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+
+            if (PostProcess != nullptr) {
+                MlasSgemmPostProcessOutput(PostProcess, 0, 1, N, C, ldc);
+            }
+
             return;
         }
 
@@ -932,101 +1215,137 @@ Return Value:
             }
 
             //
-            // Select the kernel routine to use for this panel.
+            // Multiply the slice of matrix A by the packed panel.
             //
 
-            bool UseKernelZeroRoutine = (k == 0 && beta == 0.0f);
+            const float* a = (TransA == CblasNoTrans) ? A + k : A + k * lda;
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-            PMLAS_SGEMM_KERNEL_ROUTINE SgemmKernelRoutine =
-                UseKernelZeroRoutine ? MlasPlatform.KernelZeroRoutine : MlasPlatform.KernelAddRoutine;
-#endif
+            MlasSgemmMultiplyPanelB(TransA, M, CountN, CountK, alpha, a, lda, PanelB,
+                C + n, ldc, k == 0 && beta == 0.0f,
+                (k + CountK == K) ? PostProcess : nullptr, n);
+        }
+    }
+}
 
-            //
-            // Step through each slice of matrix A along the M dimension.
-            //
+void
+MlasSgemmPackedOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t AlignedN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess
+    )
+/*++
 
-            float* c = C + n;
+Routine Description:
 
-            size_t RowsRemaining = M;
-            size_t RowsHandled;
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) using a matrix B that was packed by MlasSgemmPackB.
 
-            if (TransA == CblasNoTrans) {
+Arguments:
 
-                const float* a = A + k;
+    TransA - Supplies the transpose operation for matrix A.
 
-                //
-                // Step through the rows of matrix A.
-                //
+    M - Supplies the number of rows of matrix A and matrix C.
 
-                do {
+    RangeStartN - Supplies the starting column of the packed matrix B. This
+        must be a multiple of 16.
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                    RowsHandled = SgemmKernelRoutine(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-#else
-                    if (UseKernelZeroRoutine) {
-                        RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    } else {
-                        RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    }
-#endif
+    RangeCountN - Supplies the number of columns of the packed matrix B and
+        matrix C to compute.
+
+    AlignedN - Supplies the number of columns of the packed matrix B rounded
+        up to a multiple of 16.
 
-                    c += ldc * RowsHandled;
-                    a += lda * RowsHandled;
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
 
-                    RowsRemaining -= RowsHandled;
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
 
-                } while (RowsRemaining > 0);
+    A - Supplies the address of matrix A.
 
-            } else {
+    lda - Supplies the first dimension of matrix A.
 
-                const float* a = A + k * lda;
+    PackedB - Supplies the address of the packed matrix B.
 
-                do {
+    beta - Supplies the scaler beta multiplier (see SGEMM definition).
 
-                    //
-                    // Transpose elements from matrix A into a local buffer.
-                    //
+    C - Supplies the address of matrix C for column RangeStartN.
 
-                    size_t RowsTransposed = RowsRemaining;
+    ldc - Supplies the first dimension of matrix C.
 
-                    if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
-                        RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
-                    }
+    PostProcess - Optionally supplies the bias and activation to apply to
+        matrix C as its blocks are completed. The bias vector is addressed
+        relative to column RangeStartN.
 
-                    RowsRemaining -= RowsTransposed;
+Return Value:
 
-                    MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+    None.
 
-                    a += RowsTransposed;
+--*/
+{
+    //
+    // The packed buffer was built with a fixed K stride, so expand the N
+    // stride instead if K is small for better utilization of the B panel.
+    //
 
-                    //
-                    // Step through the rows of the local buffer.
-                    //
+    size_t StrideN = MLAS_SGEMM_STRIDEN;
 
-                    const float* pa = PanelA;
+    for (size_t StrideK = MLAS_SGEMM_STRIDEK; StrideK / 2 >= K; StrideK /= 2) {
+        StrideN *= 2;
+    }
 
-                    do {
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                        RowsHandled = SgemmKernelRoutine(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-#else
-                        if (UseKernelZeroRoutine) {
-                            RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        } else {
-                            RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        }
-#endif
+    size_t CountN;
+    size_t CountK;
+
+    for (size_t n = 0; n < RangeCountN; n += CountN) {
+
+        CountN = StrideN;
+
+        if (CountN > (RangeCountN - n)) {
+            CountN = RangeCountN - n;
+        }
+
+        //
+        // Multiply the output matrix by beta as needed.
+        //
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
 
-                        c += ldc * RowsHandled;
-                        pa += CountK * RowsHandled;
+        //
+        // Step through each slice of matrix B along the K dimension. The
+        // panels are already packed, so no copy is needed.
+        //
 
-                        RowsTransposed -= RowsHandled;
+        for (size_t k = 0; k < K; k += CountK) {
 
-                    } while (RowsTransposed > 0);
+            CountK = MLAS_SGEMM_STRIDEK;
 
-                } while (RowsRemaining > 0);
+            if (CountK > (K - k)) {
+                CountK = K - k;
             }
+
+            const float* PanelB = PackedB + AlignedN * k + CountK * (RangeStartN + n);
+            const float* a = (TransA == CblasNoTrans) ? A + k : A + k * lda;
+
+            MlasSgemmMultiplyPanelB(TransA, M, CountN, CountK, alpha, a, lda, PanelB,
+                C + n, ldc, k == 0 && beta == 0.0f,
+                (k + CountK == K) ? PostProcess : nullptr, n);
         }
     }
 }
@@ -1055,24 +1374,206 @@ Return Value:
 
 --*/
 {
-    MLAS_SGEMM_WORK_BLOCK* WorkBlock = (MLAS_SGEMM_WORK_BLOCK*)Context;
+    const MLAS_SGEMM_WORK_BLOCK* WorkBlock = (MLAS_SGEMM_WORK_BLOCK*)Context;
 
-    MLAS_SGEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+    //
+    // Compute the range of batches and the segment of each matrix C that is
+    // owned by this thread.
+    //
 
-    MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
-        Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
-        Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
-        WorkBlock->ldc);
-}
+    const int32_t ThreadCountMN = WorkBlock->ThreadCountM * WorkBlock->ThreadCountN;
+    const int32_t SegmentIndex = Index % ThreadCountMN;
 
-inline
-bool
-MlasSgemmTryMultithread(
-    CBLAS_TRANSPOSE TransA,
-    CBLAS_TRANSPOSE TransB,
-    size_t M,
-    size_t N,
-    size_t K,
+    size_t BatchIndex;
+    size_t BatchRemaining;
+
+    MlasPartitionWork(Index / ThreadCountMN, WorkBlock->ThreadCountBatch,
+        WorkBlock->BatchCount, &BatchIndex, &BatchRemaining);
+
+    const size_t m = size_t(SegmentIndex / WorkBlock->ThreadCountN) * WorkBlock->ThreadStrideM;
+    const size_t n = size_t(SegmentIndex % WorkBlock->ThreadCountN) * WorkBlock->ThreadStrideN;
+
+    const size_t CountM = std::min(WorkBlock->M - m, WorkBlock->ThreadStrideM);
+    const size_t CountN = std::min(WorkBlock->N - n, WorkBlock->ThreadStrideN);
+
+    const size_t plda = (WorkBlock->TransA == CblasNoTrans) ? WorkBlock->lda : 1;
+    const size_t pldb = (WorkBlock->TransB == CblasNoTrans) ? 1 : WorkBlock->ldb;
+
+    //
+    // The bias vector is indexed by the column of matrix C, so advance it to
+    // the start of this segment.
+    //
+
+    MLAS_SGEMM_POSTPROCESS SegmentPostProcess;
+    const MLAS_SGEMM_POSTPROCESS* PostProcess = nullptr;
+
+    if (WorkBlock->PostProcess != nullptr) {
+
+        SegmentPostProcess = *WorkBlock->PostProcess;
+
+        if (SegmentPostProcess.Bias != nullptr) {
+            SegmentPostProcess.Bias += n;
+        }
+
+        PostProcess = &SegmentPostProcess;
+    }
+
+    for (; BatchRemaining > 0; BatchRemaining--, BatchIndex++) {
+
+        const float* A = WorkBlock->A + BatchIndex * WorkBlock->StrideA + m * plda;
+        float* C = WorkBlock->C + BatchIndex * WorkBlock->StrideC + m * WorkBlock->ldc + n;
+
+        //
+        // The segments of a packed matrix B are addressed by column, so pass
+        // the starting column instead of adjusting the matrix B pointer. A
+        // packed matrix B is shared by every batch.
+        //
+
+        if (WorkBlock->PackedB != nullptr) {
+
+            const size_t AlignedN = (WorkBlock->N + 15) & ~size_t(15);
+
+            MlasSgemmPackedOperation(WorkBlock->TransA, CountM, n, CountN, AlignedN,
+                WorkBlock->K, WorkBlock->alpha, A, WorkBlock->lda, WorkBlock->PackedB,
+                WorkBlock->beta, C, WorkBlock->ldc, PostProcess);
+
+            continue;
+        }
+
+        const float* B = WorkBlock->B + BatchIndex * WorkBlock->StrideB + n * pldb;
+
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, CountM, CountN,
+            WorkBlock->K, WorkBlock->alpha, A, WorkBlock->lda, B, WorkBlock->ldb,
+            WorkBlock->beta, C, WorkBlock->ldc, PostProcess);
+    }
+}
+
+inline
+bool
+MlasSgemmTryMultithread(
+    MLAS_SGEMM_WORK_BLOCK* WorkBlock,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine attempts to launch a single precision matrix/matrix multiply
+    operation (SGEMM) across multiple threads.
+
+Arguments:
+
+    WorkBlock - Supplies the work block with the common fields of the SGEMM
+        operation initialized. The fields that segment the operation across
+        threads are initialized by this routine.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        operation should execute on the calling thread.
+
+Return Value:
+
+    Returns true if the operation was completed across multiple threads, else
+    false if the operation should fall back to a single thread.
+
+--*/
+{
+    const size_t M = WorkBlock->M;
+    const size_t N = WorkBlock->N;
+    const size_t K = WorkBlock->K;
+    const size_t BatchCount = WorkBlock->BatchCount;
+
+    int32_t TargetThreadCount;
+
+    //
+    // Compute the number of target threads given the complexity of the SGEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    double Complexity = double(M) * double(N) * double(K) * double(BatchCount);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY) * double(MaximumThreadCount)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+        return false;
+    }
+
+    //
+    // Distribute the batches across the target threads first. If there are
+    // more target threads than batches, then segment each operation across
+    // the remaining threads by slicing the larger of the M or N dimensions.
+    // The threaded routine computes its own segment from the thread index, so
+    // the number of segments is not limited by any fixed size structure.
+    //
+
+    int32_t ThreadsPerOperation;
+
+    if (BatchCount >= size_t(TargetThreadCount)) {
+        WorkBlock->ThreadCountBatch = TargetThreadCount;
+        ThreadsPerOperation = 1;
+    } else {
+        WorkBlock->ThreadCountBatch = int32_t(BatchCount);
+        ThreadsPerOperation = TargetThreadCount / int32_t(BatchCount);
+    }
+
+    if (ThreadsPerOperation == 1) {
+
+        WorkBlock->ThreadStrideM = M;
+        WorkBlock->ThreadStrideN = N;
+        WorkBlock->ThreadCountM = 1;
+        WorkBlock->ThreadCountN = 1;
+
+    } else if (N > M) {
+
+        size_t StrideN = N / ThreadsPerOperation;
+
+        if ((StrideN * ThreadsPerOperation) != N) {
+            StrideN++;
+        }
+
+        StrideN =
+            (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+        WorkBlock->ThreadStrideM = M;
+        WorkBlock->ThreadStrideN = StrideN;
+        WorkBlock->ThreadCountM = 1;
+        WorkBlock->ThreadCountN = int32_t((N + StrideN - 1) / StrideN);
+
+    } else {
+
+        size_t StrideM = M / ThreadsPerOperation;
+
+        if ((StrideM * ThreadsPerOperation) != M) {
+            StrideM++;
+        }
+
+        WorkBlock->ThreadStrideM = StrideM;
+        WorkBlock->ThreadStrideN = N;
+        WorkBlock->ThreadCountM = int32_t((M + StrideM - 1) / StrideM);
+        WorkBlock->ThreadCountN = 1;
+    }
+
+    int32_t ThreadCount = WorkBlock->ThreadCountBatch *
+        WorkBlock->ThreadCountM * WorkBlock->ThreadCountN;
+
+    MlasExecuteThreaded(MlasSgemmOperationThreaded, WorkBlock, ThreadCount, ThreadPool);
+
+    return true;
+}
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
     float alpha,
     const float* A,
     size_t lda,
@@ -1080,14 +1581,16 @@ MlasSgemmTryMultithread(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess,
+    MLAS_THREADPOOL* ThreadPool
     )
 /*++
 
 Routine Description:
 
-    This routine attempts to launch a single precision matrix/matrix multiply
-    operation (SGEMM) across multiple threads.
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM).
 
 Arguments:
 
@@ -1118,179 +1621,299 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    PostProcess - Optionally supplies a bias vector to add to each row of
+        matrix C and an activation to apply. These are applied to each block
+        of matrix C as it is completed, while the block is still in cache.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        operation should execute on the calling thread.
+
 Return Value:
 
-    Returns true if the operation was completed across multiple threads, else
-    false if the operation should fall back to a single thread.
+    None.
 
 --*/
 {
-
-#if defined(MLAS_HAS_THREADING_SUPPORT)
-
-    MLAS_SGEMM_WORK_BLOCK WorkBlock;
-    int32_t TargetThreadCount;
-
     //
-    // Compute the number of target threads given the complexity of the SGEMM
-    // operation. Small requests should run using the single threaded path.
+    // Try to run the operation across multiple threads or fall back to a
+    // single thread based on the GEMM parameters and system configuration.
     //
 
-    double Complexity = double(M) * double(N) * double(K);
+    MLAS_SGEMM_WORK_BLOCK WorkBlock;
 
-    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
-        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
-    } else {
-        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = TransB;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.B = B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.PackedB = nullptr;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.alpha = alpha;
+    WorkBlock.beta = beta;
+    WorkBlock.PostProcess = PostProcess;
+    WorkBlock.StrideA = 0;
+    WorkBlock.StrideB = 0;
+    WorkBlock.StrideC = 0;
+    WorkBlock.BatchCount = 1;
+
+    if (!MlasSgemmTryMultithread(&WorkBlock, ThreadPool)) {
+        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc,
+            PostProcess);
     }
+}
 
-    int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+void
+MLASCALL
+MlasSgemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    size_t StrideA,
+    const float* B,
+    size_t ldb,
+    size_t StrideB,
+    float beta,
+    float* C,
+    size_t ldc,
+    size_t StrideC,
+    size_t BatchCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
 
-    if (TargetThreadCount >= MaximumThreadCount) {
-        TargetThreadCount = MaximumThreadCount;
-    }
+Routine Description:
 
-    if (TargetThreadCount == 1) {
-        return false;
+    This routine implements a batch of single precision matrix/matrix multiply
+    operations (SGEMM) where the matrices of each batch are separated by a
+    fixed stride.
+
+    The batch is scheduled as a single threaded operation, so small matrices
+    are distributed across threads by batch and large matrices are also
+    segmented along the M or N dimensions.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the first matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    StrideA - Supplies the number of elements between each matrix A. A stride
+        of zero shares the same matrix A with every batch.
+
+    B - Supplies the address of the first matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    StrideB - Supplies the number of elements between each matrix B. A stride
+        of zero shares the same matrix B with every batch.
+
+    beta - Supplies the scaler beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of the first matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    StrideC - Supplies the number of elements between each matrix C.
+
+    BatchCount - Supplies the number of matrix multiply operations.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        operation should execute on the calling thread.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (BatchCount == 0) {
+        return;
     }
 
-    //
-    // Initialize the common fields of the work block.
-    //
+    MLAS_SGEMM_WORK_BLOCK WorkBlock;
 
     WorkBlock.TransA = TransA;
     WorkBlock.TransB = TransB;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
     WorkBlock.K = K;
+    WorkBlock.A = A;
     WorkBlock.lda = lda;
+    WorkBlock.B = B;
     WorkBlock.ldb = ldb;
+    WorkBlock.PackedB = nullptr;
+    WorkBlock.C = C;
     WorkBlock.ldc = ldc;
     WorkBlock.alpha = alpha;
     WorkBlock.beta = beta;
+    WorkBlock.PostProcess = nullptr;
+    WorkBlock.StrideA = StrideA;
+    WorkBlock.StrideB = StrideB;
+    WorkBlock.StrideC = StrideC;
+    WorkBlock.BatchCount = BatchCount;
 
-    //
-    // Segment the operation across multiple threads.
-    //
+    if (!MlasSgemmTryMultithread(&WorkBlock, ThreadPool)) {
 
-    int32_t Index = 0;
+        for (size_t batch = 0; batch < BatchCount; batch++) {
+            MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A + batch * StrideA,
+                lda, B + batch * StrideB, ldb, beta, C + batch * StrideC, ldc, nullptr);
+        }
+    }
+}
 
-    if (N > M) {
+size_t
+MLASCALL
+MlasSgemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
 
-        size_t StrideN = N / TargetThreadCount;
+Routine Description:
 
-        if ((StrideN * TargetThreadCount) != N) {
-            StrideN++;
-        }
+    This routine computes the size in bytes of the buffer required to pack
+    matrix B with MlasSgemmPackB.
 
-        StrideN =
-            (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+Arguments:
 
-        size_t pldb = (TransB == CblasNoTrans) ? 1 : ldb;
+    N - Supplies the number of columns of matrix B.
 
-        for (size_t CountN, n = 0; n < N; n += CountN) {
+    K - Supplies the number of rows of matrix B.
 
-            CountN = StrideN;
+Return Value:
 
-            if (CountN > (N - n)) {
-                CountN = N - n;
-            }
+    Returns the size in bytes of the packed buffer.
 
-            WorkBlock.Segments[Index].M = M;
-            WorkBlock.Segments[Index].N = CountN;
-            WorkBlock.Segments[Index].A = A;
-            WorkBlock.Segments[Index].B = B + n * pldb;
-            WorkBlock.Segments[Index].C = C + n;
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
 
-            Index++;
-        }
+    //
+    // Include space to align the start of the buffer, so the caller doesn't
+    // need to allocate an aligned buffer.
+    //
 
-    } else {
+    return AlignedN * K * sizeof(float) + MLAS_SGEMM_PACKED_B_ALIGNMENT;
+}
 
-        size_t StrideM = M / TargetThreadCount;
+void
+MLASCALL
+MlasSgemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
 
-        if ((StrideM * TargetThreadCount) != M) {
-            StrideM++;
-        }
+Routine Description:
 
-        size_t plda = (TransA == CblasNoTrans) ? lda : 1;
+    This routine packs matrix B into the layout used by the SGEMM kernels, so
+    that a matrix B that is used by many SGEMM operations, such as a weight
+    matrix, is only packed once.
 
-        for (size_t CountM, m = 0; m < M; m += CountM) {
+    The matrix is packed in slices of MLAS_SGEMM_STRIDEK rows. Each slice
+    holds the columns of matrix B in blocks of 16 columns, with the last
+    block zero-padded.
 
-            CountM = StrideM;
+Arguments:
 
-            if (CountM > (M - m)) {
-                CountM = M - m;
-            }
+    TransB - Supplies the transpose operation for matrix B.
 
-            WorkBlock.Segments[Index].M = CountM;
-            WorkBlock.Segments[Index].N = N;
-            WorkBlock.Segments[Index].A = A + m * plda;
-            WorkBlock.Segments[Index].B = B;
-            WorkBlock.Segments[Index].C = C + m * ldc;
+    N - Supplies the number of columns of matrix B.
 
-            Index++;
-        }
-    }
+    K - Supplies the number of rows of matrix B.
 
-    MlasExecuteThreaded(MlasSgemmOperationThreaded, &WorkBlock, Index);
+    B - Supplies the address of matrix B.
 
-    return true;
+    ldb - Supplies the first dimension of matrix B.
 
-#else
+    PackedB - Supplies the address of the packed buffer. The buffer must be
+        at least MlasSgemmPackBSize bytes.
 
-    //
-    // No threading implementation is available.
-    //
+Return Value:
 
-    MLAS_UNREFERENCED_PARAMETER(TransA);
-    MLAS_UNREFERENCED_PARAMETER(TransB);
-    MLAS_UNREFERENCED_PARAMETER(M);
-    MLAS_UNREFERENCED_PARAMETER(N);
-    MLAS_UNREFERENCED_PARAMETER(K);
-    MLAS_UNREFERENCED_PARAMETER(alpha);
-    MLAS_UNREFERENCED_PARAMETER(A);
-    MLAS_UNREFERENCED_PARAMETER(lda);
-    MLAS_UNREFERENCED_PARAMETER(B);
-    MLAS_UNREFERENCED_PARAMETER(ldb);
-    MLAS_UNREFERENCED_PARAMETER(beta);
-    MLAS_UNREFERENCED_PARAMETER(C);
-    MLAS_UNREFERENCED_PARAMETER(ldc);
-
-    return false;
+    None.
 
-#endif
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
 
+    float* D = MlasSgemmAlignPackedB(PackedB);
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = MLAS_SGEMM_STRIDEK;
+
+        if (CountK > (K - k)) {
+            CountK = K - k;
+        }
+
+        if (TransB == CblasNoTrans) {
+            MlasSgemmCopyPackB(D, B + k * ldb, ldb, N, CountK);
+        } else {
+            MlasSgemmTransposePackB(D, B + k, ldb, N, CountK);
+        }
+
+        D += AlignedN * CountK;
+    }
 }
 
 void
 MLASCALL
 MlasSgemm(
     CBLAS_TRANSPOSE TransA,
-    CBLAS_TRANSPOSE TransB,
     size_t M,
     size_t N,
     size_t K,
     float alpha,
     const float* A,
     size_t lda,
-    const float* B,
-    size_t ldb,
+    const void* PackedB,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess,
+    MLAS_THREADPOOL* ThreadPool
     )
 /*++
 
 Routine Description:
 
     This routine implements the single precision matrix/matrix multiply
-    operation (SGEMM).
+    operation (SGEMM) using a matrix B that was packed by MlasSgemmPackB.
 
 Arguments:
 
     TransA - Supplies the transpose operation for matrix A.
 
-    TransB - Supplies the transpose operation for matrix B.
-
     M - Supplies the number of rows of matrix A and matrix C.
 
     N - Supplies the number of columns of matrix B and matrix C.
@@ -1304,9 +1927,7 @@ Arguments:
 
     lda - Supplies the first dimension of matrix A.
 
-    B - Supplies the address of matrix B.
-
-    ldb - Supplies the first dimension of matrix B.
+    PackedB - Supplies the address of the packed matrix B.
 
     beta - Supplies the scaler beta multiplier (see SGEMM definition).
 
@@ -1314,18 +1935,44 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    PostProcess - Optionally supplies a bias vector to add to each row of
+        matrix C and an activation to apply. These are applied to each block
+        of matrix C as it is completed, while the block is still in cache.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        operation should execute on the calling thread.
+
 Return Value:
 
     None.
 
 --*/
 {
-    //
-    // Try to run the operation across multiple threads or fall back to a
-    // single thread based on the GEMM parameters and system configuration.
-    //
+    MLAS_SGEMM_WORK_BLOCK WorkBlock;
 
-    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc)) {
-        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = CblasNoTrans;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.B = nullptr;
+    WorkBlock.ldb = 0;
+    WorkBlock.PackedB = MlasSgemmAlignPackedB(PackedB);
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.alpha = alpha;
+    WorkBlock.beta = beta;
+    WorkBlock.PostProcess = PostProcess;
+    WorkBlock.StrideA = 0;
+    WorkBlock.StrideB = 0;
+    WorkBlock.StrideC = 0;
+    WorkBlock.BatchCount = 1;
+
+    if (!MlasSgemmTryMultithread(&WorkBlock, ThreadPool)) {
+        const size_t AlignedN = (N + 15) & ~size_t(15);
+        MlasSgemmPackedOperation(TransA, M, 0, N, AlignedN, K, alpha, A, lda,
+            WorkBlock.PackedB, beta, C, ldc, PostProcess);
     }
 }
@@ -16,124 +16,100 @@ Abstract:
 
 #include "mlasi.h"
 
-#if defined(MLAS_USE_WIN32_THREADPOOL)
+#include "core/common/threadpool.h"
 
-//
-// Define the parameters to execute threaded work using the Windows thread pool
-// library.
-//
-
-struct MLAS_THREADED_WORK_BLOCK {
-    volatile LONG Counter;
-    PMLAS_THREADED_ROUTINE ThreadedRoutine;
-    void* Context;
-};
-
-void
-CALLBACK
-MlasThreadedWorkCallback(
-    PTP_CALLBACK_INSTANCE Instance,
-    void* Context,
-    PTP_WORK WorkObject
+int32_t
+MlasGetMaximumThreadCount(
+    MLAS_THREADPOOL* ThreadPool
     )
 /*++
 
 Routine Description:
 
-    This routine is invoked from a worker thread to execute one iteration of a
-    batch of threaded work.
+    This routine returns the maximum number of threads that can participate in
+    an operation that is executed with the supplied thread pool.
 
 Arguments:
 
-    Instance - Supplies the callback instance object.
-
-    Context - Supplies the pointer to the parameters for the operation.
-
-    WorkObject - Supplies the threadpool work object.
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        operation is executed on the calling thread.
 
 Return Value:
 
-    None.
+    The maximum number of threads, including the calling thread.
 
 --*/
 {
-    MLAS_UNREFERENCED_PARAMETER(Instance);
-    MLAS_UNREFERENCED_PARAMETER(WorkObject);
-
-    MLAS_THREADED_WORK_BLOCK* WorkBlock = (MLAS_THREADED_WORK_BLOCK*)Context;
+    if (ThreadPool == nullptr) {
+        return 1;
+    }
 
-    LONG Index = InterlockedIncrement(&WorkBlock->Counter) - 1;
+    //
+    // The calling thread participates in the threaded work, so add one to the
+    // number of worker threads.
+    //
 
-    WorkBlock->ThreadedRoutine(WorkBlock->Context, Index);
+    return int32_t(ThreadPool->NumThreads()) + 1;
 }
 
-#endif
-
 void
 MlasExecuteThreaded(
-    MLAS_THREADED_ROUTINE ThreadedRoutine,
+    PMLAS_THREADED_ROUTINE ThreadedRoutine,
     void* Context,
-    int32_t Iterations
+    int32_t Iterations,
+    MLAS_THREADPOOL* ThreadPool
     )
-{
-    //
-    // Execute the routine directly if only one iteration is specified.
-    //
+/*++
 
-    if (Iterations == 1) {
-        ThreadedRoutine(Context, 0);
-        return;
-    }
+Routine Description:
 
-#if defined(MLAS_USE_WIN32_THREADPOOL)
+    This routine executes the threaded routine for the specified number of
+    iterations, distributing the iterations across the workers of the supplied
+    thread pool and the calling thread.
 
-    //
-    // Schedule the threaded iterations using a work object.
-    //
+Arguments:
 
-    MLAS_THREADED_WORK_BLOCK WorkBlock;
+    ThreadedRoutine - Supplies the routine to execute for each iteration.
 
-    PTP_WORK WorkObject = CreateThreadpoolWork(MlasThreadedWorkCallback, &WorkBlock, nullptr);
+    Context - Supplies the context to pass to the threaded routine.
 
-    if (WorkObject != nullptr) {
+    Iterations - Supplies the number of iterations to execute.
 
-        WorkBlock.Counter = 0;
-        WorkBlock.ThreadedRoutine = ThreadedRoutine;
-        WorkBlock.Context = Context;
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        iterations are executed serially on the calling thread.
 
-        for (int32_t tid = 1; tid < Iterations; tid++) {
-            SubmitThreadpoolWork(WorkObject);
-        }
+Return Value:
 
-        //
-        // Execute the remaining iteration on this thread.
-        //
+    None.
+
+--*/
+{
+    //
+    // Execute the routine directly if only one iteration is specified or if
+    // no thread pool is available.
+    //
 
-        ThreadedRoutine(Context, Iterations - 1);
+    if (Iterations == 1) {
+        ThreadedRoutine(Context, 0);
+        return;
+    }
 
-        //
-        // Wait for the work object callbacks to complete.
-        //
+    if (ThreadPool == nullptr) {
 
-        WaitForThreadpoolWorkCallbacks(WorkObject, FALSE);
-        CloseThreadpoolWork(WorkObject);
+        for (int32_t tid = 0; tid < Iterations; tid++) {
+            ThreadedRoutine(Context, tid);
+        }
 
         return;
     }
 
     //
-    // Fallback to a serialized implementation.
+    // Schedule the threaded iterations using the thread pool object. The
+    // calling thread takes part in the work and returns once all of the
+    // iterations have completed.
     //
 
-#endif
-
-    //
-    // Execute the routine for the specified number of iterations.
-    //
-#if defined(_OPENMP)
-#pragma omp parallel for
-#endif
-    for (int32_t tid = 0; tid < Iterations; tid++) {
+    ThreadPool->ParallelFor(Iterations, [&](int32_t tid) {
         ThreadedRoutine(Context, tid);
-    }
+    });
 }
@@ -0,0 +1,180 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/constant_folding.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "core/common/logging/logging.h"
+#include "core/framework/op_kernel.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/optimizer_execution_frame.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// ops that must not be evaluated once as each run produces different outputs
+static const std::unordered_set<std::string> excluded_op_types = {
+    "RandomNormal", "RandomNormalLike", "RandomUniform", "RandomUniformLike", "Multinomial"};
+
+// create the output of a Shape node if the shape of its input is fully known
+static bool FoldShape(const Node& node, std::vector<TensorProto>& outputs) {
+  const auto* shape = node.InputDefs()[0]->Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+
+  TensorProto tensor_proto;
+  tensor_proto.set_name(node.OutputDefs()[0]->Name());
+  tensor_proto.set_data_type(TensorProto_DataType_INT64);
+  tensor_proto.add_dims(shape->dim_size());
+  for (const auto& dim : shape->dim()) {
+    if (!dim.has_dim_value()) {
+      return false;
+    }
+
+    tensor_proto.add_int64_data(dim.dim_value());
+  }
+
+  outputs.push_back(std::move(tensor_proto));
+  return true;
+}
+
+// an initializer that is also a graph input can be overridden by a feed, so only the others are constant
+static bool IsConstantInitializer(const Graph& graph, const NodeArg& arg) {
+  const TensorProto* initializer = nullptr;
+  if (!graph.GetInitializedTensor(arg.Name(), initializer)) {
+    return false;
+  }
+
+  const auto& graph_inputs = graph.GetInputsIncludingInitializers();
+  return std::find(graph_inputs.cbegin(), graph_inputs.cend(), &arg) == graph_inputs.cend();
+}
+
+// evaluate node with the kernel of execution_provider if all its inputs are constant initializers.
+// outputs is empty if the node can't be evaluated.
+static Status EvaluateNode(const Graph& graph, const Node& node, const IExecutionProvider& execution_provider,
+                           std::vector<TensorProto>& outputs) {
+  for (const auto* input_def : node.InputDefs()) {
+    if (input_def->Exists() && !IsConstantInitializer(graph, *input_def)) {
+      return Status::OK();
+    }
+  }
+
+  OptimizerExecutionFrame::Info info({&node}, graph.GetAllInitializedTensors(), execution_provider);
+  const OpKernel* kernel = info.GetKernel(node.Index());
+  if (kernel == nullptr) {
+    // no CPU kernel for the node
+    return Status::OK();
+  }
+
+  std::vector<int> fetch_mlvalue_idxs;
+  for (const auto* output_def : node.OutputDefs()) {
+    if (output_def->Exists()) {
+      fetch_mlvalue_idxs.push_back(info.GetMLValueIndex(output_def->Name()));
+    }
+  }
+
+  OptimizerExecutionFrame frame(info, fetch_mlvalue_idxs);
+  OpKernelContext op_kernel_context(&frame, kernel, nullptr, logging::LoggingManager::DefaultLogger());
+  ORT_RETURN_IF_ERROR(kernel->Compute(&op_kernel_context));
+
+  std::vector<MLValue> fetches;
+  ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
+
+  size_t fetch_idx = 0;
+  for (const auto* output_def : node.OutputDefs()) {
+    if (!output_def->Exists()) {
+      continue;
+    }
+
+    const MLValue& mlvalue = fetches[fetch_idx++];
+    if (!mlvalue.IsTensor()) {
+      outputs.clear();
+      return Status::OK();
+    }
+
+    auto tensor_proto = utils::TensorToTensorProto(mlvalue.Get<Tensor>(), output_def->Name());
+    if (tensor_proto.data_type() == TensorProto_DataType_UNDEFINED) {
+      outputs.clear();
+      return Status::OK();
+    }
+
+    outputs.push_back(std::move(tensor_proto));
+  }
+
+  return Status::OK();
+}
+
+// the outputs of node are used in the subgraph of a control flow node, which refers to them as outer scope values
+static bool ConsumedBySubgraph(const Node& node) {
+  for (auto it = node.OutputNodesBegin(), end = node.OutputNodesEnd(); it != end; ++it) {
+    if (!(*it).ImplicitInputDefs().empty()) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  // the constant nodes are evaluated with the CPU kernels
+  CPUExecutionProvider cpu_execution_provider{CPUExecutionProviderInfo()};
+
+  for (NodeIndex i : order) {
+    auto* node = graph.GetNode(i);
+    if (!node) {
+      continue;
+    }
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level));
+
+    if (excluded_op_types.find(node->OpType()) != excluded_op_types.cend() ||
+        !node->GetAttributeNameToMutableSubgraphMap().empty() ||
+        graph.IsNodeOutputsInGraphOutputs(*node) ||
+        ConsumedBySubgraph(*node)) {
+      continue;
+    }
+
+    std::vector<TensorProto> outputs;
+    if (utils::IsSupportedOptypeVersionAndDomain(*node, "Shape", 1)) {
+      FoldShape(*node, outputs);
+    } else {
+      // leave the node to report the failure at run time instead of failing the session initialization
+      auto status = EvaluateNode(graph, *node, cpu_execution_provider, outputs);
+      if (!status.IsOK()) {
+        LOGS_DEFAULT(VERBOSE) << "Could not fold node " << node->Name() << ": " << status.ErrorMessage();
+        outputs.clear();
+      }
+    }
+
+    if (outputs.empty()) {
+      continue;
+    }
+
+    // the consumers of the node read the outputs from the initializers with the same names instead
+    std::vector<Node::EdgeEnd> output_edges{node->OutputEdgesBegin(), node->OutputEdgesEnd()};
+    for (const auto& output_edge : output_edges) {
+      graph.RemoveEdge(node->Index(), output_edge.GetNode().Index(),
+                       output_edge.GetSrcArgIndex(), output_edge.GetDstArgIndex());
+    }
+
+    graph.RemoveNode(node->Index());
+
+    for (const auto& tensor_proto : outputs) {
+      graph.AddInitializedTensor(tensor_proto);
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
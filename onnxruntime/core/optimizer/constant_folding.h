@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class ConstantFolding
+
+Transformer that evaluates the nodes whose inputs are all constant initializers, using the CPU kernels, and replaces
+them with initializers holding their outputs. Shape nodes are replaced if the shape of their input is fully known.
+Non-deterministic ops such as RandomNormal are not folded.
+Initializers that are also graph inputs can be overridden by feeds at runtime, so they are not constant and the nodes
+consuming them are not folded.
+*/
+class ConstantFolding : public GraphTransformer {
+ public:
+  ConstantFolding() noexcept
+      : GraphTransformer("ConstantFolding", "Replace nodes whose inputs are constant with initializers") {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,290 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/elementwise_fusion.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+class ElementwiseFusionImpl {
+ public:
+  explicit ElementwiseFusionImpl(Graph& graph) noexcept : graph_(graph) {}
+
+  void Fuse(Node& root, bool& modified);
+
+ private:
+  bool IsFusableNode(const Node& node) const;
+  bool IsCompatibleShape(const NodeArg* arg) const;
+  bool IsFusableProducer(const Node& node) const;
+  void CollectGroup(Node& root);
+  void EmitNode(Node& node);
+
+  Graph& graph_;
+
+  // Output shape of the root of the group being built.
+  const TensorShapeProto* root_shape_ = nullptr;
+
+  // Nodes of the group being built.
+  std::unordered_set<NodeIndex> group_;
+
+  // Map from the output of a node in the group to the node.
+  std::unordered_map<const NodeArg*, Node*> group_outputs_;
+
+  // Nodes of the group in the order that the fused node evaluates them, so
+  // that each node follows the nodes that produce its inputs.
+  std::vector<Node*> steps_;
+
+  // Inputs of the group that are not produced by a node in the group, in the
+  // order of their first use.
+  std::vector<NodeArg*> inputs_;
+
+  // Nodes that have been fused or that have been the root of a group.
+  std::unordered_set<NodeIndex> visited_;
+};
+
+bool ElementwiseFusionImpl::IsFusableNode(const Node& node) const {
+  if (!(utils::IsSupportedOptypeVersionAndDomain(node, "Add", 7) ||
+        utils::IsSupportedOptypeVersionAndDomain(node, "Sub", 7) ||
+        utils::IsSupportedOptypeVersionAndDomain(node, "Mul", 7) ||
+        utils::IsSupportedOptypeVersionAndDomain(node, "Div", 7) ||
+        utils::IsSupportedOptypeVersionAndDomain(node, "Pow", 7) ||
+        utils::IsSupportedOptypeVersionAndDomain(node, "Abs", 6) ||
+        utils::IsSupportedOptypeVersionAndDomain(node, "Neg", 6) ||
+        utils::IsSupportedOptypeVersionAndDomain(node, "Exp", 6) ||
+        utils::IsSupportedOptypeVersionAndDomain(node, "Log", 6) ||
+        utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", 6) ||
+        utils::IsSupportedOptypeVersionAndDomain(node, "Reciprocal", 6) ||
+        utils::IsSupportedOptypeVersionAndDomain(node, "Floor", 6) ||
+        utils::IsSupportedOptypeVersionAndDomain(node, "Ceil", 6) ||
+        utils::IsSupportedOptypeVersionAndDomain(node, "Relu", 6) ||
+        utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", 6) ||
+        utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", 6))) {
+    // Max and Min are variadic, so only fuse the binary form.
+    if (!(utils::IsSupportedOptypeVersionAndDomain(node, "Max", 6) ||
+          utils::IsSupportedOptypeVersionAndDomain(node, "Max", 8) ||
+          utils::IsSupportedOptypeVersionAndDomain(node, "Min", 6) ||
+          utils::IsSupportedOptypeVersionAndDomain(node, "Min", 8)) ||
+        node.InputDefs().size() != 2) {
+      return false;
+    }
+  }
+
+  const auto& provider_type = node.GetExecutionProviderType();
+  if (!provider_type.empty() && provider_type != kCpuExecutionProvider) {
+    return false;
+  }
+
+  // The fused kernel only implements float tensors.
+  const auto& output_defs = node.OutputDefs();
+  if (output_defs.size() != 1) {
+    return false;
+  }
+  const auto* type_proto = output_defs[0]->TypeAsProto();
+  return type_proto != nullptr &&
+         type_proto->tensor_type().elem_type() == TensorProto_DataType_FLOAT &&
+         output_defs[0]->Shape() != nullptr;
+}
+
+bool ElementwiseFusionImpl::IsCompatibleShape(const NodeArg* arg) const {
+  // The fused kernel broadcasts a tensor by repeating it, so the shape of the
+  // tensor without its leading ones must match the trailing dimensions of the
+  // output shape.
+  const auto* shape = arg->Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+
+  int first = 0;
+  while (first < shape->dim_size() && shape->dim(first).has_dim_value() && shape->dim(first).dim_value() == 1) {
+    first++;
+  }
+
+  const int offset = root_shape_->dim_size() - shape->dim_size();
+  if (first + offset < 0) {
+    return false;
+  }
+
+  for (int i = first; i < shape->dim_size(); i++) {
+    const auto& dim = shape->dim(i);
+    const auto& root_dim = root_shape_->dim(i + offset);
+    if (dim.has_dim_value()) {
+      if (!root_dim.has_dim_value() || root_dim.dim_value() != dim.dim_value()) {
+        return false;
+      }
+    } else if (dim.has_dim_param()) {
+      if (!root_dim.has_dim_param() || root_dim.dim_param() != dim.dim_param()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool ElementwiseFusionImpl::IsFusableProducer(const Node& node) const {
+  if (visited_.count(node.Index()) != 0 || !IsFusableNode(node)) {
+    return false;
+  }
+
+  // The output of the producer must only be consumed inside the group, so
+  // that it does not need to be materialized.
+  if (graph_.IsNodeOutputsInGraphOutputs(node)) {
+    return false;
+  }
+  for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+    if (group_.count(it->GetNode().Index()) == 0) {
+      return false;
+    }
+  }
+
+  for (const auto* input_def : node.InputDefs()) {
+    if (!IsCompatibleShape(input_def)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void ElementwiseFusionImpl::CollectGroup(Node& root) {
+  group_.insert(root.Index());
+  group_outputs_[root.OutputDefs()[0]] = &root;
+
+  std::vector<Node*> pending{&root};
+  while (!pending.empty()) {
+    Node* node = pending.back();
+    pending.pop_back();
+
+    for (auto it = node->InputNodesBegin(); it != node->InputNodesEnd(); ++it) {
+      Node* producer = graph_.GetNode((*it).Index());
+      if (group_.count(producer->Index()) == 0 && IsFusableProducer(*producer)) {
+        group_.insert(producer->Index());
+        group_outputs_[producer->OutputDefs()[0]] = producer;
+        visited_.insert(producer->Index());
+        pending.push_back(producer);
+      }
+    }
+  }
+}
+
+void ElementwiseFusionImpl::EmitNode(Node& node) {
+  if (std::find(steps_.begin(), steps_.end(), &node) != steps_.end()) {
+    return;
+  }
+
+  for (auto* input_def : node.MutableInputDefs()) {
+    auto producer_it = group_outputs_.find(input_def);
+    if (producer_it != group_outputs_.end()) {
+      EmitNode(*producer_it->second);
+    } else if (std::find(inputs_.begin(), inputs_.end(), input_def) == inputs_.end()) {
+      inputs_.push_back(input_def);
+    }
+  }
+
+  steps_.push_back(&node);
+}
+
+void ElementwiseFusionImpl::Fuse(Node& root, bool& modified) {
+  if (visited_.count(root.Index()) != 0 || !IsFusableNode(root)) {
+    return;
+  }
+  visited_.insert(root.Index());
+
+  root_shape_ = root.OutputDefs()[0]->Shape();
+  for (const auto* input_def : root.InputDefs()) {
+    if (!IsCompatibleShape(input_def)) {
+      return;
+    }
+  }
+
+  group_.clear();
+  group_outputs_.clear();
+  steps_.clear();
+  inputs_.clear();
+
+  CollectGroup(root);
+
+  // Nothing is saved by replacing a single node.
+  if (group_.size() < 2) {
+    return;
+  }
+
+  EmitNode(root);
+
+  // Operands index the inputs of the fused node followed by the results of
+  // the preceding steps. Unary steps use -1 for the second operand.
+  std::vector<std::string> ops;
+  std::vector<int64_t> operands;
+  for (const auto* step : steps_) {
+    ops.push_back(step->OpType());
+    for (size_t i = 0; i < 2; i++) {
+      int64_t operand = -1;
+      if (i < step->InputDefs().size()) {
+        const auto* input_def = step->InputDefs()[i];
+        auto input_it = std::find(inputs_.begin(), inputs_.end(), input_def);
+        if (input_it != inputs_.end()) {
+          operand = input_it - inputs_.begin();
+        } else {
+          auto step_it = std::find(steps_.begin(), steps_.end(), group_outputs_[input_def]);
+          operand = static_cast<int64_t>(inputs_.size()) + (step_it - steps_.begin());
+        }
+      }
+      operands.push_back(operand);
+    }
+  }
+
+  Node& fused_node = graph_.AddNode(graph_.GenerateNodeName("FusedElementwise"),
+                                    "FusedElementwise",
+                                    "fused element-wise operations",
+                                    inputs_,
+                                    root.MutableOutputDefs(),
+                                    nullptr,
+                                    kMSDomain);
+  fused_node.AddAttribute("ops", ops);
+  fused_node.AddAttribute("operands", operands);
+  fused_node.SetExecutionProviderType(root.GetExecutionProviderType());
+
+  // The edges of the fused node are rebuilt when the graph is resolved.
+  for (auto* step : steps_) {
+    utils::RemoveNodeOutputEdges(graph_, *step);
+    graph_.RemoveNode(step->Index());
+  }
+
+  modified = true;
+}
+
+}  // namespace
+
+Status ElementwiseFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto index : order) {
+    auto& node = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+  }
+
+  // Visit the consumers before the producers, so that each group is rooted
+  // at the last node of a chain.
+  ElementwiseFusionImpl impl(graph);
+  std::vector<NodeIndex> reverse_order(order.rbegin(), order.rend());
+  for (auto index : reverse_order) {
+    auto* node = graph.GetNode(index);
+    if (node != nullptr) {
+      impl.Fuse(*node, modified);
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
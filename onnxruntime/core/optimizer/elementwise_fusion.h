@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class ElementwiseFusion
+
+Fuses groups of adjacent unary and binary element-wise operations into a
+single FusedElementwise node. The fused node evaluates the expression one
+block of the output at a time, so the intermediate results are not written to
+full size tensors.
+
+A group is rooted at an element-wise node and grows to include the producers
+of its inputs that are element-wise nodes whose outputs are consumed only
+inside the group. Every tensor in the group must be the output shape with
+zero or more leading dimensions removed or set to one.
+*/
+class ElementwiseFusion : public onnxruntime::GraphTransformer {
+ public:
+  ElementwiseFusion() noexcept : onnxruntime::GraphTransformer("ElementwiseFusion", "Fuses chains of element-wise operations") {}
+
+ private:
+  Status ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
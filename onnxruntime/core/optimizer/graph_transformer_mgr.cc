@@ -23,4 +23,13 @@ Status GraphTransformerManager::ApplyAll(Graph& graph) const {
   return Status::OK();
 }
 
+std::vector<std::string> GraphTransformerManager::GetTransformerNames() const {
+  std::vector<std::string> names;
+  names.reserve(transformers_.size());
+  for (const auto& transformer : transformers_) {
+    names.push_back(transformer->Name());
+  }
+  return names;
+}
+
 }  // namespace onnxruntime
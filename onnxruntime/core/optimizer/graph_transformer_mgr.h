@@ -24,6 +24,12 @@ class GraphTransformerManager {
   // up to the given number of steps.
   common::Status ApplyAll(Graph& graph) const;
 
+  // Names of the registered graph transformers in the order they are applied.
+  std::vector<std::string> GetTransformerNames() const;
+
+  // Maximum number of times the list of graph transformers is applied.
+  unsigned Steps() const noexcept { return steps_; }
+
  private:
   GraphTransformerManager() = default;
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphTransformerManager);
@@ -0,0 +1,564 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <deque>
+#include <unordered_map>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/nchwc_transformer.h"
+#include "core/mlas/inc/mlas.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+class NchwcTransformerImpl {
+ public:
+  NchwcTransformerImpl(Graph& graph, int64_t block_size) noexcept;
+
+  void Transform(Node& node);
+  void Finalize(bool& modified);
+
+ private:
+  // Associate the following state with each NCHWc output that replaces an
+  // original NCHW output.
+  struct NchwcArgument {
+    // Node that produces the NCHWc output.
+    Node& output_node_;
+
+    // NCHWc version of the original output.
+    NodeArg* nchwc_arg_;
+
+    // Number of consumers of the original output that have not been
+    // transformed to consume the NCHWc output.
+    size_t remaining_original_uses_;
+
+    // Number of channels of the original output. The NCHWc output pads the
+    // channels to a multiple of the block size.
+    int64_t channels_;
+
+    NchwcArgument(Node& output_node, NodeArg* nchwc_arg, size_t original_uses, int64_t channels)
+        : output_node_(output_node),
+          nchwc_arg_(nchwc_arg),
+          remaining_original_uses_(original_uses),
+          channels_(channels) {
+    }
+  };
+
+  int64_t PadChannels(int64_t channels) const {
+    return (channels + block_size_ - 1) & ~(block_size_ - 1);
+  }
+
+  NodeArg* CreateNchwcArgument(const NodeArg* original_arg);
+  NodeArg* CreateInitializer(const std::string& base_name, Initializer& initializer);
+  NchwcArgument* LookupNchwcArgument(NodeArg* arg);
+  void InsertNchwcArgument(NodeArg* original_arg, Node& nchwc_node, NodeArg* nchwc_arg, int64_t channels);
+  NodeArg* GetReorderInput(NodeArg* arg);
+  bool IsFusableNchwcConv(const NchwcArgument* nchwc_input) const;
+
+  void TransformConv(Node& node);
+  void TransformPool(Node& node);
+  void TransformAdd(Node& node);
+  void TransformRelu(Node& node);
+  void TransformBatchNormalization(Node& node);
+
+  Graph& graph_;
+  const int64_t block_size_;
+
+  // Number of consumers of each NodeArg in the original graph, including the
+  // graph outputs.
+  std::unordered_map<const NodeArg*, size_t> original_uses_;
+
+  // Map from an original NodeArg to the NCHWc output that replaces it.
+  std::unordered_map<const NodeArg*, std::unique_ptr<NchwcArgument>> nchwc_args_;
+
+  // Map from an original NodeArg to the output of the ReorderInput node that
+  // reorders it to the NCHWc layout.
+  std::unordered_map<const NodeArg*, NodeArg*> reorder_inputs_;
+
+  std::deque<NodeIndex> removed_nodes_;
+};
+
+NchwcTransformerImpl::NchwcTransformerImpl(Graph& graph, int64_t block_size) noexcept
+    : graph_(graph), block_size_(block_size) {
+  // A graph output counts as a use that is never transformed.
+  for (const auto* output_def : graph_.GetOutputs()) {
+    original_uses_[output_def]++;
+  }
+  for (auto& node : graph_.Nodes()) {
+    for (const auto* input_def : node.InputDefs()) {
+      original_uses_[input_def]++;
+    }
+    for (const auto* input_def : node.ImplicitInputDefs()) {
+      original_uses_[input_def]++;
+    }
+  }
+}
+
+NodeArg* NchwcTransformerImpl::CreateNchwcArgument(const NodeArg* original_arg) {
+  // The shape of the NCHWc output is inferred when the graph is resolved.
+  TypeProto type_proto(*original_arg->TypeAsProto());
+  type_proto.mutable_tensor_type()->clear_shape();
+  return &graph_.GetOrCreateNodeArg(graph_.GenerateNodeArgName(original_arg->Name() + "_nchwc"), &type_proto);
+}
+
+NodeArg* NchwcTransformerImpl::CreateInitializer(const std::string& base_name, Initializer& initializer) {
+  TensorProto tensor_proto;
+  initializer.ToProto(&tensor_proto);
+  tensor_proto.set_name(graph_.GenerateNodeArgName(base_name + "_nchwc"));
+  graph_.AddInitializedTensor(tensor_proto);
+
+  TypeProto type_proto;
+  type_proto.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = type_proto.mutable_tensor_type()->mutable_shape();
+  for (auto dim : initializer.dims()) {
+    shape->add_dim()->set_dim_value(dim);
+  }
+  return &graph_.GetOrCreateNodeArg(tensor_proto.name(), &type_proto);
+}
+
+NchwcTransformerImpl::NchwcArgument* NchwcTransformerImpl::LookupNchwcArgument(NodeArg* arg) {
+  auto it = nchwc_args_.find(arg);
+  return (it != nchwc_args_.end()) ? it->second.get() : nullptr;
+}
+
+void NchwcTransformerImpl::InsertNchwcArgument(NodeArg* original_arg, Node& nchwc_node, NodeArg* nchwc_arg, int64_t channels) {
+  nchwc_args_[original_arg] =
+      std::make_unique<NchwcArgument>(nchwc_node, nchwc_arg, original_uses_[original_arg], channels);
+}
+
+NodeArg* NchwcTransformerImpl::GetReorderInput(NodeArg* arg) {
+  // Share the reordered input between all consumers of the original input.
+  auto it = reorder_inputs_.find(arg);
+  if (it != reorder_inputs_.end()) {
+    return it->second;
+  }
+
+  NodeArg* nchwc_arg = CreateNchwcArgument(arg);
+  graph_.AddNode(graph_.GenerateNodeName("ReorderInput"),
+                 "ReorderInput",
+                 "ReorderInput",
+                 std::vector<NodeArg*>{arg},
+                 std::vector<NodeArg*>{nchwc_arg},
+                 nullptr,
+                 kMSDomain);
+  reorder_inputs_[arg] = nchwc_arg;
+  return nchwc_arg;
+}
+
+bool NchwcTransformerImpl::IsFusableNchwcConv(const NchwcArgument* nchwc_input) const {
+  // An operation can be fused into the NchwcConv that produces its input if
+  // the operation is the only consumer of the convolution output and the
+  // convolution does not already apply an activation.
+  const Node& nchwc_node = nchwc_input->output_node_;
+  return nchwc_node.OpType() == "NchwcConv" &&
+         nchwc_input->remaining_original_uses_ == 1 &&
+         nchwc_node.GetAttributes().count("activation") == 0;
+}
+
+void NchwcTransformerImpl::TransformConv(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Require that the filter and optional bias are initializers, so that they
+  // can be reordered now.
+  const TensorProto* conv_W_tensor_proto = nullptr;
+  if (!graph_.GetInitializedTensor(input_defs[1]->Name(), conv_W_tensor_proto) ||
+      conv_W_tensor_proto->data_type() != TensorProto_DataType_FLOAT ||
+      conv_W_tensor_proto->dims_size() != 4) {
+    return;
+  }
+
+  const int64_t output_channels = conv_W_tensor_proto->dims(0);
+  const int64_t input_channels_per_group = conv_W_tensor_proto->dims(1);
+
+  const TensorProto* conv_B_tensor_proto = nullptr;
+  if (input_defs.size() >= 3 && input_defs[2]->Exists()) {
+    if (!graph_.GetInitializedTensor(input_defs[2]->Name(), conv_B_tensor_proto) ||
+        conv_B_tensor_proto->data_type() != TensorProto_DataType_FLOAT ||
+        conv_B_tensor_proto->dims_size() != 1 ||
+        conv_B_tensor_proto->dims(0) != output_channels) {
+      return;
+    }
+  }
+
+  const auto* group_attr = utils::GetNodeAttribute(node, "group");
+  const int64_t group_count = (group_attr != nullptr) ? group_attr->i() : 1;
+  const int64_t input_channels = input_channels_per_group * group_count;
+
+  // A grouped convolution is supported if it is depthwise or if the channels
+  // of each group fill whole blocks.
+  const bool depthwise = (group_count > 1 && input_channels_per_group == 1 && output_channels == group_count);
+
+  if (group_count > 1 && !depthwise &&
+      ((input_channels_per_group % block_size_) != 0 || ((output_channels / group_count) % block_size_) != 0)) {
+    return;
+  }
+
+  // Reordering an input with few channels costs more than it saves, so only
+  // start a chain of NCHWc operations at a convolution with enough channels.
+  auto* nchwc_input = LookupNchwcArgument(input_defs[0]);
+  if (nchwc_input != nullptr) {
+    if (nchwc_input->channels_ != input_channels) {
+      return;
+    }
+  } else if (input_channels < block_size_) {
+    return;
+  }
+
+  // Reorder the filter to the layout expected by the NCHWc kernels, padding
+  // the channel counts to multiples of the block size.
+  const int64_t nchwc_output_channels = PadChannels(output_channels);
+
+  Initializer conv_W(conv_W_tensor_proto);
+  std::vector<int64_t> nchwc_W_dims(conv_W.dims());
+  nchwc_W_dims[0] = nchwc_output_channels;
+  if (group_count == 1) {
+    nchwc_W_dims[1] = PadChannels(input_channels);
+  }
+
+  Initializer nchwc_conv_W(TensorProto_DataType_FLOAT, conv_W.name(), nchwc_W_dims);
+  if (depthwise) {
+    MlasReorderFilterOIHWBo(conv_W.dims().data(), conv_W.data<float>(), nchwc_conv_W.data<float>());
+  } else {
+    MlasReorderFilterOIHWBiBo(conv_W.dims().data(), conv_W.data<float>(), nchwc_conv_W.data<float>());
+  }
+
+  std::vector<NodeArg*> nchwc_input_defs{nullptr, CreateInitializer(input_defs[1]->Name(), nchwc_conv_W)};
+
+  if (conv_B_tensor_proto != nullptr) {
+    Initializer conv_B(conv_B_tensor_proto);
+    Initializer nchwc_conv_B(TensorProto_DataType_FLOAT, conv_B.name(), {nchwc_output_channels});
+    float* nchwc_conv_B_data = nchwc_conv_B.data<float>();
+    std::fill_n(nchwc_conv_B_data, nchwc_output_channels, 0.0f);
+    std::copy_n(conv_B.data<float>(), output_channels, nchwc_conv_B_data);
+    nchwc_input_defs.push_back(CreateInitializer(input_defs[2]->Name(), nchwc_conv_B));
+  }
+
+  if (nchwc_input != nullptr) {
+    nchwc_input_defs[0] = nchwc_input->nchwc_arg_;
+    nchwc_input->remaining_original_uses_--;
+  } else {
+    nchwc_input_defs[0] = GetReorderInput(input_defs[0]);
+  }
+
+  NodeArg* nchwc_output_arg = CreateNchwcArgument(output_defs[0]);
+
+  Node& nchwc_node = graph_.AddNode(graph_.GenerateNodeName(node.Name() + "_nchwc"),
+                                    "NchwcConv",
+                                    "NchwcConv",
+                                    nchwc_input_defs,
+                                    std::vector<NodeArg*>{nchwc_output_arg},
+                                    &node.GetAttributes(),
+                                    kMSDomain);
+
+  // A depthwise convolution uses a group for each padded channel.
+  if (depthwise) {
+    nchwc_node.AddAttribute("group", nchwc_output_channels);
+  }
+
+  InsertNchwcArgument(output_defs[0], nchwc_node, nchwc_output_arg, output_channels);
+  removed_nodes_.push_front(node.Index());
+}
+
+void NchwcTransformerImpl::TransformPool(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Pooling is only transformed if the input is already in the NCHWc layout.
+  auto* nchwc_input = LookupNchwcArgument(input_defs[0]);
+  if (nchwc_input == nullptr) {
+    return;
+  }
+
+  // The optional indices output of MaxPool is not supported.
+  if (output_defs.size() > 1 && output_defs[1]->Exists()) {
+    return;
+  }
+
+  const auto* kernel_shape_attr = utils::GetNodeAttribute(node, "kernel_shape");
+  if (kernel_shape_attr == nullptr || kernel_shape_attr->ints_size() != 2) {
+    return;
+  }
+
+  // Copy only the attributes that are supported by the NCHWc operators.
+  NodeAttributes nchwc_attributes;
+  for (const auto& attr : node.GetAttributes()) {
+    if (attr.first == "auto_pad" || attr.first == "kernel_shape" || attr.first == "pads" ||
+        attr.first == "strides" || attr.first == "count_include_pad") {
+      nchwc_attributes.insert(attr);
+    } else if (attr.first != "storage_order") {
+      return;
+    }
+  }
+
+  NodeArg* nchwc_output_arg = CreateNchwcArgument(output_defs[0]);
+
+  Node& nchwc_node = graph_.AddNode(graph_.GenerateNodeName(node.Name() + "_nchwc"),
+                                    "Nchwc" + node.OpType(),
+                                    "Nchwc" + node.OpType(),
+                                    std::vector<NodeArg*>{nchwc_input->nchwc_arg_},
+                                    std::vector<NodeArg*>{nchwc_output_arg},
+                                    &nchwc_attributes,
+                                    kMSDomain);
+
+  nchwc_input->remaining_original_uses_--;
+
+  InsertNchwcArgument(output_defs[0], nchwc_node, nchwc_output_arg, nchwc_input->channels_);
+  removed_nodes_.push_front(node.Index());
+}
+
+void NchwcTransformerImpl::TransformAdd(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Both inputs must be in the NCHWc layout with identical shapes, so that
+  // the element-wise operation does not broadcast.
+  auto* nchwc_input_0 = LookupNchwcArgument(input_defs[0]);
+  auto* nchwc_input_1 = LookupNchwcArgument(input_defs[1]);
+  if (nchwc_input_0 == nullptr || nchwc_input_1 == nullptr ||
+      nchwc_input_0->channels_ != nchwc_input_1->channels_) {
+    return;
+  }
+
+  const auto* shape_0 = input_defs[0]->Shape();
+  const auto* shape_1 = input_defs[1]->Shape();
+  if (shape_0 == nullptr || shape_1 == nullptr || shape_0->dim_size() != 4 || shape_1->dim_size() != 4) {
+    return;
+  }
+  for (int i = 0; i < 4; i++) {
+    if (!shape_0->dim(i).has_dim_value() || !shape_1->dim(i).has_dim_value() ||
+        shape_0->dim(i).dim_value() != shape_1->dim(i).dim_value()) {
+      return;
+    }
+  }
+
+  // Fuse the addition into a convolution that produces one of the inputs by
+  // accumulating into the other input. A convolution accepts a single sum
+  // input, so one that already accumulates into another input is skipped.
+  for (int i = 0; i < 2; i++) {
+    auto* nchwc_input = (i == 0) ? nchwc_input_0 : nchwc_input_1;
+    auto* nchwc_sum = (i == 0) ? nchwc_input_1 : nchwc_input_0;
+
+    if (IsFusableNchwcConv(nchwc_input) && nchwc_input != nchwc_sum &&
+        nchwc_input->output_node_.InputDefs().size() <= 3) {
+      Node& nchwc_node = nchwc_input->output_node_;
+      auto& nchwc_input_defs = nchwc_node.MutableInputDefs();
+
+      // Supply a missing optional bias.
+      if (nchwc_input_defs.size() < 3) {
+        nchwc_input_defs.push_back(&graph_.GetOrCreateNodeArg("", nullptr));
+      }
+      nchwc_input_defs.push_back(nchwc_sum->nchwc_arg_);
+      nchwc_node.MutableInputArgsCount().assign(nchwc_input_defs.size(), 1);
+
+      nchwc_sum->remaining_original_uses_--;
+
+      InsertNchwcArgument(output_defs[0], nchwc_node, nchwc_input->nchwc_arg_, nchwc_input->channels_);
+      nchwc_input->remaining_original_uses_--;
+      removed_nodes_.push_front(node.Index());
+      return;
+    }
+  }
+
+  // Otherwise add the NCHWc inputs directly. The padding channels of both
+  // inputs are zero, so the padding channels of the output are also zero.
+  NodeArg* nchwc_output_arg = CreateNchwcArgument(output_defs[0]);
+
+  Node& nchwc_node = graph_.AddNode(graph_.GenerateNodeName(node.Name() + "_nchwc"),
+                                    "Add",
+                                    "Add",
+                                    std::vector<NodeArg*>{nchwc_input_0->nchwc_arg_, nchwc_input_1->nchwc_arg_},
+                                    std::vector<NodeArg*>{nchwc_output_arg});
+
+  nchwc_input_0->remaining_original_uses_--;
+  nchwc_input_1->remaining_original_uses_--;
+
+  InsertNchwcArgument(output_defs[0], nchwc_node, nchwc_output_arg, nchwc_input_0->channels_);
+  removed_nodes_.push_front(node.Index());
+}
+
+void NchwcTransformerImpl::TransformRelu(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  auto* nchwc_input = LookupNchwcArgument(input_defs[0]);
+  if (nchwc_input == nullptr) {
+    return;
+  }
+
+  if (IsFusableNchwcConv(nchwc_input)) {
+    // Apply the activation in the convolution kernel.
+    Node& nchwc_node = nchwc_input->output_node_;
+    nchwc_node.AddAttribute("activation", "Relu");
+
+    InsertNchwcArgument(output_defs[0], nchwc_node, nchwc_input->nchwc_arg_, nchwc_input->channels_);
+  } else {
+    // Relu preserves the zero padding channels.
+    NodeArg* nchwc_output_arg = CreateNchwcArgument(output_defs[0]);
+
+    Node& nchwc_node = graph_.AddNode(graph_.GenerateNodeName(node.Name() + "_nchwc"),
+                                      "Relu",
+                                      "Relu",
+                                      std::vector<NodeArg*>{nchwc_input->nchwc_arg_},
+                                      std::vector<NodeArg*>{nchwc_output_arg});
+
+    InsertNchwcArgument(output_defs[0], nchwc_node, nchwc_output_arg, nchwc_input->channels_);
+  }
+
+  nchwc_input->remaining_original_uses_--;
+  removed_nodes_.push_front(node.Index());
+}
+
+void NchwcTransformerImpl::TransformBatchNormalization(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Batch normalization is only transformed if the input is already in the
+  // NCHWc layout. The optional training outputs are not supported.
+  auto* nchwc_input = LookupNchwcArgument(input_defs[0]);
+  if (nchwc_input == nullptr || output_defs.size() > 1) {
+    return;
+  }
+
+  const int64_t channels = nchwc_input->channels_;
+
+  const TensorProto* bn_tensor_protos[4];
+  for (int i = 0; i < 4; i++) {
+    if (!graph_.GetInitializedTensor(input_defs[i + 1]->Name(), bn_tensor_protos[i]) ||
+        bn_tensor_protos[i]->data_type() != TensorProto_DataType_FLOAT ||
+        bn_tensor_protos[i]->dims_size() != 1 ||
+        bn_tensor_protos[i]->dims(0) != channels) {
+      return;
+    }
+  }
+
+  const auto* epsilon_attr = utils::GetNodeAttribute(node, "epsilon");
+  const float epsilon = (epsilon_attr != nullptr) ? epsilon_attr->f() : 1e-5f;
+
+  Initializer bn_scale(bn_tensor_protos[0]);
+  Initializer bn_B(bn_tensor_protos[1]);
+  Initializer bn_mean(bn_tensor_protos[2]);
+  Initializer bn_var(bn_tensor_protos[3]);
+
+  // Fold the normalization into the filter and bias of a depthwise 1x1
+  // convolution.
+  bn_var.add(epsilon);
+  bn_var.sqrt();
+  bn_scale.div(bn_var);
+  bn_mean.mul(bn_scale);
+  bn_B.sub(bn_mean);
+
+  const int64_t nchwc_channels = PadChannels(channels);
+
+  std::vector<int64_t> filter_dims{channels, 1, 1, 1};
+  Initializer nchwc_conv_W(TensorProto_DataType_FLOAT, bn_scale.name(), {nchwc_channels, 1, 1, 1});
+  MlasReorderFilterOIHWBo(filter_dims.data(), bn_scale.data<float>(), nchwc_conv_W.data<float>());
+
+  Initializer nchwc_conv_B(TensorProto_DataType_FLOAT, bn_B.name(), {nchwc_channels});
+  float* nchwc_conv_B_data = nchwc_conv_B.data<float>();
+  std::fill_n(nchwc_conv_B_data, nchwc_channels, 0.0f);
+  std::copy_n(bn_B.data<float>(), channels, nchwc_conv_B_data);
+
+  NodeArg* nchwc_output_arg = CreateNchwcArgument(output_defs[0]);
+
+  Node& nchwc_node = graph_.AddNode(graph_.GenerateNodeName(node.Name() + "_nchwc"),
+                                    "NchwcConv",
+                                    "NchwcConv",
+                                    std::vector<NodeArg*>{nchwc_input->nchwc_arg_,
+                                                          CreateInitializer(input_defs[1]->Name(), nchwc_conv_W),
+                                                          CreateInitializer(input_defs[2]->Name(), nchwc_conv_B)},
+                                    std::vector<NodeArg*>{nchwc_output_arg},
+                                    nullptr,
+                                    kMSDomain);
+
+  nchwc_node.AddAttribute("group", nchwc_channels);
+
+  nchwc_input->remaining_original_uses_--;
+
+  InsertNchwcArgument(output_defs[0], nchwc_node, nchwc_output_arg, channels);
+  removed_nodes_.push_front(node.Index());
+}
+
+void NchwcTransformerImpl::Transform(Node& node) {
+  // The type of the output is required to create the NCHWc output.
+  if (node.OutputDefs().size() == 0 || node.OutputDefs()[0]->TypeAsProto() == nullptr) {
+    return;
+  }
+
+  if (utils::IsSupportedOptypeVersionAndDomain(node, "Conv", 1) ||
+      utils::IsSupportedOptypeVersionAndDomain(node, "FusedConv", 1, kMSDomain)) {
+    TransformConv(node);
+  } else if (utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", 1) ||
+             utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", 8) ||
+             utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", 7)) {
+    TransformPool(node);
+  } else if (utils::IsSupportedOptypeVersionAndDomain(node, "Add", 7)) {
+    TransformAdd(node);
+  } else if (utils::IsSupportedOptypeVersionAndDomain(node, "Relu", 6)) {
+    TransformRelu(node);
+  } else if (utils::IsSupportedOptypeVersionAndDomain(node, "BatchNormalization", 7) ||
+             utils::IsSupportedOptypeVersionAndDomain(node, "BatchNormalization", 9)) {
+    TransformBatchNormalization(node);
+  }
+}
+
+void NchwcTransformerImpl::Finalize(bool& modified) {
+  // Reorder the NCHWc outputs that are still consumed by the original graph
+  // back to the NCHW layout. The ReorderOutput node produces the original
+  // NodeArg, so that the remaining consumers are unchanged.
+  for (auto& nchwc_output : nchwc_args_) {
+    const NodeArg* original_arg = nchwc_output.first;
+
+    if (nchwc_output.second->remaining_original_uses_ > 0) {
+      Node& reorder_output_node = graph_.AddNode(graph_.GenerateNodeName("ReorderOutput"),
+                                                 "ReorderOutput",
+                                                 "ReorderOutput",
+                                                 std::vector<NodeArg*>{nchwc_output.second->nchwc_arg_},
+                                                 std::vector<NodeArg*>{const_cast<NodeArg*>(original_arg)},
+                                                 nullptr,
+                                                 kMSDomain);
+      reorder_output_node.AddAttribute("channels", nchwc_output.second->channels_);
+    }
+  }
+
+  // The consumers of the removed nodes now consume the NCHWc outputs or the
+  // ReorderOutput nodes, so drop the stale edges before removing the nodes.
+  for (auto index : removed_nodes_) {
+    utils::RemoveNodeOutputEdges(graph_, *graph_.GetNode(index));
+  }
+  for (auto index : removed_nodes_) {
+    graph_.RemoveNode(index);
+  }
+
+  if (!removed_nodes_.empty()) {
+    modified = true;
+  }
+}
+
+}  // namespace
+
+Status NchwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  const int64_t block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+
+  NchwcTransformerImpl impl(graph, block_size);
+  GraphViewer graph_viewer(graph);
+
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    auto& node = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    // The NCHWc layout is not supported if the block size is one.
+    if (block_size > 1) {
+      impl.Transform(node);
+    }
+  }
+
+  impl.Finalize(modified);
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
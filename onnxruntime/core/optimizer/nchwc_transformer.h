@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class NchwcTransformer
+
+Transforms chains of convolutions, pooling, and element-wise operations to
+operate on tensors in the NCHWc layout, where blocks of channels are stored
+contiguously for each spatial element. Tensors are reordered to the NCHWc
+layout when entering a chain and reordered back to the NCHW layout when
+consumed by an operation that was not transformed. The filter and bias
+initializers of the convolutions are reordered when the graph is transformed.
+
+The transformer does nothing if the platform does not support the NCHWc
+layout.
+*/
+class NchwcTransformer : public onnxruntime::GraphTransformer {
+ public:
+  NchwcTransformer() noexcept : onnxruntime::GraphTransformer("NchwcTransformer", "Transforms convolutions to the NCHWc layout") {}
+
+ private:
+  Status ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -14,12 +14,10 @@
 namespace onnxruntime {
 
 OptimizerExecutionFrame::Info::Info(const std::vector<const Node*>& nodes,
-                                    const InitializedTensorSet& initialized_tensor_set) {
-  // Create CPU execution provider
-  // For now, CPU execution provider will be created every time when initilizing Info.
-  // Later, it will be changed to pass by Info ctor.
-  cpu_execution_provider_ = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
-  allocator_ptr_ = cpu_execution_provider_->GetAllocator(device_id_, mem_type_);
+                                    const InitializedTensorSet& initialized_tensor_set,
+                                    const IExecutionProvider& execution_provider)
+    : execution_provider_(execution_provider) {
+  allocator_ptr_ = execution_provider_.GetAllocator(device_id_, mem_type_);
   ORT_ENFORCE(allocator_ptr_ != nullptr, "Failed to get allocator for optimizer");
 
   // Create MLValues related maps
@@ -61,9 +59,9 @@ OptimizerExecutionFrame::Info::Info(const std::vector<const Node*>& nodes,
   // create kernels for these nodes
   for (auto* node : nodes) {
     std::unique_ptr<OpKernel> op_kernel;
-    std::shared_ptr<KernelRegistry> kernel_registry = cpu_execution_provider_->GetKernelRegistry();
+    std::shared_ptr<KernelRegistry> kernel_registry = execution_provider_.GetKernelRegistry();
     auto status = kernel_registry->TryCreateKernel(*node,
-                                                   *cpu_execution_provider_,
+                                                   execution_provider_,
                                                    initializers_,
                                                    mlvalue_name_idx_map_,
                                                    FuncManager(),
@@ -18,15 +18,17 @@ class OptimizerExecutionFrame final : public IExecutionFrame {
  public:
   class Info {
    public:
+    // execution_provider creates the kernels and allocates the MLValues, and must outlive the Info.
     Info(const std::vector<const Node*>& nodes,
-         const InitializedTensorSet& initialized_tensor_set);
+         const InitializedTensorSet& initialized_tensor_set,
+         const IExecutionProvider& execution_provider);
     ~Info() {
       for (auto& kvp : deleter_for_initialized_tensors_) {
         kvp.second.f(kvp.second.param);
       }
     }
     AllocatorPtr GetAllocator(const OrtAllocatorInfo& info) const {
-      return cpu_execution_provider_->GetAllocator(info.id, info.mem_type);
+      return execution_provider_.GetAllocator(info.id, info.mem_type);
     }
 
     AllocatorPtr GetAllocator() const {
@@ -48,8 +50,8 @@ class OptimizerExecutionFrame final : public IExecutionFrame {
     const OpKernel* GetKernel(NodeIndex node_id) const;
 
    private:
-    // The optimizer is running on CPU execution provider by default.
-    std::unique_ptr<CPUExecutionProvider> cpu_execution_provider_;
+    // The optimizer runs the kernels of the CPU execution provider.
+    const IExecutionProvider& execution_provider_;
     const int device_id_{0};
     const OrtMemType mem_type_{OrtMemTypeDefault};
     AllocatorPtr allocator_ptr_;
@@ -20,6 +20,14 @@ namespace onnxruntime {
 
 Env::Env() = default;
 
+#ifndef _WIN32
+common::Status Env::MapFileIntoMemory(const char*, size_t, size_t, void**, OrtCallback&) const {
+#else
+common::Status Env::MapFileIntoMemory(const wchar_t*, size_t, size_t, void**, OrtCallback&) const {
+#endif
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "MapFileIntoMemory is not implemented on this platform.");
+}
+
 Thread::~Thread() = default;
 
 }  // namespace onnxruntime
@@ -24,6 +24,7 @@ limitations under the License.
 #include <gsl/pointers>
 
 #include "core/common/common.h"
+#include "core/framework/callback.h"
 #include "core/platform/env_time.h"
 
 #ifndef _WIN32
@@ -103,6 +104,23 @@ class Env {
   virtual common::Status ReadFileAsString(const wchar_t* file_path, std::string* out) const = 0;
 #endif
 
+
+  /// \brief Maps 'length' bytes of the file, starting at 'offset', into copy-on-write memory.
+  ///
+  /// The memory can be written to, but the writes are private to the process and are not written to the file.
+  ///
+  /// file_path must point to a regular file, which can't be a pipe/socket/...
+  /// On success, '*mapped_memory' points to the data at 'offset', and 'deleter' unmaps the memory when it is run.
+  /// If 'length' is 0, '*mapped_memory' is set to nullptr and 'deleter' does nothing.
+  /// Returns NOT_IMPLEMENTED if the platform doesn't support it.
+#ifndef _WIN32
+  virtual common::Status MapFileIntoMemory(const char* file_path, size_t offset, size_t length,
+                                           void** mapped_memory, OrtCallback& deleter) const;
+#else
+  virtual common::Status MapFileIntoMemory(const wchar_t* file_path, size_t offset, size_t length,
+                                           void** mapped_memory, OrtCallback& deleter) const;
+#endif
+
 #ifdef _WIN32
   //Mainly for use with protobuf library
   virtual common::Status FileOpenRd(const std::wstring& path, /*out*/ int& fd) const = 0;
@@ -17,6 +17,7 @@ limitations under the License.
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include <dlfcn.h>
 #include <string.h>
@@ -30,6 +31,17 @@ namespace onnxruntime {
 
 namespace {
 
+struct UnmapFileParam {
+  void* addr;
+  size_t len;
+};
+
+void ORT_API_CALL UnmapFile(void* param) noexcept {
+  UnmapFileParam* p = reinterpret_cast<UnmapFileParam*>(param);
+  (void)munmap(p->addr, p->len);
+  delete p;
+}
+
 class StdThread : public Thread {
  public:
   StdThread(std::function<void()> fn)
@@ -135,6 +147,62 @@ class PosixEnv : public Env {
     return common::Status::OK();
   }
 
+  common::Status MapFileIntoMemory(const char* fname, size_t offset, size_t length, void** mapped_memory,
+                                   OrtCallback& deleter) const override {
+    if (!mapped_memory) {
+      return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                            "MapFileIntoMemory: 'mapped_memory' cannot be NULL");
+    }
+    if (!fname) {
+      return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "MapFileIntoMemory: 'fname' cannot be NULL");
+    }
+
+    *mapped_memory = nullptr;
+    deleter.f = nullptr;
+    deleter.param = nullptr;
+
+    if (length == 0) {
+      return common::Status::OK();
+    }
+
+    int fd = open(fname, O_RDONLY);
+    if (fd < 0) {
+      int err = errno;
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "open file ", fname, " fail, errcode =", err);
+    }
+    struct stat stbuf;
+    if ((fstat(fd, &stbuf) != 0) || (!S_ISREG(stbuf.st_mode))) {
+      (void)close(fd);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Get file '", fname, "' size fail");
+    }
+    if (offset > static_cast<size_t>(stbuf.st_size) || length > static_cast<size_t>(stbuf.st_size) - offset) {
+      (void)close(fd);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Offset ", offset, " and length ", length,
+                             " are out of range for file '", fname, "' with size ", stbuf.st_size);
+    }
+
+    // the offset passed to mmap must be a multiple of the page size
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t offset_to_page = offset % page_size;
+    const size_t mapped_length = length + offset_to_page;
+
+    // the mapping is copy-on-write so a kernel can still write to the tensor. the pages that are only read stay
+    // shared with the page cache, and writes never reach the file.
+    void* addr = mmap(nullptr, mapped_length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+                      static_cast<off_t>(offset - offset_to_page));
+    int err = errno;
+    // the mapping remains valid after the file is closed
+    (void)close(fd);
+    if (addr == MAP_FAILED) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "mmap file '", fname, "' fail, error code = ", err);
+    }
+
+    *mapped_memory = static_cast<char*>(addr) + offset_to_page;
+    deleter.f = UnmapFile;
+    deleter.param = new UnmapFileParam{addr, mapped_length};
+    return common::Status::OK();
+  }
+
   common::Status FileOpenRd(const std::string& path, /*out*/ int& fd) const override {
     fd = open(path.c_str(), O_RDONLY);
     if (0 > fd) {
@@ -3,6 +3,7 @@
 
 #include "core/providers/cpu/activation/activations.h"
 #include "core/mlas/inc/mlas.h"
+#include <algorithm>
 
 namespace onnxruntime {
 
@@ -30,6 +31,84 @@ REGISTER_UNARY_ELEMENTWISE_KERNEL(Softsign, 1);
 REGISTER_UNARY_ELEMENTWISE_KERNEL(Tanh, 6);
 REGISTER_UNARY_ELEMENTWISE_KERNEL(ThresholdedRelu, 1);
 
+// The activations below that are built from exponentials stage the result of
+// the MLAS routines in a local buffer of this many elements. The input and
+// output may be the same buffer, so the output is only written after the
+// corresponding input has been consumed.
+static constexpr int64_t kActivationBlockSize = 256;
+
+template <>
+Status Elu<float>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const auto& x_shape = X->Shape();
+  Tensor* Y = context->Output(0, x_shape);
+  const float* x_data = X->template Data<float>();
+  float* y_data = Y->template MutableData<float>();
+  const int64_t size = x_shape.Size();
+
+  float buffer[kActivationBlockSize];
+
+  for (int64_t offset = 0; offset < size; offset += kActivationBlockSize) {
+    const int64_t count = std::min(kActivationBlockSize, size - offset);
+    MlasComputeExp(x_data + offset, buffer, static_cast<size_t>(count));
+    ConstEigenVectorArrayMap<float> xm(x_data + offset, count);
+    ConstEigenVectorArrayMap<float> em(buffer, count);
+    EigenVectorArrayMap<float>(y_data + offset, count) = (xm >= 0).select(xm, alpha_ * (em - 1.0f));
+  }
+
+  return Status::OK();
+}
+
+template <>
+Status ParametricSoftplus<float>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const auto& x_shape = X->Shape();
+  Tensor* Y = context->Output(0, x_shape);
+  const float* x_data = X->template Data<float>();
+  float* y_data = Y->template MutableData<float>();
+  const int64_t size = x_shape.Size();
+
+  float buffer[kActivationBlockSize];
+
+  // Softplus(z) = max(z, 0) + log(1 + exp(-|z|)), which does not overflow for
+  // large magnitudes of z = beta * x.
+  for (int64_t offset = 0; offset < size; offset += kActivationBlockSize) {
+    const int64_t count = std::min(kActivationBlockSize, size - offset);
+    ConstEigenVectorArrayMap<float> xm(x_data + offset, count);
+    EigenVectorArrayMap<float> bm(buffer, count);
+    bm = -(xm * beta_).abs();
+    MlasComputeExp(buffer, buffer, static_cast<size_t>(count));
+    bm += 1.0f;
+    MlasComputeLog(buffer, buffer, static_cast<size_t>(count));
+    EigenVectorArrayMap<float>(y_data + offset, count) = alpha_ * ((xm * beta_).cwiseMax(0.0f) + bm);
+  }
+
+  return Status::OK();
+}
+
+template <>
+Status Selu<float>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const auto& x_shape = X->Shape();
+  Tensor* Y = context->Output(0, x_shape);
+  const float* x_data = X->template Data<float>();
+  float* y_data = Y->template MutableData<float>();
+  const int64_t size = x_shape.Size();
+
+  float buffer[kActivationBlockSize];
+
+  for (int64_t offset = 0; offset < size; offset += kActivationBlockSize) {
+    const int64_t count = std::min(kActivationBlockSize, size - offset);
+    MlasComputeExp(x_data + offset, buffer, static_cast<size_t>(count));
+    ConstEigenVectorArrayMap<float> xm(x_data + offset, count);
+    ConstEigenVectorArrayMap<float> em(buffer, count);
+    EigenVectorArrayMap<float>(y_data + offset, count) =
+        gamma_ * (xm.cwiseMax(0.0f) + (alpha_ * (em - 1.0f)).cwiseMin(0.0f));
+  }
+
+  return Status::OK();
+}
+
 template <>
 Status Sigmoid<float>::Compute(OpKernelContext* context) const {
   const Tensor* X = context->Input<Tensor>(0);
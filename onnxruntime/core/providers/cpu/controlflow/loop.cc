@@ -12,6 +12,7 @@
 #include "core/providers/cpu/controlflow/loop.h"
 #include "core/providers/cpu/controlflow/utils.h"
 
+#include "core/framework/execution_frame.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/sequential_executor.h"
@@ -130,6 +131,10 @@ class LoopImpl {
   // collection of MLValue outputs from each loop iteration for the loop outputs.
   // the order from the subgraph matches the order from the loop output
   std::vector<std::vector<MLValue>> loop_output_tensors_;
+
+  // frame used to execute the subgraph. it is created by the first iteration and reused by the others,
+  // so the intermediate values of each iteration use the same memory pattern buffers.
+  std::unique_ptr<ExecutionFrame> frame_;
 };
 
 Status Loop::Compute(OpKernelContext* ctx) const {
@@ -341,11 +346,11 @@ Status LoopImpl::Execute(FeedsFetchesManager* ffm, const FeedsFetchesManager* ca
     if (cached_ffm) {
       status = utils::ExecuteGraphWithCachedInfo(session_state_, *cached_ffm, feeds, fetches, {},
                                                  /*sequential_execution*/ true, context_.GetTerminateFlag(),
-                                                 context_.Logger());
+                                                 context_.Logger(), &frame_);
     } else {
       status = utils::ExecuteGraph(session_state_, *ffm, feeds, fetches, {},
                                    /*sequential_execution*/ true, context_.GetTerminateFlag(), context_.Logger(),
-                                   /*cache_copy_info*/ true);
+                                   /*cache_copy_info*/ true, &frame_);
 
       // after the first execution, use the cached information
       cached_ffm = ffm;
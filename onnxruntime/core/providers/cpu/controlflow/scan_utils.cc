@@ -13,6 +13,7 @@
 
 #include "gsl/gsl_algorithm"
 
+#include "core/framework/execution_frame.h"
 #include "core/framework/mldata_type_utils.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/sequential_executor.h"
@@ -156,6 +157,10 @@ Status IterateSequence(OpKernelContextInternal& context,
   feeds.resize(num_inputs);
   fetches.resize(num_variadic_outputs);
 
+  // the frame is created by the first iteration and reused by the others, so the intermediate values of each
+  // iteration use the same memory pattern buffers.
+  std::unique_ptr<ExecutionFrame> frame;
+
   // add implicit inputs and pass in implicit inputs as feeds. we're going to pass in the explicit inputs
   // first in each iteration though so offset by num_variadic_inputs
   int i = 0;
@@ -211,11 +216,11 @@ Status IterateSequence(OpKernelContextInternal& context,
     if (cached_ffm) {
       status = utils::ExecuteGraphWithCachedInfo(session_state, *cached_ffm, feeds, fetches, fetch_allocators,
                                                  /*sequential_execution*/ true, context.GetTerminateFlag(),
-                                                 context.Logger());
+                                                 context.Logger(), &frame);
     } else {
       status = utils::ExecuteGraph(session_state, *ffm, feeds, fetches, fetch_allocators,
                                    /*sequential_execution*/ true, context.GetTerminateFlag(), context.Logger(),
-                                   /*cache_copy_info*/ true);
+                                   /*cache_copy_info*/ true, &frame);
       // we can now use the cached info
       cached_ffm = ffm;
     }
@@ -12,9 +12,10 @@ namespace onnxruntime {
 // Information needed to construct CPU execution providers.
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
+  ArenaSettings arena_settings;
 
-  explicit CPUExecutionProviderInfo(bool use_arena)
-      : create_arena(use_arena) {}
+  explicit CPUExecutionProviderInfo(bool use_arena, const ArenaSettings& settings = ArenaSettings())
+      : create_arena(use_arena), arena_settings(settings) {}
 
   CPUExecutionProviderInfo() = default;
 };
@@ -38,7 +39,7 @@ class CPUExecutionProvider : public IExecutionProvider {
             std::make_unique<DummyArena>(device_info.factory(0))));
 #else
     if (info.create_arena)
-      InsertAllocator(CreateAllocator(device_info));
+      InsertAllocator(CreateAllocator(device_info, 0, info.arena_settings));
     else
       InsertAllocator(
           std::shared_ptr<IArenaAllocator>(
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "core/common/common.h"
+#include "core/common/threadpool.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
 
@@ -349,6 +350,22 @@ struct BroadcastIterator {
     return index;
   }
 
+  // Position the iterator at the given element offset of the broadcast output, as if AdvanceBy had been
+  // called until that offset was reached. Level 0 moves by deltas_[0] per element and every other level
+  // moves by its delta each time the levels below it wrap around.
+  void SeekTo(size_t offset) {
+    ptrdiff_t index = deltas_[0] * static_cast<ptrdiff_t>(offset);
+    size_t wraps = offset;
+    for (size_t counterIndex = 0; counterIndex < counts_.size(); counterIndex++) {
+      if (counterIndex > 0)
+        index += deltas_[counterIndex] * static_cast<ptrdiff_t>(wraps);
+      const size_t count = static_cast<size_t>(counts_[counterIndex]);
+      counters_[counterIndex] = static_cast<int64_t>(wraps % count);
+      wraps /= count;
+    }
+    index_ = static_cast<size_t>(index);
+  }
+
   void Init(int64_t axis, int64_t largest) {
     ORT_ENFORCE(axis == 1 || axis == largest, "Attempting to broadcast an axis by a dimension other than 1. ", axis, " by ", largest);
 
@@ -504,9 +521,26 @@ struct TBroadcaster {
   ConstEigenVectorMap<T0> NextEigen0() { return ConstEigenVectorMap<T0>(Next0(), span_size_); }
   ConstEigenVectorMap<T1> NextEigen1() { return ConstEigenVectorMap<T1>(Next1(), span_size_); }
 
+  // Partial span versions used when computing a range of the output. 'count' must not cross the end of
+  // the current span.
+  const T0& NextScalar0(size_t count) { return *Next0(count); }
+  const T1& NextScalar1(size_t count) { return *Next1(count); }
+
+  ConstEigenVectorMap<T0> NextEigen0(size_t count) { return ConstEigenVectorMap<T0>(Next0(count), count); }
+  ConstEigenVectorMap<T1> NextEigen1(size_t count) { return ConstEigenVectorMap<T1>(Next1(count), count); }
+
+  // Position both inputs at the given element offset of the output
+  void SeekTo(size_t offset) {
+    broadcaster_.iterator1_.SeekTo(offset);
+    broadcaster_.iterator2_.SeekTo(offset);
+  }
+
  private:
-  const T0* Next0() { return input0_ + broadcaster_.iterator1_.AdvanceBy(span_size_); }
-  const T1* Next1() { return input1_ + broadcaster_.iterator2_.AdvanceBy(span_size_); }
+  const T0* Next0(size_t count) { return input0_ + broadcaster_.iterator1_.AdvanceBy(count); }
+  const T1* Next1(size_t count) { return input1_ + broadcaster_.iterator2_.AdvanceBy(count); }
+
+  const T0* Next0() { return Next0(span_size_); }
+  const T1* Next1() { return Next1(span_size_); }
 
   const Tensor& input_tensor0_;
   const Tensor& input_tensor1_;
@@ -604,11 +638,82 @@ void BroadcastLoopSpan(TBroadcaster& bc, Output& output, Input0Scalar input0scal
   }
 }
 
+// Number of output bytes computed by each block of a parallel broadcast. Small enough for the inputs and
+// output of a block to stay in the L2 cache, large enough to amortize the cost of scheduling the block.
+constexpr size_t kParallelBroadcastBlockBytes = 64 * 1024;
+
+// Broadcast loop over the output elements [begin, end). The range is walked in pieces that never cross a span
+// boundary, so the begin and end of the range do not need to be aligned to the span size. The functions are
+// in the same form as for BroadcastLoop.
+template <typename TBroadcaster, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
+void BroadcastRange(TBroadcaster& bc, TOutput* output, size_t begin, size_t end,
+                    Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
+  const size_t span_size = bc.GetSpanSize();
+  bc.SeekTo(begin);
+
+  if (bc.IsInput0Scalar()) {
+    for (size_t offset = begin; offset < end;) {
+      size_t count = std::min(span_size - offset % span_size, end - offset);
+      input0scalar(EigenVectorMap<TOutput>(output + offset, count), bc.NextScalar0(count), bc.NextEigen1(count));
+      offset += count;
+    }
+  } else if (bc.IsInput1Scalar()) {
+    for (size_t offset = begin; offset < end;) {
+      size_t count = std::min(span_size - offset % span_size, end - offset);
+      input1scalar(EigenVectorMap<TOutput>(output + offset, count), bc.NextEigen0(count), bc.NextScalar1(count));
+      offset += count;
+    }
+  } else {
+    for (size_t offset = begin; offset < end;) {
+      size_t count = std::min(span_size - offset % span_size, end - offset);
+      general(EigenVectorMap<TOutput>(output + offset, count), bc.NextEigen0(count), bc.NextEigen1(count));
+      offset += count;
+    }
+  }
+}
+
+// Broadcast loop that splits the output into blocks of kParallelBroadcastBlockBytes and computes the blocks on
+// the intra-op thread pool. Each block seeks its own copy of the broadcaster to the start of the block, so the
+// blocks are independent of each other. The functions are in the same form as for BroadcastLoop.
+template <typename TBroadcaster, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
+void ParallelBroadcastLoop(const TBroadcaster& bc, Tensor& output_tensor, concurrency::ThreadPool* tp,
+                           Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
+  const size_t output_size = static_cast<size_t>(output_tensor.Shape().Size());
+  if (output_size == 0)
+    return;
+
+  TOutput* output = output_tensor.template MutableData<TOutput>();
+
+  // Round the block up to whole spans when the spans are small, so that only the last piece of the output is
+  // a partial span.
+  const size_t span_size = bc.GetSpanSize();
+  size_t block_size = std::max<size_t>(kParallelBroadcastBlockBytes / sizeof(TOutput), 1);
+  if (span_size < block_size)
+    block_size = (block_size + span_size - 1) / span_size * span_size;
+
+  const size_t block_count = (output_size + block_size - 1) / block_size;
+
+  if (tp == nullptr || block_count == 1) {
+    TBroadcaster block_bc(bc);
+    BroadcastRange(block_bc, output, 0, output_size, input0scalar, input1scalar, general);
+    return;
+  }
+
+  concurrency::ThreadPool::TryParallelFor(tp, static_cast<int32_t>(block_count), [&](int32_t block) {
+    const size_t begin = static_cast<size_t>(block) * block_size;
+    const size_t end = std::min(begin + block_size, output_size);
+
+    TBroadcaster block_bc(bc);
+    BroadcastRange(block_bc, output, begin, end, input0scalar, input1scalar, general);
+  });
+}
+
 template <typename TInput, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
 Status BroadcastTwo(OpKernelContext& context, Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
   TBroadcaster<TInput, TInput> bc(*context.Input<Tensor>(0), *context.Input<Tensor>(1));
-  TBroadcastOutput<TOutput> output(bc.GetSpanSize(), *context.Output(0, bc.GetOutputShape()));
-  BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+  Tensor& output = *context.Output(0, bc.GetOutputShape());
+  ParallelBroadcastLoop<TBroadcaster<TInput, TInput>, TOutput>(bc, output, context.GetOperatorThreadPool(),
+                                                               input0scalar, input1scalar, general);
 
   return Status::OK();
 }
@@ -645,9 +750,8 @@ Status BroadcastVariadic(const Node& node, OpKernelContext& context, Input0Scala
       p_output = tempOutput.get();
     }
 
-    TBroadcastOutput<TOutput> output(bc.GetSpanSize(), *p_output);
-
-    BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+    ParallelBroadcastLoop<TBroadcaster<TInput, TInput>, TOutput>(bc, *p_output, context.GetOperatorThreadPool(),
+                                                                 input0scalar, input1scalar, general);
 
     tempInput = std::move(tempOutput);
   }
@@ -8,6 +8,7 @@
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
+#include "gemm_packed_b.h"
 
 namespace onnxruntime {
 
@@ -27,6 +28,10 @@ class Gemm : public OpKernel {
 
     ORT_ENFORCE(info.GetAttr<float>("alpha", &alpha_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
+
+    if (std::is_same<T_W, float>::value) {
+      PackGemmB(info, 1, trans_B_ != CblasNoTrans, packed_b_);
+    }
   }
 
   Status Compute(OpKernelContext* context) const override {
@@ -47,6 +52,52 @@ class Gemm : public OpKernel {
       return Status::OK();
     T_Y* y_data = Y->template MutableData<T_Y>();
 
+    // a bias that is broadcast across the rows of Y and the activation are applied by the MLAS
+    // SGEMM as each block of Y is completed, instead of with extra passes over Y
+    if (std::is_same<T_Y, float>::value && K > 0 &&
+        (beta_ == 0 || (beta_ == 1 && IsRowBias(B->Shape(), N)))) {
+      MLAS_ACTIVATION activation;
+      GetMlasActivation(activation);
+
+      MLAS_SGEMM_POSTPROCESS post_process;
+      post_process.Bias = beta_ == 0 ? nullptr : B->template Data<float>();
+      post_process.Activation = &activation;
+
+      if (packed_b_) {
+        MlasSgemm(trans_A_,
+                  static_cast<size_t>(M),
+                  static_cast<size_t>(N),
+                  static_cast<size_t>(K),
+                  alpha_,
+                  X->template Data<float>(),
+                  static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+                  packed_b_.get(),
+                  0.0f,
+                  Y->template MutableData<float>(),
+                  static_cast<size_t>(N),
+                  &post_process,
+                  context->GetOperatorThreadPool());
+      } else {
+        MlasSgemm(trans_A_,
+                  trans_B_,
+                  static_cast<size_t>(M),
+                  static_cast<size_t>(N),
+                  static_cast<size_t>(K),
+                  alpha_,
+                  X->template Data<float>(),
+                  static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+                  W->template Data<float>(),
+                  static_cast<size_t>(trans_B_ == CblasNoTrans ? N : K),
+                  0.0f,
+                  Y->template MutableData<float>(),
+                  static_cast<size_t>(N),
+                  &post_process,
+                  context->GetOperatorThreadPool());
+      }
+
+      return Status::OK();
+    }
+
     //bias
     // Todo: we might should move this part into math::gemm to let eigen
     // have better chance to further optimize it.
@@ -95,18 +146,35 @@ class Gemm : public OpKernel {
     }
 
     // W * x
-    math::Gemm<T_X, CPUMathUtil>(
-        trans_A_,
-        trans_B_,
-        M,
-        N,
-        K,
-        alpha_,
-        X->template Data<T_X>(),
-        W->template Data<T_W>(),
-        beta_,
-        y_data,
-        &CPUMathUtil::Instance());
+    if (packed_b_) {
+      MlasSgemm(trans_A_,
+                static_cast<size_t>(M),
+                static_cast<size_t>(N),
+                static_cast<size_t>(K),
+                alpha_,
+                X->template Data<float>(),
+                static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+                packed_b_.get(),
+                beta_,
+                Y->template MutableData<float>(),
+                static_cast<size_t>(N),
+                nullptr,
+                context->GetOperatorThreadPool());
+    } else {
+      math::Gemm<T_X, CPUMathUtil>(
+          trans_A_,
+          trans_B_,
+          M,
+          N,
+          K,
+          alpha_,
+          X->template Data<T_X>(),
+          W->template Data<T_W>(),
+          beta_,
+          y_data,
+          &CPUMathUtil::Instance(),
+          context->GetOperatorThreadPool());
+    }
 
     FuseActivation<T_Y>(activation_, y_data, M * N, leaky_relu_alpha_);
 
@@ -114,11 +182,39 @@ class Gemm : public OpKernel {
   }
 
  private:
+  // returns true if B is a vector of N elements that is added to each row of Y
+  static bool IsRowBias(const TensorShape& b_shape, int64_t N) {
+    if (b_shape.NumDimensions() == 1) {
+      return b_shape[0] == N;
+    }
+    return b_shape.NumDimensions() == 2 && b_shape[0] == 1 && b_shape[1] == N;
+  }
+
+  void GetMlasActivation(MLAS_ACTIVATION& activation) const {
+    if (activation_.empty()) {
+      activation.ActivationKind = MlasIdentityActivation;
+    } else if (activation_ == "Relu") {
+      activation.ActivationKind = MlasReluActivation;
+    } else if (activation_ == "LeakyRelu") {
+      activation.ActivationKind = MlasLeakyReluActivation;
+      activation.alpha = leaky_relu_alpha_;
+    } else if (activation_ == "Tanh") {
+      activation.ActivationKind = MlasTanhActivation;
+    } else if (activation_ == "Sigmoid") {
+      activation.ActivationKind = MlasLogisticActivation;
+    } else {
+      ORT_NOT_IMPLEMENTED("Not implemented fused activation: ", activation_);
+    }
+  }
+
   CBLAS_TRANSPOSE trans_A_;
   CBLAS_TRANSPOSE trans_B_;
   float alpha_;
   float beta_;
 
+  // B packed for MLAS if it is a constant initializer
+  BufferUniquePtr packed_b_;
+
 protected:
   // For fused gemm + activation
   std::string activation_;
@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/util/math.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+
+// Pack the B input of a float GEMM into the layout used by the MLAS kernels if it's a constant initializer,
+// so the kernel packs it once when it is created instead of on every call to Compute.
+// Returns false, and leaves packed_b empty, if the input is not a constant 2D tensor.
+inline bool PackGemmB(const OpKernelInfo& info, int input_index, bool trans_b, BufferUniquePtr& packed_b) {
+  const Tensor* b;
+  if (!info.TryGetConstantInput(input_index, &b) ||
+      b->DataType() != DataTypeImpl::GetType<float>() ||
+      b->Shape().NumDimensions() != 2) {
+    return false;
+  }
+
+  const auto& shape = b->Shape();
+  const size_t K = static_cast<size_t>(trans_b ? shape[1] : shape[0]);
+  const size_t N = static_cast<size_t>(trans_b ? shape[0] : shape[1]);
+  if (K == 0 || N == 0) {
+    return false;
+  }
+
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+  void* buffer = alloc->Alloc(MlasSgemmPackBSize(N, K));
+  packed_b = BufferUniquePtr(buffer, BufferDeleter(alloc));
+
+  MlasSgemmPackB(trans_b ? CblasTrans : CblasNoTrans, N, K, b->Data<float>(), trans_b ? K : N, buffer);
+  return true;
+}
+
+}  // namespace onnxruntime
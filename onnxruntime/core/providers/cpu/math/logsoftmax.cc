@@ -26,13 +26,9 @@ Status LogSoftmax<float>::Compute(OpKernelContext* ctx) const {
 
   float* Ydata = Y->template MutableData<float>();
 
-  std::vector<float> scale_(N);
-  std::vector<float> rowmax_(N);
-  std::vector<float> sum_multiplier_(D, 1.f);  // initialize all multiplier values to 1.0
-
   const bool logarithmic = true;
-  auto status = SoftmaxCPU(N, D, X.template Data<float>(), Ydata,
-                           scale_.data(), sum_multiplier_.data(), logarithmic, rowmax_.data());
+  auto status = SoftmaxCPU(N, D, X.template Data<float>(), Ydata, logarithmic,
+                           ctx->GetOperatorThreadPool());
 
   return status;
 }
@@ -40,7 +36,7 @@ Status LogSoftmax<float>::Compute(OpKernelContext* ctx) const {
 ONNX_CPU_OPERATOR_KERNEL(
     LogSoftmax,
     1,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     LogSoftmax<float>);
 
 }  // namespace onnxruntime
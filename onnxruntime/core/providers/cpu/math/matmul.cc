@@ -51,6 +51,18 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<uint64_t>()),
     MatMul<uint64_t>);
 
+// Returns true if the batched matrix offsets advance by a fixed stride. A stride of zero
+// means that the same matrix is shared by every batch.
+static bool IsStridedBatch(const std::vector<size_t>& offsets, size_t& stride) {
+  stride = offsets.size() > 1 ? offsets[1] - offsets[0] : 0;
+  for (size_t i = 1; i < offsets.size(); i++) {
+    if (offsets[i] != offsets[0] + i * stride) {
+      return false;
+    }
+  }
+  return true;
+}
+
 template <typename T>
 Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   const Tensor* left_X = ctx->Input<Tensor>(0);
@@ -61,7 +73,58 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
 
   Tensor* Y = ctx->Output(0, helper.OutputShape());
 
-  // TODO: replace it with GemmBatch for performance, it's OK for now as GemmBatch unrolls as well
+  // a 2D right input is shared by all the matrices in the left input, so the packed copy can be used for each
+  if (packed_b_) {
+    size_t max_len = helper.OutputOffsets().size();
+    for (size_t i = 0; i < max_len; i++) {
+      MlasSgemm(CblasNoTrans,
+                static_cast<size_t>(helper.M()),
+                static_cast<size_t>(helper.N()),
+                static_cast<size_t>(helper.K()),
+                /* alpha */ 1.0f,
+                left_X->template Data<float>() + helper.LeftOffsets()[i],
+                static_cast<size_t>(helper.K()),
+                packed_b_.get(),
+                /* beta */ 0.0f,
+                Y->template MutableData<float>() + helper.OutputOffsets()[i],
+                static_cast<size_t>(helper.N()),
+                nullptr,
+                ctx->GetOperatorThreadPool());
+    }
+
+    return Status::OK();
+  }
+
+  // batches that step through both inputs at fixed strides run as a single strided batch, so that
+  // MLAS can distribute the batch and the M/N dimensions across threads together
+  size_t left_stride;
+  size_t right_stride;
+  if (std::is_same<T, float>::value &&
+      IsStridedBatch(helper.LeftOffsets(), left_stride) &&
+      IsStridedBatch(helper.RightOffsets(), right_stride)) {
+    MlasSgemmBatch(CblasNoTrans,
+                   CblasNoTrans,
+                   static_cast<size_t>(helper.M()),
+                   static_cast<size_t>(helper.N()),
+                   static_cast<size_t>(helper.K()),
+                   /* alpha */ 1.0f,
+                   left_X->template Data<float>(),
+                   static_cast<size_t>(helper.K()),
+                   left_stride,
+                   right_X->template Data<float>(),
+                   static_cast<size_t>(helper.N()),
+                   right_stride,
+                   /* beta */ 0.0f,
+                   Y->template MutableData<float>(),
+                   static_cast<size_t>(helper.N()),
+                   static_cast<size_t>(helper.M() * helper.N()),
+                   helper.OutputOffsets().size(),
+                   ctx->GetOperatorThreadPool());
+
+    return Status::OK();
+  }
+
+  // the remaining broadcasts mix shared and strided matrices along different dims, so run one GEMM per batch
   size_t max_len = helper.OutputOffsets().size();
   for (size_t i = 0; i < max_len; i++) {
     math::Gemm<T, CPUMathUtil>(
@@ -75,7 +138,8 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
         right_X->template Data<T>() + helper.RightOffsets()[i],
         /* beta */ 0.0f,
         Y->template MutableData<T>() + helper.OutputOffsets()[i],
-        &CPUMathUtil::Instance());
+        &CPUMathUtil::Instance(),
+        ctx->GetOperatorThreadPool());
   }
 
   return Status::OK();
@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/math/gemm_packed_b.h"
 
 namespace onnxruntime {
 
@@ -13,9 +14,16 @@ class MatMul final : public OpKernel {
  public:
   MatMul(const OpKernelInfo& info)
       : OpKernel(info) {
+    if (std::is_same<T, float>::value) {
+      PackGemmB(info, 1, false, packed_b_);
+    }
   }
 
   Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // right input packed for MLAS if it is a constant 2D initializer
+  BufferUniquePtr packed_b_;
 };
 
 }  // namespace onnxruntime
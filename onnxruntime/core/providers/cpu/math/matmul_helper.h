@@ -124,6 +124,13 @@ class MatMulComputeHelper {
   void ComputeBroadcastOffsets() {
     num_broadcasted_dims_ = left_padded_dims_.size() - 2;
 
+    // trailing broadcast dims that the right operand is shared across can be folded into M,
+    // as the rows of the left and output matrices are contiguous along those dims
+    while (num_broadcasted_dims_ > 0 && right_padded_dims_[num_broadcasted_dims_ - 1] == 1) {
+      M_ *= left_padded_dims_[num_broadcasted_dims_ - 1];
+      num_broadcasted_dims_--;
+    }
+
     if (num_broadcasted_dims_ == 0) {
       left_offsets_ = {0};
       right_offsets_ = {0};
@@ -206,7 +213,7 @@ class MatMulComputeHelper {
     return output_shape_;
   }
 
-  // left and output matrices' first dim
+  // left and output matrices' first dim, including any broadcast dims folded into the rows
   int64_t M() const {
     return M_;
   }
@@ -28,13 +28,9 @@ Status Softmax<float>::Compute(OpKernelContext* ctx) const {
 
   float* Ydata = Y->template MutableData<float>();
 
-  std::vector<float> scale_(N);
-  std::vector<float> rowmax_(N);
-  std::vector<float> sum_multiplier_(D, 1.f);  // initialize all multiplier values to 1.0
-
   const bool logarithmic = false;
-  auto status = SoftmaxCPU(N, D, X.template Data<float>(), Ydata,
-                           scale_.data(), sum_multiplier_.data(), logarithmic, rowmax_.data());
+  auto status = SoftmaxCPU(N, D, X.template Data<float>(), Ydata, logarithmic,
+                           ctx->GetOperatorThreadPool());
 
   return status;
 }
@@ -42,7 +38,7 @@ Status Softmax<float>::Compute(OpKernelContext* ctx) const {
 ONNX_CPU_OPERATOR_KERNEL(
     Softmax,
     1,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Softmax<float>);
 
 }  // namespace onnxruntime
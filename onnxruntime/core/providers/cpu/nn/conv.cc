@@ -48,6 +48,8 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
 
   const size_t kernel_rank = kernel_shape.size();
 
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
   if (kernel_rank == 2 || kernel_rank == 3) {
     MLAS_ACTIVATION Activation;
     if (activation_.empty()) {
@@ -80,7 +82,8 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     output_shape.GetDims().data(),
                     static_cast<size_t>(M / group_),
                     &Activation,
-                    &WorkingBufferSize);
+                    &WorkingBufferSize,
+                    thread_pool);
 
     auto working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * WorkingBufferSize) : nullptr;
     BufferUniquePtr working_buffer(working_data, BufferDeleter(alloc));
@@ -90,7 +93,8 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
              W->template Data<float>(),
              B != nullptr ? B->template Data<float>() : nullptr,
              static_cast<float*>(working_buffer.get()),
-             Ydata);
+             Ydata,
+             thread_pool);
   } else {
     const int64_t input_image_size = input_shape.Size();
     const int64_t output_image_size = output_shape.Size();
@@ -136,7 +140,8 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
             col_buffer_data,
             0,
             Ydata + group_id * Y_offset,
-            &CPUMathUtil::Instance());
+            &CPUMathUtil::Instance(),
+            thread_pool);
       }
 
       if (B != nullptr) {
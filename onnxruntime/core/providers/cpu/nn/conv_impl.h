@@ -130,7 +130,8 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
           col_buffer_data,
           0,
           Ydata + group_id * Y_offset,
-          &CPUMathUtil::Instance());
+          &CPUMathUtil::Instance(),
+          context->GetOperatorThreadPool());
     }
 
     if (B != nullptr) {
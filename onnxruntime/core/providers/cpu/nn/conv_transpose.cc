@@ -250,7 +250,8 @@ Status ConvTranspose<T>::Compute(OpKernelContext* context) const {
           Xdata + group_id * X_offset,
           0,
           col_buffer_data,
-          &CPUMathUtil::Instance());
+          &CPUMathUtil::Instance(),
+          context->GetOperatorThreadPool());
 
       // Col2im
       math::Col2im<T, CPUMathUtil, StorageOrder::NCHW>(
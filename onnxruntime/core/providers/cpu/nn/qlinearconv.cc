@@ -7,6 +7,7 @@
 #endif
 
 #include "core/providers/cpu/nn/qlinearconv.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
@@ -37,9 +38,6 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   auto result_offset_data = *(result_offset->template Data<uint8_t>());
 
   const float real_multiplier = (input_scale_data * filter_scale_data) / result_scale_data;
-  int32_t integer_multiplier;
-  int right_shift;
-  QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
 
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* bias = nullptr;
@@ -95,6 +93,11 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
   uint8_t* col_buffer_data = static_cast<uint8_t*>(col_buffer.get());
 
+  // the 32-bit accumulators for a group, which are requantized to the output as each block is completed
+  auto gemm_output_data = alloc->Alloc(sizeof(int32_t) * (M / group_) * output_image_size);
+  BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
+  int32_t* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
+
   TensorShape image_shape = X->Shape().Slice(1);
   std::vector<int64_t> col_buffer_shape{kernel_dim};
   col_buffer_shape.insert(col_buffer_shape.end(), output_shape.GetDims().begin(),
@@ -118,32 +121,27 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
 		  false,
           input_offset_data);
 
-      const uint8_t* filter_data_as_uint8 = W->template Data<uint8_t>() + group_id * W_offset;
-      static const gemmlowp::MapOrder MatOrder = gemmlowp::MapOrder::RowMajor;
-      gemmlowp::MatrixMap<const std::uint8_t, MatOrder> lhs(
-          filter_data_as_uint8, static_cast<int>(M / group_), static_cast<int>(kernel_dim));
-      gemmlowp::MatrixMap<const std::uint8_t, MatOrder> rhs(
-          col_buffer_data, static_cast<int>(kernel_dim), static_cast<int>(output_image_size));
-      gemmlowp::MatrixMap<std::uint8_t, MatOrder> result(
-          Ydata + group_id * Y_offset, static_cast<int>(M / group_), static_cast<int>(output_image_size));
-
-      // TODO: worker thread pool needs to be handled.
-      gemmlowp::GemmContext gemm_context;
-      if (bias == nullptr) {
-        auto output_pipeline = MakeOutputPipelineWithOutBias(result_offset_data, 
-            integer_multiplier, right_shift);
-        gemmlowp::GemmWithOutputPipeline<std::uint8_t, std::uint8_t,
-                                         gemmlowp::DefaultL8R8BitDepthParams>(
-            &gemm_context, lhs, rhs, &result, -filter_offset_data, -input_offset_data,
-            output_pipeline);        
-      } else {
-        auto output_pipeline = MakeOutputPipelineWithBias(bias->template Data<int32_t>() + group_id * bias_offset, 
-            static_cast<int>(M / group_), result_offset_data, integer_multiplier, right_shift);
-        gemmlowp::GemmWithOutputPipeline<std::uint8_t, std::uint8_t,
-                                         gemmlowp::DefaultL8R8BitDepthParams>(
-            &gemm_context, lhs, rhs, &result, -filter_offset_data, -input_offset_data,
-            output_pipeline);
-      }      
+      MLAS_QGEMM_REQUANTIZE requantize;
+      requantize.Bias = bias != nullptr ? bias->template Data<int32_t>() + group_id * bias_offset : nullptr;
+      requantize.Scale = real_multiplier;
+      requantize.ZeroPoint = result_offset_data;
+      requantize.Output = Ydata + group_id * Y_offset;
+      requantize.ldo = static_cast<size_t>(output_image_size);
+
+      MlasQgemm(static_cast<size_t>(M / group_),
+                static_cast<size_t>(output_image_size),
+                static_cast<size_t>(kernel_dim),
+                W->template Data<uint8_t>() + group_id * W_offset,
+                static_cast<size_t>(kernel_dim),
+                filter_offset_data,
+                col_buffer_data,
+                static_cast<size_t>(output_image_size),
+                input_offset_data,
+                false,
+                gemm_output,
+                static_cast<size_t>(output_image_size),
+                &requantize,
+                context->GetOperatorThreadPool());
     }
 
     Xdata += X_offset * group_;
@@ -153,23 +151,6 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
-void QLinearConv::QuantizeMultiplier(float fp_multiplier, std::int32_t* integer_multiplier, int* right_shift) const {
-  uint32_t* fp_as_bits = reinterpret_cast<uint32_t*>(&fp_multiplier);
-  auto current_exponent = (*fp_as_bits >> 23);
-  // bring multiplier in [.5,1) range and calculate the shift
-  auto bumped_multiplier_as_bits =
-      (*fp_as_bits & UINT32_C(0x007fffff)) | UINT32_C(0x3f000000);
-  float* bumped_multiplier =
-      reinterpret_cast<float*>(&bumped_multiplier_as_bits);
-  auto shift = 126 - current_exponent;
-  // convert to fixed point number
-  std::int64_t int_multiplier =
-      static_cast<std::int64_t>(std::round(*bumped_multiplier * (1ll << 31)));
-
-  *integer_multiplier = static_cast<int32_t>(int_multiplier);
-  *right_shift = shift;
-}
-
 void QLinearConv::ScaleAndZeropointPairValidationHelper(const Tensor* scale, const Tensor* zeropoint) const {
   ORT_ENFORCE(scale->Shape().NumDimensions() == 0 ||
                   (scale->Shape().NumDimensions() == 1 && scale->Shape().GetDims().size() == 1),
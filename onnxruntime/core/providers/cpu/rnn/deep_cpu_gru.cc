@@ -12,7 +12,6 @@
 #include "core/providers/cpu/rnn/deep_cpu_gru.h"
 
 #include <algorithm>
-#include <future>
 #include <stdexcept>
 
 #include "core/common/logging/logging.h"
@@ -177,11 +176,7 @@ class UniDirectionalGru {
                     const ActivationFuncs::Entry& activation_func_f,
                     const ActivationFuncs::Entry& activation_func_g,
                     const float clip,
-#ifdef USE_EIGEN_THREADPOOL
-                    Eigen::NonBlockingThreadPool& ttp_);
-#else
-                    TaskThreadPool& ttp_);
-#endif
+                    concurrency::ThreadPool* ttp);
 
   void Compute(const gsl::span<const T>& inputs,
                const gsl::span<const int>& sequence_lengths,
@@ -197,11 +192,7 @@ class UniDirectionalGru {
   AllocatorPtr allocator_;
   const logging::Logger& logger_;
 
-#ifdef USE_EIGEN_THREADPOOL
-  Eigen::NonBlockingThreadPool& ttp_;
-#else
-  TaskThreadPool& ttp_;
-#endif
+  concurrency::ThreadPool* ttp_;
 
   int seq_length_;
   int batch_size_;
@@ -321,6 +312,8 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   AllocatorPtr alloc;
   status = context.GetTempSpaceAllocator(&alloc);
   ORT_RETURN_IF_ERROR(status);
+
+  concurrency::ThreadPool* ttp = context.GetOperatorThreadPool();
   gsl::span<const T> input_weights = W.DataAsSpan<T>();
   gsl::span<const T> recurrent_weights = R.DataAsSpan<T>();
   gsl::span<const T> bias = B != nullptr ? B->DataAsSpan<T>() : gsl::span<const T>();
@@ -383,81 +376,50 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
     gsl::span<T> hidden_output_2 = hidden_output.subspan(hidden_output_size_per_direction,
                                                          hidden_output_size_per_direction);
 
-#if defined(USE_MLAS) && !defined(USE_OPENMP)
-#ifdef USE_EIGEN_THREADPOOL
-    auto fn =
-#else
-    std::packaged_task<void()> task_fw{
-#endif
-        [&]() {
-#endif  // USE_MLAS && ! USE_OPENMP
-          std::unique_ptr<detail::UniDirectionalGru<T>> fw = std::make_unique<detail::UniDirectionalGru<T>>(
-              alloc, logger,
-              seq_length, batch_size, input_size, hidden_size_, linear_before_reset_, Direction::kForward,
-              bias_1, initial_hidden_1,
-              activation_funcs_.Entries()[0],
-              activation_funcs_.Entries()[1],
-              clip_, ttp_);
-          fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1);
-
-#if defined(USE_MLAS) && !defined(USE_OPENMP)
-#ifndef USE_EIGEN_THREADPOOL
-        }
-  };
-  auto task_results_fw = task_fw.get_future();
-  ttp_.RunTask(std::move(task_fw));
-#else
-        };
-    OrtCondVar cv;
-    OrtMutex lock;
-    bool done = false;
-
-    ttp_.Schedule([&]() {
-      fn();
-      auto ul = std::unique_lock<OrtMutex>(lock);
-      done = true;
-      cv.notify_one();
-    });
-#endif  // USE_EIGEN_THREADPOOL
-#endif  // USE_MLAS && ! USE_OPENMP
-
-  std::unique_ptr<detail::UniDirectionalGru<T>> bw = std::make_unique<detail::UniDirectionalGru<T>>(
-      alloc, logger,
-      seq_length, batch_size, input_size, hidden_size_, linear_before_reset_, Direction::kReverse,
-      bias_2, initial_hidden_2,
-      activation_funcs_.Entries()[2],
-      activation_funcs_.Entries()[3],
-      clip_, ttp_);
-  bw->Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2, output_2, hidden_output_2);
-
-#if defined(USE_MLAS) && !defined(USE_OPENMP)
-#ifdef USE_EIGEN_THREADPOOL
-  auto ul = std::unique_lock<OrtMutex>(lock);
-  if (!done) cv.wait(ul);
-#else
-    task_results_fw.get();
-#endif
-#endif  // USE_MLAS && ! USE_OPENMP
-}  // namespace onnxruntime
-else {
-  std::unique_ptr<detail::UniDirectionalGru<T>> gru_p = std::make_unique<detail::UniDirectionalGru<T>>(
-      alloc, logger,
-      seq_length, batch_size, input_size, hidden_size_, linear_before_reset_, direction_,
-      bias_1, initial_hidden_1,
-      activation_funcs_.Entries()[0],
-      activation_funcs_.Entries()[1],
-      clip_, ttp_);
-
-  gru_p->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1);
-}
+    // run the forward and reverse directions concurrently. each direction can also use the thread pool
+    // for its own batch level parallelism.
+    auto compute_direction = [&](int32_t direction_index) {
+      if (direction_index == 0) {
+        std::unique_ptr<detail::UniDirectionalGru<T>> fw = std::make_unique<detail::UniDirectionalGru<T>>(
+            alloc, logger,
+            seq_length, batch_size, input_size, hidden_size_, linear_before_reset_, Direction::kForward,
+            bias_1, initial_hidden_1,
+            activation_funcs_.Entries()[0],
+            activation_funcs_.Entries()[1],
+            clip_, ttp);
+        fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1);
+      } else {
+        std::unique_ptr<detail::UniDirectionalGru<T>> bw = std::make_unique<detail::UniDirectionalGru<T>>(
+            alloc, logger,
+            seq_length, batch_size, input_size, hidden_size_, linear_before_reset_, Direction::kReverse,
+            bias_2, initial_hidden_2,
+            activation_funcs_.Entries()[2],
+            activation_funcs_.Entries()[3],
+            clip_, ttp);
+        bw->Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2, output_2, hidden_output_2);
+      }
+    };
+
+    concurrency::ThreadPool::TryParallelFor(ttp, 2, compute_direction);
+  } else {
+    std::unique_ptr<detail::UniDirectionalGru<T>> gru_p = std::make_unique<detail::UniDirectionalGru<T>>(
+        alloc, logger,
+        seq_length, batch_size, input_size, hidden_size_, linear_before_reset_, direction_,
+        bias_1, initial_hidden_1,
+        activation_funcs_.Entries()[0],
+        activation_funcs_.Entries()[1],
+        clip_, ttp);
+
+    gru_p->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1);
+  }
 
-if (!output.empty())
-  DumpMatrix("Y", output.data(), seq_length* num_directions_* batch_size, hidden_size_);
+  if (!output.empty())
+    DumpMatrix("Y", output.data(), seq_length * num_directions_ * batch_size, hidden_size_);
 
-DumpMatrix("Y_h", hidden_output.data(), num_directions_* batch_size, hidden_size_);
+  DumpMatrix("Y_h", hidden_output.data(), num_directions_ * batch_size, hidden_size_);
 
-return Status::OK();
-}  // namespace onnxruntime
+  return Status::OK();
+}
 
 //
 // Implementation of internal helper code
@@ -477,11 +439,7 @@ UniDirectionalGru<T>::UniDirectionalGru(AllocatorPtr allocator,
                                         const ActivationFuncs::Entry& activation_func_f,
                                         const ActivationFuncs::Entry& activation_func_g,
                                         const float clip,
-#ifdef USE_EIGEN_THREADPOOL
-                                        Eigen::NonBlockingThreadPool& ttp)
-#else
-                                        TaskThreadPool& ttp)
-#endif
+                                        concurrency::ThreadPool* ttp)
     : allocator_(allocator),
       logger_(logger),
       ttp_(ttp),
@@ -642,7 +600,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
     if (batch_size_ % hidden_num_threads_ != 0)
       fused_hidden_rows++;
 
-    // lambda executed by Eigen::NonBlockingThreadPool
+    // lambda executed by concurrency::ThreadPool
     auto hidden_gemm_and_activations = [&](const int row) {
       //handling boundaries
       int local_fused_hidden_rows = fused_hidden_rows;
@@ -1109,10 +1067,8 @@ void UniDirectionalGru<T>::AllocateBuffers() {
 
 template <typename T>
 void UniDirectionalGru<T>::SetNumThreads() {
-  int threads = std::thread::hardware_concurrency() - 1;
-
-  if (threads < 1)
-    threads = 1;
+  // the calling thread takes part in the work so the parallelism is one more than the pool size
+  int threads = ttp_ != nullptr ? ttp_->NumThreads() + 1 : 1;
 
   hidden_num_threads_ = threads;
   batch_parallel_ = false;
@@ -65,6 +65,53 @@ ORT_API(void, OrtDisableCpuMemArena, _In_ OrtSessionOptions* options) {
   options->value.enable_cpu_mem_arena = false;
 }
 
+ORT_API(void, OrtEnableCpuMemArenaThreadCache, _In_ OrtSessionOptions* options) {
+  options->value.cpu_mem_arena_settings.enable_thread_cache = true;
+}
+
+ORT_API(void, OrtDisableCpuMemArenaThreadCache, _In_ OrtSessionOptions* options) {
+  options->value.cpu_mem_arena_settings.enable_thread_cache = false;
+}
+
+ORT_API(int, OrtSetCpuMemArenaSettings, _In_ OrtSessionOptions* options, size_t initial_chunk_size_bytes,
+        int growth_factor, size_t max_retained_bytes) {
+  if (initial_chunk_size_bytes == 0 || growth_factor < 1) return -1;
+  auto& settings = options->value.cpu_mem_arena_settings;
+  settings.initial_chunk_size_bytes = initial_chunk_size_bytes;
+  settings.growth_factor = growth_factor;
+  settings.max_retained_bytes = max_retained_bytes;
+  return 0;
+}
+
+// shrink the arenas once the session has been idle for timeout_ms. 0 to disable.
+ORT_API(void, OrtSetArenaShrinkIdleTimeout, _In_ OrtSessionOptions* options, unsigned int timeout_ms) {
+  options->value.arena_shrink_idle_timeout_ms = timeout_ms;
+}
+
+// use the external data of CPU initializers directly by mapping the data files into memory
+ORT_API(void, OrtEnableMmapForExternalInitializers, _In_ OrtSessionOptions* options) {
+  options->value.use_mmap_for_external_initializers = true;
+}
+
+ORT_API(void, OrtDisableMmapForExternalInitializers, _In_ OrtSessionOptions* options) {
+  options->value.use_mmap_for_external_initializers = false;
+}
+
+// share the CPU initializers with the other sessions in the process that use the same weights
+ORT_API(void, OrtEnableSharedInitializers, _In_ OrtSessionOptions* options) {
+  options->value.share_initializers = true;
+}
+
+ORT_API(void, OrtDisableSharedInitializers, _In_ OrtSessionOptions* options) {
+  options->value.share_initializers = false;
+}
+
+// save the transformed model to the file, or load it from there if it's for the same model and providers
+ORT_API(void, OrtSetOptimizedModelFilePath, _In_ OrtSessionOptions* options,
+        _In_ const ORTCHAR_T* optimized_model_filepath) {
+  options->value.optimized_model_filepath = optimized_model_filepath;
+}
+
 ///< logger id to use for session output
 ORT_API(void, OrtSetSessionLogId, _In_ OrtSessionOptions* options, const char* logid) {
   options->value.session_logid = logid;
@@ -82,6 +129,13 @@ ORT_API(int, OrtSetSessionThreadPoolSize, _In_ OrtSessionOptions* options, int s
   return 0;
 }
 
+///How many threads in the intra-op thread pool shared by the kernels of the session.
+ORT_API(int, OrtSetIntraOpNumThreads, _In_ OrtSessionOptions* options, int intra_op_num_threads) {
+  if (intra_op_num_threads < 0) return -1;
+  options->value.intra_op_num_threads = intra_op_num_threads;
+  return 0;
+}
+
 ORT_API(void, OrtAppendCustomOpLibPath, _In_ OrtSessionOptions* options, const char* lib_path) {
   options->custom_op_paths.emplace_back(lib_path);
 }
@@ -7,6 +7,9 @@
 
 #include "core/session/inference_session.h"
 
+#include <atomic>
+#include <chrono>
+#include <exception>
 #include <memory>
 #include <sstream>
 #include <unordered_set>
@@ -14,12 +17,15 @@
 
 #include "core/common/logging/logging.h"
 #include "core/common/task_thread_pool.h"
+#include "core/common/threadpool.h"
+#include "core/platform/env.h"
 #include "core/platform/notification.h"
 #include "core/platform/ort_mutex.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/graph_utils.h"
 #include "core/graph/model.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/arena.h"
 #include "core/framework/customregistry.h"
 #include "core/framework/environment.h"
 #include "core/framework/error_code_helper.h"
@@ -48,6 +54,8 @@
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/CustomOpsLoader.h"
 #include "core/session/IOBinding.h"
+#include "core/session/optimized_model.h"
+#include "core/session/prepared_run.h"
 
 #ifdef USE_EIGEN_THREADPOOL
 #include <unsupported/Eigen/CXX11/ThreadPool>
@@ -224,6 +232,18 @@ class InferenceSession::Impl {
     }
 
     session_state_.SetThreadPool(thread_pool_.get());
+
+    // the intra-op threadpool is shared by all kernels in the session. the thread calling into a kernel takes part
+    // in the work, so the pool needs one thread less than the requested parallelism.
+    int intra_op_num_threads = session_options_.intra_op_num_threads == 0
+                                   ? Env::Default().GetNumCpuCores()
+                                   : session_options_.intra_op_num_threads;
+    if (intra_op_num_threads > 1) {
+      intra_op_thread_pool_ = std::make_unique<concurrency::ThreadPool>("intra_op_thread_pool",
+                                                                        intra_op_num_threads - 1);
+    }
+
+    session_state_.SetIntraOpThreadPool(intra_op_thread_pool_.get());
     session_profiler_.Initialize(session_logger_);
     session_state_.SetProfiler(session_profiler_);
     if (session_options.enable_profiling) {
@@ -231,6 +251,18 @@ class InferenceSession::Impl {
     }
   }
 
+  ~Impl() {
+    if (arena_shrink_thread_.joinable()) {
+      {
+        std::lock_guard<OrtMutex> lock(arena_shrink_mutex_);
+        stop_arena_shrink_ = true;
+      }
+
+      arena_shrink_cv_.notify_one();
+      arena_shrink_thread_.join();
+    }
+  }
+
   common::Status RegisterExecutionProvider(std::unique_ptr<IExecutionProvider> p_exec_provider) {
     if (p_exec_provider == nullptr) {
       return Status(common::ONNXRUNTIME, common::FAIL, "Received nullptr for exec provider");
@@ -477,6 +509,7 @@ class InferenceSession::Impl {
         auto subgraph_session_state = std::make_unique<SessionState>(execution_providers_);
         subgraph_session_state->SetProfiler(session_profiler_);
         subgraph_session_state->SetLogger(*session_logger_);
+        subgraph_session_state->SetIntraOpThreadPool(intra_op_thread_pool_.get());
 
         // recurse
         ORT_RETURN_IF_ERROR(CreateSubgraphSessionState(*subgraph, *subgraph_session_state));
@@ -494,30 +527,65 @@ class InferenceSession::Impl {
   /// @param graph The graph to iterate
   /// @param session_state The SessionState instance for 'graph'.
   /// @remarks We pass in graph and session_state so we can handled nested subgraphs in the future
+  /// @remarks The subgraphs are independent of each other, so they are initialized in parallel using the
+  /// intra-op thread pool. The error of the first subgraph that failed, in node order, is returned.
   common::Status InitializeSubgraphSessions(Graph& graph, SessionState& session_state) {
+    struct SubgraphInfo {
+      Node* node;
+      Graph* subgraph;
+      SessionState* session_state;
+    };
+
+    std::vector<SubgraphInfo> subgraphs;
     for (auto& node : graph.Nodes()) {
       for (const auto& entry : node.GetAttributeNameToMutableSubgraphMap()) {
-        auto& name = entry.first;
-        Graph& subgraph = *entry.second;
-
-        SessionState* subgraph_session_state = session_state.GetMutableSubgraphSessionState(node.Index(), name);
+        SessionState* subgraph_session_state = session_state.GetMutableSubgraphSessionState(node.Index(),
+                                                                                            entry.first);
         ORT_ENFORCE(subgraph_session_state, "CreateSubgraphSessionState should have created an entry earlier.");
+        subgraphs.push_back({&node, entry.second, subgraph_session_state});
+      }
+    }
 
+    std::vector<Status> statuses(subgraphs.size());
+    std::vector<std::exception_ptr> exceptions(subgraphs.size());
+
+    auto initialize_subgraph = [this, &subgraphs, &statuses, &exceptions](int32_t i) {
+      const auto& info = subgraphs[i];
+      try {
         // setup everything required to execute the subgraph and save it in subgraph_session_state
-        SessionStateInitializer initializer{model_location_, subgraph, *subgraph_session_state, execution_providers_,
-                                            kernel_registry_manager_};
+        SessionStateInitializer initializer{model_location_, *info.subgraph, *info.session_state,
+                                            execution_providers_, kernel_registry_manager_};
 
-        ORT_RETURN_IF_ERROR(initializer.CreatePlan(node.ImplicitInputDefs(),
-                                                   session_options_.enable_sequential_execution));
+        statuses[i] = initializer.CreatePlan(info.node->ImplicitInputDefs(),
+                                             session_options_.enable_sequential_execution);
 
-        ORT_RETURN_IF_ERROR(initializer.InitializeAndSave(&node.ImplicitInputDefs()));
+        if (statuses[i].IsOK()) {
+          statuses[i] = initializer.InitializeAndSave(&info.node->ImplicitInputDefs(),
+                                                      session_options_.use_mmap_for_external_initializers,
+                                                      session_options_.share_initializers);
+        }
 
         // LOGS(*session_logger_, VERBOSE) << std::make_pair(subgraph_info.session_state->GetExecutionPlan(),
         //                                                   &*subgraph_info.session_state);
 
         // recurse
-        ORT_RETURN_IF_ERROR(InitializeSubgraphSessions(subgraph, *subgraph_session_state));
+        if (statuses[i].IsOK()) {
+          statuses[i] = InitializeSubgraphSessions(*info.subgraph, *info.session_state);
+        }
+      } catch (...) {
+        exceptions[i] = std::current_exception();
       }
+    };
+
+    concurrency::ThreadPool::TryParallelFor(intra_op_thread_pool_.get(), static_cast<int32_t>(subgraphs.size()),
+                                            initialize_subgraph);
+
+    for (size_t i = 0; i < subgraphs.size(); ++i) {
+      if (exceptions[i] != nullptr) {
+        std::rethrow_exception(exceptions[i]);
+      }
+
+      ORT_RETURN_IF_ERROR(statuses[i]);
     }
 
     return Status::OK();
@@ -543,11 +611,29 @@ class InferenceSession::Impl {
       // Register default CPUExecutionProvider if user didn't provide it through the Register() calls
       if (!execution_providers_.Get(onnxruntime::kCpuExecutionProvider)) {
         LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
-        CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+        CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena,
+                                     session_options_.cpu_mem_arena_settings};
         ORT_RETURN_IF_ERROR(execution_providers_.Add(onnxruntime::kCpuExecutionProvider,
                                                      std::make_unique<CPUExecutionProvider>(epi)));
       }
 
+      // use the optimized model saved by a previous session if it was created from the same model for the same
+      // execution providers and graph transformers. the kernels and schemas of custom registries can't be part of
+      // the key, so the optimized model isn't used or saved if there are any.
+      std::string optimized_model_key;
+      bool use_optimized_model = false;
+      bool save_optimized_model = false;
+      if (!session_options_.optimized_model_filepath.empty()) {
+        if (HasLocalSchema()) {
+          LOGS(*session_logger_, INFO) << "The optimized model is not used as custom registries are registered.";
+        } else {
+          optimized_model_key = optimized_model::CalculateKey(model_->MainGraph(), execution_providers_,
+                                                              graph_transformation_mgr_);
+          use_optimized_model = LoadOptimizedModel(optimized_model_key);
+          save_optimized_model = !use_optimized_model;
+        }
+      }
+
       onnxruntime::Graph& graph = model_->MainGraph();
 
       // Collect the kernel registries from execution provider instances;
@@ -566,24 +652,36 @@ class InferenceSession::Impl {
       // create SessionState for subgraphs as it's needed by the transformers
       ORT_RETURN_IF_ERROR(CreateSubgraphSessionState(graph, session_state_));
 
-      // apply any transformations to the main graph and any subgraphs
-      ORT_RETURN_IF_ERROR(TransformGraph(graph, graph_transformation_mgr_,
-                                         execution_providers_, kernel_registry_manager_,
-                                         insert_cast_transformer_,
-                                         session_state_));
+      // apply any transformations to the main graph and any subgraphs.
+      // the optimized model already has them applied, and the nodes assigned to the execution providers.
+      if (!use_optimized_model) {
+        ORT_RETURN_IF_ERROR(TransformGraph(graph, graph_transformation_mgr_,
+                                           execution_providers_, kernel_registry_manager_,
+                                           insert_cast_transformer_,
+                                           session_state_));
+      }
 
       // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
       ORT_RETURN_IF_ERROR(graph.Resolve());
 
+      if (save_optimized_model) {
+        SaveOptimizedModel(optimized_model_key);
+      }
+
       ORT_RETURN_IF_ERROR(session_initializer.CreatePlan({}, session_options_.enable_sequential_execution));
-      ORT_RETURN_IF_ERROR(session_initializer.InitializeAndSave(nullptr));
+      ORT_RETURN_IF_ERROR(session_initializer.InitializeAndSave(
+          nullptr, session_options_.use_mmap_for_external_initializers, session_options_.share_initializers));
 
       // handle any subgraphs
       ORT_RETURN_IF_ERROR(InitializeSubgraphSessions(graph, session_state_));
 
       session_state_.CalculateNodeIndexInfo();
 
-      is_inited_ = true;
+      if (session_options_.arena_shrink_idle_timeout_ms > 0) {
+        arena_shrink_thread_ = std::thread([this]() { ShrinkArenasWhenIdle(); });
+      }
+
+      is_inited_.store(true, std::memory_order_release);
 
       LOGS(*session_logger_, INFO) << "Session successfully initialized.";
     } catch (const NotImplementedException& ex) {
@@ -603,6 +701,43 @@ class InferenceSession::Impl {
     return status;
   }
 
+  // replace the loaded model with the optimized model from SessionOptions::optimized_model_filepath if it's valid
+  // for the loaded model and the registered execution providers. returns true if the model was replaced.
+  bool LoadOptimizedModel(const std::string& key) {
+    std::shared_ptr<onnxruntime::Model> optimized;
+    auto status = optimized_model::Load(session_options_.optimized_model_filepath, key, execution_providers_,
+                                        HasLocalSchema() ? &custom_schema_registries_ : nullptr, optimized);
+    if (!status.IsOK()) {
+      LOGS(*session_logger_, INFO) << "Optimized model was not loaded. " << status.ErrorMessage();
+      return false;
+    }
+
+    if (!optimized) {
+      LOGS(*session_logger_, INFO) << "Optimized model was created from a different model or for different "
+                                   << "execution providers or graph transformers and will be replaced.";
+      return false;
+    }
+
+    // the input and output defs refer to the graph of the model being replaced
+    model_ = optimized;
+    SaveInputOutputDefs(model_->MainGraph());
+
+    LOGS(*session_logger_, INFO) << "Using the optimized model.";
+    return true;
+  }
+
+  // save the transformed model to SessionOptions::optimized_model_filepath. failure is not an error as the session
+  // can still be used.
+  void SaveOptimizedModel(const std::string& key) {
+    bool saved = false;
+    auto status = optimized_model::Save(*model_, session_options_.optimized_model_filepath, key, saved);
+    if (!status.IsOK()) {
+      LOGS(*session_logger_, WARNING) << "Failed to save the optimized model. " << status.ErrorMessage();
+    } else if (!saved) {
+      LOGS(*session_logger_, INFO) << "The optimized model can't be saved as it contains subgraphs or fused nodes.";
+    }
+  }
+
   int GetCurrentNumRuns() const {
     return current_num_runs_.load();
   }
@@ -729,38 +864,22 @@ class InferenceSession::Impl {
     return common::Status::OK();
   }
 
-  Status Run(const RunOptions& run_options,
-             const std::vector<std::string>& feed_names,
-             const std::vector<MLValue>& feeds,
-             const std::vector<std::string>& output_names,
-             std::vector<MLValue>* p_fetches) {
-    auto tp = session_profiler_.StartTime();
+  // Execute the graph using either feeds_fetches_manager, which will have the device copy info cached in it
+  // on success, or cached_feeds_fetches_manager, which already has cached device copy info.
+  Status ExecuteGraph(const RunOptions& run_options,
+                      FeedsFetchesManager* feeds_fetches_manager,
+                      const FeedsFetchesManager* cached_feeds_fetches_manager,
+                      const std::vector<MLValue>& feeds,
+                      std::vector<MLValue>& fetches) {
     Status retval = Status::OK();
 
-    try {
-      {
-        std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
-        if (!is_inited_) {
-          LOGS(*session_logger_, ERROR) << "Session was not initialized";
-          retval = Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
-        }
-      }
-
-      ORT_RETURN_IF_ERROR(ValidateInputs(feed_names, feeds));
-
-      // if the output vector is non-empty, ensure that its the same size as the output_names
-      ORT_RETURN_IF_ERROR(ValidateOutputs(output_names, p_fetches));
-
-      FeedsFetchesInfo info(feed_names, output_names);
-      ORT_RETURN_IF_ERROR(info.SetMLValueIdxs(session_state_.GetMLValueNameIdxMap()));
-      FeedsFetchesManager feeds_fetches_manager{std::move(info)};
-
-      if (!run_options.run_tag.empty()) {
-        LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
-      }
+    if (!run_options.run_tag.empty()) {
+      LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
+    }
 
-      ++current_num_runs_;
+    ++current_num_runs_;
 
+    try {
       // TODO should we add this exec to the list of executors? i guess its not needed now?
 
       // scope of owned_run_logger is just the call to Execute.
@@ -775,11 +894,17 @@ class InferenceSession::Impl {
       }
 
       // execute the graph
-      ORT_CHECK_AND_SET_RETVAL(
-          utils::ExecuteGraph(session_state_, feeds_fetches_manager, feeds, *p_fetches, {},
-                              session_options_.enable_sequential_execution, run_options.terminate, run_logger,
-                              false));
-
+      if (cached_feeds_fetches_manager != nullptr) {
+        ORT_CHECK_AND_SET_RETVAL(
+            utils::ExecuteGraphWithCachedInfo(session_state_, *cached_feeds_fetches_manager, feeds, fetches, {},
+                                              session_options_.enable_sequential_execution, run_options.terminate,
+                                              run_logger));
+      } else {
+        ORT_CHECK_AND_SET_RETVAL(
+            utils::ExecuteGraph(session_state_, *feeds_fetches_manager, feeds, fetches, {},
+                                session_options_.enable_sequential_execution, run_options.terminate, run_logger,
+                                true));
+      }
     } catch (const std::exception& e) {
       retval = Status(common::ONNXRUNTIME, common::FAIL, e.what());
     } catch (...) {
@@ -792,6 +917,113 @@ class InferenceSession::Impl {
     }
 
     --current_num_runs_;
+
+    // return the memory of the arenas that isn't in use, now if requested by the run, or once the session is idle
+    if (run_options.shrink_arenas) {
+      ShrinkArenas();
+    }
+
+    if (arena_shrink_thread_.joinable()) {
+      std::lock_guard<OrtMutex> lock(arena_shrink_mutex_);
+      last_run_end_ = std::chrono::steady_clock::now();
+      arena_shrink_pending_ = true;
+      arena_shrink_cv_.notify_one();
+    }
+
+    return retval;
+  }
+
+  // Return the memory held by the arenas of the execution providers that isn't in use.
+  void ShrinkArenas() {
+    size_t released_bytes = 0;
+    for (auto& xp : execution_providers_) {
+      released_bytes += xp->ShrinkArenas();
+    }
+
+    if (released_bytes > 0) {
+      LOGS(*session_logger_, INFO) << "Released " << released_bytes << " bytes of arena memory.";
+    }
+  }
+
+  // Shrink the arenas once no Run has been active for session_options_.arena_shrink_idle_timeout_ms.
+  // Runs on arena_shrink_thread_ until the session is destroyed.
+  void ShrinkArenasWhenIdle() {
+    const auto timeout = std::chrono::milliseconds(session_options_.arena_shrink_idle_timeout_ms);
+
+    std::unique_lock<OrtMutex> lock(arena_shrink_mutex_);
+    while (!stop_arena_shrink_) {
+      if (!arena_shrink_pending_) {
+        arena_shrink_cv_.wait(lock);
+        continue;
+      }
+
+      // wait for the timeout from the end of the last run. a run that ends in the meantime moves the deadline.
+      auto now = std::chrono::steady_clock::now();
+      if (now < last_run_end_ + timeout) {
+        arena_shrink_cv_.wait_for(lock, last_run_end_ + timeout - now);
+        continue;
+      }
+
+      // a run that is still active sets arena_shrink_pending_ again when it ends
+      arena_shrink_pending_ = false;
+      if (current_num_runs_ == 0) {
+        lock.unlock();
+        ShrinkArenas();
+        lock.lock();
+      }
+    }
+  }
+
+  Status Run(const RunOptions& run_options,
+             const std::vector<std::string>& feed_names,
+             const std::vector<MLValue>& feeds,
+             const std::vector<std::string>& output_names,
+             std::vector<MLValue>* p_fetches) {
+    auto tp = session_profiler_.StartTime();
+    Status retval = Status::OK();
+
+    try {
+      // is_inited_ is only ever set once, by Initialize, so there's no need to take session_mutex_ here
+      if (!is_inited_.load(std::memory_order_acquire)) {
+        LOGS(*session_logger_, ERROR) << "Session was not initialized";
+        return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+      }
+
+      ORT_RETURN_IF_ERROR(ValidateInputs(feed_names, feeds));
+
+      // if the output vector is non-empty, ensure that its the same size as the output_names
+      ORT_RETURN_IF_ERROR(ValidateOutputs(output_names, p_fetches));
+
+      // re-use the MLValue indexes and device copy info from a previous Run with the same feed and output names
+      // if the feeds and any pre-allocated fetches are on the same devices as they were for that Run.
+      const FeedsFetchesManager* cached_feeds_fetches_manager =
+          session_state_.GetCachedFeedsFetchesManager(feed_names, output_names);
+      if (cached_feeds_fetches_manager != nullptr &&
+          !cached_feeds_fetches_manager->MatchesFeedsFetchesLocations(feeds, *p_fetches)) {
+        cached_feeds_fetches_manager = nullptr;
+      }
+
+      std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager;
+      if (cached_feeds_fetches_manager == nullptr) {
+        ORT_RETURN_IF_ERROR(FeedsFetchesManager::Create(feed_names, output_names,
+                                                        session_state_.GetMLValueNameIdxMap(),
+                                                        feeds_fetches_manager));
+        feeds_fetches_manager->SetFeedsFetchesLocations(feeds, *p_fetches);
+      }
+
+      retval = ExecuteGraph(run_options, feeds_fetches_manager.get(), cached_feeds_fetches_manager,
+                            feeds, *p_fetches);
+
+      // cache for use by the next Run with the same feed and output names
+      if (retval.IsOK() && feeds_fetches_manager) {
+        session_state_.CacheFeedsFetchesManager(std::move(feeds_fetches_manager));
+      }
+    } catch (const std::exception& e) {
+      retval = Status(common::ONNXRUNTIME, common::FAIL, e.what());
+    } catch (...) {
+      retval = Status(common::ONNXRUNTIME, common::RUNTIME_EXCEPTION, "Encountered unknown exception in Run()");
+    }
+
     if (session_profiler_.FEnabled()) {
       session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run", tp);
     }
@@ -838,15 +1070,105 @@ class InferenceSession::Impl {
     return std::make_pair(common::Status::OK(), &output_def_list_);
   }
 
-  common::Status NewIOBinding(std::unique_ptr<IOBinding>* io_binding) {
-    {
-      std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
-      if (!is_inited_) {
-        LOGS(*session_logger_, ERROR) << "Session was not initialized";
-        return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  common::Status NewPreparedRun(const std::vector<std::string>& feed_names,
+                                const std::vector<std::string>& output_names,
+                                std::unique_ptr<PreparedRun>* prepared_run) {
+    if (!is_inited_.load(std::memory_order_acquire)) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+
+    // validate the names once. the feed types are checked on each Run as the values can change.
+    std::vector<MLDataType> feed_types;
+    feed_types.reserve(feed_names.size());
+    for (const auto& name : feed_names) {
+      auto iter = input_def_map_.find(name);
+      if (iter == input_def_map_.end()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Feed Input Name:", name);
+      }
+
+      feed_types.push_back(utils::GetMLDataType(*iter->second));
+    }
+
+    for (const auto* arg : required_input_def_list_) {
+      if (!arg->Name().empty() &&
+          std::find(feed_names.cbegin(), feed_names.cend(), arg->Name()) == feed_names.cend()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Missing required input: ", arg->Name());
       }
     }
 
+    std::vector<MLValue> fetches;
+    ORT_RETURN_IF_ERROR(ValidateOutputs(output_names, &fetches));
+
+    std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager;
+    ORT_RETURN_IF_ERROR(FeedsFetchesManager::Create(feed_names, output_names, session_state_.GetMLValueNameIdxMap(),
+                                                    feeds_fetches_manager));
+
+    // private constructor, can't use make_unique
+    *prepared_run = std::unique_ptr<PreparedRun>(new PreparedRun(std::move(feeds_fetches_manager),
+                                                                 std::move(feed_types)));
+    return Status::OK();
+  }
+
+  common::Status Run(const RunOptions& run_options, PreparedRun& prepared_run) {
+    auto tp = session_profiler_.StartTime();
+    Status retval = Status::OK();
+
+    try {
+      const auto& feeds = prepared_run.feeds_;
+      auto& fetches = prepared_run.fetches_;
+      const auto& feed_types = prepared_run.feed_types_;
+
+      if (feeds.size() != feed_types.size() || fetches.size() != prepared_run.GetOutputNames().size()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "The number of feeds and fetches must match the names the PreparedRun was created with.");
+      }
+
+      for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+        if (feeds[i].IsTensor()) {
+          ORT_RETURN_IF_ERROR(CheckTypes(feeds[i].Get<Tensor>().DataType(),
+                                         feed_types[i]->AsTensorType()->GetElementType()));
+        } else {
+          ORT_RETURN_IF_ERROR(CheckTypes(feeds[i].Type(), feed_types[i]));
+        }
+      }
+
+      auto& feeds_fetches_manager = *prepared_run.feeds_fetches_manager_;
+      const auto copy_checks_status = feeds_fetches_manager.GetDeviceCopyChecks().status;
+
+      if (copy_checks_status == DeviceCopyCheck::Unknown) {
+        // first Run. cache the device copy info for these feeds and fetches.
+        feeds_fetches_manager.SetFeedsFetchesLocations(feeds, fetches);
+        retval = ExecuteGraph(run_options, &feeds_fetches_manager, nullptr, feeds, fetches);
+      } else if (feeds_fetches_manager.MatchesFeedsFetchesLocations(feeds, fetches)) {
+        retval = ExecuteGraph(run_options, nullptr, &feeds_fetches_manager, feeds, fetches);
+      } else {
+        // the feeds or fetches moved to different devices so the cached copy info can't be used.
+        std::unique_ptr<FeedsFetchesManager> new_feeds_fetches_manager;
+        ORT_RETURN_IF_ERROR(FeedsFetchesManager::Create(prepared_run.GetFeedNames(), prepared_run.GetOutputNames(),
+                                                        session_state_.GetMLValueNameIdxMap(),
+                                                        new_feeds_fetches_manager));
+        retval = ExecuteGraph(run_options, new_feeds_fetches_manager.get(), nullptr, feeds, fetches);
+      }
+    } catch (const std::exception& e) {
+      retval = Status(common::ONNXRUNTIME, common::FAIL, e.what());
+    } catch (...) {
+      retval = Status(common::ONNXRUNTIME, common::RUNTIME_EXCEPTION, "Encountered unknown exception in Run()");
+    }
+
+    if (session_profiler_.FEnabled()) {
+      session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run", tp);
+    }
+
+    return retval;
+  }
+
+  common::Status NewIOBinding(std::unique_ptr<IOBinding>* io_binding) {
+    if (!is_inited_.load(std::memory_order_acquire)) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+
     // private constructor, can't use make_unique
     *io_binding = std::unique_ptr<IOBinding>(new IOBinding(session_state_));
     return Status::OK();
@@ -906,6 +1228,20 @@ class InferenceSession::Impl {
     model_metadata_.custom_metadata_map = model.MetaData();
     model_metadata_.graph_name = graph.Name();
 
+    SaveInputOutputDefs(graph);
+
+    VLOGS(*session_logger_, 1) << "Done saving model metadata";
+    return common::Status::OK();
+  }
+
+  void SaveInputOutputDefs(const onnxruntime::Graph& graph) {
+    required_input_def_list_.clear();
+    required_model_input_names_.clear();
+    input_def_map_.clear();
+    model_input_names_.clear();
+    output_def_list_.clear();
+    model_output_names_.clear();
+
     // save required inputs
     const auto& required_inputs = graph.GetInputs();  // inputs excluding initializers
     required_input_def_list_.reserve(required_inputs.size());
@@ -932,9 +1268,6 @@ class InferenceSession::Impl {
       output_def_list_.push_back(elem);
       model_output_names_.insert(elem->Name());
     }
-
-    VLOGS(*session_logger_, 1) << "Done saving model metadata";
-    return common::Status::OK();
   }
 
   // Create a Logger for a single execution if possible. Otherwise use the default logger.
@@ -1067,12 +1400,24 @@ class InferenceSession::Impl {
   std::unique_ptr<TaskThreadPool> thread_pool_;
 #endif
 
+  // Threadpool shared by the kernels of this session (and its subgraphs) for intra-op parallelism
+  std::unique_ptr<concurrency::ThreadPool> intra_op_thread_pool_;
+
   // Number of concurrently running executors
-  std::atomic<int> current_num_runs_;
+  std::atomic<int> current_num_runs_{0};
+
+  // Thread that shrinks the arenas when the session goes idle, if session_options_.arena_shrink_idle_timeout_ms
+  // is set. It's started by Initialize.
+  std::thread arena_shrink_thread_;
+  OrtMutex arena_shrink_mutex_;
+  OrtCondVar arena_shrink_cv_;
+  std::chrono::steady_clock::time_point last_run_end_;  // GUARDED_BY(arena_shrink_mutex_)
+  bool arena_shrink_pending_ = false;                    // GUARDED_BY(arena_shrink_mutex_)
+  bool stop_arena_shrink_ = false;                       // GUARDED_BY(arena_shrink_mutex_)
 
   mutable onnxruntime::OrtMutex session_mutex_;  // to ensure only one thread can invoke Load/Initialize
   bool is_model_loaded_ = false;                 // GUARDED_BY(session_mutex_)
-  bool is_inited_ = false;                       // GUARDED_BY(session_mutex_)
+  std::atomic<bool> is_inited_{false};           // written under session_mutex_, read lock-free by Run and NewIOBinding
 
   InsertCastTransformer insert_cast_transformer_;
   // The file path of where the model was loaded. e.g. /tmp/test_squeezenet/model.onnx
@@ -1201,6 +1546,16 @@ common::Status InferenceSession::Run(IOBinding& io_binding) {
   return impl_->Run(io_binding);
 }
 
+common::Status InferenceSession::NewPreparedRun(const std::vector<std::string>& feed_names,
+                                                const std::vector<std::string>& output_names,
+                                                std::unique_ptr<PreparedRun>* prepared_run) {
+  return impl_->NewPreparedRun(feed_names, output_names, prepared_run);
+}
+
+common::Status InferenceSession::Run(const RunOptions& run_options, PreparedRun& prepared_run) {
+  return impl_->Run(run_options, prepared_run);
+}
+
 common::Status InferenceSession::LoadCustomOps(const std::vector<std::string>& dso_list) {
   return impl_->LoadCustomOps(dso_list);
 }
@@ -8,6 +8,7 @@
 
 #include "core/common/common.h"
 #include "core/common/status.h"
+#include "core/framework/arena.h"
 #include "core/framework/framework_common.h"
 #include "core/graph/basic_types.h"
 #include "core/common/logging/logging.h"
@@ -30,6 +31,7 @@ struct OrtCustomOpDomain {
 namespace onnxruntime {
 class IExecutionProvider;  // forward decl
 class IOBinding;
+class PreparedRun;
 
 class CustomRegistry;
 
@@ -52,6 +54,15 @@ struct SessionOptions {
   // set this option to false if you don't want it.
   bool enable_cpu_mem_arena = true;
 
+  // settings of the CPU memory arena: the size of its first region, how fast it grows, how much free memory it
+  // keeps, and whether it has per-thread caches of small buffers in front of it so concurrent Run calls and the
+  // parallel executor don't contend on the arena lock for most allocations.
+  ArenaSettings cpu_mem_arena_settings;
+
+  // return the memory of the arenas that isn't in use to the system once no Run has been active for this many
+  // milliseconds. 0 to keep the memory until the session is destroyed.
+  unsigned arena_shrink_idle_timeout_ms = 0;
+
   // the prefix of the profile file. The current time will be appended to the file name.
   std::basic_string<ORTCHAR_T> profile_file_prefix = ORT_TSTR("onnxruntime_profile_");
 
@@ -62,6 +73,25 @@ struct SessionOptions {
 
   // How many threads in the session thread pool.
   int session_thread_pool_size = 0;
+
+  // How many threads in the intra-op thread pool that is shared by all the kernels in the session.
+  // 0 to let onnxruntime choose (number of cores). 1 to run the kernels on the calling thread only.
+  int intra_op_num_threads = 0;
+
+  // use the external data of initializers on CPU directly by mapping the data files into copy-on-write memory,
+  // instead of copying the data into buffers. writes to the data are not written to the files. the mappings are
+  // released when the session is destroyed.
+  bool use_mmap_for_external_initializers = false;
+
+  // share the initializers on CPU with the other sessions in the process that load the same weights from the same
+  // model, so only one copy of each weight is kept in memory. see Environment::GetSharedInitializerStore.
+  bool share_initializers = false;
+
+  // file to save the model to once the graph transforms and partitioning have been applied. if the file already
+  // contains the optimized model for the same model, execution providers and graph transformers, it's used instead
+  // of applying the transforms and partitioning again. models with subgraphs or nodes fused by an execution provider
+  // are not saved, and the file is not used if the session has custom registries.
+  std::basic_string<ORTCHAR_T> optimized_model_filepath;
 };
 
 /**
@@ -215,6 +245,22 @@ class InferenceSession {
   common::Status Run(const RunOptions& run_options, IOBinding& io_binding);
   common::Status Run(IOBinding& io_binding);
 
+  /**
+  * Creates a PreparedRun for repeated calls to Run with the same feed and output names.
+  * The names are validated and mapped to MLValue indexes once, here, instead of on every Run.
+  * See PreparedRun class for more info.
+  */
+  common::Status NewPreparedRun(const std::vector<std::string>& feed_names,
+                                const std::vector<std::string>& output_names,
+                                std::unique_ptr<PreparedRun>* prepared_run);
+
+  /**
+  * Run using the feeds and pre-allocated fetches set in the PreparedRun. The outputs are returned in
+  * PreparedRun::GetFetches().
+  * Multiple threads may call this concurrently as long as each uses a different PreparedRun instance.
+  */
+  common::Status Run(const RunOptions& run_options, PreparedRun& prepared_run);
+
   /**
     * @return pair.first = OK; FAIL otherwise. pair.second is non-NULL when pair.first = OK.
     * @note lifetime of the returned pointer is valid as long as the Session object is live.
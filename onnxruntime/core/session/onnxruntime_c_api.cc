@@ -21,6 +21,7 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/onnxruntime_typeinfo.h"
 #include "core/session/inference_session.h"
+#include "core/session/prepared_run.h"
 #include "core/framework/data_types.h"
 #include "abi_session_options_impl.h"
 
@@ -46,6 +47,11 @@ using namespace onnxruntime;
     if (_status) return _status;      \
   } while (0)
 
+struct OrtPreparedRun {
+  ::onnxruntime::InferenceSession* session;
+  std::unique_ptr<::onnxruntime::PreparedRun> prepared_run;
+};
+
 struct OrtEnv {
  public:
   Environment* value;
@@ -461,6 +467,101 @@ ORT_API_STATUS_IMPL(OrtRun, _In_ OrtSession* sess,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtCreatePreparedRun, _Inout_ OrtSession* sess,
+                    _In_ const char* const* input_names, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len, _Out_ OrtPreparedRun** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> feed_names(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    feed_names[i] = input_names[i];
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+  }
+
+  std::unique_ptr<::onnxruntime::PreparedRun> prepared_run;
+  auto status = session->NewPreparedRun(feed_names, output_names, &prepared_run);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+
+  *out = new OrtPreparedRun{session, std::move(prepared_run)};
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtRunPrepared, _Inout_ OrtPreparedRun* prepared_run, _In_opt_ OrtRunOptions* run_options,
+                    _In_ const OrtValue* const* input, _Inout_ OrtValue** output) {
+  API_IMPL_BEGIN
+  auto& feeds = prepared_run->prepared_run->GetFeeds();
+  auto& fetches = prepared_run->prepared_run->GetFetches();
+  const int queue_id = 0;
+
+  // assigning to the existing MLValue instances only updates their reference counts, so the steady state
+  // doesn't allocate.
+  for (size_t i = 0, end = feeds.size(); i != end; ++i) {
+    auto& mlvalue = feeds[i] = *reinterpret_cast<const ::onnxruntime::MLValue*>(input[i]);
+
+    if (mlvalue.Fence())
+      mlvalue.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+  }
+
+  for (size_t i = 0, end = fetches.size(); i != end; ++i) {
+    if (output[i] != nullptr) {
+      ::onnxruntime::MLValue& value = *reinterpret_cast<::onnxruntime::MLValue*>(output[i]);
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsOutput(onnxruntime::kCpuExecutionProvider, queue_id);
+      fetches[i] = value;
+    } else {
+      fetches[i] = MLValue();
+    }
+  }
+
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = prepared_run->session->Run(op, *prepared_run->prepared_run);
+  } else {
+    status = prepared_run->session->Run(*run_options, *prepared_run->prepared_run);
+  }
+
+  // don't hold on to the caller's values between runs
+  for (auto& feed : feeds) {
+    feed = MLValue();
+  }
+
+  if (!status.IsOK()) {
+    // drop the caller's output values and any partial outputs
+    for (auto& fetch : fetches) {
+      fetch = MLValue();
+    }
+
+    return ToOrtStatus(status);
+  }
+
+  for (size_t i = 0, end = fetches.size(); i != end; ++i) {
+    ::onnxruntime::MLValue& value = fetches[i];
+    if (value.Fence())
+      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    if (output[i] == nullptr) {
+      output[i] = reinterpret_cast<OrtValue*>(new MLValue(value));
+    }
+    value = MLValue();
+  }
+
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtGetTensorMutableData, _In_ OrtValue* value, _Out_ void** output) {
   TENSOR_READWRITE_API_BEGIN
   //TODO: test if it's a string tensor
@@ -1100,3 +1201,4 @@ DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Env, OrtEnv)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Value, MLValue)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(RunOptions, OrtRunOptions)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Session, ::onnxruntime::InferenceSession)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(PreparedRun, OrtPreparedRun)
@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/optimized_model.h"
+
+#include <functional>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include "core/graph/graph_viewer.h"
+#include "core/graph/onnx_protobuf.h"
+
+namespace onnxruntime {
+namespace optimized_model {
+
+// increment if the optimized model format or the way the key is calculated changes
+static constexpr int kFormatVersion = 2;
+
+static constexpr const char* kKeyMetadataName = "onnxruntime.optimized_model.key";
+static constexpr const char* kExecutionProvidersMetadataName = "onnxruntime.optimized_model.execution_providers";
+
+static constexpr char kExecutionProviderSeparator = ';';
+
+static void HashCombine(size_t& seed, size_t value) {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+static size_t HashTensorProto(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  if (!tensor_proto.has_raw_data()) {
+    return std::hash<std::string>{}(tensor_proto.SerializeAsString());
+  }
+
+  // hash the raw data in place to avoid serializing a copy of it
+  size_t hash = std::hash<std::string>{}(tensor_proto.raw_data());
+  HashCombine(hash, std::hash<std::string>{}(tensor_proto.name()));
+  HashCombine(hash, static_cast<size_t>(tensor_proto.data_type()));
+  for (auto dim : tensor_proto.dims()) {
+    HashCombine(hash, std::hash<int64_t>{}(dim));
+  }
+
+  return hash;
+}
+
+std::string CalculateKey(const Graph& graph, const ExecutionProviders& providers,
+                         const GraphTransformerManager& transformers) {
+  size_t hash = std::hash<int>{}(kFormatVersion);
+
+  for (const auto& provider : providers) {
+    HashCombine(hash, std::hash<std::string>{}(provider->Type()));
+  }
+
+  // the order matters as each transformer sees the output of the previous one
+  for (const auto& name : transformers.GetTransformerNames()) {
+    HashCombine(hash, std::hash<std::string>{}(name));
+  }
+  HashCombine(hash, std::hash<unsigned>{}(transformers.Steps()));
+
+  // sort so the key doesn't depend on the iteration order of the unordered maps
+  std::map<std::string, int> domain_to_version{graph.DomainToVersionMap().cbegin(),
+                                               graph.DomainToVersionMap().cend()};
+  for (const auto& entry : domain_to_version) {
+    HashCombine(hash, std::hash<std::string>{}(entry.first));
+    HashCombine(hash, std::hash<int>{}(entry.second));
+  }
+
+  for (const auto* input : graph.GetInputsIncludingInitializers()) {
+    HashCombine(hash, std::hash<std::string>{}(input->Name()));
+  }
+
+  for (const auto* output : graph.GetOutputs()) {
+    HashCombine(hash, std::hash<std::string>{}(output->Name()));
+  }
+
+  ONNX_NAMESPACE::NodeProto node_proto;
+  for (const auto& node : graph.Nodes()) {
+    node_proto.Clear();
+    node.ToProto(node_proto);
+    HashCombine(hash, std::hash<std::string>{}(node_proto.SerializeAsString()));
+  }
+
+  std::map<std::string, const ONNX_NAMESPACE::TensorProto*> initializers{graph.GetAllInitializedTensors().cbegin(),
+                                                                        graph.GetAllInitializedTensors().cend()};
+  for (const auto& entry : initializers) {
+    HashCombine(hash, HashTensorProto(*entry.second));
+  }
+
+  std::ostringstream key;
+  key << std::hex << hash;
+  return key.str();
+}
+
+common::Status Save(Model& model, const std::basic_string<ORTCHAR_T>& file_path, const std::string& key,
+                    bool& saved) {
+  saved = false;
+
+  Graph& graph = model.MainGraph();
+  for (auto& node : graph.Nodes()) {
+    if (node.NodeType() == Node::Type::Fused || !node.GetAttributeNameToMutableSubgraphMap().empty()) {
+      return Status::OK();
+    }
+  }
+
+  // the nodes are saved in topological order, which is the order of the node indexes when the model is loaded.
+  // make sure the nodes are re-serialized in that order, even if the transforms didn't change the graph.
+  graph.SetGraphProtoSyncNeeded();
+
+  std::ostringstream execution_providers;
+  GraphViewer graph_viewer(graph);
+  for (auto node_index : graph_viewer.GetNodesInTopologicalOrder()) {
+    execution_providers << graph.GetNode(node_index)->GetExecutionProviderType() << kExecutionProviderSeparator;
+  }
+
+  model.SetMetaDataProperty(kKeyMetadataName, key);
+  model.SetMetaDataProperty(kExecutionProvidersMetadataName, execution_providers.str());
+
+  ORT_RETURN_IF_ERROR(Model::Save(model, file_path));
+
+  saved = true;
+  return Status::OK();
+}
+
+common::Status Load(const std::basic_string<ORTCHAR_T>& file_path, const std::string& key,
+                    const ExecutionProviders& providers,
+                    const IOnnxRuntimeOpSchemaRegistryList* local_registries,
+                    std::shared_ptr<Model>& model) {
+  model = nullptr;
+
+  std::shared_ptr<Model> optimized_model;
+  ORT_RETURN_IF_ERROR(Model::Load(file_path, optimized_model, local_registries));
+
+  const auto& metadata = optimized_model->MetaData();
+  auto key_entry = metadata.find(kKeyMetadataName);
+  auto providers_entry = metadata.find(kExecutionProvidersMetadataName);
+  if (key_entry == metadata.cend() || key_entry->second != key || providers_entry == metadata.cend()) {
+    return Status::OK();
+  }
+
+  std::vector<std::string> node_providers;
+  std::istringstream execution_providers{providers_entry->second};
+  std::string provider_type;
+  while (std::getline(execution_providers, provider_type, kExecutionProviderSeparator)) {
+    node_providers.push_back(provider_type);
+  }
+
+  Graph& graph = optimized_model->MainGraph();
+  if (node_providers.size() != static_cast<size_t>(graph.MaxNodeIndex())) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "Optimized model has ", graph.MaxNodeIndex(),
+                           " nodes but execution providers for ", node_providers.size());
+  }
+
+  for (int i = 0, end = graph.MaxNodeIndex(); i < end; ++i) {
+    Node* node = graph.GetNode(i);
+    const auto& type = node_providers[i];
+    if (node == nullptr || providers.Get(type) == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "Optimized model has an invalid execution provider of '",
+                             type, "' for node ", i);
+    }
+
+    node->SetExecutionProviderType(type);
+  }
+
+  model = optimized_model;
+  return Status::OK();
+}
+}  // namespace optimized_model
+}  // namespace onnxruntime
@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "core/common/status.h"
+#include "core/framework/execution_providers.h"
+#include "core/framework/path_lib.h"
+#include "core/graph/model.h"
+#include "core/optimizer/graph_transformer_mgr.h"
+
+namespace onnxruntime {
+/**
+  * Save and load a model after the graph transforms and partitioning have been applied to it, so a session for the
+  * same model and execution providers can skip straight to creating the execution plan and kernels.
+  * The saved model contains a key calculated from the original model, the execution providers and the graph
+  * transformers, and the execution provider assigned to each node.
+  * Kernels and schemas from custom registries can't be identified between processes, so the session doesn't use
+  * an optimized model when any are registered.
+  */
+namespace optimized_model {
+
+// Calculate the key for the optimized model from the original graph, before any transforms are applied, and the
+// execution providers and graph transformers registered with the session.
+std::string CalculateKey(const Graph& graph, const ExecutionProviders& providers,
+                         const GraphTransformerManager& transformers);
+
+// Save the fully transformed and partitioned model to file_path.
+// saved is false if the model can't be saved as it has subgraphs, or nodes that were fused by an
+// execution provider.
+common::Status Save(Model& model, const std::basic_string<ORTCHAR_T>& file_path, const std::string& key,
+                    bool& saved);
+
+// Load the optimized model from file_path and restore the execution provider assigned to each node.
+// model is set to nullptr if the saved model was created from a different model or for different
+// execution providers or graph transformers.
+common::Status Load(const std::basic_string<ORTCHAR_T>& file_path, const std::string& key,
+                    const ExecutionProviders& providers,
+                    const IOnnxRuntimeOpSchemaRegistryList* local_registries,
+                    std::shared_ptr<Model>& model);
+}  // namespace optimized_model
+}  // namespace onnxruntime
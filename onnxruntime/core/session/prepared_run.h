@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/data_types.h"
+#include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/ml_value.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+/**
+  * A Run with a fixed set of feed and output names.
+  * The names are validated and mapped to MLValue indexes when the PreparedRun is created, and the device copy
+  * info is cached by the first Run, so subsequent calls do no name based lookups and, if all the outputs are
+  * pre-allocated, no allocations to set up the feeds and fetches.
+  * Usage is as follows:
+  *
+  * InferenceSession session;
+  * session.Load();
+  * session.Initialize();
+  * ...
+  * unique_ptr<PreparedRun> prepared_run;
+  * session.NewPreparedRun({"X"}, {"Y"}, &prepared_run);
+  *
+  * prepared_run->GetFeeds()[0] = x;
+  * prepared_run->GetFetches()[0] = y;  // optional pre-allocated output
+  * session.Run(run_options, *prepared_run);
+  *
+  * MLValue& output = prepared_run->GetFetches()[0];
+  *
+  * A PreparedRun is not thread-safe. Use a separate instance on each thread that calls Run.
+  */
+class PreparedRun {
+ public:
+  const std::vector<std::string>& GetFeedNames() const {
+    return feeds_fetches_manager_->GetFeedsFetchesInfo().feed_names;
+  }
+
+  const std::vector<std::string>& GetOutputNames() const {
+    return feeds_fetches_manager_->GetFeedsFetchesInfo().output_names;
+  }
+
+  /**
+    * The feeds, in the order of the feed names. Set these before calling Run.
+    */
+  std::vector<MLValue>& GetFeeds() { return feeds_; }
+
+  /**
+    * The fetches, in the order of the output names. An allocated entry is used as a pre-allocated output
+    * by Run. An empty entry is allocated during Run. Contains the outputs after Run.
+    */
+  std::vector<MLValue>& GetFetches() { return fetches_; }
+
+ private:
+  friend InferenceSession;
+
+  PreparedRun(std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager, std::vector<MLDataType>&& feed_types)
+      : feeds_fetches_manager_{std::move(feeds_fetches_manager)},
+        feed_types_{std::move(feed_types)},
+        feeds_(feed_types_.size()),
+        fetches_(feeds_fetches_manager_->GetFeedsFetchesInfo().output_names.size()) {
+  }
+
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
+  std::vector<MLDataType> feed_types_;
+
+  std::vector<MLValue> feeds_;
+  std::vector<MLValue> fetches_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PreparedRun);
+};
+}  // namespace onnxruntime
@@ -41,6 +41,10 @@ extern "C" {
 
 namespace onnxruntime {
 
+namespace concurrency {
+class ThreadPool;
+}
+
 enum StorageOrder {
   UNKNOWN = 0,
   NHWC = 1,
@@ -190,6 +194,8 @@ void Gemm(
     float beta,
     T* C,
     Provider* provider,
+    // optional intra-op thread pool used to parallelize the operation. nullptr to run on the calling thread.
+    concurrency::ThreadPool* threadpool = nullptr,
     //Caffe2 use this type to control on GPU, what presicion do we want to do the calculation
     //But not sure is this a good design for us. Keep it here for now.
     MLDataType math_type = FLOAT_TYPE);
@@ -211,7 +217,8 @@ void GemmEx(
     T beta,
     T* C,
     int ldc,
-    Provider* provider);
+    Provider* provider,
+    concurrency::ThreadPool* threadpool = nullptr);
 
 // GemmBatched provides a simple abstraction into library routines
 template <typename T, class Provider>
@@ -141,8 +141,10 @@ void Gemm<float, CPUMathUtil>(
     const float beta,
     float* C,
     CPUMathUtil* /*provider*/,
+    concurrency::ThreadPool* threadpool,
     MLDataType /*math_type*/) {
 #if defined(USE_MKLDNN)
+  ORT_UNUSED_PARAMETER(threadpool);
   int lda = (int)((TransA == CblasTrans) ? M : K);
   int ldb = (int)((TransB == CblasTrans) ? K : N);
   int M_ = (int)M;
@@ -161,8 +163,9 @@ void Gemm<float, CPUMathUtil>(
 #elif defined(USE_MLAS)
   int lda = (int)((TransA == CblasNoTrans) ? K : M);
   int ldb = (int)((TransB == CblasNoTrans) ? N : K);
-  MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, N);
+  MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, N, nullptr, threadpool);
 #else
+  ORT_UNUSED_PARAMETER(threadpool);
   GemmEigen<float>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
 #endif
 }
@@ -180,9 +183,16 @@ void Gemm<double, CPUMathUtil>(
     const float beta,
     double* C,
     CPUMathUtil* /*provider*/,
+    concurrency::ThreadPool* threadpool,
     MLDataType /*math_type*/) {
-  // No double precision Gemm offering from MLAS or MKLDNN. Directly fallback to Eigen.
+#if defined(USE_MLAS)
+  size_t lda = (size_t)((TransA == CblasNoTrans) ? K : M);
+  size_t ldb = (size_t)((TransB == CblasNoTrans) ? N : K);
+  MlasDgemm(TransA, TransB, M, N, K, static_cast<double>(alpha), A, lda, B, ldb, static_cast<double>(beta), C, N, threadpool);
+#else
+  ORT_UNUSED_PARAMETER(threadpool);
   GemmEigen<double>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
+#endif
 }
 
 template <>
@@ -198,9 +208,16 @@ void Gemm<int32_t, CPUMathUtil>(
     const float beta,
     int32_t* C,
     CPUMathUtil* /*provider*/,
+    concurrency::ThreadPool* threadpool,
     MLDataType /*math_type*/) {
-    // No int32_t Gemm offering from MLAS or MKLDNN. Directly fallback to Eigen.
-    GemmEigen<int32_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
+#if defined(USE_MLAS)
+  size_t lda = (size_t)((TransA == CblasNoTrans) ? K : M);
+  size_t ldb = (size_t)((TransB == CblasNoTrans) ? N : K);
+  MlasIgemm(TransA, TransB, M, N, K, static_cast<int32_t>(alpha), A, lda, B, ldb, static_cast<int32_t>(beta), C, N, threadpool);
+#else
+  ORT_UNUSED_PARAMETER(threadpool);
+  GemmEigen<int32_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
+#endif
 }
 
 template <>
@@ -216,9 +233,16 @@ void Gemm<uint32_t, CPUMathUtil>(
     const float beta,
     uint32_t* C,
     CPUMathUtil* /*provider*/,
+    concurrency::ThreadPool* threadpool,
     MLDataType /*math_type*/) {
-    // No uint32_t Gemm offering from MLAS or MKLDNN. Directly fallback to Eigen.
-    GemmEigen<uint32_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
+#if defined(USE_MLAS)
+  size_t lda = (size_t)((TransA == CblasNoTrans) ? K : M);
+  size_t ldb = (size_t)((TransB == CblasNoTrans) ? N : K);
+  MlasIgemm(TransA, TransB, M, N, K, static_cast<uint32_t>(alpha), A, lda, B, ldb, static_cast<uint32_t>(beta), C, N, threadpool);
+#else
+  ORT_UNUSED_PARAMETER(threadpool);
+  GemmEigen<uint32_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
+#endif
 }
 
 template <>
@@ -234,9 +258,16 @@ void Gemm<int64_t, CPUMathUtil>(
     const float beta,
     int64_t* C,
     CPUMathUtil* /*provider*/,
+    concurrency::ThreadPool* threadpool,
     MLDataType /*math_type*/) {
-    // No int64_t Gemm offering from MLAS or MKLDNN. Directly fallback to Eigen.
-    GemmEigen<int64_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
+#if defined(USE_MLAS)
+  size_t lda = (size_t)((TransA == CblasNoTrans) ? K : M);
+  size_t ldb = (size_t)((TransB == CblasNoTrans) ? N : K);
+  MlasIgemm(TransA, TransB, M, N, K, static_cast<int64_t>(alpha), A, lda, B, ldb, static_cast<int64_t>(beta), C, N, threadpool);
+#else
+  ORT_UNUSED_PARAMETER(threadpool);
+  GemmEigen<int64_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
+#endif
 }
 
 template <>
@@ -252,9 +283,16 @@ void Gemm<uint64_t, CPUMathUtil>(
     const float beta,
     uint64_t* C,
     CPUMathUtil* /*provider*/,
+    concurrency::ThreadPool* threadpool,
     MLDataType /*math_type*/) {
-    // No uint64_t Gemm offering from MLAS or MKLDNN. Directly fallback to Eigen.
-    GemmEigen<uint64_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
+#if defined(USE_MLAS)
+  size_t lda = (size_t)((TransA == CblasNoTrans) ? K : M);
+  size_t ldb = (size_t)((TransB == CblasNoTrans) ? N : K);
+  MlasIgemm(TransA, TransB, M, N, K, static_cast<uint64_t>(alpha), A, lda, B, ldb, static_cast<uint64_t>(beta), C, N, threadpool);
+#else
+  ORT_UNUSED_PARAMETER(threadpool);
+  GemmEigen<uint64_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
+#endif
 }
 
 template <>
@@ -272,8 +310,10 @@ void GemmEx<float, CPUMathUtil>(
     const float beta,
     float* C,
     const int ldc,
-    CPUMathUtil*) {
+    CPUMathUtil*,
+    concurrency::ThreadPool* threadpool) {
 #if defined(USE_MKLDNN)
+  ORT_UNUSED_PARAMETER(threadpool);
   // mkldnn_sgemm expects col major matrices, so we need to swap the operands A and B
   auto status = mkldnn_sgemm(TransB == CblasNoTrans ? "N" : "T",
                              TransA == CblasNoTrans ? "N" : "T",
@@ -285,8 +325,9 @@ void GemmEx<float, CPUMathUtil>(
     ORT_THROW("mkldnn_sgemm failed with status: ", status);
   }
 #elif defined(USE_MLAS)
-  MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+  MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, nullptr, threadpool);
 #else
+  ORT_UNUSED_PARAMETER(threadpool);
   using OuterStride = Eigen::OuterStride<Eigen::Dynamic>;
   using StridedMap = Eigen::Map<Eigen::MatrixXf, 0, OuterStride>;
   using ConstStridedMap = Eigen::Map<const Eigen::MatrixXf, 0, OuterStride>;
@@ -438,6 +479,7 @@ void Gemm<float, CPUMathUtil>(
     const float beta,
     float* C,
     CPUMathUtil* /*context*/,
+    concurrency::ThreadPool* /*threadpool*/,
     MLDataType /*math_type*/) {
   int lda = gsl::narrow_cast<int>((TransA == CblasNoTrans) ? K : M);
   int ldb = gsl::narrow_cast<int>((TransB == CblasNoTrans) ? N : K);
@@ -462,6 +504,7 @@ void Gemm<double, CPUMathUtil>(
     const float beta,
     double* C,
     CPUMathUtil* /*provider*/,
+    concurrency::ThreadPool* /*threadpool*/,
     MLDataType /*math_type*/) {
     int lda = gsl::narrow_cast<int>((TransA == CblasNoTrans) ? K : M);
     int ldb = gsl::narrow_cast<int>((TransB == CblasNoTrans) ? N : K);
@@ -486,6 +529,7 @@ void Gemm<int32_t, CPUMathUtil>(
     const float beta,
     int32_t* C,
     CPUMathUtil* /*provider*/,
+    concurrency::ThreadPool* /*threadpool*/,
     MLDataType /*math_type*/) {
     // No int32_t Gemm offering from MKLML. Directly fallback to Eigen.
     GemmEigen<int32_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
@@ -504,6 +548,7 @@ void Gemm<uint32_t, CPUMathUtil>(
     const float beta,
     uint32_t* C,
     CPUMathUtil* /*provider*/,
+    concurrency::ThreadPool* /*threadpool*/,
     MLDataType /*math_type*/) {
    // No uint32_t Gemm offering from MKLML. Directly fallback to Eigen.
     GemmEigen<uint32_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
@@ -522,6 +567,7 @@ void Gemm<int64_t, CPUMathUtil>(
     const float beta,
     int64_t* C,
     CPUMathUtil* /*provider*/,
+    concurrency::ThreadPool* /*threadpool*/,
     MLDataType /*math_type*/) {
     // No int64_t Gemm offering from MKLML. Directly fallback to Eigen.
     GemmEigen<int64_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
@@ -540,6 +586,7 @@ void Gemm<uint64_t, CPUMathUtil>(
     const float beta,
     uint64_t* C,
     CPUMathUtil* /*provider*/,
+    concurrency::ThreadPool* /*threadpool*/,
     MLDataType /*math_type*/) {
     // No uint64_t Gemm offering from MKLML. Directly fallback to Eigen.
     GemmEigen<uint64_t>(TransA, TransB, M, N, K, alpha, A, B, beta, C);
@@ -560,7 +607,8 @@ void GemmEx<float, CPUMathUtil>(
     const float beta,
     float* C,
     const int ldc,
-    CPUMathUtil* /*context*/) {
+    CPUMathUtil* /*context*/,
+    concurrency::ThreadPool* /*threadpool*/) {
   cblas_sgemm(CblasRowMajor, TransA, TransB, M, N, K, alpha, A, lda, B, ldb,
               beta, C, ldc);
 }
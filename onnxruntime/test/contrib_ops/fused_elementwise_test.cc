@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ContribOpTest, FusedElementwiseUnaryAndBinary) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+
+  // Y = Sqrt((X - M) * (X - M)), which reuses the result of a step.
+  test.AddAttribute("ops", std::vector<std::string>{"Sub", "Mul", "Sqrt"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 2, 2, 3, -1});
+
+  test.AddInput<float>("X", {2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+  test.AddInput<float>("M", {3}, {2.0f, 2.0f, 2.0f});
+  test.AddOutput<float>("Y", {2, 3}, {1.0f, 0.0f, 1.0f, 2.0f, 3.0f, 4.0f});
+  test.Run();
+}
+
+// The output spans several blocks and tasks of the kernel, and the inputs are
+// broadcast from a scalar and from the trailing dimension.
+TEST(ContribOpTest, FusedElementwiseBroadcastLarge) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+
+  // Y = Tanh(X * S + B)
+  test.AddAttribute("ops", std::vector<std::string>{"Mul", "Add", "Tanh"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 3, 2, 4, -1});
+
+  const int64_t rows = 5;
+  const int64_t columns = 7001;
+
+  std::vector<float> X(rows * columns);
+  std::vector<float> B(columns);
+  std::vector<float> Y(rows * columns);
+  for (int64_t c = 0; c < columns; c++) {
+    B[c] = static_cast<float>(c % 13) * 0.25f - 1.5f;
+  }
+  for (int64_t i = 0; i < rows * columns; i++) {
+    X[i] = static_cast<float>(i % 17) * 0.125f - 1.0f;
+    Y[i] = std::tanh(X[i] * 0.5f + B[i % columns]);
+  }
+
+  test.AddInput<float>("X", {rows, columns}, X);
+  test.AddInput<float>("S", {1}, {0.5f});
+  test.AddInput<float>("B", {1, columns}, B);
+  test.AddOutput<float>("Y", {rows, columns}, Y);
+  test.Run();
+}
+
+TEST(ContribOpTest, FusedElementwiseTrailingBroadcast) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("ops", std::vector<std::string>{"Add", "Relu"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 2, -1});
+
+  test.AddInput<float>("X", {2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+  test.AddInput<float>("B", {2, 1}, {1.0f, 2.0f});
+  test.AddOutput<float>("Y", {2, 3}, {2.0f, 3.0f, 4.0f, 6.0f, 7.0f, 8.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "is broadcast along a trailing dimension of the output");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+static void RunFusedGemmTest(const std::string& activation, const std::vector<float>& expected_vals,
+                             bool is_b_constant = false) {
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)0);
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", activation);
+  test.AddAttribute("leaky_relu_alpha", 0.1f);
+
+  test.AddInput<float>("A", {2, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, -2.0f, -3.0f, -4.0f});
+  test.AddInput<float>("B", {4, 3}, std::vector<float>(12, 1.0f), is_b_constant);
+  test.AddInput<float>("C", {3}, std::vector<float>{1.0f, 2.0f, 3.0f});
+  test.AddOutput<float>("Y", {2, 3}, expected_vals);
+  test.Run();
+}
+
+TEST(ContribOpTest, FusedGemmRelu) {
+  RunFusedGemmTest("Relu", {11.0f, 12.0f, 13.0f, 0.0f, 0.0f, 0.0f});
+}
+
+TEST(ContribOpTest, FusedGemmLeakyRelu) {
+  RunFusedGemmTest("LeakyRelu", {11.0f, 12.0f, 13.0f, -0.9f, -0.8f, -0.7f});
+}
+
+// a constant B is pre-packed by the kernel
+TEST(ContribOpTest, FusedGemmReluConstantB) {
+  RunFusedGemmTest("Relu", {11.0f, 12.0f, 13.0f, 0.0f, 0.0f, 0.0f}, true);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
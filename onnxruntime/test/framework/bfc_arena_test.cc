@@ -3,7 +3,10 @@
 
 #include "core/framework/bfc_arena.h"
 #include "gtest/gtest.h"
+#include <condition_variable>
 #include <cstdlib>
+#include <mutex>
+#include <thread>
 
 namespace onnxruntime {
 namespace test {
@@ -234,5 +237,322 @@ TEST(BFCArenaTest, TestReserve) {
   a.GetStats(&stats);
   EXPECT_EQ(stats.total_allocated_bytes, 1048576);
 }
+
+TEST(BFCArenaTest, ThreadCache) {
+  ArenaSettings settings;
+  settings.enable_thread_cache = true;
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, settings);
+
+  // the first allocations of each size miss the cache
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 64; i++) {
+    ptrs.push_back(a.Alloc(1024));
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, 64);
+  EXPECT_EQ(stats.num_thread_cache_hits, 0);
+  EXPECT_EQ(stats.num_thread_cache_misses, 64);
+
+  // the frees are returned to the thread cache in batches, and the next allocations reuse the same chunks
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  std::vector<void*> reused_ptrs;
+  for (int i = 0; i < 64; i++) {
+    reused_ptrs.push_back(a.Alloc(1024));
+  }
+
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, 128);
+  EXPECT_EQ(stats.num_thread_cache_hits, 64);
+  EXPECT_EQ(stats.num_thread_cache_misses, 64);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 0);
+
+  std::sort(ptrs.begin(), ptrs.end());
+  std::sort(reused_ptrs.begin(), reused_ptrs.end());
+  EXPECT_EQ(ptrs, reused_ptrs);
+
+  // large allocations bypass the cache
+  void* large = a.Alloc(1 << 20);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_cache_misses, 64);
+
+  for (void* p : reused_ptrs) {
+    a.Free(p);
+  }
+  a.Free(large);
+
+  // the next allocation that takes the arena lock returns the pending frees, so the large chunk is back in the bins
+  void* medium = a.Alloc(100 << 10);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_cache_misses, 64);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 64 * 1024);
+  EXPECT_EQ(stats.bytes_in_use, 64 * 1024 + static_cast<int64_t>(a.AllocatedSize(medium)));
+  a.Free(medium);
+}
+
+TEST(BFCArenaTest, ThreadCacheMultipleThreads) {
+  ArenaSettings settings;
+  settings.enable_thread_cache = true;
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, settings);
+
+  std::vector<std::vector<void*>> ptrs(4);
+  auto allocate = [&a, &ptrs](size_t t) {
+    for (int i = 0; i < 1000; i++) {
+      size_t size = 64 + (i % 16) * 512;
+      void* p = a.Alloc(size);
+      memset(p, static_cast<int>(t), size);
+      ptrs[t].push_back(p);
+    }
+  };
+
+  for (int round = 0; round < 2; round++) {
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < ptrs.size(); t++) {
+      threads.emplace_back(allocate, t);
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    std::vector<void*> all_ptrs;
+    for (auto& thread_ptrs : ptrs) {
+      all_ptrs.insert(all_ptrs.end(), thread_ptrs.begin(), thread_ptrs.end());
+      thread_ptrs.clear();
+    }
+
+    std::sort(all_ptrs.begin(), all_ptrs.end());
+    EXPECT_EQ(std::adjacent_find(all_ptrs.begin(), all_ptrs.end()), all_ptrs.end());
+
+    // memory allocated by other threads is freed into the cache of this thread
+    for (void* p : all_ptrs) {
+      a.Free(p);
+    }
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, 8000);
+  EXPECT_EQ(stats.num_thread_cache_hits + stats.num_thread_cache_misses, 8000);
+}
+
+TEST(BFCArenaTest, ThreadCacheOfExitedThread) {
+  ArenaSettings settings;
+  settings.enable_thread_cache = true;
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, settings);
+
+  // each thread leaves chunks in its cache and frees pending a flush when it exits
+  auto allocate_and_free = [&a]() {
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 40; i++) {
+      ptrs.push_back(a.Alloc(1024));
+    }
+
+    for (void* p : ptrs) {
+      a.Free(p);
+    }
+
+    ptrs.clear();
+    for (int i = 0; i < 8; i++) {
+      ptrs.push_back(a.Alloc(1024));
+    }
+
+    for (void* p : ptrs) {
+      a.Free(p);
+    }
+  };
+
+  for (int round = 0; round < 4; round++) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+      threads.emplace_back(allocate_and_free);
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    AllocatorStats stats;
+    a.GetStats(&stats);
+    EXPECT_EQ(stats.bytes_in_use, 0);
+    EXPECT_EQ(stats.bytes_in_thread_caches, 0);
+    EXPECT_EQ(stats.num_allocs, (round + 1) * 4 * 48);
+  }
+
+  // all the chunks were returned, so the regions can be released
+  EXPECT_GT(a.Shrink(), 0u);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+}
+
+TEST(BFCArenaTest, Shrink) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+
+  // the arena allocates a region of 1MiB, then one of 2MiB
+  void* first_ptr = a.Alloc(1 << 20);
+  void* second_ptr = a.Alloc(1 << 20);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 3 << 20);
+
+  // only regions that are entirely free are released
+  EXPECT_EQ(a.Shrink(), 0u);
+  a.Free(second_ptr);
+  EXPECT_EQ(a.Shrink(), size_t{2 << 20});
+  a.Free(first_ptr);
+  EXPECT_EQ(a.Shrink(), size_t{1 << 20});
+
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+
+  // the arena grows from the initial region size again
+  void* ptr = a.Alloc(1024);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1 << 20);
+  a.Free(ptr);
+}
+
+TEST(BFCArenaTest, InitialChunkSizeAndGrowthFactor) {
+  ArenaSettings settings;
+  settings.initial_chunk_size_bytes = 1 << 16;
+  settings.growth_factor = 4;
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, settings);
+
+  std::vector<void*> ptrs;
+  ptrs.push_back(a.Alloc(1 << 16));
+  ptrs.push_back(a.Alloc(1 << 16));
+  ptrs.push_back(a.Alloc(1 << 20));
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, (1 << 16) + (1 << 18) + (1 << 20));
+
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  // with a growth factor of 1 the regions stay at the initial size, or the size of the request if it's larger
+  settings.growth_factor = 1;
+  BFCArena b(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, settings);
+
+  ptrs.clear();
+  ptrs.push_back(b.Alloc(1 << 16));
+  ptrs.push_back(b.Alloc(1 << 16));
+  ptrs.push_back(b.Alloc(100 << 10));
+
+  b.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, (2 << 16) + (100 << 10));
+
+  // the large request doesn't change the size of the next region
+  ptrs.push_back(b.Alloc(1 << 16));
+
+  b.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, (3 << 16) + (100 << 10));
+
+  for (void* p : ptrs) {
+    b.Free(p);
+  }
+}
+
+TEST(BFCArenaTest, MaxRetainedBytes) {
+  ArenaSettings settings;
+  settings.max_retained_bytes = 1 << 20;
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, settings);
+
+  void* first_ptr = a.Alloc(1 << 20);
+  void* second_ptr = a.Alloc(2 << 20);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 3 << 20);
+
+  // the free region would put the arena over the limit, so it's released
+  a.Free(second_ptr);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1 << 20);
+
+  // the arena keeps up to the limit
+  a.Free(first_ptr);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1 << 20);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, ShrinkThreadCache) {
+  ArenaSettings settings;
+  settings.enable_thread_cache = true;
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, settings);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 32; i++) {
+    ptrs.push_back(a.Alloc(1024));
+  }
+
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 32 * 1024);
+
+  // the chunks cached by this thread are returned to the arena, so the region is free
+  EXPECT_EQ(a.Shrink(), size_t{1 << 20});
+
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 0);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+
+  // the chunks cached by another thread are returned the next time it uses the arena
+  std::mutex mutex;
+  std::condition_variable cv;
+  int step = 0;
+  std::thread thread([&]() {
+    std::vector<void*> thread_ptrs;
+    for (int i = 0; i < 32; i++) {
+      thread_ptrs.push_back(a.Alloc(1024));
+    }
+
+    for (void* p : thread_ptrs) {
+      a.Free(p);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    step = 1;
+    cv.notify_one();
+    cv.wait(lock, [&step]() { return step == 2; });
+
+    void* p = a.Alloc(1024);
+    AllocatorStats thread_stats;
+    a.GetStats(&thread_stats);
+    EXPECT_EQ(thread_stats.bytes_in_thread_caches, 0);
+    EXPECT_EQ(thread_stats.bytes_in_use, 1024);
+    a.Free(p);
+  });
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&step]() { return step == 1; });
+  }
+
+  EXPECT_EQ(a.Shrink(), 0u);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    step = 2;
+  }
+
+  cv.notify_one();
+  thread.join();
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #include "core/framework/execution_frame.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
+#include "core/framework/symbolic_mem_pattern_planner.h"
 #include "core/graph/model.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "test_utils.h"
@@ -155,6 +156,59 @@ TEST(ExecutionFrameTest, FeedInDataTest) {
   EXPECT_EQ(p_tensor_arg_0->MutableData<float>(), value.GetMutable<Tensor>()->MutableData<float>());
 }
 
+TEST(ExecutionFrameTest, ResetTest) {
+  onnxruntime::Model model("test");
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def("X", &tensor_float), output_def("Y", &tensor_float);
+
+  graph.AddNode("node1", "Clip", "Clip operator", ArgMap{&input_def}, ArgMap{&output_def});
+  graph.Resolve();
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  auto element_type = DataTypeImpl::GetType<float>();
+
+  auto create_value = [&](const TensorShape& shape) {
+    MLValue value;
+    value.Init(new Tensor(element_type, shape, cpu_allocator),
+               DataTypeImpl::GetType<Tensor>(),
+               DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    return value;
+  };
+
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_typ = cpu_xp->Type();
+
+  KernelRegistryManager kernel_registry_manager;
+  ExecutionProviders execution_providers;
+  execution_providers.Add(xp_typ, std::move(cpu_xp));
+  EXPECT_TRUE(kernel_registry_manager.RegisterKernels(execution_providers).IsOK());
+
+  SessionState state{execution_providers};
+  state.SetGraphViewer(std::make_unique<GraphViewer>(graph));
+
+  MLValueNameIdxMap& mlvalue_name_idx_map{state.GetMLValueNameIdxMap()};
+  auto x_idx = mlvalue_name_idx_map.Add("X");
+  auto y_idx = mlvalue_name_idx_map.Add("Y");
+
+  state.CalculateNodeIndexInfo();
+
+  MLValue value1 = create_value(TensorShape({3, 2}));
+  vector<MLValue> outputs;
+  ExecutionFrame frame({x_idx}, {value1}, {y_idx}, outputs, {}, state);
+
+  // the frame is reused with a new feed, and the value of the previous feed is replaced
+  MLValue value2 = create_value(TensorShape({4, 5}));
+  Status status = frame.Reset({value2}, outputs, {});
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  MLValue* p_ml_value = frame.GetMutableNodeInputOrOutputMLValue(0);
+  Tensor* p_tensor_arg_0 = p_ml_value ? p_ml_value->GetMutable<Tensor>() : nullptr;
+  EXPECT_TRUE(p_tensor_arg_0);
+  EXPECT_EQ(p_tensor_arg_0->Shape(), TensorShape({4, 5}));
+  EXPECT_EQ(p_tensor_arg_0->MutableData<float>(), value2.GetMutable<Tensor>()->MutableData<float>());
+}
+
 TEST(ExecutionFrameTest, MemPatternTest) {
   auto cpu_xp = CreateCPUExecutionProvider();
   auto xp_type = cpu_xp->Type();
@@ -258,5 +312,101 @@ TEST(ExecutionFrameTest, MemPatternTest) {
   EXPECT_EQ(p->GetBlock(3)->offset_, 0);
   EXPECT_EQ(p->GetBlock(4)->offset_, 64);
 }
+
+TEST(ExecutionFrameTest, SymbolicMemPatternTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  onnxruntime::Graph& graph = model.MainGraph();
+
+  // X1 has a symbolic batch dim, so T1 and T2 have sizes that depend on it
+  TypeProto tensor_float_n_2, tensor_float_2_2, tensor_float_2_3, tensor_float;
+  tensor_float_n_2.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_float_n_2.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  tensor_float_n_2.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  tensor_float_2_2.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_float_2_2.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  tensor_float_2_2.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  tensor_float_2_3.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_float_2_3.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  tensor_float_2_3.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+  onnxruntime::NodeArg input_def1("X1", &tensor_float_n_2),
+      input_def2("X2", &tensor_float_2_2),
+      input_def3("X3", &tensor_float_2_3),
+      gemm1_out_def("T1", &tensor_float),
+      gemm2_out_def("T2", &tensor_float),
+      clip_out_def("T3", &tensor_float);
+
+  graph.AddNode("node1", "MatMul", "gemm1", ArgMap{&input_def1, &input_def2}, ArgMap{&gemm1_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node2", "MatMul", "gemm2", ArgMap{&gemm1_out_def, &input_def3}, ArgMap{&gemm2_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node3", "Clip", "clip1", ArgMap{&gemm2_out_def}, ArgMap{&clip_out_def})
+      .SetExecutionProviderType(xp_type);
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  KernelRegistryManager kernel_registry_manager;
+  kernel_registry_manager.RegisterKernelRegistry(cpu_xp->GetKernelRegistry());
+
+  ExecutionProviders execution_providers;
+  execution_providers.Add(xp_type, std::move(cpu_xp));
+
+  SessionState state{execution_providers};
+  GraphViewer graph_viewer(graph);
+
+  MLValueNameIdxMap& mlvalue_name_idx_map{state.GetMLValueNameIdxMap()};
+  auto x1_idx = mlvalue_name_idx_map.Add("X1");
+  auto x2_idx = mlvalue_name_idx_map.Add("X2");
+  auto x3_idx = mlvalue_name_idx_map.Add("X3");
+  auto t1_idx = mlvalue_name_idx_map.Add("T1");
+  auto t2_idx = mlvalue_name_idx_map.Add("T2");
+  mlvalue_name_idx_map.Add("T3");
+
+  std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan;
+  status = SequentialPlanner::CreatePlan(graph_viewer, {}, execution_providers, kernel_registry_manager,
+                                         mlvalue_name_idx_map, p_seq_exec_plan);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::unique_ptr<SymbolicMemPatternPlanner> planner;
+  status = SymbolicMemPatternPlanner::Create(graph_viewer, *p_seq_exec_plan, mlvalue_name_idx_map, planner);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_NE(planner, nullptr);
+
+  auto cpu_allocator = execution_providers.Get(xp_type)->GetAllocator(0, OrtMemTypeDefault);
+
+  // a pattern can be generated for any value of N without tracing a run
+  for (int64_t n : {1, 100}) {
+    MLValue v1, v2, v3;
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{n, 2}, std::vector<float>(n * 2, 1.0f), &v1);
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 2}, std::vector<float>(4, 1.0f), &v2);
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 3}, std::vector<float>(6, 1.0f), &v3);
+
+    MemoryPatternGroup pattern;
+    status = planner->GeneratePatterns({x1_idx, x2_idx, x3_idx}, {v1, v2, v3}, &pattern);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    // each allocation is 64-byte aligned
+    size_t t1_size = (n * 2 * sizeof(float) + 63) / 64 * 64;
+    size_t t2_size = (n * 3 * sizeof(float) + 63) / 64 * 64;
+
+    auto p = pattern.GetPatterns(cpu_allocator->Info());
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(p->PeakSize(), t1_size + t2_size);
+    EXPECT_EQ(p->GetBlock(t1_idx)->offset_, 0);
+    EXPECT_EQ(p->GetBlock(t1_idx)->size_, t1_size);
+    EXPECT_EQ(p->GetBlock(t2_idx)->offset_, t1_size);
+    EXPECT_EQ(p->GetBlock(t2_idx)->size_, t2_size);
+  }
+
+  // N can't be resolved without X1
+  MemoryPatternGroup pattern;
+  EXPECT_FALSE(planner->GeneratePatterns({}, {}, &pattern).IsOK());
+}
 }  // namespace test
 }  // namespace onnxruntime
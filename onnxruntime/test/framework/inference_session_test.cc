@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <chrono>
 #include <functional>
 #include <iterator>
 #include <thread>
@@ -13,20 +14,27 @@
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include "core/common/logging/logging.h"
 #include "core/common/profiler.h"
+#include "core/common/threadpool.h"
+#include "core/framework/bfc_arena.h"
 #include "core/framework/compute_capability.h"
+#include "core/framework/customregistry.h"
+#include "core/framework/environment.h"
 #include "core/framework/execution_provider.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
 #include "core/graph/op.h"
+#include "core/optimizer/graph_transformer.h"
 #include "core/platform/env.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 #include "core/session/IOBinding.h"
 #include "dummy_provider.h"
+#include "file_util.h"
 #include "test_utils.h"
 #include "test/capturing_sink.h"
 #include "test/test_environment.h"
@@ -335,6 +343,295 @@ TEST(InferenceSessionTests, DisableCPUArena) {
   RunModel(session_object, run_options);
 }
 
+// Mul kernel that records the intra-op threadpool it was given
+class ThreadPoolRecordingMul : public OpKernel {
+ public:
+  ThreadPoolRecordingMul(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const override {
+    thread_pool = context->GetOperatorThreadPool();
+
+    auto X = context->Input<Tensor>(0);
+    auto W = context->Input<Tensor>(1);
+    auto& shape = X->Shape();
+    auto Y = context->Output(0, shape)->template MutableData<float>();
+    for (int64_t i = 0; i < shape.Size(); ++i) {
+      Y[i] = X->template Data<float>()[i] * W->template Data<float>()[i];
+    }
+    return Status::OK();
+  }
+
+  static concurrency::ThreadPool* thread_pool;
+};
+
+concurrency::ThreadPool* ThreadPoolRecordingMul::thread_pool = nullptr;
+
+// Run MODEL_URI with Mul bound to ThreadPoolRecordingMul and return the threadpool the kernel was given.
+// The threadpool belongs to session_object, so it is only valid while the session exists.
+static concurrency::ThreadPool* RunAndGetOperatorThreadPool(InferenceSession& session_object) {
+  std::shared_ptr<CustomRegistry> registry = std::make_shared<CustomRegistry>();
+  KernelDefBuilder def;
+  def.SetName("Mul")
+      .SetDomain(onnxruntime::kOnnxDomain)
+      .SinceVersion(7)
+      .Provider(onnxruntime::kCpuExecutionProvider)
+      .TypeConstraint("T", DataTypeImpl::GetTensorType<float>());
+  EXPECT_TRUE(registry->RegisterCustomKernel(def, [](const OpKernelInfo& info) -> OpKernel* {
+                        return new ThreadPoolRecordingMul(info);
+                      })
+                  .IsOK());
+
+  EXPECT_TRUE(session_object.RegisterCustomRegistry(registry).IsOK());
+  EXPECT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  EXPECT_TRUE(session_object.Initialize().IsOK());
+
+  ThreadPoolRecordingMul::thread_pool = nullptr;
+  RunOptions run_options;
+  run_options.run_tag = "InferenceSessionTests.IntraOpThreadPool";
+  RunModel(session_object, run_options);
+  return ThreadPoolRecordingMul::thread_pool;
+}
+
+TEST(InferenceSessionTests, IntraOpThreadPool) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.IntraOpThreadPool";
+
+  // one thread runs the kernels on the calling thread only
+  {
+    so.intra_op_num_threads = 1;
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    EXPECT_EQ(RunAndGetOperatorThreadPool(session_object), nullptr);
+  }
+
+  // the calling thread takes part in the work, so the pool has one thread less than requested
+  {
+    so.intra_op_num_threads = 3;
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    auto* thread_pool = RunAndGetOperatorThreadPool(session_object);
+    ASSERT_NE(thread_pool, nullptr);
+    EXPECT_EQ(thread_pool->NumThreads(), 2);
+
+    // the same pool is used by every run of the session
+    ThreadPoolRecordingMul::thread_pool = nullptr;
+    RunModel(session_object, RunOptions{});
+    EXPECT_EQ(ThreadPoolRecordingMul::thread_pool, thread_pool);
+  }
+
+  // 0 uses one thread per core
+  {
+    so.intra_op_num_threads = 0;
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    auto* thread_pool = RunAndGetOperatorThreadPool(session_object);
+    int num_cores = Env::Default().GetNumCpuCores();
+    if (num_cores > 1) {
+      ASSERT_NE(thread_pool, nullptr);
+      EXPECT_EQ(thread_pool->NumThreads(), num_cores - 1);
+    } else {
+      EXPECT_EQ(thread_pool, nullptr);
+    }
+  }
+}
+
+// Creates a branch of an If node that adds an initializer of value to the outer scope value input.
+static ONNX_NAMESPACE::GraphProto CreateAddInitializerBranch(const std::string& input, const std::string& output,
+                                                             float value) {
+  Model model("AddInitializerBranch");
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& outer_scope_input = graph.GetOrCreateNodeArg(input, &float_tensor);
+  graph.AddOuterScopeNodeArg(input);
+
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  tensor_proto.add_dims(2);
+  tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+  tensor_proto.add_float_data(value);
+  tensor_proto.add_float_data(value);
+  tensor_proto.set_name(output + "_B");
+  graph.AddInitializedTensor(tensor_proto);
+
+  auto& b = graph.GetOrCreateNodeArg(output + "_B", &float_tensor);
+  auto& add_output = graph.GetOrCreateNodeArg(output, &float_tensor);
+  graph.AddNode("add", "Add", "Add the initializer", {&outer_scope_input, &b}, {&add_output});
+
+  auto status = graph.Resolve();
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  return graph.ToGraphProto();
+}
+
+// Creates a model that adds the initializers W_1 to W_8 to X, with the nodes add_1 to add_8, and then passes the
+// sum to the If nodes if_0 to if_3. The then branch of if_i adds i + 1 and outputs Y_i. The initializers named in
+// invalid_initializers have less data than their shape.
+static ONNX_NAMESPACE::ModelProto CreateModelWithInitializersAndSubgraphs(
+    const std::vector<std::string>& invalid_initializers = {}) {
+  Model model("ModelWithInitializersAndSubgraphs");
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  TypeProto bool_tensor;
+  bool_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  bool_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  NodeArg* sum = &graph.GetOrCreateNodeArg("X", &float_tensor);
+  for (int i = 1; i <= 8; ++i) {
+    const std::string name = "W_" + std::to_string(i);
+
+    ONNX_NAMESPACE::TensorProto tensor_proto;
+    tensor_proto.add_dims(2);
+    tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+    tensor_proto.set_name(name);
+    if (std::find(invalid_initializers.cbegin(), invalid_initializers.cend(), name) != invalid_initializers.cend()) {
+      tensor_proto.set_raw_data(std::string(sizeof(float), '\0'));
+    } else {
+      tensor_proto.add_float_data(static_cast<float>(i));
+      tensor_proto.add_float_data(static_cast<float>(i));
+    }
+
+    graph.AddInitializedTensor(tensor_proto);
+
+    auto& w = graph.GetOrCreateNodeArg(name, &float_tensor);
+    auto& add_output = graph.GetOrCreateNodeArg("sum_" + std::to_string(i), &float_tensor);
+    graph.AddNode("add_" + std::to_string(i), "Add", "Add an initializer", {sum, &w}, {&add_output});
+    sum = &add_output;
+  }
+
+  auto& cond = graph.GetOrCreateNodeArg("cond", &bool_tensor);
+  for (int i = 0; i < 4; ++i) {
+    auto& if_output = graph.GetOrCreateNodeArg("Y_" + std::to_string(i), &float_tensor);
+    auto& if_node = graph.AddNode("if_" + std::to_string(i), "If", "If node", {&cond}, {&if_output});
+    if_node.AddAttribute("then_branch", CreateAddInitializerBranch(sum->Name(), "then_" + std::to_string(i),
+                                                                   static_cast<float>(i + 1)));
+    if_node.AddAttribute("else_branch", CreateAddInitializerBranch(sum->Name(), "else_" + std::to_string(i),
+                                                                   -static_cast<float>(i + 1)));
+  }
+
+  auto status = graph.Resolve();
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  return model.ToProto();
+}
+
+static common::Status LoadAndInitialize(InferenceSession& session_object,
+                                        const ONNX_NAMESPACE::ModelProto& model_proto) {
+  std::stringstream s1;
+  model_proto.SerializeToOstream(&s1);
+  ORT_RETURN_IF_ERROR(session_object.Load(s1));
+  return session_object.Initialize();
+}
+
+// Add kernel that fails to be constructed for the nodes add_3 and add_6
+class FailingAdd : public OpKernel {
+ public:
+  FailingAdd(const OpKernelInfo& info) : OpKernel(info) {
+    const auto& name = info.node().Name();
+    if (name == "add_3" || name == "add_6") {
+      ORT_THROW("Constructing the kernel of ", name, " failed.");
+    }
+  }
+
+  Status Compute(OpKernelContext* /*context*/) const override {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "FailingAdd is not meant to be run.");
+  }
+};
+
+// The initializers of the graph and the subgraphs are deserialized, the kernels are created, and the subgraph
+// sessions are initialized in parallel when the session has an intra-op thread pool.
+// Check that the outputs are the same as with serial initialization, and that the error of the first initializer
+// or kernel that fails in graph order is reported.
+TEST(InferenceSessionTests, ParallelInitialization) {
+  auto model_proto = CreateModelWithInitializersAndSubgraphs();
+
+  auto run = [&model_proto](int intra_op_num_threads, std::vector<std::vector<float>>& outputs) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.ParallelInitialization";
+    so.intra_op_num_threads = intra_op_num_threads;
+
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    auto status = LoadAndInitialize(session_object, model_proto);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+    MLValue x;
+    CreateMLValue<float>(allocator, {2}, {1.f, 2.f}, &x);
+
+    // std::vector<bool> has no contiguous storage to copy from, so the tensor is written directly
+    auto cond_tensor = std::make_unique<Tensor>(DataTypeImpl::GetType<bool>(), TensorShape({1}), allocator);
+    *cond_tensor->MutableData<bool>() = true;
+    MLValue cond;
+    cond.Init(cond_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    NameMLValMap feeds{{"X", x}, {"cond", cond}};
+
+    std::vector<std::string> output_names{"Y_0", "Y_1", "Y_2", "Y_3"};
+    std::vector<MLValue> fetches;
+    status = session_object.Run(RunOptions{}, feeds, output_names, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    outputs.clear();
+    for (const auto& fetch : fetches) {
+      const auto& tensor = fetch.Get<Tensor>();
+      outputs.emplace_back(tensor.Data<float>(), tensor.Data<float>() + tensor.Shape().Size());
+    }
+  };
+
+  std::vector<std::vector<float>> serial_outputs;
+  run(1, serial_outputs);
+  ASSERT_EQ(serial_outputs.size(), 4u);
+  for (size_t i = 0; i < serial_outputs.size(); ++i) {
+    const float offset = 36.f + static_cast<float>(i + 1);
+    EXPECT_EQ(serial_outputs[i], std::vector<float>({1.f + offset, 2.f + offset}));
+  }
+
+  std::vector<std::vector<float>> parallel_outputs;
+  run(4, parallel_outputs);
+  EXPECT_EQ(parallel_outputs, serial_outputs);
+
+  // returns the error of Initialize
+  auto initialize = [](const ONNX_NAMESPACE::ModelProto& model_proto, int intra_op_num_threads,
+                       bool use_failing_add) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.ParallelInitialization";
+    so.intra_op_num_threads = intra_op_num_threads;
+
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    if (use_failing_add) {
+      std::shared_ptr<CustomRegistry> registry = std::make_shared<CustomRegistry>();
+      KernelDefBuilder def;
+      def.SetName("Add")
+          .SetDomain(onnxruntime::kOnnxDomain)
+          .SinceVersion(7)
+          .Provider(onnxruntime::kCpuExecutionProvider)
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<float>());
+      EXPECT_TRUE(registry->RegisterCustomKernel(def, [](const OpKernelInfo& info) -> OpKernel* {
+                            return new FailingAdd(info);
+                          })
+                      .IsOK());
+      EXPECT_TRUE(session_object.RegisterCustomRegistry(registry).IsOK());
+    }
+
+    auto status = LoadAndInitialize(session_object, model_proto);
+    EXPECT_FALSE(status.IsOK());
+    return status.ErrorMessage();
+  };
+
+  // initializers
+  auto invalid_model_proto = CreateModelWithInitializersAndSubgraphs({"W_3", "W_6"});
+  auto serial_error = initialize(invalid_model_proto, 1, false);
+  EXPECT_THAT(serial_error, testing::HasSubstr("Deserialize tensor W_3 failed."));
+  EXPECT_EQ(initialize(invalid_model_proto, 4, false), serial_error);
+
+  // kernels
+  serial_error = initialize(model_proto, 1, true);
+  EXPECT_THAT(serial_error, testing::HasSubstr("Constructing the kernel of add_3 failed."));
+  EXPECT_EQ(initialize(model_proto, 4, true), serial_error);
+}
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 static bool Compare(const InputDefList& f_arg, const InputDefList& s_arg) {
   if (f_arg.size() != s_arg.size()) {
@@ -577,6 +874,114 @@ TEST(InferenceSessionTests, PreAllocateOutputVector) {
   RunModel(session_object, run_options, is_preallocate_output_vec);
 }
 
+// Run re-uses the FeedsFetchesManager cached by the first Run with the same feed and output names.
+// Check that concurrent runs, with and without pre-allocated outputs, produce the correct output.
+TEST(InferenceSessionTests, RepeatedRunsConcurrently) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.RepeatedRunsConcurrently";
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  auto run = [&session_object](bool is_preallocate_output_vec) {
+    RunOptions run_options;
+    run_options.run_tag = "InferenceSessionTests.RepeatedRunsConcurrently";
+    for (int i = 0; i < 10; ++i) {
+      RunModel(session_object, run_options, is_preallocate_output_vec);
+    }
+  };
+
+  std::thread thread1{run, false};
+  std::thread thread2{run, true};
+  std::thread thread3{run, false};
+
+  thread1.join();
+  thread2.join();
+  thread3.join();
+}
+
+// Registers a CPU execution provider with the session whose arena allocates a region for each allocation, so that
+// the arena can release the memory of each allocation that is freed. Returns the arena.
+static BFCArena* RegisterCPUExecutionProviderWithSmallRegions(InferenceSession& session_object) {
+  ArenaSettings arena_settings;
+  arena_settings.initial_chunk_size_bytes = 256;
+  arena_settings.growth_factor = 1;
+  auto provider = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo(true, arena_settings));
+  auto* arena = dynamic_cast<BFCArena*>(provider->GetAllocator(0, OrtMemTypeDefault).get());
+  EXPECT_TRUE(session_object.RegisterExecutionProvider(std::move(provider)).IsOK());
+  return arena;
+}
+
+static AllocatorStats GetArenaStats(BFCArena& arena) {
+  AllocatorStats stats;
+  arena.GetStats(&stats);
+  return stats;
+}
+
+TEST(InferenceSessionTests, ShrinkArenasOnRunEnd) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.ShrinkArenasOnRunEnd";
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  auto* arena = RegisterCPUExecutionProviderWithSmallRegions(session_object);
+  ASSERT_NE(arena, nullptr);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // the arena keeps the region of the output after it's released
+  RunOptions run_options;
+  run_options.run_tag = "InferenceSessionTests.ShrinkArenasOnRunEnd";
+  RunModel(session_object, run_options);
+
+  auto stats = GetArenaStats(*arena);
+  const int64_t reserved_bytes = stats.total_allocated_bytes;
+  EXPECT_GT(reserved_bytes, stats.bytes_in_use);
+
+  // the output is pre-allocated, so the run doesn't use the free region, and returns it to the device when it ends
+  run_options.shrink_arenas = true;
+  bool is_preallocate_output_vec = true;
+  RunModel(session_object, run_options, is_preallocate_output_vec);
+
+  stats = GetArenaStats(*arena);
+  EXPECT_LT(stats.total_allocated_bytes, reserved_bytes);
+  EXPECT_EQ(stats.total_allocated_bytes, stats.bytes_in_use);
+}
+
+TEST(InferenceSessionTests, ShrinkArenasWhenIdle) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.ShrinkArenasWhenIdle";
+  so.arena_shrink_idle_timeout_ms = 1000;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  auto* arena = RegisterCPUExecutionProviderWithSmallRegions(session_object);
+  ASSERT_NE(arena, nullptr);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "InferenceSessionTests.ShrinkArenasWhenIdle";
+  RunModel(session_object, run_options);
+
+  auto stats = GetArenaStats(*arena);
+  const int64_t reserved_bytes = stats.total_allocated_bytes;
+  EXPECT_GT(reserved_bytes, stats.bytes_in_use);
+
+  // the free region is returned to the device once the session has been idle for the timeout
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (GetArenaStats(*arena).total_allocated_bytes == reserved_bytes &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  stats = GetArenaStats(*arena);
+  EXPECT_LT(stats.total_allocated_bytes, reserved_bytes);
+  EXPECT_EQ(stats.total_allocated_bytes, stats.bytes_in_use);
+}
+
 TEST(InferenceSessionTests, ConfigureVerbosityLevel) {
   SessionOptions so;
 
@@ -950,6 +1355,292 @@ TEST(InferenceSessionTests, TestOptionalInputs) {
   EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("Missing required input:"));
 }
 
+TEST(InferenceSessionTests, SharedInitializers) {
+  auto model_proto = CreateModelWithOptionalInputs();
+  std::string model_str;
+  model_proto.SerializeToString(&model_str);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.SharedInitializers";
+  so.share_initializers = true;
+
+  const auto& store = Environment::GetSharedInitializerStore();
+  ASSERT_EQ(store.Size(), 0u);
+
+  std::vector<std::unique_ptr<InferenceSession>> sessions;
+  for (int i = 0; i < 2; ++i) {
+    sessions.push_back(std::make_unique<InferenceSession>(so, &DefaultLoggingManager()));
+    std::stringstream s1(model_str);
+    auto status = sessions.back()->Load(s1);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    status = sessions.back()->Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  }
+
+  // both sessions use the same copy of the initializer
+  EXPECT_EQ(store.Size(), 1u);
+
+  MLValue required_input_mlvalue;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault),
+                       {1}, {1.f}, &required_input_mlvalue);
+  NameMLValMap feeds{{"required_input", required_input_mlvalue}};
+
+  // the initializer stays valid while any session that uses it exists
+  for (auto& session : sessions) {
+    std::vector<MLValue> fetches;
+    auto status = session->Run(RunOptions{}, feeds, {"add_output"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    EXPECT_EQ(*fetches.front().Get<Tensor>().Data<float>(), 2.f);
+
+    session.reset();
+  }
+
+  EXPECT_EQ(store.Size(), 0u);
+}
+
+// the sessions share an initializer only if its content is the same, even if the key matches
+TEST(InferenceSessionTests, SharedInitializersWithSameKey) {
+  auto& store = Environment::GetSharedInitializerStore();
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+
+  auto create_initializer = [&allocator](float value) {
+    MLValue mlvalue;
+    CreateMLValue<float>(allocator, {1}, {value}, &mlvalue);
+    return std::make_unique<SharedInitializer>(mlvalue, BufferUniquePtr(), OrtCallback{nullptr, nullptr});
+  };
+
+  // use the same key for all of them, as if the hash collided
+  auto key = SharedInitializerStore::MakeKey(ORT_TSTR("model.onnx"), "weight",
+                                             create_initializer(1.f)->Value().Get<Tensor>());
+
+  auto first = store.Add(key, create_initializer(1.f));
+  auto same_content = store.Add(key, create_initializer(1.f));
+  auto different_content = store.Add(key, create_initializer(2.f));
+
+  EXPECT_EQ(same_content, first);
+  EXPECT_NE(different_content, first);
+  EXPECT_EQ(*different_content->Value().Get<Tensor>().Data<float>(), 2.f);
+  EXPECT_EQ(store.Size(), 1u);
+}
+
+// a session doesn't share the initializer of another session if the external data file changed in between
+TEST(InferenceSessionTests, SharedInitializersWithChangedExternalData) {
+  std::basic_string<ORTCHAR_T> filename(ORT_TSTR("shared_initializer_XXXXXX"));
+  FILE* fp;
+  CreateTestFile(fp, filename);
+  std::unique_ptr<ORTCHAR_T, decltype(&DeleteFileFromDisk)> file_deleter(const_cast<ORTCHAR_T*>(filename.c_str()),
+                                                                         DeleteFileFromDisk);
+  auto write_data = [&fp, &filename](float value) {
+    if (!fp) {
+#ifdef _WIN32
+      ASSERT_EQ(0, _wfopen_s(&fp, filename.c_str(), ORT_TSTR("wb")));
+#else
+      fp = fopen(filename.c_str(), "wb");
+      ASSERT_NE(fp, nullptr);
+#endif
+    }
+    ASSERT_EQ(1u, fwrite(&value, sizeof(float), 1, fp));
+    ASSERT_EQ(0, fclose(fp));
+    fp = nullptr;
+  };
+
+  // use external data for the initializer
+  auto model_proto = CreateModelWithOptionalInputs();
+  auto* tensor_proto = model_proto.mutable_graph()->mutable_initializer(0);
+  tensor_proto->clear_float_data();
+  auto* location = tensor_proto->mutable_external_data()->Add();
+  location->set_key("location");
+  location->set_value(ToMBString(filename));
+  tensor_proto->set_data_location(TensorProto_DataLocation_EXTERNAL);
+
+  std::string model_str;
+  model_proto.SerializeToString(&model_str);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.SharedInitializersWithChangedExternalData";
+  so.share_initializers = true;
+
+  const auto& store = Environment::GetSharedInitializerStore();
+  ASSERT_EQ(store.Size(), 0u);
+
+  MLValue required_input_mlvalue;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault),
+                       {1}, {1.f}, &required_input_mlvalue);
+  NameMLValMap feeds{{"required_input", required_input_mlvalue}};
+
+  std::vector<std::unique_ptr<InferenceSession>> sessions;
+  for (float value : {1.f, 5.f}) {
+    write_data(value);
+
+    sessions.push_back(std::make_unique<InferenceSession>(so, &DefaultLoggingManager()));
+    std::stringstream s1(model_str);
+    auto status = sessions.back()->Load(s1);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    status = sessions.back()->Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    std::vector<MLValue> fetches;
+    status = sessions.back()->Run(RunOptions{}, feeds, {"add_output"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    EXPECT_EQ(*fetches.front().Get<Tensor>().Data<float>(), 1.f + value);
+  }
+
+  // each session uses the data that was in the file when it was loaded
+  EXPECT_EQ(store.Size(), 2u);
+
+  sessions.clear();
+  EXPECT_EQ(store.Size(), 0u);
+}
+
+TEST(InferenceSessionTests, OptimizedModel) {
+  const std::basic_string<ORTCHAR_T> optimized_model_path = ORT_TSTR("InferenceSessionTests.OptimizedModel.onnx");
+  static const std::string key_metadata_name = "onnxruntime.optimized_model.key";
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.OptimizedModel";
+  so.optimized_model_filepath = optimized_model_path;
+
+  // save the optimized model of a different model first, so the file needs to be replaced
+  {
+    auto model_proto = CreateModelWithOptionalInputs();
+    std::stringstream s1;
+    model_proto.SerializeToOstream(&s1);
+
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(s1).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+  }
+
+  std::shared_ptr<Model> optimized_model;
+  ASSERT_TRUE(Model::Load(optimized_model_path, optimized_model).IsOK());
+  ASSERT_EQ(optimized_model->MetaData().count(key_metadata_name), 1u);
+  const std::string other_key = optimized_model->MetaData().at(key_metadata_name);
+
+  {
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    RunOptions run_options;
+    run_options.run_tag = "saved optimized model";
+    RunModel(session_object, run_options);
+  }
+
+  ASSERT_TRUE(Model::Load(optimized_model_path, optimized_model).IsOK());
+  ASSERT_EQ(optimized_model->MetaData().count(key_metadata_name), 1u);
+  EXPECT_NE(optimized_model->MetaData().at(key_metadata_name), other_key);
+
+  // a session for the same model uses the saved optimized model
+  auto capturing_sink = new CapturingSink();
+  auto logging_manager = std::make_unique<logging::LoggingManager>(
+      std::unique_ptr<ISink>(capturing_sink), logging::Severity::kINFO, false,
+      LoggingManager::InstanceType::Temporal);
+
+  InferenceSession session_object{so, logging_manager.get()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  auto& msgs = capturing_sink->Messages();
+  EXPECT_TRUE(std::find_if(msgs.begin(), msgs.end(), [](const std::string& msg) {
+                return msg.find("Using the optimized model.") != std::string::npos;
+              }) != msgs.end());
+
+  RunOptions run_options;
+  run_options.run_tag = "loaded optimized model";
+  RunModel(session_object, run_options);
+}
+
+// transformer that counts how many times it's applied
+class CountingTransformer : public GraphTransformer {
+ public:
+  explicit CountingTransformer(int& num_applied)
+      : GraphTransformer("CountingTransformer", "Counts how many times it's applied"), num_applied_(num_applied) {}
+
+ private:
+  Status ApplyImpl(Graph& /*graph*/, bool& modified, int /*graph_level*/) const override {
+    ++num_applied_;
+    modified = false;
+    return Status::OK();
+  }
+
+  int& num_applied_;
+};
+
+TEST(InferenceSessionTests, OptimizedModelKey) {
+  const std::basic_string<ORTCHAR_T> optimized_model_path = ORT_TSTR("InferenceSessionTests.OptimizedModelKey.onnx");
+  static const std::string key_metadata_name = "onnxruntime.optimized_model.key";
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.OptimizedModelKey";
+  so.optimized_model_filepath = optimized_model_path;
+
+  auto get_saved_key = [&optimized_model_path]() {
+    std::shared_ptr<Model> optimized_model;
+    EXPECT_TRUE(Model::Load(optimized_model_path, optimized_model).IsOK());
+    EXPECT_EQ(optimized_model->MetaData().count(key_metadata_name), 1u);
+    return optimized_model->MetaData().at(key_metadata_name);
+  };
+
+  {
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+  }
+
+  const std::string key_without_transformer = get_saved_key();
+
+  // a session with another graph transformer doesn't use the saved model, and replaces it
+  int num_applied = 0;
+  {
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.RegisterGraphTransformer(std::make_unique<CountingTransformer>(num_applied)).IsOK());
+    ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    RunOptions run_options;
+    run_options.run_tag = "with graph transformer";
+    RunModel(session_object, run_options);
+  }
+
+  EXPECT_GT(num_applied, 0);
+  const std::string key_with_transformer = get_saved_key();
+  EXPECT_NE(key_with_transformer, key_without_transformer);
+
+  // a session with the same graph transformer uses the saved model, so the transformer isn't applied
+  num_applied = 0;
+  {
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.RegisterGraphTransformer(std::make_unique<CountingTransformer>(num_applied)).IsOK());
+    ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+  }
+
+  EXPECT_EQ(num_applied, 0);
+
+  // a session with a custom registry neither uses nor replaces the saved model
+  {
+    auto capturing_sink = new CapturingSink();
+    auto logging_manager = std::make_unique<logging::LoggingManager>(
+        std::unique_ptr<ISink>(capturing_sink), logging::Severity::kINFO, false,
+        LoggingManager::InstanceType::Temporal);
+
+    num_applied = 0;
+    InferenceSession session_object{so, logging_manager.get()};
+    ASSERT_TRUE(session_object.RegisterGraphTransformer(std::make_unique<CountingTransformer>(num_applied)).IsOK());
+    ASSERT_TRUE(session_object.RegisterCustomRegistry(std::make_shared<CustomRegistry>()).IsOK());
+    ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    EXPECT_GT(num_applied, 0);
+    auto& msgs = capturing_sink->Messages();
+    EXPECT_TRUE(std::find_if(msgs.begin(), msgs.end(), [](const std::string& msg) {
+                  return msg.find("Using the optimized model.") != std::string::npos;
+                }) == msgs.end());
+  }
+
+  EXPECT_EQ(get_saved_key(), key_with_transformer);
+}
+
 TEST(ExecutionProviderTest, FunctionTest) {
   onnxruntime::Model model("graph_1");
   auto& graph = model.MainGraph();
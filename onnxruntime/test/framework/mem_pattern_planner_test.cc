@@ -34,5 +34,33 @@ TEST(MemPatternPlannerTest, TraceAllocaitonTest) {
   EXPECT_EQ(pattern.GetBlock(5)->offset_, 1024 + 256 + 512);
   EXPECT_EQ(pattern.GetBlock(6)->offset_, 1024);
 }
+
+TEST(MemPatternPlannerTest, BestFitTest) {
+  MemPatternPlanner planner;
+  planner.TraceAllocation(0, 512);
+  planner.TraceAllocation(1, 128);
+  planner.TraceAllocation(2, 256);
+  planner.TraceAllocation(3, 128);
+  planner.TraceAllocation(4, 256);
+
+  // leaves gaps of 512 bytes at 0 and 384 bytes at 640. the gaps left by 2 and 3 are merged.
+  planner.TraceFree(0);
+  planner.TraceFree(2);
+  planner.TraceFree(3);
+
+  // smallest gap that fits is used
+  planner.TraceAllocation(5, 300);
+  // the remaining 84 bytes of the gap at 640 is too small so the gap at 0 is used
+  planner.TraceAllocation(6, 100);
+  // nothing fits so allocate at the end
+  planner.TraceAllocation(7, 1024);
+
+  auto pattern = planner.GenerateMemPattern();
+
+  EXPECT_EQ(pattern.GetBlock(5)->offset_, 640);
+  EXPECT_EQ(pattern.GetBlock(6)->offset_, 0);
+  EXPECT_EQ(pattern.GetBlock(7)->offset_, 1280);
+  EXPECT_EQ(pattern.PeakSize(), 1280 + 1024);
+}
 }  // namespace test
 }  // namespace onnxruntime
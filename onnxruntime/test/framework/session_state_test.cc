@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include "core/framework/execution_providers.h"
+#include "core/framework/mem_pattern.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
 #include "core/graph/graph_viewer.h"
@@ -70,5 +71,76 @@ TEST(SessionStateTest, AddGetKernelTest) {
   std::cout << "orig: " << orig_num_outputs << " new: " << test_kernel->Node().OutputDefs().size() << std::endl;
   EXPECT_EQ(orig_num_outputs, test_kernel->Node().OutputDefs().size());
 }
+
+TEST(SessionStateTest, MemoryPatternCache) {
+  ExecutionProviders execution_providers;
+  SessionState s{execution_providers};
+  s.SetMaxMemoryPatternGroups(2);
+
+  std::vector<TensorShape> shapes_1{TensorShape({1, 5})};
+  std::vector<TensorShape> shapes_2{TensorShape({1, 7})};  // same bucket as shapes_1 but larger
+  std::vector<TensorShape> shapes_3{TensorShape({1, 20})};
+  std::vector<TensorShape> shapes_4{TensorShape({5, 1})};
+
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes_1), nullptr);
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes_1, std::make_unique<MemoryPatternGroup>()).IsOK());
+  auto pattern_1 = s.GetMemoryPatternGroup(shapes_1);
+  EXPECT_NE(pattern_1, nullptr);
+
+  // a pattern generated from smaller inputs in the same bucket can't be used, and is replaced
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes_2), nullptr);
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes_2, std::make_unique<MemoryPatternGroup>()).IsOK());
+  auto pattern_2 = s.GetMemoryPatternGroup(shapes_2);
+  EXPECT_NE(pattern_2, nullptr);
+  EXPECT_NE(pattern_1, pattern_2);
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes_1), pattern_2);
+
+  // smaller inputs don't replace the pattern
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes_1, std::make_unique<MemoryPatternGroup>()).IsOK());
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes_2), pattern_2);
+
+  // shapes_4 has the same number of elements but a different bucket
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes_4), nullptr);
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes_4, std::make_unique<MemoryPatternGroup>()).IsOK());
+  EXPECT_NE(s.GetMemoryPatternGroup(shapes_4), nullptr);
+
+  // cache is full so the least recently used pattern, for shapes_2, is evicted
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes_3, std::make_unique<MemoryPatternGroup>()).IsOK());
+  EXPECT_NE(s.GetMemoryPatternGroup(shapes_3), nullptr);
+  EXPECT_NE(s.GetMemoryPatternGroup(shapes_4), nullptr);
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes_2), nullptr);
+
+  // an evicted pattern remains valid while it is in use
+  EXPECT_EQ(pattern_2.use_count(), 1);
+
+  auto stats = s.GetMemoryPatternCacheStats();
+  EXPECT_EQ(stats.hits, size_t(7));
+  EXPECT_EQ(stats.misses, size_t(4));
+  EXPECT_EQ(stats.evictions, size_t(1));
+}
+
+TEST(SessionStateTest, MemoryPatternCacheComparesDimensions) {
+  ExecutionProviders execution_providers;
+  SessionState s{execution_providers};
+
+  // all in the same bucket. shapes_2 has fewer elements than shapes_1 in total, but a larger second input.
+  std::vector<TensorShape> shapes_1{TensorShape({1, 8}), TensorShape({1, 3})};
+  std::vector<TensorShape> shapes_2{TensorShape({1, 5}), TensorShape({1, 4})};
+  std::vector<TensorShape> shapes_3{TensorShape({1, 5}), TensorShape({1, 3})};
+
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes_1, std::make_unique<MemoryPatternGroup>()).IsOK());
+  auto pattern_1 = s.GetMemoryPatternGroup(shapes_1);
+  EXPECT_NE(pattern_1, nullptr);
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes_3), pattern_1);
+
+  // the blocks for the second input may be too small, so the pattern can't be used, and is replaced
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes_2), nullptr);
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes_2, std::make_unique<MemoryPatternGroup>()).IsOK());
+  auto pattern_2 = s.GetMemoryPatternGroup(shapes_2);
+  EXPECT_NE(pattern_2, nullptr);
+  EXPECT_NE(pattern_1, pattern_2);
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes_3), pattern_2);
+  EXPECT_EQ(s.GetMemoryPatternGroup(shapes_1), nullptr);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,8 +1,11 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "core/framework/tensor.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/onnx_protobuf.h"
+#include "core/platform/env.h"
+#include "file_util.h"
 #include "gtest/gtest.h"
 
 using namespace ::onnxruntime::utils;
@@ -71,5 +74,102 @@ TEST(TensorParseTest, TensorUtilsTest) {
   status = UnpackTensorWrapper(bool_tensor_proto, string_data, 2);
   EXPECT_FALSE(status.IsOK());
 }
+
+// create a file with 'padding' floats followed by test_data, and a TensorProto with the test_data as external data
+static void CreateExternalDataTensorProto(const std::vector<float>& test_data, size_t padding,
+                                          std::basic_string<ORTCHAR_T>& filename, TensorProto& tensor_proto) {
+  FILE* fp;
+  CreateTestFile(fp, filename);
+  std::vector<float> data(padding, 0.f);
+  data.insert(data.end(), test_data.begin(), test_data.end());
+  ASSERT_EQ(data.size(), fwrite(data.data(), sizeof(float), data.size(), fp));
+  ASSERT_EQ(0, fclose(fp));
+
+  StringStringEntryProto* location = tensor_proto.mutable_external_data()->Add();
+  location->set_key("location");
+  location->set_value(ToMBString(filename));
+  StringStringEntryProto* offset = tensor_proto.mutable_external_data()->Add();
+  offset->set_key("offset");
+  offset->set_value(std::to_string(padding * sizeof(float)));
+  tensor_proto.mutable_dims()->Add(static_cast<int64_t>(test_data.size()));
+  tensor_proto.set_data_location(TensorProto_DataLocation_EXTERNAL);
+  tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+}
+
+TEST(TensorParseTest, ExternalDataWithOffset) {
+  std::vector<float> test_data{1.0f, 2.2f, 3.5f};
+  std::basic_string<ORTCHAR_T> filename(ORT_TSTR("tensor_XXXXXX"));
+  TensorProto tensor_proto;
+  CreateExternalDataTensorProto(test_data, 5, filename, tensor_proto);
+  std::unique_ptr<ORTCHAR_T, decltype(&DeleteFileFromDisk)> file_deleter(const_cast<ORTCHAR_T*>(filename.c_str()),
+                                                                         DeleteFileFromDisk);
+
+  OrtAllocatorInfo cpu_info(CPU, OrtDeviceAllocator);
+  std::vector<float> output(test_data.size());
+  MLValue value;
+  OrtCallback deleter;
+  auto status = TensorProtoToMLValue(Env::Default(), nullptr, tensor_proto,
+                                     MemBuffer(output.data(), output.size() * sizeof(float), cpu_info), value, deleter);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_EQ(output, test_data);
+}
+
+#ifndef _WIN32
+TEST(TensorParseTest, MappedExternalData) {
+  std::vector<float> test_data{1.0f, 2.2f, 3.5f};
+  std::basic_string<ORTCHAR_T> filename(ORT_TSTR("tensor_XXXXXX"));
+  TensorProto tensor_proto;
+  // use an offset that isn't a multiple of the page size
+  CreateExternalDataTensorProto(test_data, 1025, filename, tensor_proto);
+  std::unique_ptr<ORTCHAR_T, decltype(&DeleteFileFromDisk)> file_deleter(const_cast<ORTCHAR_T*>(filename.c_str()),
+                                                                         DeleteFileFromDisk);
+
+  OrtAllocatorInfo cpu_info(CPU, OrtDeviceAllocator);
+  {
+    MLValue value;
+    OrtCallback deleter;
+    auto status = MappedExternalDataTensorProtoToMLValue(Env::Default(), nullptr, tensor_proto, cpu_info, value,
+                                                         deleter);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    ASSERT_NE(deleter.f, nullptr);
+
+    const Tensor& tensor = value.Get<Tensor>();
+    ASSERT_EQ(tensor.Shape().Size(), 3);
+    const float* data = tensor.Data<float>();
+    EXPECT_EQ(std::vector<float>(data, data + 3), test_data);
+
+    // the mapping is copy-on-write, so a kernel can write to the tensor
+    value.GetMutable<Tensor>()->MutableData<float>()[0] = 42.f;
+    EXPECT_EQ(data[0], 42.f);
+
+    deleter.f(deleter.param);
+  }
+
+  // the write was not written to the file
+  {
+    MLValue value;
+    OrtCallback deleter;
+    auto status = MappedExternalDataTensorProtoToMLValue(Env::Default(), nullptr, tensor_proto, cpu_info, value,
+                                                         deleter);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    const float* data = value.Get<Tensor>().Data<float>();
+    EXPECT_EQ(std::vector<float>(data, data + 3), test_data);
+
+    deleter.f(deleter.param);
+  }
+
+  // data that isn't aligned for the element type can't be used directly
+  (*tensor_proto.mutable_external_data())[1].set_value("2");
+  {
+    MLValue value;
+    OrtCallback deleter;
+    auto status = MappedExternalDataTensorProtoToMLValue(Env::Default(), nullptr, tensor_proto, cpu_info, value,
+                                                         deleter);
+    EXPECT_EQ(status.Code(), common::NOT_IMPLEMENTED);
+    EXPECT_EQ(deleter.f, nullptr);
+  }
+}
+#endif
 }  // namespace test
 }  // namespace onnxruntime
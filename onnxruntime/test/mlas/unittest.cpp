@@ -17,9 +17,14 @@ Abstract:
 #include <stdio.h>
 #include <memory.h>
 #include <algorithm>
+#include <cmath>
 #include <limits>
+#include <memory>
+#include <vector>
 #include <mlas.h>
 
+#include "core/common/threadpool.h"
+
 #if defined(_WIN32)
 #include <windows.h>
 #else
@@ -30,6 +35,13 @@ Abstract:
 #define _countof(_Array) (sizeof(_Array) / sizeof(_Array[0]))
 #endif
 
+//
+// Thread pool used by the tests, else nullptr to run the tests on the calling
+// thread.
+//
+
+MLAS_THREADPOOL* threadpool = nullptr;
+
 class MatrixGuardBuffer
 {
 public:
@@ -240,7 +252,7 @@ TrialSgemm(
         CReference[f] = -0.5f;
     }
 
-    MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+    MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, nullptr, threadpool);
     ReferenceSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, CReference, ldc);
 
     for (size_t f = 0; f < M * N; f++) {
@@ -249,6 +261,72 @@ TrialSgemm(
             printf("mismatch TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
         }
     }
+
+    //
+    // Repeat the operation with a pre-packed matrix B.
+    //
+
+    std::unique_ptr<uint8_t[]> PackedB(new uint8_t[MlasSgemmPackBSize(N, K)]);
+
+    MlasSgemmPackB(TransB, N, K, B, ldb, PackedB.get());
+
+    for (size_t f = 0; f < M * N; f++) {
+        C[f] = -0.5f;
+    }
+
+    MlasSgemm(TransA, M, N, K, alpha, A, lda, PackedB.get(), beta, C, ldc, nullptr, threadpool);
+
+    for (size_t f = 0; f < M * N; f++) {
+        if (C[f] != CReference[f]) {
+            printf("mismatch packed TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
+        }
+    }
+
+    //
+    // Repeat the operation with a bias vector and an activation applied as
+    // post-processing. The first row of matrix B doubles as the bias vector.
+    //
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasLeakyReluActivation;
+    Activation.alpha = 0.125f;
+
+    MLAS_SGEMM_POSTPROCESS PostProcess;
+    PostProcess.Bias = B;
+    PostProcess.Activation = &Activation;
+
+    for (size_t m = 0; m < M; m++) {
+        for (size_t n = 0; n < N; n++) {
+            float Value = CReference[m * ldc + n] + B[n];
+            CReference[m * ldc + n] = (Value >= 0.0f) ? Value : Value * 0.125f;
+        }
+    }
+
+    for (size_t f = 0; f < M * N; f++) {
+        C[f] = -0.5f;
+    }
+
+    MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, &PostProcess, threadpool);
+
+    for (size_t f = 0; f < M * N; f++) {
+        if (C[f] != CReference[f]) {
+            printf("mismatch postprocess TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
+            break;
+        }
+    }
+
+    for (size_t f = 0; f < M * N; f++) {
+        C[f] = -0.5f;
+    }
+
+    MlasSgemm(TransA, M, N, K, alpha, A, lda, PackedB.get(), beta, C, ldc, &PostProcess, threadpool);
+
+    for (size_t f = 0; f < M * N; f++) {
+        if (C[f] != CReference[f]) {
+            printf("mismatch packed postprocess TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
+            break;
+        }
+    }
 }
 
 void
@@ -275,6 +353,52 @@ TrialSgemm(
     TrialSgemm(CblasTrans, CblasTrans, M, N, K, alpha, A, M, B, K, beta, C, CReference, N);
 }
 
+void
+TrialSgemmBatch(
+    size_t BatchCount,
+    size_t M,
+    size_t N,
+    size_t K,
+    bool ShareA,
+    bool ShareB
+    )
+{
+    const size_t StrideA = ShareA ? 0 : M * K;
+    const size_t StrideB = ShareB ? 0 : K * N;
+    const size_t StrideC = M * N;
+
+    MatrixGuardBuffer BufferA(M * K * (ShareA ? 1 : BatchCount), true);
+    MatrixGuardBuffer BufferB(K * N * (ShareB ? 1 : BatchCount), true);
+    MatrixGuardBuffer BufferC(M * N * BatchCount, false);
+    MatrixGuardBuffer BufferCReference(M * N * BatchCount, false);
+
+    const float* A = BufferA.GetBuffer(M * K * (ShareA ? 1 : BatchCount));
+    const float* B = BufferB.GetBuffer(K * N * (ShareB ? 1 : BatchCount));
+    float* C = BufferC.GetBuffer(M * N * BatchCount);
+    float* CReference = BufferCReference.GetBuffer(M * N * BatchCount);
+
+    for (size_t f = 0; f < M * N * BatchCount; f++) {
+        C[f] = -0.5f;
+        CReference[f] = -0.5f;
+    }
+
+    MlasSgemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, StrideA, B, N, StrideB,
+        0.0f, C, N, StrideC, BatchCount, threadpool);
+
+    for (size_t batch = 0; batch < BatchCount; batch++) {
+        ReferenceSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A + batch * StrideA, K,
+            B + batch * StrideB, N, 0.0f, CReference + batch * StrideC, N);
+    }
+
+    for (size_t f = 0; f < M * N * BatchCount; f++) {
+        if (C[f] != CReference[f]) {
+            printf("mismatch batch BatchCount=%zd, M=%zd, N=%zd, K=%zd, ShareA=%d, ShareB=%d!\n",
+                BatchCount, M, N, K, int(ShareA), int(ShareB));
+            break;
+        }
+    }
+}
+
 void
 ExecuteSgemmTests(
     void
@@ -287,6 +411,78 @@ ExecuteSgemmTests(
     MatrixGuardBuffer BufferC(MaximumDimension * MaximumDimension, false);
     MatrixGuardBuffer BufferCReference(MaximumDimension * MaximumDimension, false);
 
+    //
+    // Each trial also runs the packed matrix B and post-processing variants.
+    // The sizes cover the edges of the kernel tiles and the packing blocks
+    // while keeping the run short. ExecuteLongSgemmTests sweeps the sizes
+    // exhaustively.
+    //
+
+    // Trial balloons.
+    for (size_t b = 1; b < 16; b++) {
+        TrialSgemm(b, b, b, 1.0f, BufferA, BufferB, 0.0f, BufferC, BufferCReference);
+    }
+    for (size_t b = 16; b <= 256; b <<= 1) {
+        TrialSgemm(b, b, b, 1.0f, BufferA, BufferB, 0.0f, BufferC, BufferCReference);
+    }
+    for (size_t b = 256; b < 320; b += 32) {
+        TrialSgemm(b, b, b, 1.0f, BufferA, BufferB, 0.0f, BufferC, BufferCReference);
+    }
+
+    static const float multipliers[] = { 0.0f, -0.0f, 0.25f, -0.5f, 1.0f, -1.0f };
+
+    for (size_t a = 0; a < _countof(multipliers); a++) {
+        for (size_t b = 0; b < _countof(multipliers); b++) {
+            TrialSgemm(1, 17, 33, multipliers[a], BufferA, BufferB, multipliers[b], BufferC, BufferCReference);
+            TrialSgemm(19, 33, 121, multipliers[a], BufferA, BufferB, multipliers[b], BufferC, BufferCReference);
+        }
+    }
+
+    for (size_t M = 1; M < 36; M += 3) {
+        for (size_t N = 1; N < 40; N++) {
+            static const size_t ks[] = { 1, 3, 16, 17 };
+            for (size_t k = 0; k < _countof(ks); k++) {
+                TrialSgemm(M, N, ks[k], 1.0f, BufferA, BufferB, 0.0f, BufferC, BufferCReference);
+            }
+        }
+    }
+
+    static const size_t ks[] = { 127, 128, 129, 255, 256, 257, 320 };
+    for (size_t k = 0; k < _countof(ks); k++) {
+        TrialSgemm(7, 31, ks[k], 1.0f, BufferA, BufferB, 0.0f, BufferC, BufferCReference);
+        TrialSgemm(33, 100, ks[k], 1.0f, BufferA, BufferB, 0.0f, BufferC, BufferCReference);
+    }
+
+    static const size_t batches[] = { 1, 2, 3, 7, 16, 33 };
+
+    for (size_t b = 0; b < _countof(batches); b++) {
+        for (size_t M = 1; M < 100; M += 17) {
+            for (size_t N = 1; N < 100; N += 23) {
+                for (size_t K = 1; K < 100; K += 31) {
+                    TrialSgemmBatch(batches[b], M, N, K, false, false);
+                    TrialSgemmBatch(batches[b], M, N, K, true, false);
+                    TrialSgemmBatch(batches[b], M, N, K, false, true);
+                }
+            }
+        }
+    }
+
+    TrialSgemmBatch(4, 128, 256, 512, false, false);
+    TrialSgemmBatch(12, 64, 64, 64, false, true);
+}
+
+void
+ExecuteLongSgemmTests(
+    void
+    )
+{
+    constexpr size_t MaximumDimension = 320;
+
+    MatrixGuardBuffer BufferA(MaximumDimension * MaximumDimension, true);
+    MatrixGuardBuffer BufferB(MaximumDimension * MaximumDimension, true);
+    MatrixGuardBuffer BufferC(MaximumDimension * MaximumDimension, false);
+    MatrixGuardBuffer BufferCReference(MaximumDimension * MaximumDimension, false);
+
     // Trial balloons.
     for (size_t b = 1; b < 16; b++) {
         TrialSgemm(b, b, b, 1.0f, BufferA, BufferB, 0.0f, BufferC, BufferCReference);
@@ -359,8 +555,330 @@ ExecuteSgemmTests(
             for (size_t K = 1; K < 16; K++) {
                 TrialSgemm(M, N, K, 1.0f, BufferA, BufferB, 0.0f, BufferC, BufferCReference);
             }
-            for (size_t K = 16; K < 160; K += 32) {
-                TrialSgemm(M, N, K, 1.0f, BufferA, BufferB, 0.0f, BufferC, BufferCReference);
+            for (size_t K = 16; K < 160; K += 32) {
+                TrialSgemm(M, N, K, 1.0f, BufferA, BufferB, 0.0f, BufferC, BufferCReference);
+            }
+        }
+        printf("M %zd\n", M);
+    }
+}
+
+template<typename T>
+void
+ReferenceGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    T alpha,
+    const T* A,
+    size_t lda,
+    const T* B,
+    size_t ldb,
+    T beta,
+    T* C,
+    size_t ldc
+    )
+{
+    for (size_t m = 0; m < M; m++) {
+        for (size_t n = 0; n < N; n++) {
+
+            T sum = T(0);
+
+            for (size_t k = 0; k < K; k++) {
+                T a = (TransA == CblasNoTrans) ? A[m * lda + k] : A[k * lda + m];
+                T b = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+                sum += a * b;
+            }
+
+            T* c = C + m * ldc + n;
+            *c = (beta == T(0)) ? (sum * alpha) : (*c * beta) + (sum * alpha);
+        }
+    }
+}
+
+void
+InvokeGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    double alpha,
+    const double* A,
+    size_t lda,
+    const double* B,
+    size_t ldb,
+    double beta,
+    double* C,
+    size_t ldc
+    )
+{
+    MlasDgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, threadpool);
+}
+
+template<typename T>
+void
+InvokeGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    T alpha,
+    const T* A,
+    size_t lda,
+    const T* B,
+    size_t ldb,
+    T beta,
+    T* C,
+    size_t ldc
+    )
+{
+    MlasIgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, threadpool);
+}
+
+template<typename T>
+void
+TrialGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    T alpha,
+    T beta
+    )
+{
+    std::vector<T> A(M * K);
+    std::vector<T> B(K * N);
+    std::vector<T> C(M * N);
+    std::vector<T> CReference(M * N);
+
+    for (size_t i = 0; i < A.size(); i++) {
+        A[i] = T((i * 7) % 13) - T(3);
+    }
+
+    for (size_t i = 0; i < B.size(); i++) {
+        B[i] = T((i * 5) % 11) - T(2);
+    }
+
+    for (size_t i = 0; i < C.size(); i++) {
+        C[i] = T(i % 5);
+        CReference[i] = T(i % 5);
+    }
+
+    const size_t lda = (TransA == CblasNoTrans) ? K : M;
+    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+    InvokeGemm(TransA, TransB, M, N, K, alpha, A.data(), lda, B.data(), ldb, beta, C.data(), N);
+
+    ReferenceGemm<T>(TransA, TransB, M, N, K, alpha, A.data(), lda, B.data(), ldb, beta,
+        CReference.data(), N);
+
+    //
+    // The inputs are small integers, so the double precision results are
+    // exact and can be compared directly.
+    //
+
+    for (size_t f = 0; f < M * N; f++) {
+        if (C[f] != CReference[f]) {
+            printf("mismatch gemm sizeof(T)=%zd TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd!\n",
+                sizeof(T), TransA, TransB, M, N, K);
+            break;
+        }
+    }
+}
+
+template<typename T>
+void
+ExecuteGemmTests(
+    T alpha,
+    T beta
+    )
+{
+    static const CBLAS_TRANSPOSE trans[] = { CblasNoTrans, CblasTrans };
+
+    for (size_t ta = 0; ta < _countof(trans); ta++) {
+        for (size_t tb = 0; tb < _countof(trans); tb++) {
+            for (size_t M = 1; M < 40; M += 3) {
+                for (size_t N = 1; N < 300; N += 37) {
+                    for (size_t K = 0; K < 300; K += 43) {
+                        TrialGemm<T>(trans[ta], trans[tb], M, N, K, alpha, beta);
+                    }
+                }
+            }
+        }
+    }
+
+    TrialGemm<T>(CblasNoTrans, CblasNoTrans, 160, 200, 256, alpha, beta);
+    TrialGemm<T>(CblasNoTrans, CblasTrans, 255, 127, 129, alpha, beta);
+}
+
+void
+ExecuteGemmTests(
+    void
+    )
+{
+    ExecuteGemmTests<double>(1.0, 0.0);
+    ExecuteGemmTests<double>(0.5, 2.0);
+    ExecuteGemmTests<int32_t>(1, 0);
+    ExecuteGemmTests<int32_t>(2, -1);
+    ExecuteGemmTests<uint32_t>(1, 1);
+    ExecuteGemmTests<int64_t>(-3, 1);
+    ExecuteGemmTests<uint64_t>(1, 0);
+}
+
+void
+ReferenceQgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    bool BIsSigned,
+    int32_t* C,
+    size_t ldc
+    )
+{
+    const int32_t ZeroPointB = BIsSigned ? int32_t(int8_t(offb)) : int32_t(offb);
+
+    for (size_t m = 0; m < M; m++) {
+        for (size_t n = 0; n < N; n++) {
+
+            const uint8_t* a = A + (m * lda);
+            const uint8_t* b = B + n;
+            int32_t sum = 0;
+
+            for (size_t k = 0; k < K; k++) {
+                int32_t bvalue = BIsSigned ? int32_t(int8_t(*b)) : int32_t(*b);
+                sum += (int32_t(*a) - int32_t(offa)) * (bvalue - ZeroPointB);
+                b += ldb;
+                a += 1;
+            }
+
+            C[m * ldc + n] = sum;
+        }
+    }
+}
+
+void
+TrialQgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    uint8_t offa,
+    uint8_t offb,
+    bool BIsSigned
+    )
+{
+    std::vector<uint8_t> A(M * K);
+    std::vector<uint8_t> B(K * N);
+    std::vector<int32_t> C(M * N);
+    std::vector<int32_t> CReference(M * N);
+    std::vector<int32_t> Bias(M);
+    std::vector<uint8_t> Output(M * N);
+
+    for (size_t f = 0; f < A.size(); f++) {
+        A[f] = uint8_t((f * 7 + 3) % 256);
+    }
+    for (size_t f = 0; f < B.size(); f++) {
+        B[f] = uint8_t((f * 13 + 5) % 256);
+    }
+    for (size_t f = 0; f < Bias.size(); f++) {
+        Bias[f] = int32_t(f * 37 % 1000) - 500;
+    }
+
+    std::fill(C.begin(), C.end(), -1);
+
+    MlasQgemm(M, N, K, A.data(), K, offa, B.data(), N, offb, BIsSigned, C.data(), N, nullptr, threadpool);
+    ReferenceQgemm(M, N, K, A.data(), K, offa, B.data(), N, offb, BIsSigned, CReference.data(), N);
+
+    for (size_t f = 0; f < M * N; f++) {
+        if (C[f] != CReference[f]) {
+            printf("mismatch M=%zd, N=%zd, K=%zd, offa=%d, offb=%d, signed=%d!\n", M, N, K, offa, offb, int(BIsSigned));
+            break;
+        }
+    }
+
+    //
+    // Repeat the operation with requantization to unsigned 8-bit values.
+    //
+
+    MLAS_QGEMM_REQUANTIZE Requantize;
+
+    Requantize.Bias = Bias.data();
+    Requantize.Scale = 1.0f / float(4 * K + 1);
+    Requantize.ZeroPoint = 128;
+    Requantize.Output = Output.data();
+    Requantize.ldo = N;
+
+    MlasQgemm(M, N, K, A.data(), K, offa, B.data(), N, offb, BIsSigned, C.data(), N, &Requantize, threadpool);
+
+    for (size_t m = 0; m < M; m++) {
+        for (size_t n = 0; n < N; n++) {
+
+            double Scaled = double(CReference[m * N + n] + Bias[m]) * double(Requantize.Scale);
+            int32_t Expected = int32_t(std::round(Scaled)) + Requantize.ZeroPoint;
+            Expected = std::min(std::max(Expected, int32_t(0)), int32_t(255));
+
+            if (std::abs(int32_t(Output[m * N + n]) - Expected) > 1) {
+                printf("mismatch requantize M=%zd, N=%zd, K=%zd, offa=%d, offb=%d, signed=%d!\n", M, N, K, offa, offb, int(BIsSigned));
+                m = M;
+                break;
+            }
+        }
+    }
+}
+
+void
+ExecuteQgemmTests(
+    void
+    )
+{
+    for (size_t b = 1; b < 16; b++) {
+        TrialQgemm(b, b, b, 0, 0, false);
+        TrialQgemm(b, b, b, 0, 0, true);
+    }
+    for (size_t b = 16; b <= 256; b <<= 1) {
+        TrialQgemm(b, b, b, 34, 46, false);
+        TrialQgemm(b, b, b, 34, 0xF6, true);
+    }
+
+    static const uint8_t offsets[] = { 0, 1, 127, 128, 255 };
+
+    for (size_t a = 0; a < _countof(offsets); a++) {
+        for (size_t b = 0; b < _countof(offsets); b++) {
+
+            for (size_t M = 1; M < 20; M += 3) {
+                for (size_t N = 1; N < 40; N += 5) {
+                    for (size_t K = 1; K < 40; K += 3) {
+                        TrialQgemm(M, N, K, offsets[a], offsets[b], false);
+                        TrialQgemm(M, N, K, offsets[a], offsets[b], true);
+                    }
+                }
+            }
+        }
+    }
+
+    for (size_t M = 16; M < 160; M += 32) {
+        for (size_t N = 16; N < 160; N += 32) {
+
+            static const size_t ks[] = { 1, 3, 4, 5, 16, 48, 255, 256, 257, 600, 1100 };
+            for (size_t k = 0; k < _countof(ks); k++) {
+                size_t K = ks[k];
+
+                TrialQgemm(M, N, K, 3, 250, false);
+                TrialQgemm(M + 1, N + 1, K, 3, 250, false);
+                TrialQgemm(M + 3, N + 7, K, 200, 6, true);
+                TrialQgemm(M + 15, N + 15, K, 200, 6, true);
+                TrialQgemm(1, N + 1, K, 7, 9, false);
+                TrialQgemm(M + 1, 1, K, 7, 9, false);
             }
         }
         printf("M %zd\n", M);
@@ -439,7 +957,7 @@ ReferenceConv2D(
             }
 
             MlasSgemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f,
-                filter, K, Im2Col, OutputSize, 0.0f, Output, OutputSize);
+                filter, K, Im2Col, OutputSize, 0.0f, Output, OutputSize, nullptr, threadpool);
 
             //
             // Apply the bias.
@@ -516,7 +1034,8 @@ TrialConv2D(
                     OutputShape,
                     FilterCount,
                     &Activation,
-                    &WorkingBufferSize);
+                    &WorkingBufferSize,
+                    threadpool);
 
     size_t OutputHeight = size_t(OutputHeight64);
     size_t OutputWidth = size_t(OutputWidth64);
@@ -549,7 +1068,8 @@ TrialConv2D(
              Filter,
              Bias,
              BufferWorking.GetBuffer(WorkingBufferSize),
-             Output);
+             Output,
+             threadpool);
 
     ReferenceConv2D(BatchCount,
                     GroupCount,
@@ -566,10 +1086,36 @@ TrialConv2D(
                     Bias,
                     OutputReference);
 
-    if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
-        printf("mismatch: batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd,kernel(%zd,%zd)!!!\n",
-            BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount,
-            KernelHeight, KernelWidth);
+    //
+    // The Winograd algorithm computes the convolution with transforms that
+    // introduce rounding errors, so compare its output with a tolerance. The
+    // other algorithms produce exact results for the integer fill values.
+    //
+
+    bool Mismatch;
+
+    if (Parameters.Algorithm == MlasConvAlgorithmWinograd) {
+
+        const float Tolerance = 1e-5f * float(InputChannels * KernelSize * 23 * 23);
+
+        Mismatch = false;
+
+        for (size_t n = 0; n < OutputBufferElements; n++) {
+            if (!(std::fabs(Output[n] - OutputReference[n]) <= Tolerance)) {
+                Mismatch = true;
+                break;
+            }
+        }
+
+    } else {
+
+        Mismatch = (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0);
+    }
+
+    if (Mismatch) {
+        printf("mismatch: algorithm=%d,batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd,kernel(%zd,%zd)!!!\n",
+            int(Parameters.Algorithm), BatchCount, GroupCount, InputChannels, InputHeight,
+            InputWidth, FilterCount, KernelHeight, KernelWidth);
     }
 }
 
@@ -601,6 +1147,34 @@ ExecuteConvTests(
         TrialConv2D(b, 1, 64, 11, 11, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
     }
 
+    //
+    // Exercise the Winograd algorithm with both tile sizes and partial tiles.
+    //
+
+    static const unsigned ws[] = { 1, 2, 3, 5, 8, 9, 14, 19, 28, 57 };
+
+    for (unsigned ih = 0; ih < _countof(ws); ih++) {
+        for (unsigned iw = 0; iw < _countof(ws); iw++) {
+            for (unsigned p = 0; p < 2; p++) {
+                TrialConv2D(1, 1, 16, ws[ih] + 2 - 2 * p, ws[iw] + 2 - 2 * p, 16, 3, 3, p, p, p, p, 1, 1, 1, 1);
+                TrialConv2D(1, 1, 37, ws[ih] + 2 - 2 * p, ws[iw] + 2 - 2 * p, 21, 3, 3, p, p, p, p, 1, 1, 1, 1);
+            }
+        }
+    }
+
+    TrialConv2D(3, 2, 64, 14, 14, 64, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+    TrialConv2D(1, 1, 128, 56, 56, 128, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+    TrialConv2D(1, 1, 32, 7, 150, 48, 3, 3, 0, 1, 2, 0, 1, 1, 1, 1);
+
+    //
+    // Exercise the direct algorithm with partial blocks of filters.
+    //
+
+    for (unsigned fc = 1; fc <= 17; fc++) {
+        TrialConv2D(2, 1, 3, 31, 37, fc, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+        TrialConv2D(1, 2, 1, 30, 29, fc, 5, 5, 2, 1, 0, 2, 1, 2, 2, 1);
+    }
+
     for (unsigned ic = 0; ic < _countof(cs); ic++) {
         for (unsigned ih = 0; ih < _countof(is); ih++) {
             for (unsigned iw = 0; iw < _countof(is); iw++) {
@@ -975,7 +1549,7 @@ TrialPool2D(
     float* Output = BufferOutput.GetBuffer(OutputBufferElements);
     float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
 
-    MlasPool(MlasMaximumPooling, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+    MlasPool(MlasMaximumPooling, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
     ReferenceMaximumPool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference);
 
     if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
@@ -983,7 +1557,7 @@ TrialPool2D(
             InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
     }
 
-    MlasPool(MlasAveragePoolingExcludePad, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+    MlasPool(MlasAveragePoolingExcludePad, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
     ReferenceAveragePool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, false);
 
     if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
@@ -991,7 +1565,7 @@ TrialPool2D(
             InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
     }
 
-    MlasPool(MlasAveragePoolingIncludePad, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+    MlasPool(MlasAveragePoolingIncludePad, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
     ReferenceAveragePool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, true);
 
     if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
@@ -1042,7 +1616,7 @@ TrialPool3D(
     float* Output = BufferOutput.GetBuffer(OutputBufferElements);
     float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
 
-    MlasPool(MlasMaximumPooling, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+    MlasPool(MlasMaximumPooling, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
     ReferenceMaximumPool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference);
 
     if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
@@ -1050,7 +1624,7 @@ TrialPool3D(
             InputChannels, InputDepth, InputHeight, InputWidth, KernelDepth, KernelHeight, KernelWidth);
     }
 
-    MlasPool(MlasAveragePoolingExcludePad, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+    MlasPool(MlasAveragePoolingExcludePad, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
     ReferenceAveragePool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, false);
 
     if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
@@ -1058,7 +1632,7 @@ TrialPool3D(
             InputChannels, InputDepth, InputHeight, InputWidth, KernelDepth, KernelHeight, KernelWidth);
     }
 
-    MlasPool(MlasAveragePoolingIncludePad, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+    MlasPool(MlasAveragePoolingIncludePad, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
     ReferenceAveragePool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, true);
 
     if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
@@ -1152,6 +1726,402 @@ ExecutePool3DTests(
     }
 }
 
+void
+TrialNchwcConv2D(
+    size_t BatchCount,
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t InputHeight,
+    size_t InputWidth,
+    size_t FilterCount,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t PaddingLeftHeight,
+    size_t PaddingLeftWidth,
+    size_t PaddingRightHeight,
+    size_t PaddingRightWidth,
+    size_t DilationHeight,
+    size_t DilationWidth,
+    size_t StrideHeight,
+    size_t StrideWidth
+    )
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    int64_t OutputHeight64 =
+        ((int64_t(InputHeight) + int64_t(PaddingLeftHeight) + int64_t(PaddingRightHeight)) -
+        (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
+    int64_t OutputWidth64 =
+        ((int64_t(InputWidth) + int64_t(PaddingLeftWidth) + int64_t(PaddingRightWidth)) -
+        (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
+
+    if (OutputHeight64 <= 0 || OutputWidth64 <= 0) {
+        return;
+    }
+
+    size_t OutputHeight = size_t(OutputHeight64);
+    size_t OutputWidth = size_t(OutputWidth64);
+
+    size_t InputSize = InputHeight * InputWidth;
+    size_t KernelSize = KernelHeight * KernelWidth;
+    size_t OutputSize = OutputHeight * OutputWidth;
+
+    //
+    // A depthwise convolution uses a group per channel, else the channels of
+    // each group must fill whole blocks.
+    //
+
+    const bool Depthwise = (GroupCount > 1 && InputChannels == 1 && FilterCount == 1);
+
+    size_t TotalInputChannels = GroupCount * InputChannels;
+    size_t TotalFilterCount = GroupCount * FilterCount;
+    size_t NchwcInputChannels = (TotalInputChannels + BlockSize - 1) & ~(BlockSize - 1);
+    size_t NchwcFilterCount = (TotalFilterCount + BlockSize - 1) & ~(BlockSize - 1);
+
+    size_t InputBufferElements = BatchCount * TotalInputChannels * InputSize;
+    size_t FilterBufferElements = TotalFilterCount * InputChannels * KernelSize;
+    size_t BiasBufferElements = TotalFilterCount;
+    size_t OutputBufferElements = BatchCount * TotalFilterCount * OutputSize;
+    size_t NchwcInputElements = BatchCount * NchwcInputChannels * InputSize;
+    size_t NchwcFilterElements = NchwcFilterCount * (Depthwise ? 1 : (InputChannels + BlockSize - 1) & ~(BlockSize - 1)) * KernelSize;
+    size_t NchwcOutputElements = BatchCount * NchwcFilterCount * OutputSize;
+
+    MatrixGuardBuffer BufferInput(InputBufferElements, true);
+    MatrixGuardBuffer BufferFilter(FilterBufferElements, true);
+    MatrixGuardBuffer BufferBias(BiasBufferElements, true);
+    MatrixGuardBuffer BufferOutput(OutputBufferElements, false);
+    MatrixGuardBuffer BufferOutputReference(OutputBufferElements, false);
+    MatrixGuardBuffer BufferNchwcInput(NchwcInputElements, false);
+    MatrixGuardBuffer BufferNchwcFilter(NchwcFilterElements, false);
+    MatrixGuardBuffer BufferNchwcBias(NchwcFilterCount, false);
+    MatrixGuardBuffer BufferNchwcOutput(NchwcOutputElements, false);
+
+    const float* Input = BufferInput.GetBuffer(InputBufferElements);
+    const float* Filter = BufferFilter.GetBuffer(FilterBufferElements);
+    const float* Bias = BufferBias.GetBuffer(BiasBufferElements);
+    float* Output = BufferOutput.GetBuffer(OutputBufferElements);
+    float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
+    float* NchwcInput = BufferNchwcInput.GetBuffer(NchwcInputElements);
+    float* NchwcFilter = BufferNchwcFilter.GetBuffer(NchwcFilterElements);
+    float* NchwcBias = BufferNchwcBias.GetBuffer(NchwcFilterCount);
+    float* NchwcOutput = BufferNchwcOutput.GetBuffer(NchwcOutputElements);
+
+    //
+    // Reorder the input and filter tensors to the NCHWc layout.
+    //
+
+    int64_t InputShape[] = { int64_t(BatchCount), int64_t(TotalInputChannels), int64_t(InputHeight), int64_t(InputWidth) };
+    int64_t FilterShape[] = { int64_t(TotalFilterCount), int64_t(InputChannels), int64_t(KernelHeight), int64_t(KernelWidth) };
+    int64_t OutputShape[] = { int64_t(BatchCount), int64_t(TotalFilterCount), OutputHeight64, OutputWidth64 };
+
+    MlasReorderInput(InputShape, Input, NchwcInput);
+
+    if (Depthwise) {
+        MlasReorderFilterOIHWBo(FilterShape, Filter, NchwcFilter);
+    } else {
+        MlasReorderFilterOIHWBiBo(FilterShape, Filter, NchwcFilter);
+    }
+
+    std::fill_n(NchwcBias, NchwcFilterCount, 0.0f);
+    std::copy_n(Bias, BiasBufferElements, NchwcBias);
+
+    int64_t NchwcInputShape[] = { int64_t(BatchCount), int64_t(NchwcInputChannels), int64_t(InputHeight), int64_t(InputWidth) };
+    int64_t NchwcOutputShape[] = { int64_t(BatchCount), int64_t(NchwcFilterCount), OutputHeight64, OutputWidth64 };
+    int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+    int64_t DilationShape[] = { int64_t(DilationHeight), int64_t(DilationWidth) };
+    int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+    int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasIdentityActivation;
+
+    MlasNchwcConv(NchwcInputShape,
+                  KernelShape,
+                  DilationShape,
+                  Padding,
+                  StrideShape,
+                  NchwcOutputShape,
+                  Depthwise ? NchwcInputChannels : GroupCount,
+                  NchwcInput,
+                  NchwcFilter,
+                  NchwcBias,
+                  NchwcOutput,
+                  &Activation,
+                  true,
+                  threadpool);
+
+    MlasReorderOutput(OutputShape, NchwcOutput, Output);
+
+    ReferenceConv2D(BatchCount,
+                    GroupCount,
+                    InputChannels,
+                    InputHeight, InputWidth,
+                    FilterCount,
+                    KernelHeight, KernelWidth,
+                    PaddingLeftHeight, PaddingLeftWidth,
+                    DilationHeight, DilationWidth,
+                    StrideHeight, StrideWidth,
+                    OutputHeight, OutputWidth,
+                    Input,
+                    Filter,
+                    Bias,
+                    OutputReference);
+
+    if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+        printf("mismatch: nchwc batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd,kernel(%zd,%zd)!!!\n",
+            BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount,
+            KernelHeight, KernelWidth);
+    }
+}
+
+void
+TrialNchwcPool2D(
+    size_t BatchCount,
+    size_t InputChannels,
+    size_t InputHeight,
+    size_t InputWidth,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t PaddingLeftHeight,
+    size_t PaddingLeftWidth,
+    size_t PaddingRightHeight,
+    size_t PaddingRightWidth,
+    size_t StrideHeight,
+    size_t StrideWidth
+    )
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    size_t NchwcChannels = (InputChannels + BlockSize - 1) & ~(BlockSize - 1);
+
+    int64_t InputShape[] = { int64_t(BatchCount), int64_t(InputChannels), int64_t(InputHeight), int64_t(InputWidth) };
+    int64_t NchwcInputShape[] = { int64_t(BatchCount), int64_t(NchwcChannels), int64_t(InputHeight), int64_t(InputWidth) };
+    int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+    int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+    int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+    int64_t OutputShape[] = { int64_t(BatchCount), int64_t(InputChannels), 0, 0 };
+
+    OutputShape[2] = (InputShape[2] + Padding[0] + Padding[2] - KernelShape[0]) / StrideShape[0] + 1;
+    OutputShape[3] = (InputShape[3] + Padding[1] + Padding[3] - KernelShape[1]) / StrideShape[1] + 1;
+
+    if (OutputShape[2] <= 0 || OutputShape[3] <= 0) {
+        return;
+    }
+
+    int64_t NchwcOutputShape[] = { int64_t(BatchCount), int64_t(NchwcChannels), OutputShape[2], OutputShape[3] };
+
+    size_t InputBufferElements = size_t(InputShape[0] * InputShape[1] * InputShape[2] * InputShape[3]);
+    size_t OutputBufferElements = size_t(OutputShape[0] * OutputShape[1] * OutputShape[2] * OutputShape[3]);
+    size_t NchwcInputElements = size_t(NchwcInputShape[0] * NchwcInputShape[1] * NchwcInputShape[2] * NchwcInputShape[3]);
+    size_t NchwcOutputElements = size_t(NchwcOutputShape[0] * NchwcOutputShape[1] * NchwcOutputShape[2] * NchwcOutputShape[3]);
+
+    MatrixGuardBuffer BufferInput(InputBufferElements, true);
+    MatrixGuardBuffer BufferOutput(OutputBufferElements, false);
+    MatrixGuardBuffer BufferOutputReference(OutputBufferElements, false);
+    MatrixGuardBuffer BufferNchwcInput(NchwcInputElements, false);
+    MatrixGuardBuffer BufferNchwcOutput(NchwcOutputElements, false);
+
+    const float* Input = BufferInput.GetBuffer(InputBufferElements);
+    float* Output = BufferOutput.GetBuffer(OutputBufferElements);
+    float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
+    float* NchwcInput = BufferNchwcInput.GetBuffer(NchwcInputElements);
+    float* NchwcOutput = BufferNchwcOutput.GetBuffer(NchwcOutputElements);
+
+    MlasReorderInput(InputShape, Input, NchwcInput);
+
+    static const MLAS_POOLING_KIND PoolingKinds[] = {
+        MlasMaximumPooling,
+        MlasAveragePoolingExcludePad,
+        MlasAveragePoolingIncludePad,
+    };
+
+    for (MLAS_POOLING_KIND PoolingKind : PoolingKinds) {
+
+        MlasNchwcPool(PoolingKind, NchwcInputShape, KernelShape, Padding, StrideShape, NchwcOutputShape,
+            NchwcInput, NchwcOutput, threadpool);
+        MlasReorderOutput(OutputShape, NchwcOutput, Output);
+
+        MlasPool(PoolingKind, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input,
+            OutputReference, threadpool);
+
+        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+            printf("mismatch: nchwc pool=%d,input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
+                int(PoolingKind), InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+        }
+    }
+}
+
+void
+ExecuteNchwcTests(
+    void
+    )
+{
+    //
+    // The NCHWc routines are only available if the platform supports them.
+    //
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    if (BlockSize <= 1) {
+        return;
+    }
+
+    static const unsigned cs[] = { 3, 16, 37, 64 };
+    static const unsigned is[] = { 1, 2, 5, 11, 28 };
+
+    for (unsigned ic = 0; ic < _countof(cs); ic++) {
+        for (unsigned fc = 0; fc < _countof(cs); fc++) {
+            for (unsigned ih = 0; ih < _countof(is); ih++) {
+                for (unsigned iw = 0; iw < _countof(is); iw++) {
+                    fprintf(stderr, "Handling nchwc %dx%dx%d filters %d\n", cs[ic], is[ih], is[iw], cs[fc]);
+                    for (unsigned k = 1; k <= 5; k += 2) {
+                        for (unsigned p = 0; p <= k / 2; p++) {
+                            for (unsigned s = 1; s <= 2; s++) {
+                                TrialNchwcConv2D(1, 1, cs[ic], is[ih], is[iw], cs[fc], k, k, p, p, p, p, 1, 1, s, s);
+                                TrialNchwcConv2D(1, 1, cs[ic], is[ih], is[iw], cs[fc], k, 1, p, 0, 0, 0, 2, 1, s, 1);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    //
+    // Exercise grouped and depthwise convolutions and batches.
+    //
+
+    for (unsigned c = 1; c <= 40; c++) {
+        TrialNchwcConv2D(2, c, 1, 13, 17, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+        TrialNchwcConv2D(1, c, 1, 13, 17, 1, 3, 3, 1, 1, 1, 1, 1, 1, 2, 2);
+        TrialNchwcConv2D(1, c, 1, 16, 16, 1, 5, 5, 2, 1, 2, 1, 2, 2, 1, 1);
+    }
+
+    TrialNchwcConv2D(2, 2, BlockSize, 11, 13, BlockSize, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+    TrialNchwcConv2D(1, 3, 2 * BlockSize, 9, 9, BlockSize, 3, 3, 0, 1, 2, 0, 1, 1, 2, 1);
+    TrialNchwcConv2D(3, 1, 64, 14, 14, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+    TrialNchwcConv2D(1, 1, 64, 56, 56, 64, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+
+    for (unsigned c = 1; c <= 40; c += 13) {
+        for (unsigned ih = 0; ih < _countof(is); ih++) {
+            for (unsigned iw = 0; iw < _countof(is); iw++) {
+                for (unsigned k = 1; k <= 3; k++) {
+                    for (unsigned p = 0; p < k; p++) {
+                        for (unsigned s = 1; s <= 2; s++) {
+                            TrialNchwcPool2D(2, c, is[ih], is[iw], k, k, p, p, p, p, s, s);
+                            TrialNchwcPool2D(1, c, is[ih], is[iw], k, 1, p, 0, p, 0, s, 1);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+TrialComputeUnary(
+    const char* Name,
+    void (MLASCALL *ComputeRoutine)(const float*, float*, size_t),
+    double (*ReferenceRoutine)(double),
+    float Minimum,
+    float Maximum,
+    size_t N
+    )
+{
+    std::vector<float> Input(N);
+    std::vector<float> Output(N);
+
+    for (size_t n = 0; n < N; n++) {
+        Input[n] = Minimum + (Maximum - Minimum) * float(n) / float(N);
+    }
+
+    ComputeRoutine(Input.data(), Output.data(), N);
+
+    for (size_t n = 0; n < N; n++) {
+        double Expected = ReferenceRoutine(double(Input[n]));
+        double Tolerance = 1e-6 * std::max(std::abs(Expected), 1.0);
+        if (!(std::abs(double(Output[n]) - Expected) <= Tolerance)) {
+            printf("mismatch %s N=%zd, x=%f, y=%f, expected=%f!\n", Name, N, Input[n], Output[n], Expected);
+            break;
+        }
+    }
+}
+
+void
+TrialComputeSoftmax(
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    )
+{
+    std::vector<float> Input(N * D);
+    std::vector<float> Output(N * D);
+
+    //
+    // The ramp along each row raises the maximum in each block of the row.
+    //
+
+    for (size_t f = 0; f < Input.size(); f++) {
+        Input[f] = float(int(f * 37 % 201) - 100) * 0.125f + float(f % D) * 16.0f / float(D);
+    }
+
+    MlasComputeSoftmax(Input.data(), Output.data(), N, D, LogSoftmax, threadpool);
+
+    for (size_t n = 0; n < N; n++) {
+
+        const float* x = Input.data() + n * D;
+        const float* y = Output.data() + n * D;
+
+        double Maximum = *std::max_element(x, x + D);
+        double Sum = 0.0;
+        for (size_t d = 0; d < D; d++) {
+            Sum += std::exp(double(x[d]) - Maximum);
+        }
+
+        for (size_t d = 0; d < D; d++) {
+            double Expected = double(x[d]) - Maximum;
+            Expected = LogSoftmax ? Expected - std::log(Sum) : std::exp(Expected) / Sum;
+            if (!(std::abs(double(y[d]) - Expected) <= 1e-5 * std::max(std::abs(Expected), 1.0))) {
+                printf("mismatch softmax N=%zd, D=%zd, log=%d!\n", N, D, int(LogSoftmax));
+                n = N;
+                break;
+            }
+        }
+    }
+}
+
+void
+ExecuteComputeTests(
+    void
+    )
+{
+    static const size_t ns[] = { 1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 255, 1000 };
+
+    for (size_t n = 0; n < _countof(ns); n++) {
+        size_t N = ns[n];
+
+        TrialComputeUnary("exp", MlasComputeExp, std::exp, -80.0f, 80.0f, N);
+        TrialComputeUnary("log", MlasComputeLog, std::log, 1e-10f, 1e10f, N);
+        TrialComputeUnary("erf", MlasComputeErf, std::erf, -5.0f, 5.0f, N);
+
+        for (size_t D = 1; D < 40; D += 3) {
+            TrialComputeSoftmax(N, D, false);
+            TrialComputeSoftmax(N, D, true);
+        }
+    }
+
+    //
+    // Rows that are split into several blocks.
+    //
+
+    static const size_t ds[] = { 2047, 2048, 2049, 10000, 200000 };
+
+    for (size_t d = 0; d < _countof(ds); d++) {
+        TrialComputeSoftmax(5, ds[d], false);
+        TrialComputeSoftmax(5, ds[d], true);
+    }
+}
+
 #if 0
 #if defined(_WIN32)
 
@@ -1190,7 +2160,7 @@ EvaluateThreadingPerformance(
                 DWORD start = GetTickCount();
                 DWORD stop;
                 do {
-                    MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, 0.0f, C, N);
+                    MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, 0.0f, C, N, nullptr, threadpool);
                     stop = GetTickCount();
                     NumberIterations++;
                 } while ((stop - start) <= 5000);
@@ -1210,7 +2180,7 @@ EvaluateThreadingPerformance(
 
                     start = GetTickCount();
                     for (size_t iters = 0; iters < NumberIterations; iters++) {
-                        MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, 0.0f, C, N);
+                        MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, 0.0f, C, N, nullptr, threadpool);
                         stop = GetTickCount();
                         if ((stop - start) > 20000) {
                             break;
@@ -1238,11 +2208,30 @@ main(
     void
     )
 {
-//    ExecuteSgemmTests();
-    ExecuteConvTests();
-//    ExecutePool2DTests();
-//    ExecutePool3DTests();
-//    EvaluateThreadingPerformance();
+    //
+    // Run the tests on the calling thread and then again using a thread pool.
+    //
+
+    std::unique_ptr<onnxruntime::concurrency::ThreadPool> ThreadPool =
+        std::make_unique<onnxruntime::concurrency::ThreadPool>("MlasTestThreadPool", 2);
+
+    for (MLAS_THREADPOOL* tp : { (MLAS_THREADPOOL*)nullptr, ThreadPool.get() }) {
+
+        threadpool = tp;
+
+        printf("Running tests %s thread pool.\n", (threadpool != nullptr) ? "with" : "without");
+
+        ExecuteSgemmTests();
+//        ExecuteLongSgemmTests();
+        ExecuteGemmTests();
+        ExecuteQgemmTests();
+        ExecuteConvTests();
+        ExecuteNchwcTests();
+        ExecuteComputeTests();
+//        ExecutePool2DTests();
+//        ExecutePool3DTests();
+//        EvaluateThreadingPerformance();
+    }
 
     return 0;
 }
@@ -4,6 +4,7 @@
 #include "core/session/inference_session.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
+#include "core/graph/graph_utils.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/identity_elimination.h"
@@ -13,11 +14,16 @@
 #include "core/optimizer/conv_mul_fusion.h"
 #include "core/optimizer/conv_add_fusion.h"
 #include "core/optimizer/conv_activation_fusion.h"
+#include "core/optimizer/constant_folding.h"
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
+#include "core/optimizer/nchwc_transformer.h"
+#include "core/optimizer/elementwise_fusion.h"
 #include "core/framework/data_types.h"
 #include "core/framework/ml_value.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/util/math.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/env.h"
 #include "test/framework/test_utils.h"
 #include "test/capturing_sink.h"
@@ -338,5 +344,425 @@ TEST(GraphTransformationTests, FuseConvBnAddMulFloat16) {
   ASSERT_EQ(expected_values_prod, found);
 }
 
+// W is a constant initializer. W2 is an initializer that is also a graph input, so a feed can override it.
+static ModelProto CreateConstantFoldingModel() {
+  Model model("ConstantFolding");
+  auto& graph = model.MainGraph();
+
+  TypeProto float_2x3;
+  float_2x3.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_2x3.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_2x3.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  for (const auto* name : {"W", "W2"}) {
+    TensorProto w_tensor;
+    w_tensor.set_name(name);
+    w_tensor.set_data_type(TensorProto_DataType_FLOAT);
+    w_tensor.add_dims(2);
+    w_tensor.add_dims(3);
+    for (int i = 1; i <= 6; ++i) {
+      w_tensor.add_float_data(static_cast<float>(i));
+    }
+    graph.AddInitializedTensor(w_tensor);
+  }
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_2x3);
+  auto& w = graph.GetOrCreateNodeArg("W", &float_2x3);
+  auto& w_squared = graph.GetOrCreateNodeArg("W_squared", &float_2x3);
+  auto& x_shape = graph.GetOrCreateNodeArg("X_shape", nullptr);
+  auto& sum = graph.GetOrCreateNodeArg("sum", &float_2x3);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_2x3);
+  auto& random = graph.GetOrCreateNodeArg("random", &float_2x3);
+  auto& z = graph.GetOrCreateNodeArg("Z", &float_2x3);
+  auto& w2 = graph.GetOrCreateNodeArg("W2", &float_2x3);
+  auto& w2_squared = graph.GetOrCreateNodeArg("W2_squared", &float_2x3);
+  auto& y2 = graph.GetOrCreateNodeArg("Y2", &float_2x3);
+
+  // constant inputs
+  graph.AddNode("mul", "Mul", "W * W", {&w, &w}, {&w_squared});
+  // input with static shape
+  graph.AddNode("shape", "Shape", "shape of X", {&x}, {&x_shape});
+  graph.AddNode("add", "Add", "X + W_squared", {&x, &w_squared}, {&sum});
+  graph.AddNode("reshape", "Reshape", "reshape to the shape of X", {&sum, &x_shape}, {&y});
+  // non-deterministic
+  auto& random_node = graph.AddNode("random", "RandomUniform", "random values", {}, {&random});
+  random_node.AddAttribute("shape", std::vector<int64_t>{2, 3});
+  graph.AddNode("add_random", "Add", "X + random", {&x, &random}, {&z});
+  // initializer that can be overridden
+  graph.AddNode("mul_overridable", "Mul", "W2 * W2", {&w2, &w2}, {&w2_squared});
+  graph.AddNode("add_overridable", "Add", "X + W2_squared", {&x, &w2_squared}, {&y2});
+
+  EXPECT_TRUE(graph.Resolve().IsOK());
+
+  // a graph that isn't loaded from a model lists all its initializers as inputs, so remove W from the inputs
+  auto model_proto = model.ToProto();
+  auto* inputs = model_proto.mutable_graph()->mutable_input();
+  for (auto it = inputs->begin(); it != inputs->end(); ++it) {
+    if (it->name() == "W") {
+      inputs->erase(it);
+      break;
+    }
+  }
+
+  return model_proto;
+}
+
+TEST(GraphTransformationTests, ConstantFolding) {
+  std::shared_ptr<Model> model;
+  ASSERT_TRUE(Model::Load(CreateConstantFoldingModel(), model).IsOK());
+  auto& graph = model->MainGraph();
+
+  ConstantFolding constant_folding;
+  bool modified = false;
+  auto status = constant_folding.Apply(graph, modified);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_TRUE(modified);
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Mul"], 1);
+  EXPECT_EQ(op_to_count["Shape"], 0);
+  EXPECT_EQ(op_to_count["Add"], 3);
+  EXPECT_EQ(op_to_count["Reshape"], 1);
+  EXPECT_EQ(op_to_count["RandomUniform"], 1);
+
+  const TensorProto* folded = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor("W_squared", folded));
+  std::vector<float> w_squared_values(6);
+  ASSERT_TRUE(utils::UnpackTensor(*folded, folded->raw_data().data(), folded->raw_data().size(),
+                                  w_squared_values.data(), 6)
+                  .IsOK());
+  EXPECT_EQ(w_squared_values, (std::vector<float>{1.f, 4.f, 9.f, 16.f, 25.f, 36.f}));
+
+  ASSERT_TRUE(graph.GetInitializedTensor("X_shape", folded));
+  std::vector<int64_t> x_shape_values(2);
+  ASSERT_TRUE(utils::UnpackTensor(*folded, folded->has_raw_data() ? folded->raw_data().data() : nullptr,
+                                  folded->raw_data().size(), x_shape_values.data(), 2)
+                  .IsOK());
+  EXPECT_EQ(x_shape_values, (std::vector<int64_t>{2, 3}));
+
+  // the initializer that can be overridden is not folded
+  EXPECT_FALSE(graph.GetInitializedTensor("W2_squared", folded));
+}
+
+TEST(GraphTransformationTests, ConstantFoldingOverriddenInitializer) {
+  std::stringstream model_stream;
+  CreateConstantFoldingModel().SerializeToOstream(&model_stream);
+
+  SessionOptions so;
+  so.session_logid = "GraphTransformationTests.ConstantFoldingOverriddenInitializer";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.RegisterGraphTransformer(std::make_unique<ConstantFolding>()).IsOK());
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  std::vector<int64_t> dims = {2, 3};
+  MLValue x_value;
+  CreateMLValue<float>(allocator, dims, {0.f, 0.f, 0.f, 0.f, 0.f, 0.f}, &x_value);
+  MLValue w2_value;
+  CreateMLValue<float>(allocator, dims, {2.f, 2.f, 2.f, 2.f, 2.f, 2.f}, &w2_value);
+
+  // the feed replaces the value of W2
+  NameMLValMap feeds{{"X", x_value}, {"W2", w2_value}};
+  std::vector<MLValue> fetches;
+  auto status = session_object.Run(RunOptions{}, feeds, {"Y", "Y2"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_EQ(fetches.size(), 2u);
+
+  const float* y = fetches[0].Get<Tensor>().Data<float>();
+  EXPECT_EQ(std::vector<float>(y, y + 6), (std::vector<float>{1.f, 4.f, 9.f, 16.f, 25.f, 36.f}));
+  const float* y2 = fetches[1].Get<Tensor>().Data<float>();
+  EXPECT_EQ(std::vector<float>(y2, y2 + 6), (std::vector<float>{4.f, 4.f, 4.f, 4.f, 4.f, 4.f}));
+}
+
+// a kernel failing on constant inputs leaves the node in the graph instead of failing the transform
+TEST(GraphTransformationTests, ConstantFoldingKernelFailure) {
+  Model model("ConstantFoldingKernelFailure");
+  auto& graph = model.MainGraph();
+
+  TensorProto data_tensor;
+  data_tensor.set_name("data");
+  data_tensor.set_data_type(TensorProto_DataType_FLOAT);
+  data_tensor.add_dims(3);
+  for (int i = 1; i <= 3; ++i) {
+    data_tensor.add_float_data(static_cast<float>(i));
+  }
+  graph.AddInitializedTensor(data_tensor);
+
+  TensorProto indices_tensor;
+  indices_tensor.set_name("indices");
+  indices_tensor.set_data_type(TensorProto_DataType_INT64);
+  indices_tensor.add_dims(1);
+  indices_tensor.add_int64_data(5);
+  graph.AddInitializedTensor(indices_tensor);
+
+  TypeProto float_3;
+  float_3.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_3.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  TypeProto int64_1;
+  int64_1.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  int64_1.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  TypeProto float_1;
+  float_1.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_1.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  auto& data = graph.GetOrCreateNodeArg("data", &float_3);
+  auto& indices = graph.GetOrCreateNodeArg("indices", &int64_1);
+  auto& gathered = graph.GetOrCreateNodeArg("gathered", &float_1);
+  auto& x = graph.GetOrCreateNodeArg("X", &float_1);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_1);
+
+  // index 5 is out of the bounds of data
+  graph.AddNode("gather", "Gather", "gather out of bounds", {&data, &indices}, {&gathered});
+  graph.AddNode("add", "Add", "X + gathered", {&x, &gathered}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  // remove the initializers from the graph inputs so they are constant
+  auto model_proto = model.ToProto();
+  auto* inputs = model_proto.mutable_graph()->mutable_input();
+  for (auto it = inputs->begin(); it != inputs->end();) {
+    it = it->name() == "X" ? it + 1 : inputs->erase(it);
+  }
+
+  std::shared_ptr<Model> loaded_model;
+  ASSERT_TRUE(Model::Load(model_proto, loaded_model).IsOK());
+  auto& loaded_graph = loaded_model->MainGraph();
+
+  ConstantFolding constant_folding;
+  bool modified = false;
+  auto status = constant_folding.Apply(loaded_graph, modified);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_FALSE(modified);
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(loaded_graph);
+  EXPECT_EQ(op_to_count["Gather"], 1);
+  EXPECT_EQ(op_to_count["Add"], 1);
+}
+
+TEST(GraphTransformationTests, NchwcTransformer) {
+  if (MlasNchwcGetBlockSize() <= 1) {
+    return;
+  }
+
+  Model model("NchwcTransformer");
+  auto& graph = model.MainGraph();
+
+  auto make_type = [](std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (int64_t dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+
+  auto add_weights = [&graph](const std::string& name, int64_t output_channels, int64_t input_channels) {
+    TensorProto w_tensor;
+    w_tensor.set_name(name);
+    w_tensor.set_data_type(TensorProto_DataType_FLOAT);
+    w_tensor.add_dims(output_channels);
+    w_tensor.add_dims(input_channels);
+    w_tensor.add_dims(3);
+    w_tensor.add_dims(3);
+    for (int64_t i = 0; i < output_channels * input_channels * 9; ++i) {
+      w_tensor.add_float_data(static_cast<float>(i % 7) * 0.125f);
+    }
+    graph.AddInitializedTensor(w_tensor);
+  };
+
+  TypeProto x_type = make_type({1, 32, 28, 28});
+  TypeProto w_type = make_type({32, 32, 3, 3});
+  TypeProto pooled_type = make_type({1, 32, 14, 14});
+
+  add_weights("W1", 32, 32);
+  add_weights("W2", 32, 32);
+  add_weights("W3", 32, 32);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& w1 = graph.GetOrCreateNodeArg("W1", &w_type);
+  auto& w2 = graph.GetOrCreateNodeArg("W2", &w_type);
+  auto& w3 = graph.GetOrCreateNodeArg("W3", &w_type);
+  auto& conv1_out = graph.GetOrCreateNodeArg("conv1_out", &x_type);
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", &x_type);
+  auto& pool_out = graph.GetOrCreateNodeArg("pool_out", &pooled_type);
+  auto& conv2_out = graph.GetOrCreateNodeArg("conv2_out", &pooled_type);
+  auto& conv3_out = graph.GetOrCreateNodeArg("conv3_out", &pooled_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &pooled_type);
+
+  const std::vector<int64_t> pads{1, 1, 1, 1};
+
+  auto& conv1 = graph.AddNode("conv1", "Conv", "3x3 conv", {&x, &w1}, {&conv1_out});
+  conv1.AddAttribute("pads", pads);
+  graph.AddNode("relu", "Relu", "relu", {&conv1_out}, {&relu_out});
+  auto& pool = graph.AddNode("pool", "MaxPool", "2x2 pool", {&relu_out}, {&pool_out});
+  pool.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+  pool.AddAttribute("strides", std::vector<int64_t>{2, 2});
+  auto& conv2 = graph.AddNode("conv2", "Conv", "3x3 conv", {&pool_out, &w2}, {&conv2_out});
+  conv2.AddAttribute("pads", pads);
+  auto& conv3 = graph.AddNode("conv3", "Conv", "3x3 conv", {&pool_out, &w3}, {&conv3_out});
+  conv3.AddAttribute("pads", pads);
+  graph.AddNode("add", "Add", "residual add", {&conv2_out, &conv3_out}, {&y});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  NchwcTransformer nchwc_transformer;
+  bool modified = false;
+  auto status = nchwc_transformer.Apply(graph, modified);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_TRUE(modified);
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Conv"], 0);
+  EXPECT_EQ(op_to_count["Relu"], 0);
+  EXPECT_EQ(op_to_count["MaxPool"], 0);
+  EXPECT_EQ(op_to_count["Add"], 0);
+  EXPECT_EQ(op_to_count["NchwcConv"], 3);
+  EXPECT_EQ(op_to_count["NchwcMaxPool"], 1);
+  EXPECT_EQ(op_to_count["ReorderInput"], 1);
+  EXPECT_EQ(op_to_count["ReorderOutput"], 1);
+}
+
+// A chain of additions after a convolution fuses at most one addition into
+// each convolution.
+TEST(GraphTransformationTests, NchwcTransformerChainedAdd) {
+  if (MlasNchwcGetBlockSize() <= 1) {
+    return;
+  }
+
+  Model model("NchwcTransformerChainedAdd");
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (int64_t dim : {1, 32, 28, 28}) {
+    x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+
+  TypeProto w_type;
+  w_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (int64_t dim : {32, 32, 3, 3}) {
+    w_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  std::vector<NodeArg*> conv_outputs;
+  for (int i = 1; i <= 3; ++i) {
+    const std::string w_name = "W" + std::to_string(i);
+    TensorProto w_tensor;
+    w_tensor.set_name(w_name);
+    w_tensor.set_data_type(TensorProto_DataType_FLOAT);
+    for (int64_t dim : {32, 32, 3, 3}) {
+      w_tensor.add_dims(dim);
+    }
+    for (int64_t j = 0; j < 32 * 32 * 9; ++j) {
+      w_tensor.add_float_data(static_cast<float>(j % 5) * 0.25f);
+    }
+    graph.AddInitializedTensor(w_tensor);
+
+    auto& w = graph.GetOrCreateNodeArg(w_name, &w_type);
+    auto& conv_out = graph.GetOrCreateNodeArg("conv" + std::to_string(i) + "_out", &x_type);
+    auto& conv = graph.AddNode("conv" + std::to_string(i), "Conv", "3x3 conv", {&x, &w}, {&conv_out});
+    conv.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+    conv_outputs.push_back(&conv_out);
+  }
+
+  // conv1 accumulates conv2 for the first Add. conv3 is also used by the
+  // Sigmoid, so the second Add can't be fused into conv3, and must not be
+  // fused into conv1 either.
+  auto& add1_out = graph.GetOrCreateNodeArg("add1_out", &x_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &x_type);
+  auto& z = graph.GetOrCreateNodeArg("Z", &x_type);
+  graph.AddNode("add1", "Add", "first add", {conv_outputs[0], conv_outputs[1]}, {&add1_out});
+  graph.AddNode("add2", "Add", "second add", {&add1_out, conv_outputs[2]}, {&y});
+  graph.AddNode("sigmoid", "Sigmoid", "sigmoid", {conv_outputs[2]}, {&z});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  NchwcTransformer nchwc_transformer;
+  bool modified = false;
+  auto status = nchwc_transformer.Apply(graph, modified);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_TRUE(modified);
+
+  status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Conv"], 0);
+  EXPECT_EQ(op_to_count["NchwcConv"], 3);
+  EXPECT_EQ(op_to_count["Add"], 1);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "NchwcConv") {
+      EXPECT_LE(node.InputDefs().size(), 4u);
+    }
+  }
+}
+
+TEST(GraphTransformationTests, ElementwiseFusion) {
+  Model model("ElementwiseFusion");
+  auto& graph = model.MainGraph();
+
+  auto make_type = [](std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (int64_t dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+
+  TypeProto x_type = make_type({4, 16});
+  TypeProto s_type = make_type({1});
+  TypeProto b_type = make_type({16});
+  TypeProto c_type = make_type({4, 1});
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& s = graph.GetOrCreateNodeArg("S", &s_type);
+  auto& b = graph.GetOrCreateNodeArg("B", &b_type);
+  auto& c = graph.GetOrCreateNodeArg("C", &c_type);
+  auto& mul_out = graph.GetOrCreateNodeArg("mul_out", &x_type);
+  auto& add_out = graph.GetOrCreateNodeArg("add_out", &x_type);
+  auto& y1 = graph.GetOrCreateNodeArg("Y1", &x_type);
+  auto& y2 = graph.GetOrCreateNodeArg("Y2", &x_type);
+
+  graph.AddNode("mul", "Mul", "scale", {&x, &s}, {&mul_out});
+  graph.AddNode("add", "Add", "bias", {&mul_out, &b}, {&add_out});
+  graph.AddNode("tanh", "Tanh", "activation", {&add_out}, {&y1});
+  // The input C is broadcast along the trailing dimension, so this node is
+  // not fused.
+  graph.AddNode("add2", "Add", "column add", {&y1, &c}, {&y2});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  ElementwiseFusion elementwise_fusion;
+  bool modified = false;
+  auto status = elementwise_fusion.Apply(graph, modified);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_TRUE(modified);
+
+  status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Mul"], 0);
+  EXPECT_EQ(op_to_count["Tanh"], 0);
+  EXPECT_EQ(op_to_count["Add"], 1);
+  EXPECT_EQ(op_to_count["FusedElementwise"], 1);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "FusedElementwise") {
+      const auto* ops = utils::GetNodeAttribute(node, "ops");
+      const auto* operands = utils::GetNodeAttribute(node, "operands");
+      ASSERT_TRUE(ops != nullptr && operands != nullptr);
+      EXPECT_EQ(std::vector<std::string>(ops->strings().begin(), ops->strings().end()),
+                (std::vector<std::string>{"Mul", "Add", "Tanh"}));
+      EXPECT_EQ(std::vector<int64_t>(operands->ints().begin(), operands->ints().end()),
+                (std::vector<int64_t>{0, 1, 3, 2, 4, -1}));
+      EXPECT_EQ(node.OutputDefs()[0], &y1);
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -66,7 +66,8 @@ TEST(OptimizerTest, Basic) {
     nodes.push_back(&node);
   }
 
-  OptimizerExecutionFrame::Info info(nodes, initialized_tensor_set);
+  CPUExecutionProvider cpu_execution_provider{CPUExecutionProviderInfo()};
+  OptimizerExecutionFrame::Info info(nodes, initialized_tensor_set, cpu_execution_provider);
   std::vector<int> fetch_mlvalue_idxs{info.GetMLValueIndex("out")};
   OptimizerExecutionFrame frame(info, fetch_mlvalue_idxs);
   const logging::Logger& logger = ::onnxruntime::test::DefaultLoggingManager().DefaultLogger();
@@ -74,7 +75,7 @@ TEST(OptimizerTest, Basic) {
   for (auto& node : graph.Nodes()) {
     auto* kernel = info.GetKernel(node.Index());
 
-    OpKernelContext op_kernel_context(&frame, kernel, logger);
+    OpKernelContext op_kernel_context(&frame, kernel, nullptr, logger);
 
     kernel->Compute(&op_kernel_context);
 
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include <future>
+#include <thread>
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
@@ -487,6 +488,161 @@ TEST(Loop, InfiniteLoopTermination) {
   terminator_thread.join();
 }
 
+// the subgraph execution frame is reused across iterations, so test that the shapes of the values in the subgraph
+// can change part way through the loop.
+TEST(Loop, SubgraphShapesChangeMidLoop) {
+  auto create_subgraph = [](const RunOptions&) {
+    Model model("Loop subgraph with changing shapes");
+    auto& graph = model.MainGraph();
+
+    std::vector<NodeArg*> inputs;
+    std::vector<NodeArg*> outputs;
+
+    /* Tile the loop carried var by max(iter_num - 1, 1). The shapes of the subgraph inputs are the same for the
+       first 4 iterations, but the tiled value is larger in the 4th. The shape of loop_var changes in the 5th.
+
+       Inputs: iter_num, cond_in, loop_var_in
+
+     iter_num_in        loop_var_in  [outer_scope_0]   cond_in
+          |                   |        /                 |
+        [Cast]              [Add]-----/              [Identity]
+          |                   |                          |
+   iter_num_float [constant_1]|                       cond_out
+          |          /    |   |
+        [Sub]-------/     |   |
+          |               |   |
+        [Max]------------/    |
+          |                   |
+        [Cast]                |
+          |                   |
+      num_repeats          sum_0
+           \                 |
+            \--------------[Tile]
+                             |
+                           tiled
+                           /   \
+                  [Identity]   [ReduceSum]
+                       |           |
+                 loop_var_out  loop_out_0
+    */
+
+    TypeProto int64_scalar;
+    int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_scalar;
+    bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto float_scalar;
+    float_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    // dimension value changes during the loop so just add a dimension but no value
+    TypeProto float_tensor_single_dim;
+    float_tensor_single_dim.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_tensor_single_dim.mutable_tensor_type()->mutable_shape()->add_dim();
+
+    TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+    // graph inputs
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+    auto& loop_var_in = graph.GetOrCreateNodeArg("loop_var_in", &float_tensor_single_dim);
+
+    // outer scope value. need type but not shape.
+    auto& outer_scope_0 = graph.GetOrCreateNodeArg("outer_scope_0", &float_tensor);
+
+    // add so that we don't end up with it being considered a graph input
+    graph.AddOuterScopeNodeArg("outer_scope_0");
+
+    auto& constant_1 = graph.GetOrCreateNodeArg("constant_1", &float_scalar);
+    auto& iter_num_float = graph.GetOrCreateNodeArg("iter_num_float", &float_scalar);
+    auto& iter_num_minus_1 = graph.GetOrCreateNodeArg("iter_num_minus_1", &float_scalar);
+    auto& num_repeats_float = graph.GetOrCreateNodeArg("num_repeats_float", &float_scalar);
+    auto& num_repeats = graph.GetOrCreateNodeArg("num_repeats", &int64_scalar);
+    auto& sum_0 = graph.GetOrCreateNodeArg("sum_0", &float_tensor_single_dim);
+    auto& tiled = graph.GetOrCreateNodeArg("tiled", &float_tensor_single_dim);
+
+    // graph outputs
+    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+    auto& loop_var_out = graph.GetOrCreateNodeArg("loop_var_out", &float_tensor_single_dim);
+    auto& loop_out_0 = graph.GetOrCreateNodeArg("loop_out_0", &float_scalar);
+
+    // cond_in -> cond_out
+    {
+      inputs = {&cond_in};
+      outputs = {&cond_out};
+
+      graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", inputs, outputs);
+    }
+
+    // Add outer_scope_0 to loop_var_in
+    {
+      inputs = {&loop_var_in, &outer_scope_0};
+      outputs = {&sum_0};
+
+      graph.AddNode("add", "Add", "Add outer_scope_0 to loop_var_in", inputs, outputs);
+    }
+
+    // calculate the number of repeats as max(iter_num - 1, 1)
+    {
+      auto& constant = graph.AddNode("constant_1", "Constant", "Constant with value 1", {}, {&constant_1});
+
+      TensorProto value_tensor;
+      value_tensor.add_dims(1);
+      value_tensor.add_float_data(1.f);
+      value_tensor.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+
+      constant.AddAttribute("value", value_tensor);
+
+      auto& cast_in = graph.AddNode("iter_num_cast", "Cast", "Cast iter_num to float",
+                                    {&iter_num_in}, {&iter_num_float});
+      cast_in.AddAttribute("to", int64_t{TensorProto_DataType_FLOAT});
+
+      graph.AddNode("sub", "Sub", "Subtract 1 from iter_num", {&iter_num_float, &constant_1}, {&iter_num_minus_1});
+      graph.AddNode("max", "Max", "Make the number of repeats at least 1", {&iter_num_minus_1, &constant_1},
+                    {&num_repeats_float});
+
+      auto& cast_out = graph.AddNode("num_repeats_cast", "Cast", "Cast the number of repeats to int64",
+                                     {&num_repeats_float}, {&num_repeats});
+      cast_out.AddAttribute("to", int64_t{TensorProto_DataType_INT64});
+    }
+
+    // Tile sum_0, and output the tiled value as the loop carried var and its sum as the loop output
+    {
+      graph.AddNode("tile", "Tile", "Tile sum_0", {&sum_0, &num_repeats}, {&tiled});
+      graph.AddNode("tiled_identity", "Identity", "Forward tiled to loop_var_out", {&tiled}, {&loop_var_out});
+
+      auto& reduce_sum = graph.AddNode("reduce_sum", "ReduceSum", "Sum the tiled values", {&tiled}, {&loop_out_0});
+      reduce_sum.AddAttribute("axes", std::vector<int64_t>{0});
+      reduce_sum.AddAttribute("keepdims", int64_t{1});
+    }
+
+    graph.SetInputOrder({&iter_num_in, &cond_in, &loop_var_in});
+    graph.SetOutputOrder({&cond_out, &loop_var_out, &loop_out_0});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  LoopOpTester test{{}, create_subgraph};
+
+  test.AddInput<int64_t>("M", {1}, {5});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("loop_var_0_orig", {1}, {0.f});
+
+  // kOuterNodeAddValue is added on each iteration. the value is tiled twice in the 4th iteration and
+  // three times in the 5th.
+  test.AddOutput<float>("loop_var_0_final", {6}, {15.f, 15.f, 15.f, 15.f, 15.f, 15.f});
+  test.AddOutput<float>("loop_out_0_final", {5, 1}, {3.f, 6.f, 9.f, 24.f, 90.f});
+
+  test.Run();
+}
+
 #ifdef USE_CUDA
 // test that when part of the subgraph run on CUDA it executes successfully
 TEST(Loop, MixedExecutionProviders) {
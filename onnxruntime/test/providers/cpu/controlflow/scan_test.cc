@@ -569,6 +569,113 @@ static void BadShape(bool is_v8) {
 
 TEST_8_AND_9(BadShape);
 
+// the shape of scan_output_0 is only known once the subgraph runs, so the first iteration allocates the Scan output
+// with a custom allocator, and the later iterations, which reuse the same execution frame, must write to the
+// slices of the Scan output instead.
+static void SymbolicShapeInSubgraphOutput(bool is_v8) {
+  Model model("SymbolicShapeInSubgraphOutput");
+  auto& graph = model.MainGraph();
+
+  /* Subgraph looks like this.
+
+    [constant_1]  loop_state_in_1     scan_in_0
+            \        /    |      \       |
+             \-[Add]-/ [Identity] \---[Add]
+                 |         |            |
+       loop_state_out_1  scan_out_1  scan_out_0
+  */
+  {
+    TypeProto float_single_value;
+    float_single_value.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_single_value.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    // symbolic dimension so the shape of scan_out_0 is not known until the subgraph runs
+    TypeProto float_single_dim;
+    float_single_dim.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_single_dim.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("input_size");
+
+    auto& loop_state_in_1 = graph.GetOrCreateNodeArg("loop_state_in_1", &float_single_value);
+    auto& scan_in_0 = graph.GetOrCreateNodeArg("scan_in_0", &float_single_dim);
+
+    auto& constant_1 = graph.GetOrCreateNodeArg("constant_1", &float_single_value);
+    auto& loop_state_out_1 = graph.GetOrCreateNodeArg("loop_state_out_1", &float_single_value);
+    auto& scan_out_0 = graph.GetOrCreateNodeArg("scan_out_0", &float_single_dim);
+    auto& scan_out_1 = graph.GetOrCreateNodeArg("scan_out_1", &float_single_value);
+
+    auto& constant = graph.AddNode("constant", "Constant", "Constant with value 1", {}, {&constant_1});
+
+    TensorProto value_tensor;
+    value_tensor.add_dims(1);
+    value_tensor.add_float_data(1.f);
+    value_tensor.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+
+    constant.AddAttribute("value", value_tensor);
+
+    graph.AddNode("add_loop_state", "Add", "Add 1 to the loop state", {&loop_state_in_1, &constant_1},
+                  {&loop_state_out_1});
+    graph.AddNode("add_scan_input", "Add", "Add the loop state to the scan input", {&scan_in_0, &loop_state_in_1},
+                  {&scan_out_0});
+    graph.AddNode("identity", "Identity", "Output the loop state", {&loop_state_in_1}, {&scan_out_1});
+
+    graph.SetInputOrder({&loop_state_in_1, &scan_in_0});
+    graph.SetOutputOrder({&loop_state_out_1, &scan_out_0, &scan_out_1});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+  }
+
+  auto& proto = graph.ToGraphProto();
+
+  ScanOpTester test{is_v8 ? 8 : 9};
+
+  test.AddAttribute("body", proto);
+  test.AddAttribute<int64_t>("num_scan_inputs", 1);
+
+  if (is_v8) {
+    const int64_t batch_size = 2;
+
+    test.AddMissingOptionalInput<int64_t>();
+    test.AddShapeToTensorData(false);
+
+    test.AddInput<float>("scan_loop_state_in_0", {batch_size, 1}, {0.f, 10.f});
+    test.AddInput<float>("scan_input_0", {batch_size, 3, 2}, {1.f, 2.f,
+                                                              3.f, 4.f,
+                                                              5.f, 6.f,
+
+                                                              -1.f, -2.f,
+                                                              -3.f, -4.f,
+                                                              -5.f, -6.f});
+
+    test.AddOutput<float>("scan_loop_state_out_0", {batch_size, 1}, {3.f, 13.f});
+    test.AddOutput<float>("scan_output_0", {batch_size, 3, 2}, {1.f, 2.f,
+                                                                4.f, 5.f,
+                                                                7.f, 8.f,
+
+                                                                9.f, 8.f,
+                                                                8.f, 7.f,
+                                                                7.f, 6.f});
+    test.AddOutput<float>("scan_output_1", {batch_size, 3, 1}, {0.f, 1.f, 2.f,
+                                                                10.f, 11.f, 12.f});
+  } else {
+    test.AddShapeToTensorData(false);
+
+    test.AddInput<float>("scan_loop_state_in_0", {1}, {0.f});
+    test.AddInput<float>("scan_input_0", {3, 2}, {1.f, 2.f,
+                                                  3.f, 4.f,
+                                                  5.f, 6.f});
+
+    test.AddOutput<float>("scan_loop_state_out_0", {1}, {3.f});
+    test.AddOutput<float>("scan_output_0", {3, 2}, {1.f, 2.f,
+                                                    4.f, 5.f,
+                                                    7.f, 8.f});
+    test.AddOutput<float>("scan_output_1", {3, 1}, {0.f, 1.f, 2.f});
+  }
+
+  test.Run();
+}
+
+TEST_8_AND_9(SymbolicShapeInSubgraphOutput);
+
 TEST(Scan8, ShortSequenceTwoInBatchOneLoopStateVar) {
   const int64_t batch_size = 2;
   const int64_t sequence_len = 2;
@@ -155,6 +155,53 @@ TEST(MathOpTest, Add_Broadcast_2x1x1_3x4) {
   test.Run();
 }
 
+// Large enough for the output to be split into several blocks on the thread pool, with
+// the block boundaries falling inside the broadcast spans.
+TEST(MathOpTest, Add_Broadcast_Large_Blocks) {
+  OpTester test("Add");
+
+  const int64_t batch = 3, heads = 2, rows = 50, cols = 700;
+  std::vector<float> a(batch * heads * rows * cols);
+  std::vector<float> b(batch * rows * cols);
+  std::vector<float> c(a.size());
+
+  for (size_t i = 0; i < a.size(); i++)
+    a[i] = static_cast<float>(i % 251);
+  for (size_t i = 0; i < b.size(); i++)
+    b[i] = static_cast<float>(i % 127) * 1000.0f;
+
+  for (int64_t n = 0; n < batch; n++)
+    for (int64_t h = 0; h < heads; h++)
+      for (int64_t i = 0; i < rows * cols; i++) {
+        size_t index = static_cast<size_t>((n * heads + h) * rows * cols + i);
+        c[index] = a[index] + b[static_cast<size_t>(n * rows * cols + i)];
+      }
+
+  test.AddInput<float>("A", {batch, heads, rows, cols}, a);
+  test.AddInput<float>("B", {batch, 1, rows, cols}, b);
+  test.AddOutput<float>("C", {batch, heads, rows, cols}, c);
+  test.Run();
+}
+
+TEST(MathOpTest, Mul_Broadcast_Large_Scalar_Spans) {
+  OpTester test("Mul");
+
+  const int64_t rows = 3, cols = 40000;
+  std::vector<float> a(rows * cols);
+  std::vector<float> b{2.0f, -1.0f, 0.5f};
+  std::vector<float> c(a.size());
+
+  for (size_t i = 0; i < a.size(); i++)
+    a[i] = static_cast<float>(i % 1000);
+  for (size_t i = 0; i < c.size(); i++)
+    c[i] = a[i] * b[i / cols];
+
+  test.AddInput<float>("A", {rows, cols}, a);
+  test.AddInput<float>("B", {rows, 1}, b);
+  test.AddOutput<float>("C", {rows, cols}, c);
+  test.Run();
+}
+
 TEST(MathOpTest, Sub_int32) {
   OpTester test("Sub");
   test.AddInput<int32_t>("A", {3}, {1, 4, 3});
@@ -100,6 +100,39 @@ TEST(GemmOpTest, GemmTrans) {
   test.Run();
 }
 
+// a constant B is pre-packed by the kernel
+TEST(GemmOpTest, GemmConstantB) {
+  for (int64_t trans_b : {0, 1}) {
+    OpTester test("Gemm");
+
+    test.AddAttribute("transA", (int64_t)0);
+    test.AddAttribute("transB", trans_b);
+    test.AddAttribute("alpha", 0.5f);
+    test.AddAttribute("beta", 1.0f);
+
+    test.AddInput<float>("A", {2, 4},
+                         {1.0f, 2.0f, 3.0f, 4.0f,
+                          -1.0f, -2.0f, -3.0f, -4.0f});
+    if (trans_b) {
+      test.AddInput<float>("B", {3, 4}, {1.0f, 1.0f, 1.0f, 1.0f,
+                                         2.0f, 2.0f, 2.0f, 2.0f,
+                                         0.0f, 1.0f, 0.0f, 1.0f},
+                           true);
+    } else {
+      test.AddInput<float>("B", {4, 3}, {1.0f, 2.0f, 0.0f,
+                                         1.0f, 2.0f, 1.0f,
+                                         1.0f, 2.0f, 0.0f,
+                                         1.0f, 2.0f, 1.0f},
+                           true);
+    }
+    test.AddInput<float>("C", {3}, std::vector<float>(3, 1.0f));
+    test.AddOutput<float>("Y", {2, 3},
+                          {6.0f, 11.0f, 4.0f,
+                           -4.0f, -9.0f, -2.0f});
+    test.Run();
+  }
+}
+
 TEST(GemmOpTest, GemmAlphaBeta) {
   OpTester test("Gemm");
 
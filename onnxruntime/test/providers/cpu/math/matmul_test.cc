@@ -77,11 +77,32 @@ std::vector<MatMulTestData<T>> GenerateTestCases()
     {2, 2, 4},
     {20, 23, 26, 29, 56, 68, 80, 92, 92, 113, 134, 155, 128, 158, 188, 218}});
 
+  test_cases.push_back(
+    {"test 3D batch",
+    {2, 2, 3},
+    {2, 3, 2},
+    {2, 2, 2},
+    {10, 13, 28, 40, 172, 193, 244, 274}});
+
+  test_cases.push_back(
+    {"test 3D batch shared left",
+    {2, 3},
+    {2, 3, 2},
+    {2, 2, 2},
+    {10, 13, 28, 40, 28, 31, 100, 112}});
+
+  test_cases.push_back(
+    {"test broadcast folded into rows",
+    {2, 2, 1, 3},
+    {2, 1, 3, 2},
+    {2, 2, 1, 2},
+    {10, 13, 28, 40, 172, 193, 244, 274}});
+
   return test_cases;
 }
 
 template <typename T>
-void RunMatMulTest(int32_t opset_version = 7)
+void RunMatMulTest(int32_t opset_version = 7, bool is_b_constant = false)
 {
   std::vector<T> common_input_vals{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
   for (auto t : GenerateTestCases<T>()) {
@@ -93,7 +114,7 @@ void RunMatMulTest(int32_t opset_version = 7)
 
     int64_t size1 = TensorShape::ReinterpretBaseType(t.input1_dims).SizeHelper(0, t.input1_dims.size());
     std::vector<T> input1_vals(common_input_vals.cbegin(), common_input_vals.cbegin() + size1);
-    test.AddInput<T>("B", t.input1_dims, input1_vals);
+    test.AddInput<T>("B", t.input1_dims, input1_vals, is_b_constant);
 
     test.AddOutput<T>("Y", t.expected_dims, t.expected_vals);
     test.Run();
@@ -104,6 +125,11 @@ TEST(MathOpTest, MatMulFloatType) {
   RunMatMulTest<float>();
 }
 
+// a constant B is pre-packed by the kernel
+TEST(MathOpTest, MatMulFloatTypeConstantB) {
+  RunMatMulTest<float>(7, true);
+}
+
 TEST(MathOpTest, MatMulDoubleType) {
   RunMatMulTest<double>();
 }
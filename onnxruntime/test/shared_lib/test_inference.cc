@@ -3,6 +3,7 @@
 
 #include "core/session/onnxruntime_cxx_api.h"
 #include "providers.h"
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <iostream>
@@ -255,6 +256,77 @@ TEST_F(CApiTest, custom_op_handler) {
   TestInference<PATH_TYPE>(env, CUSTOM_OP_MODEL_URI, dims_x, values_x, expected_dims_y, expected_values_y, false, false, custom_op_domain);
 }
 
+TEST_F(CApiTest, prepared_run) {
+  std::vector<size_t> dims_x = {3, 2};
+  std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<float> expected_values_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  SessionOptionsWrapper sf(env);
+  std::unique_ptr<OrtSession, decltype(&OrtReleaseSession)>
+      inference_session(sf.OrtCreateSession(MODEL_URI), OrtReleaseSession);
+  std::unique_ptr<MockedOrtAllocator> default_allocator(std::make_unique<MockedOrtAllocator>());
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  const char* invalid_output_names[] = {"Z"};
+
+  OrtPreparedRun* prepared_run_ptr = nullptr;
+  OrtStatus* status = OrtCreatePreparedRun(inference_session.get(), input_names, 1, invalid_output_names, 1,
+                                           &prepared_run_ptr);
+  ASSERT_NE(status, nullptr);
+  OrtReleaseStatus(status);
+
+  ORT_THROW_ON_ERROR(OrtCreatePreparedRun(inference_session.get(), input_names, 1, output_names, 1,
+                                          &prepared_run_ptr));
+  std::unique_ptr<OrtPreparedRun> prepared_run(prepared_run_ptr);
+
+  std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> value_x(
+      OrtCreateTensorAsOrtValue(default_allocator.get(), dims_x, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT),
+      OrtReleaseValue);
+  float* x;
+  ORT_THROW_ON_ERROR(OrtGetTensorMutableData(value_x.get(), (void**)&x));
+  std::copy(values_x.cbegin(), values_x.cend(), x);
+
+  std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> value_y(
+      OrtCreateTensorAsOrtValue(default_allocator.get(), dims_x, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT),
+      OrtReleaseValue);
+
+  const OrtValue* inputs[] = {value_x.get()};
+
+  // the first run is without a pre-allocated output, the others re-use the pre-allocated output
+  for (int i = 0; i != 3; ++i) {
+    OrtValue* outputs[] = {i == 0 ? nullptr : value_y.get()};
+    ORT_THROW_ON_ERROR(OrtRunPrepared(prepared_run.get(), nullptr, inputs, outputs));
+    ASSERT_NE(outputs[0], nullptr);
+
+    float* y;
+    ORT_THROW_ON_ERROR(OrtGetTensorMutableData(outputs[0], (void**)&y));
+    ASSERT_EQ(expected_values_y, std::vector<float>(y, y + expected_values_y.size()));
+
+    if (i == 0) {
+      OrtReleaseValue(outputs[0]);
+    } else {
+      ASSERT_EQ(outputs[0], value_y.get());
+    }
+  }
+
+  // a failed run must not keep a reference to the caller's values
+  std::vector<size_t> dims_bad_x = {3, 2};
+  std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> value_bad_x(
+      OrtCreateTensorAsOrtValue(default_allocator.get(), dims_bad_x, ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32),
+      OrtReleaseValue);
+  const OrtValue* bad_inputs[] = {value_bad_x.get()};
+  OrtValue* outputs[] = {value_y.get()};
+  status = OrtRunPrepared(prepared_run.get(), nullptr, bad_inputs, outputs);
+  ASSERT_NE(status, nullptr);
+  OrtReleaseStatus(status);
+
+  value_x.reset();
+  value_y.reset();
+  value_bad_x.reset();
+  ASSERT_NO_THROW(default_allocator->LeakCheck());
+}
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 TEST_F(CApiTest, create_session_without_session_option) {
   constexpr PATH_TYPE model_uri = TSTR("../models/opset8/test_squeezenet/model.onnx");